@@ -0,0 +1,621 @@
+#include <limits>
+#include <memory>
+#include <string>
+#include <sstream>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+#include <boost/range.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/program_options.hpp>
+
+#include "TrainingSet.h"
+#include "NeuralNetwork.h"
+#include "ClassRegistry.h"
+
+#include "TrainingAlgorithm.h"
+#include "RpropTrainingAlgorithm.h"
+#include "AdamTrainingAlgorithm.h"
+#include "AdamWTrainingAlgorithm.h"
+#include "AdaGradTrainingAlgorithm.h"
+#include "LbfgsTrainingAlgorithm.h"
+#include "RMSPropTrainingAlgorithm.h"
+#include "REvolutionaryTrainingAlgorithm.h"
+#include "BackpropagationTrainingAlgorithm.h"
+#include "LevenbergMarquardtTrainingAlgorithm.h"
+#include "BackpropagationThroughTimeTrainingAlgorithm.h"
+#include "ScaledConjugateGradientTrainingAlgorithm.h"
+#include "SimulatedAnnealingTrainingAlgorithm.h"
+#include "PsoTrainingAlgorithm.h"
+
+#include "TrainingOptions.h"
+
+
+using std::cout;
+using std::string;
+using std::unique_ptr;
+
+using namespace wzann;
+
+using boost::make_iterator_range;
+
+namespace fs = boost::filesystem;
+namespace po = boost::program_options;
+
+
+
+po::options_description trainingAlgorithmOptions()
+{
+    po::options_description desc("Training algorithm options");
+
+    desc.add_options()
+        ("revol-population-size",
+                po::value<size_t>()->default_value(30),
+                "REvol: Size of the general population")
+        ("revol-elite-size",
+                po::value<size_t>()->default_value(3),
+                "REvol: The size of the elite (contained in the population)")
+        ("revol-gradient-weight",
+                po::value<double>()->default_value(1.0),
+                "REvol: Weight of the implicit gradient information")
+        ("revol-success-weight",
+                po::value<double>()->default_value(1.0),
+                "REvol: Weight of population success rate")
+        ("revol-measurement-epochs",
+                po::value<wzalgorithm::REvol::epoch_t>()->default_value(
+                    REvolutionaryTrainingAlgorithm().measurementEpochs()),
+                "REvol: Time period of the pt1 function used for measuring "
+                    "overall population success")
+        ("revol-max-no-success-epochs",
+                po::value<wzalgorithm::REvol::epoch_t>()->default_value(
+                    std::numeric_limits<wzalgorithm::REvol::epoch_t>::max()),
+                "REvol: Maximum number of epochs without a global success")
+        ("revol-startttl",
+                po::value<std::ptrdiff_t>()->default_value(5 * 30),
+                "REvol: Initial Time To Live of a new individual")
+        ("revol-eamin",
+                po::value<double>()->default_value(
+                    REvolutionaryTrainingAlgorithm().eamin()),
+                "REvol: Absolute minimum value of a change")
+        ("revol-ebmin",
+                po::value<double>()->default_value(
+                    REvolutionaryTrainingAlgorithm().ebmin()),
+                "REvol: Relative minimum value of a change")
+        ("revol-ebmax",
+                po::value<double>()->default_value(
+                    REvolutionaryTrainingAlgorithm().ebmax()),
+                "REvol: Relative maximum value of a change")
+        ("revol-threads",
+                po::value<size_t>()->default_value(
+                    REvolutionaryTrainingAlgorithm().numThreads()),
+                "REvol: Number of threads that evaluate an individual; "
+                    "0 uses all hardware threads")
+        ("revol-racing",
+                "REvol: Stop evaluating individuals that are already worse "
+                    "than all recent ones")
+        ("backprop-learning-rate",
+                po::value<double>()->default_value(
+                    BackpropagationTrainingAlgorithm().learningRate()),
+                "Backpropagation: The learning rate")
+        ("backprop-batch-size",
+                po::value<size_t>()->default_value(
+                    BackpropagationTrainingAlgorithm().batchSize()),
+                "Backpropagation: Number of training items per weight "
+                    "update; 0 uses the whole training set")
+        ("backprop-momentum",
+                po::value<double>()->default_value(
+                    BackpropagationTrainingAlgorithm().momentum()),
+                "Backpropagation: Momentum factor; 0 disables momentum")
+        ("backprop-nesterov",
+                "Backpropagation: Use Nesterov's accelerated gradient")
+        ("bptt-learning-rate",
+                po::value<double>()->default_value(
+                    BackpropagationThroughTimeTrainingAlgorithm()
+                        .learningRate()),
+                "BPTT: The learning rate")
+        ("bptt-window",
+                po::value<size_t>()->default_value(
+                    BackpropagationThroughTimeTrainingAlgorithm().window()),
+                "BPTT: Number of time steps the errors are propagated back")
+        ("bptt-stride",
+                po::value<size_t>()->default_value(
+                    BackpropagationThroughTimeTrainingAlgorithm().stride()),
+                "BPTT: Number of time steps between weight updates; "
+                    "0 uses the window")
+        ("lm-damping",
+                po::value<double>()->default_value(
+                    LevenbergMarquardtTrainingAlgorithm().damping()),
+                "Levenberg-Marquardt: Damping at the start of the training")
+        ("lm-damping-factor",
+                po::value<double>()->default_value(
+                    LevenbergMarquardtTrainingAlgorithm().dampingFactor()),
+                "Levenberg-Marquardt: Factor by which the damping is "
+                    "raised or lowered")
+        ("lm-max-damping",
+                po::value<double>()->default_value(
+                    LevenbergMarquardtTrainingAlgorithm().maxDamping()),
+                "Levenberg-Marquardt: Damping at which the training stops")
+        ("lbfgs-history-size",
+                po::value<size_t>()->default_value(
+                    LbfgsTrainingAlgorithm().historySize()),
+                "L-BFGS: Number of epochs whose changes approximate the "
+                    "inverse Hessian")
+        ("lbfgs-line-search-steps",
+                po::value<size_t>()->default_value(
+                    LbfgsTrainingAlgorithm().lineSearchSteps()),
+                "L-BFGS: Maximum number of trial steps per epoch")
+        ("scg-sigma",
+                po::value<double>()->default_value(
+                    ScaledConjugateGradientTrainingAlgorithm().sigma()),
+                "SCG: Distance at which the curvature is estimated")
+        ("scg-lambda",
+                po::value<double>()->default_value(
+                    ScaledConjugateGradientTrainingAlgorithm().lambda()),
+                "SCG: Initial scale of the curvature")
+        ("sa-start-temperature",
+                po::value<double>()->default_value(
+                    SimulatedAnnealingTrainingAlgorithm()
+                        .startTemperature()),
+                "Simulated annealing: Temperature each epoch starts at, "
+                    "or of the hottest replica")
+        ("sa-stop-temperature",
+                po::value<double>()->default_value(
+                    SimulatedAnnealingTrainingAlgorithm()
+                        .stopTemperature()),
+                "Simulated annealing: Temperature each epoch ends at, "
+                    "or of the coldest replica")
+        ("sa-cycles",
+                po::value<size_t>()->default_value(
+                    SimulatedAnnealingTrainingAlgorithm().cycles()),
+                "Simulated annealing: Number of steps per epoch")
+        ("sa-step-size",
+                po::value<double>()->default_value(
+                    SimulatedAnnealingTrainingAlgorithm().stepSize()),
+                "Simulated annealing: Width of a weight change at the "
+                    "start temperature")
+        ("sa-replicas",
+                po::value<size_t>()->default_value(
+                    SimulatedAnnealingTrainingAlgorithm().replicas()),
+                "Simulated annealing: Number of replicas; more than 1 "
+                    "selects parallel tempering")
+        ("sa-exchange-interval",
+                po::value<size_t>()->default_value(
+                    SimulatedAnnealingTrainingAlgorithm()
+                        .exchangeInterval()),
+                "Simulated annealing: Number of steps between two "
+                    "exchanges of parallel tempering")
+        ("sa-threads",
+                po::value<size_t>()->default_value(
+                    SimulatedAnnealingTrainingAlgorithm().numThreads()),
+                "Simulated annealing: Number of threads that run the "
+                    "replicas; 0 uses all hardware threads")
+        ("pso-swarm-size",
+                po::value<size_t>()->default_value(
+                    PsoTrainingAlgorithm().swarmSize()),
+                "PSO: Number of particles")
+        ("pso-inertia",
+                po::value<double>()->default_value(
+                    PsoTrainingAlgorithm().inertia()),
+                "PSO: Factor by which a particle keeps its velocity")
+        ("pso-cognitive-weight",
+                po::value<double>()->default_value(
+                    PsoTrainingAlgorithm().cognitiveWeight()),
+                "PSO: Attraction of a particle's own best position")
+        ("pso-social-weight",
+                po::value<double>()->default_value(
+                    PsoTrainingAlgorithm().socialWeight()),
+                "PSO: Attraction of the swarm's best position")
+        ("pso-max-velocity",
+                po::value<double>()->default_value(
+                    PsoTrainingAlgorithm().maxVelocity()),
+                "PSO: Maximum change of a weight per epoch")
+        ("pso-lower-boundary",
+                po::value<double>()->default_value(
+                    PsoTrainingAlgorithm().lowerBoundary()),
+                "PSO: Smallest value a weight can take")
+        ("pso-upper-boundary",
+                po::value<double>()->default_value(
+                    PsoTrainingAlgorithm().upperBoundary()),
+                "PSO: Largest value a weight can take")
+        ("pso-threads",
+                po::value<size_t>()->default_value(
+                    PsoTrainingAlgorithm().numThreads()),
+                "PSO: Number of threads that evaluate the particles; "
+                    "0 uses all hardware threads")
+        ("rprop-threads",
+                po::value<size_t>()->default_value(
+                    RpropTrainingAlgorithm().numThreads()),
+                "Rprop: Number of threads that calculate the gradient; "
+                    "0 uses all hardware threads")
+        ("adam-learning-rate",
+                po::value<double>()->default_value(
+                    AdamTrainingAlgorithm().learningRate()),
+                "Adam, AdamW: The learning rate")
+        ("adam-batch-size",
+                po::value<size_t>()->default_value(
+                    AdamTrainingAlgorithm().batchSize()),
+                "Adam, AdamW: Number of training items per weight update; "
+                    "0 uses the whole training set")
+        ("adam-beta1",
+                po::value<double>()->default_value(
+                    AdamTrainingAlgorithm().beta1()),
+                "Adam, AdamW: Decay rate of the first moment estimates")
+        ("adam-beta2",
+                po::value<double>()->default_value(
+                    AdamTrainingAlgorithm().beta2()),
+                "Adam, AdamW: Decay rate of the second moment estimates")
+        ("adam-epsilon",
+                po::value<double>()->default_value(
+                    AdamTrainingAlgorithm().epsilon()),
+                "Adam, AdamW: Term added to the denominator of each step")
+        ("adamw-weight-decay",
+                po::value<double>()->default_value(
+                    AdamWTrainingAlgorithm().weightDecay()),
+                "AdamW: Fraction of each weight removed per step, times "
+                    "the learning rate")
+        ("rmsprop-learning-rate",
+                po::value<double>()->default_value(
+                    RMSPropTrainingAlgorithm().learningRate()),
+                "RMSProp: The learning rate")
+        ("rmsprop-batch-size",
+                po::value<size_t>()->default_value(
+                    RMSPropTrainingAlgorithm().batchSize()),
+                "RMSProp: Number of training items per weight update; "
+                    "0 uses the whole training set")
+        ("rmsprop-decay",
+                po::value<double>()->default_value(
+                    RMSPropTrainingAlgorithm().decay()),
+                "RMSProp: Decay rate of the mean squared gradients")
+        ("rmsprop-epsilon",
+                po::value<double>()->default_value(
+                    RMSPropTrainingAlgorithm().epsilon()),
+                "RMSProp: Term added to the denominator of each step")
+        ("adagrad-learning-rate",
+                po::value<double>()->default_value(
+                    AdaGradTrainingAlgorithm().learningRate()),
+                "AdaGrad: The learning rate")
+        ("adagrad-batch-size",
+                po::value<size_t>()->default_value(
+                    AdaGradTrainingAlgorithm().batchSize()),
+                "AdaGrad: Number of training items per weight update; "
+                    "0 uses the whole training set")
+        ("adagrad-epsilon",
+                po::value<double>()->default_value(
+                    AdaGradTrainingAlgorithm().epsilon()),
+                "AdaGrad: Term added to the denominator of each step");
+
+    return desc;
+}
+
+
+void listTrainingAlgorithms()
+{
+    cout << "Available training algorithms:\n";
+    auto* cr = ClassRegistry<TrainingAlgorithm>::instance();
+    for (auto const& i : make_iterator_range(cr->registry())) {
+        cout << "  * " << i.first << "\n";
+    }
+}
+
+
+template <class T>
+void configureTrainingAlgorithm(
+        T&,
+        po::variables_map const& = po::variables_map())
+{
+}
+
+
+template <>
+void configureTrainingAlgorithm(
+        REvolutionaryTrainingAlgorithm& trainingAlgorithm,
+        boost::program_options::variables_map const& vm)
+{
+    trainingAlgorithm
+            .successWeight(vm["revol-success-weight"].as<double>())
+            .measurementEpochs(vm["revol-measurement-epochs"].as<
+                wzalgorithm::REvol::epoch_t>())
+            .gradientWeight(vm["revol-gradient-weight"].as<double>())
+            .populationSize(vm["revol-population-size"].as<size_t>())
+            .eliteSize(vm["revol-elite-size"].as<size_t>())
+            .startTTL(vm["revol-startttl"].as<std::ptrdiff_t>())
+            .eamin(vm["revol-eamin"].as<double>())
+            .ebmin(vm["revol-ebmin"].as<double>())
+            .ebmax(vm["revol-ebmax"].as<double>())
+            .maxNoSuccessEpochs(vm["revol-max-no-success-epochs"].as<
+                wzalgorithm::REvol::epoch_t>());
+    trainingAlgorithm
+            .numThreads(vm["revol-threads"].as<size_t>())
+            .racing(vm.count("revol-racing") > 0);
+}
+
+
+template <>
+void configureTrainingAlgorithm(
+        BackpropagationTrainingAlgorithm& trainingAlgorithm,
+        boost::program_options::variables_map const& vm)
+{
+    trainingAlgorithm
+            .learningRate(vm["backprop-learning-rate"].as<double>())
+            .batchSize(vm["backprop-batch-size"].as<size_t>())
+            .momentum(vm["backprop-momentum"].as<double>())
+            .nesterov(vm.count("backprop-nesterov") > 0);
+}
+
+
+template <>
+void configureTrainingAlgorithm(
+        BackpropagationThroughTimeTrainingAlgorithm& trainingAlgorithm,
+        boost::program_options::variables_map const& vm)
+{
+    trainingAlgorithm
+            .learningRate(vm["bptt-learning-rate"].as<double>())
+            .window(vm["bptt-window"].as<size_t>())
+            .stride(vm["bptt-stride"].as<size_t>());
+}
+
+
+template <>
+void configureTrainingAlgorithm(
+        LevenbergMarquardtTrainingAlgorithm& trainingAlgorithm,
+        boost::program_options::variables_map const& vm)
+{
+    trainingAlgorithm
+            .damping(vm["lm-damping"].as<double>())
+            .dampingFactor(vm["lm-damping-factor"].as<double>())
+            .maxDamping(vm["lm-max-damping"].as<double>());
+}
+
+
+template <>
+void configureTrainingAlgorithm(
+        LbfgsTrainingAlgorithm& trainingAlgorithm,
+        boost::program_options::variables_map const& vm)
+{
+    trainingAlgorithm
+            .historySize(vm["lbfgs-history-size"].as<size_t>())
+            .lineSearchSteps(vm["lbfgs-line-search-steps"].as<size_t>());
+}
+
+
+template <>
+void configureTrainingAlgorithm(
+        ScaledConjugateGradientTrainingAlgorithm& trainingAlgorithm,
+        boost::program_options::variables_map const& vm)
+{
+    trainingAlgorithm
+            .sigma(vm["scg-sigma"].as<double>())
+            .lambda(vm["scg-lambda"].as<double>());
+}
+
+
+template <>
+void configureTrainingAlgorithm(
+        SimulatedAnnealingTrainingAlgorithm& trainingAlgorithm,
+        boost::program_options::variables_map const& vm)
+{
+    trainingAlgorithm
+            .startTemperature(vm["sa-start-temperature"].as<double>())
+            .stopTemperature(vm["sa-stop-temperature"].as<double>())
+            .cycles(vm["sa-cycles"].as<size_t>())
+            .stepSize(vm["sa-step-size"].as<double>())
+            .replicas(vm["sa-replicas"].as<size_t>())
+            .exchangeInterval(vm["sa-exchange-interval"].as<size_t>())
+            .numThreads(vm["sa-threads"].as<size_t>());
+}
+
+
+template <>
+void configureTrainingAlgorithm(
+        PsoTrainingAlgorithm& trainingAlgorithm,
+        boost::program_options::variables_map const& vm)
+{
+    trainingAlgorithm
+            .swarmSize(vm["pso-swarm-size"].as<size_t>())
+            .inertia(vm["pso-inertia"].as<double>())
+            .cognitiveWeight(vm["pso-cognitive-weight"].as<double>())
+            .socialWeight(vm["pso-social-weight"].as<double>())
+            .maxVelocity(vm["pso-max-velocity"].as<double>())
+            .lowerBoundary(vm["pso-lower-boundary"].as<double>())
+            .upperBoundary(vm["pso-upper-boundary"].as<double>())
+            .numThreads(vm["pso-threads"].as<size_t>());
+}
+
+
+template <>
+void configureTrainingAlgorithm(
+        RpropTrainingAlgorithm& trainingAlgorithm,
+        boost::program_options::variables_map const& vm)
+{
+    trainingAlgorithm.numThreads(vm["rprop-threads"].as<size_t>());
+}
+
+
+template <>
+void configureTrainingAlgorithm(
+        AdamTrainingAlgorithm& trainingAlgorithm,
+        boost::program_options::variables_map const& vm)
+{
+    trainingAlgorithm
+            .learningRate(vm["adam-learning-rate"].as<double>())
+            .batchSize(vm["adam-batch-size"].as<size_t>())
+            .epsilon(vm["adam-epsilon"].as<double>());
+    trainingAlgorithm
+            .beta1(vm["adam-beta1"].as<double>())
+            .beta2(vm["adam-beta2"].as<double>());
+}
+
+
+template <>
+void configureTrainingAlgorithm(
+        AdamWTrainingAlgorithm& trainingAlgorithm,
+        boost::program_options::variables_map const& vm)
+{
+    configureTrainingAlgorithm<AdamTrainingAlgorithm>(trainingAlgorithm, vm);
+    trainingAlgorithm.weightDecay(vm["adamw-weight-decay"].as<double>());
+}
+
+
+template <>
+void configureTrainingAlgorithm(
+        RMSPropTrainingAlgorithm& trainingAlgorithm,
+        boost::program_options::variables_map const& vm)
+{
+    trainingAlgorithm
+            .learningRate(vm["rmsprop-learning-rate"].as<double>())
+            .batchSize(vm["rmsprop-batch-size"].as<size_t>())
+            .epsilon(vm["rmsprop-epsilon"].as<double>());
+    trainingAlgorithm.decay(vm["rmsprop-decay"].as<double>());
+}
+
+
+template <>
+void configureTrainingAlgorithm(
+        AdaGradTrainingAlgorithm& trainingAlgorithm,
+        boost::program_options::variables_map const& vm)
+{
+    trainingAlgorithm
+            .learningRate(vm["adagrad-learning-rate"].as<double>())
+            .batchSize(vm["adagrad-batch-size"].as<size_t>())
+            .epsilon(vm["adagrad-epsilon"].as<double>());
+}
+
+
+unique_ptr<TrainingAlgorithm> createTrainingAlgorithm(
+        string const& name,
+        po::variables_map const& commandLineArguments)
+{
+    unique_ptr<TrainingAlgorithm> trainingAlgorithm(nullptr);
+    auto* cr = ClassRegistry<TrainingAlgorithm>::instance();
+
+    if (cr->isRegistered(name)) {
+        trainingAlgorithm.reset(cr->create(name));
+
+        if (name == "wzann::REvolutionaryTrainingAlgorithm") {
+            configureTrainingAlgorithm<REvolutionaryTrainingAlgorithm>(
+                    dynamic_cast<REvolutionaryTrainingAlgorithm&>(
+                        *trainingAlgorithm),
+                    commandLineArguments);
+        } else if (name == "wzann::RpropTrainingAlgorithm"
+                || name == "wzann::IRpropPlusTrainingAlgorithm"
+                || name == "wzann::IRpropMinusTrainingAlgorithm") {
+            configureTrainingAlgorithm<RpropTrainingAlgorithm>(
+                    dynamic_cast<RpropTrainingAlgorithm&>(
+                        *trainingAlgorithm),
+                    commandLineArguments);
+        } else if (name == "wzann::BackpropagationTrainingAlgorithm") {
+            configureTrainingAlgorithm<BackpropagationTrainingAlgorithm>(
+                    dynamic_cast<BackpropagationTrainingAlgorithm&>(
+                        *trainingAlgorithm),
+                    commandLineArguments);
+        } else if (name
+                == "wzann::BackpropagationThroughTimeTrainingAlgorithm") {
+            configureTrainingAlgorithm<
+                    BackpropagationThroughTimeTrainingAlgorithm>(
+                        dynamic_cast<
+                            BackpropagationThroughTimeTrainingAlgorithm&>(
+                                *trainingAlgorithm),
+                        commandLineArguments);
+        } else if (name == "wzann::LevenbergMarquardtTrainingAlgorithm") {
+            configureTrainingAlgorithm<LevenbergMarquardtTrainingAlgorithm>(
+                    dynamic_cast<LevenbergMarquardtTrainingAlgorithm&>(
+                        *trainingAlgorithm),
+                    commandLineArguments);
+        } else if (name == "wzann::LbfgsTrainingAlgorithm") {
+            configureTrainingAlgorithm<LbfgsTrainingAlgorithm>(
+                    dynamic_cast<LbfgsTrainingAlgorithm&>(*trainingAlgorithm),
+                    commandLineArguments);
+        } else if (name
+                == "wzann::ScaledConjugateGradientTrainingAlgorithm") {
+            configureTrainingAlgorithm<
+                    ScaledConjugateGradientTrainingAlgorithm>(
+                        dynamic_cast<
+                            ScaledConjugateGradientTrainingAlgorithm&>(
+                                *trainingAlgorithm),
+                        commandLineArguments);
+        } else if (name == "wzann::SimulatedAnnealingTrainingAlgorithm") {
+            configureTrainingAlgorithm<SimulatedAnnealingTrainingAlgorithm>(
+                    dynamic_cast<SimulatedAnnealingTrainingAlgorithm&>(
+                        *trainingAlgorithm),
+                    commandLineArguments);
+        } else if (name == "wzann::PsoTrainingAlgorithm") {
+            configureTrainingAlgorithm<PsoTrainingAlgorithm>(
+                    dynamic_cast<PsoTrainingAlgorithm&>(*trainingAlgorithm),
+                    commandLineArguments);
+        } else if (name == "wzann::AdamTrainingAlgorithm") {
+            configureTrainingAlgorithm<AdamTrainingAlgorithm>(
+                    dynamic_cast<AdamTrainingAlgorithm&>(*trainingAlgorithm),
+                    commandLineArguments);
+        } else if (name == "wzann::AdamWTrainingAlgorithm") {
+            configureTrainingAlgorithm<AdamWTrainingAlgorithm>(
+                    dynamic_cast<AdamWTrainingAlgorithm&>(*trainingAlgorithm),
+                    commandLineArguments);
+        } else if (name == "wzann::RMSPropTrainingAlgorithm") {
+            configureTrainingAlgorithm<RMSPropTrainingAlgorithm>(
+                    dynamic_cast<RMSPropTrainingAlgorithm&>(
+                        *trainingAlgorithm),
+                    commandLineArguments);
+        } else if (name == "wzann::AdaGradTrainingAlgorithm") {
+            configureTrainingAlgorithm<AdaGradTrainingAlgorithm>(
+                    dynamic_cast<AdaGradTrainingAlgorithm&>(
+                        *trainingAlgorithm),
+                    commandLineArguments);
+        }
+    } else {
+        throw std::runtime_error("Unknown training algorithm");
+    }
+
+    return trainingAlgorithm;
+}
+
+
+unique_ptr<TrainingSet> readTrainingSet(
+        string const& path,
+        po::variables_map const& options)
+{
+    fs::path tsp(path);
+    unique_ptr<TrainingSet> trainingSet(nullptr);
+
+    if (! fs::exists(tsp)) {
+        throw std::runtime_error(
+                string("Training set path '")
+                    .append(path)
+                    .append("' does not exist."));
+    }
+
+    std::ifstream infs(path);
+    auto jsonString = static_cast<std::stringstream const&>(
+            std::stringstream() << infs.rdbuf()).str();
+    trainingSet.reset(new_from_json<TrainingSet>(jsonString));
+
+    if (options.count("target-error")) {
+        trainingSet->targetError(options.at("target-error").as<double>());
+    }
+    if (options.count("max-epochs")) {
+        trainingSet->maxEpochs(options.at("max-epochs").as<size_t>());
+    }
+
+    return trainingSet;
+}
+
+
+unique_ptr<NeuralNetwork> readNeuralNetwork(string const& path)
+{
+    fs::path tsp(path);
+    unique_ptr<NeuralNetwork> neuralNetwork(nullptr);
+
+    if (! fs::exists(tsp)) {
+        throw std::runtime_error(
+                string("Neural network path '")
+                    .append(path)
+                    .append("' does not exist."));
+    }
+
+    std::ifstream infs(path);
+    auto jsonString = static_cast<std::stringstream const&>(
+            std::stringstream() << infs.rdbuf()).str();
+    neuralNetwork.reset(new_from_json<NeuralNetwork>(jsonString));
+
+    return neuralNetwork;
+}
@@ -0,0 +1,70 @@
+#ifndef WZANN_TRAININGOPTIONS_H_
+#define WZANN_TRAININGOPTIONS_H_
+
+
+#include <memory>
+#include <string>
+
+#include <boost/program_options.hpp>
+
+
+namespace wzann {
+    class TrainingSet;
+    class NeuralNetwork;
+    class TrainingAlgorithm;
+}
+
+
+/*!
+ * \brief Describes the command line options of all training algorithms
+ *
+ * The options are shared by the tools that train networks, so that
+ * `--revol-population-size` etc. mean the same everywhere.
+ *
+ * \return The options, each with the algorithm's default value
+ */
+boost::program_options::options_description trainingAlgorithmOptions();
+
+
+//! \brief Prints the names of all registered training algorithms
+void listTrainingAlgorithms();
+
+
+/*!
+ * \brief Creates a training algorithm and configures it from the
+ *  command line
+ *
+ * \param[in] name The registered name of the training algorithm
+ *
+ * \param[in] commandLineArguments The parsed #trainingAlgorithmOptions()
+ *
+ * \return The configured training algorithm
+ *
+ * \throw std::runtime_error If there is no such training algorithm
+ */
+std::unique_ptr<wzann::TrainingAlgorithm> createTrainingAlgorithm(
+        std::string const& name,
+        boost::program_options::variables_map const& commandLineArguments
+            = boost::program_options::variables_map());
+
+
+/*!
+ * \brief Reads a training set, applying the `target-error` and
+ *  `max-epochs` options
+ *
+ * \throw std::runtime_error If the file does not exist
+ */
+std::unique_ptr<wzann::TrainingSet> readTrainingSet(
+        std::string const& path,
+        boost::program_options::variables_map const& options);
+
+
+/*!
+ * \brief Reads a neural network
+ *
+ * \throw std::runtime_error If the file does not exist
+ */
+std::unique_ptr<wzann::NeuralNetwork> readNeuralNetwork(
+        std::string const& path);
+
+#endif // WZANN_TRAININGOPTIONS_H_
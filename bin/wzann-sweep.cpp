@@ -0,0 +1,394 @@
+#include <cmath>
+#include <vector>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <sstream>
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include <exception>
+#include <stdexcept>
+
+#include <boost/program_options.hpp>
+
+#include "WzannGlobal.h"
+#include "Sweep.h"
+#include "TrainingSet.h"
+#include "NeuralNetwork.h"
+#include "TrainingAlgorithm.h"
+
+#include "TrainingOptions.h"
+
+
+using std::cout;
+using std::cerr;
+using std::vector;
+using std::string;
+using std::unique_ptr;
+
+using namespace wzann;
+
+namespace po = boost::program_options;
+
+
+
+po::options_description buildCliOptions()
+{
+    po::options_description desc("Allowed options");
+
+    desc.add_options()
+        ("ann-input,i",
+                po::value<string>()->required(),
+                "The input ANN every trial trains a copy of")
+        ("training-set-input,I",
+                po::value<string>()->required(),
+                "Input training set")
+        ("verify-input,V",
+                po::value<string>(),
+                "The path of the training set used for ranking trials; "
+                    "the training set is used if not specified")
+        ("results-output,o",
+                po::value<string>()->default_value("-"),
+                "Where to write the results table to. "
+                    "Defaults to STDOUT ('-').")
+        ("target-error,e",
+                po::value<double>(),
+                "The desired training error; taken from the training set "
+                    "if not specified")
+        ("max-epochs,E",
+                po::value<wzann::TrainingAlgorithm::epoch_t>(),
+                "The maximum number of epochs of each trial; "
+                    "taken from the training set if not specified")
+        ("training-algorithm,t",
+                po::value<string>()->required(),
+                "Chooses the training algorithm whose options are swept")
+        ("list-training-algorithms,T",
+            "Lists all available training algorithms")
+        ("grid",
+                po::value<vector<string>>()->composing(),
+                "OPTION=V1,V2,...: Tries each of the values of a training "
+                    "algorithm option")
+        ("uniform",
+                po::value<vector<string>>()->composing(),
+                "OPTION=MIN:MAX: Draws the option uniformly from a range")
+        ("log-uniform",
+                po::value<vector<string>>()->composing(),
+                "OPTION=MIN:MAX: Draws the option's logarithm uniformly")
+        ("integer",
+                po::value<vector<string>>()->composing(),
+                "OPTION=MIN:MAX: Draws the option from the integers in a "
+                    "range")
+        ("set",
+                po::value<vector<string>>()->composing(),
+                "OPTION[=VALUE]: Passes a training algorithm option to "
+                    "all trials")
+        ("samples",
+                po::value<size_t>()->default_value(0),
+                "Number of random configurations; 0 tries all "
+                    "combinations of the --grid values")
+        ("seed",
+                po::value<std::uint32_t>()->default_value(0),
+                "Random seed of the configurations")
+        ("threads",
+                po::value<size_t>()->default_value(0),
+                "Number of trials trained concurrently; "
+                    "0 uses all hardware threads")
+        ("min-epochs",
+                po::value<TrainingAlgorithm::epoch_t>()->default_value(0),
+                "Number of epochs after which the first trials are pruned; "
+                    "0 trains all trials for the maximum number of epochs")
+        ("halving-rate",
+                po::value<size_t>()->default_value(
+                    Sweep().halvingRate()),
+                "Factor by which each round of successive halving reduces "
+                    "the trials and multiplies their epochs")
+        ("help,h", "Produces this help message")
+        ("version,v", "Prints \"wzann-sweep " WZANN_VERSION "\"");
+
+    return desc;
+}
+
+
+/*!
+ * \brief Splits a search space definition of the form `OPTION=VALUES`
+ *
+ * \throw std::invalid_argument If there is no `=`
+ */
+std::pair<string, string> splitDefinition(string const& definition)
+{
+    auto const i = definition.find('=');
+
+    if (string::npos == i || 0 == i) {
+        throw std::invalid_argument(
+                "Malformed search space definition '" + definition + "'");
+    }
+
+    return { definition.substr(0, i), definition.substr(i + 1) };
+}
+
+
+/*!
+ * \brief Splits a list of numbers
+ *
+ * \throw std::invalid_argument If an element is not a number
+ */
+vector<double> splitNumbers(string const& list, char separator)
+{
+    vector<double> numbers;
+    std::istringstream is(list);
+    string element;
+
+    while (std::getline(is, element, separator)) {
+        std::size_t end = 0;
+        numbers.push_back(std::stod(element, &end));
+
+        if (end != element.size()) {
+            throw std::invalid_argument("'" + element + "' is no number");
+        }
+    }
+
+    return numbers;
+}
+
+
+/*!
+ * \brief Adds the parameters given on the command line to a sweep
+ */
+void configureSweep(Sweep& sweep, po::variables_map const& vm)
+{
+    if (vm.count("grid")) {
+        for (auto const& d: vm.at("grid").as<vector<string>>()) {
+            auto const definition = splitDefinition(d);
+            sweep.values(
+                    definition.first,
+                    splitNumbers(definition.second, ','));
+        }
+    }
+
+    for (string const option: { "uniform", "log-uniform", "integer" }) {
+        if (0 == vm.count(option)) {
+            continue;
+        }
+
+        for (auto const& d: vm.at(option).as<vector<string>>()) {
+            auto const definition = splitDefinition(d);
+            auto const range = splitNumbers(definition.second, ':');
+
+            if (range.size() != 2) {
+                throw std::invalid_argument(
+                        "'" + d + "' does not give a range MIN:MAX");
+            }
+
+            if ("uniform" == option) {
+                sweep.uniform(definition.first, range[0], range[1]);
+            } else if ("log-uniform" == option) {
+                sweep.logUniform(definition.first, range[0], range[1]);
+            } else {
+                sweep.uniformInteger(
+                        definition.first,
+                        std::lround(range[0]),
+                        std::lround(range[1]));
+            }
+        }
+    }
+
+    sweep
+            .numSamples(vm.at("samples").as<size_t>())
+            .seed(vm.at("seed").as<std::uint32_t>())
+            .numThreads(vm.at("threads").as<size_t>())
+            .minEpochs(vm.at("min-epochs").as<TrainingAlgorithm::epoch_t>())
+            .halvingRate(vm.at("halving-rate").as<size_t>());
+}
+
+
+/*!
+ * \brief Writes the trials as a tab-separated table, the best first
+ */
+void writeResults(vector<Sweep::Trial> const& trials, std::ostream& os)
+{
+    vector<Sweep::Trial const*> ranking;
+
+    for (auto const& trial: trials) {
+        ranking.push_back(&trial);
+    }
+
+    // Trials that got further rank higher, then the lower error:
+
+    std::stable_sort(
+            ranking.begin(),
+            ranking.end(),
+            [](Sweep::Trial const* a, Sweep::Trial const* b) {
+                if (a->pruned != b->pruned) {
+                    return b->pruned;
+                }
+
+                if (a->budget != b->budget) {
+                    return a->budget > b->budget;
+                }
+
+                return a->score() < b->score();
+            });
+
+    os << "rank";
+
+    if (! trials.empty()) {
+        for (auto const& p: trials.front().configuration) {
+            os << "\t" << p.first;
+        }
+    }
+
+    os << "\tmax_epochs\tepochs\ttraining_error\tverification_error"
+            << "\tstatus\n";
+
+    for (std::size_t i = 0; i != ranking.size(); ++i) {
+        auto const& trial = *(ranking[i]);
+        os << (i + 1);
+
+        for (auto const& p: trial.configuration) {
+            os << "\t" << p.second;
+        }
+
+        os
+                << "\t" << trial.budget
+                << "\t" << trial.epochs
+                << "\t" << trial.trainingError
+                << "\t";
+
+        if (std::isnan(trial.verificationError)) {
+            os << "-";
+        } else {
+            os << trial.verificationError;
+        }
+
+        os << "\t" << (trial.pruned ? "pruned" : "complete") << "\n";
+    }
+}
+
+
+int main (int argc, char* argv[])
+{
+    po::variables_map vm;
+    auto desc(buildCliOptions());
+
+
+    try {
+        po::store(po::parse_command_line(argc, argv, desc), vm);
+
+        if (vm.count("help")) {
+            cout
+                    << desc << "\n"
+                    << "Training algorithm options for --grid, --uniform, "
+                        "--log-uniform, --integer and --set:\n\n"
+                    << trainingAlgorithmOptions();
+            return EXIT_SUCCESS;
+        }
+
+        if (vm.count("version")) {
+            std::cout << "wzann-sweep " << WZANN_VERSION << "\n";
+            return EXIT_SUCCESS;
+        }
+
+        if (vm.count("list-training-algorithms")) {
+            listTrainingAlgorithms();
+            return EXIT_SUCCESS;
+        }
+
+        po::notify(vm);
+    } catch (po::error const& e) {
+        cerr
+                << "ERROR: " << e.what() << ".\n"
+                << "Run \"" << argv[0]
+                << " --help\" to see all available options.\n";
+        return EXIT_FAILURE;
+    }
+
+
+    // Each trial parses its configuration like a wzann-train command line:
+
+    auto const algorithmName = vm.at("training-algorithm").as<string>();
+    auto const algorithmOptions = trainingAlgorithmOptions();
+    vector<string> fixedArguments;
+
+    if (vm.count("set")) {
+        for (auto const& option: vm.at("set").as<vector<string>>()) {
+            fixedArguments.push_back("--" + option);
+        }
+    }
+
+    auto factory = [&](Sweep::Configuration const& configuration) {
+        auto arguments = fixedArguments;
+
+        for (auto const& p: configuration) {
+            std::ostringstream argument;
+            argument.precision(12);
+            argument << "--" << p.first << "=" << p.second;
+            arguments.push_back(argument.str());
+        }
+
+        po::variables_map algorithmArguments;
+        po::store(
+                po::command_line_parser(arguments)
+                    .options(algorithmOptions)
+                    .run(),
+                algorithmArguments);
+        po::notify(algorithmArguments);
+
+        return createTrainingAlgorithm(algorithmName, algorithmArguments)
+                .release();
+    };
+
+    Sweep sweep;
+    unique_ptr<TrainingSet> trainingSet;
+    unique_ptr<TrainingSet> verificationSet;
+    unique_ptr<NeuralNetwork> neuralNetwork;
+
+    try {
+        configureSweep(sweep, vm);
+
+        // Reject unknown options before any trial runs:
+
+        for (auto const& configuration: sweep.configurations()) {
+            delete factory(configuration);
+        }
+
+        trainingSet = readTrainingSet(
+                vm.at("training-set-input").as<string>(),
+                vm);
+        neuralNetwork = readNeuralNetwork(vm.at("ann-input").as<string>());
+
+        if (vm.count("verify-input")) {
+            verificationSet = readTrainingSet(
+                    vm.at("verify-input").as<string>(),
+                    vm);
+        }
+    } catch (std::exception& e) {
+        cerr << "ERROR: " << e.what() << ".\n";
+        return EXIT_FAILURE;
+    }
+
+    vector<Sweep::Trial> trials;
+
+    try {
+        trials = sweep.run(
+                *neuralNetwork,
+                *trainingSet,
+                verificationSet.get(),
+                factory);
+    } catch (std::invalid_argument& e) {
+        cerr << "ERROR: " << e.what() << ".\n";
+        return EXIT_FAILURE;
+    }
+
+    auto const path = vm.at("results-output").as<string>();
+
+    if (path != "-") {
+        std::ofstream os(path);
+        writeResults(trials, os);
+    } else {
+        writeResults(trials, cout);
+    }
+
+    return EXIT_SUCCESS;
+}
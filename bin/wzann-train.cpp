@@ -1,21 +1,27 @@
+#include <vector>
+#include <cstdint>
 #include <cstdlib>
 #include <memory>
 #include <string>
-#include <sstream>
+#include <utility>
 #include <fstream>
 #include <iostream>
 #include <exception>
+#include <stdexcept>
 
-#include <boost/range.hpp>
-#include <boost/filesystem.hpp>
 #include <boost/program_options.hpp>
 
 #include "WzannGlobal.h"
 #include "TrainingSet.h"
-#include "ClassRegistry.h"
+#include "ParallelFor.h"
+#include "NeuralNetwork.h"
+#include "InferenceContext.h"
+#include "AveragingEnsemble.h"
+#include "SimpleWeightRandomizer.h"
 
 #include "TrainingAlgorithm.h"
-#include "REvolutionaryTrainingAlgorithm.h"
+
+#include "TrainingOptions.h"
 
 
 #define EXIT_TRAINING_FAILURE (128+1)
@@ -30,9 +36,6 @@ using std::unique_ptr;
 
 using namespace wzann;
 
-using boost::make_iterator_range;
-
-namespace fs = boost::filesystem;
 namespace po = boost::program_options;
 
 
@@ -68,44 +71,26 @@ po::options_description buildCliOptions()
                 "Chooses the appropriate training algorithm")
         ("list-training-algorithms,T",
             "Lists all available training algorithms")
-        ("revol-population-size",
-                po::value<size_t>()->default_value(30),
-                "REvol: Size of the general population")
-        ("revol-elite-size",
-                po::value<size_t>()->default_value(3),
-                "REvol: The size of the elite (contained in the population)")
-        ("revol-gradient-weight",
-                po::value<double>()->default_value(1.0),
-                "REvol: Weight of the implicit gradient information")
-        ("revol-success-weight",
-                po::value<double>()->default_value(1.0),
-                "REvol: Weight of population success rate")
-        ("revol-measurement-epochs",
-                po::value<wzalgorithm::REvol::epoch_t>()->default_value(
-                    REvolutionaryTrainingAlgorithm().measurementEpochs()),
-                "REvol: Time period of the pt1 function used for measuring "
-                    "overall population success")
-        ("revol-max-no-success-epochs",
-                po::value<wzalgorithm::REvol::epoch_t>()->default_value(
-                    std::numeric_limits<wzalgorithm::REvol::epoch_t>::max()),
-                "REvol: Maximum number of epochs without a global success")
-        ("revol-startttl",
-                po::value<std::ptrdiff_t>()->default_value(5 * 30),
-                "REvol: Initial Time To Live of a new individual")
-        ("revol-eamin",
-                po::value<double>()->default_value(
-                    REvolutionaryTrainingAlgorithm().eamin()),
-                "REvol: Absolute minimum value of a change")
-        ("revol-ebmin",
-                po::value<double>()->default_value(
-                    REvolutionaryTrainingAlgorithm().ebmin()),
-                "REvol: Relative minimum value of a change")
-        ("revol-ebmax",
-                po::value<double>()->default_value(
-                    REvolutionaryTrainingAlgorithm().ebmax()),
-                "REvol: Relative maximum value of a change")
+        ("restarts",
+                po::value<size_t>()->default_value(1),
+                "Number of randomly initialized copies of the input ANN "
+                    "to train; the best one is kept. 1 trains the input "
+                    "ANN as it is")
+        ("threads",
+                po::value<size_t>()->default_value(0),
+                "Number of restarts trained concurrently; "
+                    "0 uses all hardware threads")
+        ("seed",
+                po::value<std::uint32_t>()->default_value(
+                    SimpleWeightRandomizer::defaultSeed),
+                "Random seed of the first restart; each further restart "
+                    "adds 1")
+        ("ensemble",
+                "Outputs all restarts as one ANN that averages their "
+                    "outputs instead of the best one")
         ("help,h", "Produces this help message")
         ("version,v", "Prints \"wzann-train " WZANN_VERSION "\"");
+    desc.add(trainingAlgorithmOptions());
 
     return desc;
 }
@@ -134,154 +119,68 @@ void printHelp(
 
 
 
-void listTrainingAlgorithms()
-{
-    cout << "Available training algorithms:\n";
-    auto* cr = ClassRegistry<TrainingAlgorithm>::instance();
-    for (auto const& i : make_iterator_range(cr->registry())) {
-        cout << "  * " << i.first << "\n";
-    }
-}
-
-
-template <class T>
-void configureTrainingAlgorithm(
-        T&,
-        po::variables_map const& = po::variables_map())
-{
-}
-
-
-template <>
-void configureTrainingAlgorithm(
-        REvolutionaryTrainingAlgorithm& trainingAlgorithm,
-        boost::program_options::variables_map const& vm)
-{
-    trainingAlgorithm
-            .successWeight(vm["revol-success-weight"].as<double>())
-            .measurementEpochs(vm["revol-measurement-epochs"].as<
-                wzalgorithm::REvol::epoch_t>())
-            .gradientWeight(vm["revol-gradient-weight"].as<double>())
-            .populationSize(vm["revol-population-size"].as<size_t>())
-            .eliteSize(vm["revol-elite-size"].as<size_t>())
-            .startTTL(vm["revol-startttl"].as<std::ptrdiff_t>())
-            .eamin(vm["revol-eamin"].as<double>())
-            .ebmin(vm["revol-ebmin"].as<double>())
-            .ebmax(vm["revol-ebmax"].as<double>())
-            .maxNoSuccessEpochs(vm["revol-max-no-success-epochs"].as<
-                wzalgorithm::REvol::epoch_t>());
-}
-
-
-unique_ptr<TrainingAlgorithm> createTrainingAlgorithm(
-        string const& name,
-        po::variables_map const& commandLineArguments = po::variables_map())
+void writeNeuralNetwork(NeuralNetwork const& ann, string const& path)
 {
-    unique_ptr<TrainingAlgorithm> trainingAlgorithm(nullptr);
-    auto* cr = ClassRegistry<TrainingAlgorithm>::instance();
-
-    if (cr->isRegistered(name)) {
-        trainingAlgorithm.reset(cr->create(name));
-
-        if (name == "wzann::REvolutionaryTrainingAlgorithm") {
-            configureTrainingAlgorithm<REvolutionaryTrainingAlgorithm>(
-                    dynamic_cast<REvolutionaryTrainingAlgorithm&>(
-                        *trainingAlgorithm),
-                    commandLineArguments);
-        }
+    if (path != "-") {
+        std::ofstream(path) << to_json(ann);
     } else {
-        throw std::runtime_error("Unknown training algorithm");
-    }
-
-    return trainingAlgorithm;
-}
-
-
-unique_ptr<TrainingSet> readTrainingSet(
-        string const& path,
-        po::variables_map const& options)
-{
-    fs::path tsp(path);
-    unique_ptr<TrainingSet> trainingSet(nullptr);
-
-    if (! fs::exists(tsp)) {
-        throw std::runtime_error(
-                string("Training set path '")
-                    .append(path)
-                    .append("' does not exist."));
-    }
-
-    std::ifstream infs(path);
-    auto jsonString = static_cast<std::stringstream const&>(
-            std::stringstream() << infs.rdbuf()).str();
-    trainingSet.reset(new_from_json<TrainingSet>(jsonString));
-
-    if (options.count("target-error")) {
-        trainingSet->targetError(options.at("target-error").as<double>());
-    }
-    if (options.count("max-epochs")) {
-        trainingSet->maxEpochs(options.at("max-epochs").as<size_t>());
+        cout << to_json(ann);
     }
-
-    return trainingSet;
 }
 
 
-unique_ptr<NeuralNetwork> readNeuralNetwork(string const& path)
+void checkInputSizes(NeuralNetwork& ann, TrainingSet const& vs)
 {
-    fs::path tsp(path);
-    unique_ptr<NeuralNetwork> neuralNetwork(nullptr);
-
-    if (! fs::exists(tsp)) {
-        throw std::runtime_error(
-                string("Neural network path '")
-                    .append(path)
-                    .append("' does not exist."));
+    auto const numInputs = ann.inputLayer().size();
+
+    for (size_t i = 0; i != vs.trainingItems.size(); ++i) {
+        auto const size = vs.trainingItems[i].input().size();
+
+        if (size != numInputs) {
+            throw std::runtime_error(
+                    string("Verification set item ")
+                        .append(std::to_string(i))
+                        .append(" has ")
+                        .append(std::to_string(size))
+                        .append(" inputs, but the neural network has ")
+                        .append(std::to_string(numInputs))
+                        .append(" input neurons"));
+        }
     }
-
-    std::ifstream infs(path);
-    auto jsonString = static_cast<std::stringstream const&>(
-            std::stringstream() << infs.rdbuf()).str();
-    neuralNetwork.reset(new_from_json<NeuralNetwork>(jsonString));
-
-    return neuralNetwork;
 }
 
 
-void writeNeuralNetwork(NeuralNetwork const& ann, string const& path)
+/*!
+ * \brief Lets each training algorithm use one thread, unless the command
+ *  line sets its number of threads
+ *
+ * Restarts already run concurrently; training algorithms that use all
+ * hardware threads by default would compete with them.
+ */
+void limitTrainingAlgorithmThreads(po::variables_map& vm)
 {
-    if (path != "-") {
-        std::ofstream(path) << to_json(ann);
-    } else {
-        cout << to_json(ann);
+    string const suffix = "-threads";
+    auto const options = trainingAlgorithmOptions();
+
+    for (auto const& option: options.options()) {
+        auto const& name = option->long_name();
+
+        if (name.size() > suffix.size()
+                && 0 == name.compare(
+                    name.size() - suffix.size(),
+                    suffix.size(),
+                    suffix)
+                && vm.count(name) > 0
+                && vm[name].defaulted()) {
+            vm.at(name).value() = size_t(1);
+        }
     }
 }
 
 
-double runVerificationSet(NeuralNetwork& ann, TrainingSet const& vs)
+double runVerificationSet(NeuralNetwork const& ann, TrainingSet const& vs)
 {
-    double error = 0.0;
-    size_t numRelevantItems = 0;
-
-    for (auto const& vi : vs.trainingItems) {
-        const auto actual = ann.calculate(vi.input());
-        if (! vi.outputRelevant()) {
-            continue;
-        }
-        numRelevantItems++;
-        auto const& expected = vi.expectedOutput();
-
-        double lerror = 0.0;
-        for (auto ait = actual.begin(), eit = expected.begin();
-                ait != actual.end() && eit != expected.end();
-                ait++, eit++) {
-            lerror += std::pow(*eit - *ait, 2);
-        }
-
-        error += lerror / 2.0;
-    }
-
-    return error / static_cast<double>(numRelevantItems);
+    return TrainingAlgorithm::meanError(ann, vs, InferenceContext(ann));
 }
 
 
@@ -319,6 +218,13 @@ int main (int argc, char* argv[])
     }
 
 
+    auto const numRestarts = vm.at("restarts").as<size_t>();
+    bool const ensemble = (numRestarts > 1 && vm.count("ensemble") > 0);
+
+    if (numRestarts > 1) {
+        limitTrainingAlgorithmThreads(vm);
+    }
+
     unique_ptr<TrainingSet> trainingSet;
     unique_ptr<TrainingSet> verificationSet;
     unique_ptr<NeuralNetwork> neuralNetwork;
@@ -337,6 +243,14 @@ int main (int argc, char* argv[])
             verificationSet = readTrainingSet(
                     vm.at("verify-input").as<string>(),
                     vm);
+            checkInputSizes(*neuralNetwork, *verificationSet);
+        }
+
+        // All restarts are copies of the input ANN, so it tells whether
+        // they can be combined before any of them is trained:
+
+        if (ensemble) {
+            checkEnsembleMember(*neuralNetwork);
         }
     } catch (std::exception& e) {
         cerr << "ERROR: " << e.what() << ".\n";
@@ -344,13 +258,110 @@ int main (int argc, char* argv[])
     }
 
 
-    trainingAlgorithm->train(*neuralNetwork, *trainingSet);
-    cerr
-            << "Training ended. Final error: "
-            << trainingSet->error() << "/" << trainingSet->targetError()
-            << ", number of epochs taken: "
-            << trainingSet->epochs() << "/" << trainingSet->maxEpochs()
-            << "\n";
+    // Each restart trains a re-randomized copy of the input ANN with
+    // its own training algorithm and copy of the training set:
+
+    vector<unique_ptr<NeuralNetwork>> networks;
+    vector<unique_ptr<TrainingSet>> trainingSets;
+    vector<unique_ptr<TrainingAlgorithm>> trainingAlgorithms;
+
+    if (numRestarts > 1) {
+        auto const seed = vm.at("seed").as<std::uint32_t>();
+
+        for (size_t i = 0; i != numRestarts; ++i) {
+            networks.emplace_back(neuralNetwork->clone());
+            SimpleWeightRandomizer()
+                    .seed(seed + static_cast<std::uint32_t>(i))
+                    .randomize(*networks.back());
+            trainingSets.emplace_back(new TrainingSet(*trainingSet));
+            trainingAlgorithms.push_back(createTrainingAlgorithm(
+                    vm.at("training-algorithm").as<string>(),
+                    vm));
+        }
+    }
+
+    // Training algorithms reject networks they cannot train:
+
+    try {
+        if (networks.empty()) {
+            trainingAlgorithm->train(*neuralNetwork, *trainingSet);
+        } else {
+            parallelFor(
+                    numRestarts,
+                    vm.at("threads").as<size_t>(),
+                    [&](size_t i) {
+                        trainingAlgorithms[i]->train(
+                                *networks[i],
+                                *trainingSets[i]);
+                    });
+        }
+    } catch (std::invalid_argument& e) {
+        cerr << "ERROR: " << e.what() << ".\n";
+        return EXIT_FAILURE;
+    }
+
+    // Keep the restart with the lowest verification error, or the lowest
+    // training error without a verification set:
+
+    if (! networks.empty()) {
+        size_t best = 0;
+        vector<double> errors(numRestarts);
+
+        for (size_t i = 0; i != numRestarts; ++i) {
+            cerr
+                    << "Restart " << i << ": Final error: "
+                    << trainingSets[i]->error()
+                    << ", number of epochs taken: "
+                    << trainingSets[i]->epochs();
+
+            if (verificationSet) {
+                errors[i] = runVerificationSet(
+                        *networks[i],
+                        *verificationSet);
+                cerr << ", verification set error: " << errors[i];
+            } else {
+                errors[i] = trainingSets[i]->error();
+            }
+
+            cerr << "\n";
+
+            if (errors[i] < errors[best]) {
+                best = i;
+            }
+        }
+
+        if (ensemble) {
+            vector<NeuralNetwork const*> members;
+
+            for (auto const& network: networks) {
+                members.push_back(network.get());
+            }
+
+            neuralNetwork.reset(averagingEnsemble(members));
+        } else {
+            cerr << "Keeping restart " << best << "\n";
+            neuralNetwork = std::move(networks[best]);
+            trainingSet = std::move(trainingSets[best]);
+        }
+    }
+
+    double trainingError = trainingSet->error();
+
+    if (ensemble) {
+        trainingError = runVerificationSet(*neuralNetwork, *trainingSet);
+        cerr
+                << "Training ended. Ensemble of " << numRestarts
+                << " networks, training set error: "
+                << trainingError << "/" << trainingSet->targetError()
+                << "\n";
+    } else {
+        cerr
+                << "Training ended. Final error: "
+                << trainingSet->error() << "/" << trainingSet->targetError()
+                << ", number of epochs taken: "
+                << trainingSet->epochs() << "/" << trainingSet->maxEpochs()
+                << "\n";
+    }
 
 
     writeNeuralNetwork(*neuralNetwork, vm.at("ann-output").as<string>());
@@ -367,7 +378,7 @@ int main (int argc, char* argv[])
         if (verror > verificationSet->targetError()) {
             return EXIT_VERIFICYTION_FAILURE;
         }
-    } else if (trainingSet->error() > trainingSet->targetError()) {
+    } else if (trainingError > trainingSet->targetError()) {
         return EXIT_TRAINING_FAILURE;
     }
     return EXIT_SUCCESS;
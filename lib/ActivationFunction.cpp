@@ -1,8 +1,201 @@
 #include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <cstddef>
+#include <algorithm>
 
 #include "ActivationFunction.h"
 
 
+// Runtime dispatch to instruction set specific clones of the array
+// kernels. This requires ifunc support, hence ELF and GCC or Clang:
+
+#if defined(__x86_64__) && defined(__ELF__) && defined(__has_attribute)
+#   if __has_attribute(target_clones)
+#       define WZANN_TARGET_CLONES \
+            __attribute__((target_clones("avx512f", "avx2", "default")))
+#   endif
+#endif
+
+#ifndef WZANN_TARGET_CLONES
+#   define WZANN_TARGET_CLONES
+#endif
+
+
+namespace {
+
+
+    /*!
+     * \brief A branch-free approximation of `std::exp` that compilers
+     *  can vectorize
+     *
+     * The argument is reduced to $x = n \ln 2 + r$, $|r| \le \ln 2 / 2$;
+     * $e^r$ is approximated by its Taylor polynomial of degree 13, and
+     * $2^n$ is constructed directly in the exponent bits. The relative
+     * error is within a few ULP of `std::exp`.
+     */
+    inline double vexp(double x)
+    {
+        const double log2e = 1.4426950408889634;
+        const double ln2hi = 6.93147180369123816490e-01;
+        const double ln2lo = 1.90821492927058770002e-10;
+        const double shift = 6755399441055744.0; // 1.5 * 2^52
+        const double xmin = -708.0;
+        const double xmax = 709.0;
+
+        double xc = std::min(std::max(x, xmin), xmax);
+
+        // Round x * log2(e) to the nearest integer. The integer ends up
+        // in the lower mantissa bits of t:
+
+        double t = xc * log2e + shift;
+        double n = t - shift;
+        double r = (xc - n * ln2hi) - n * ln2lo;
+
+        double p = 1.0 / 6227020800.0;
+        p = p * r + 1.0 / 479001600.0;
+        p = p * r + 1.0 / 39916800.0;
+        p = p * r + 1.0 / 3628800.0;
+        p = p * r + 1.0 / 362880.0;
+        p = p * r + 1.0 / 40320.0;
+        p = p * r + 1.0 / 5040.0;
+        p = p * r + 1.0 / 720.0;
+        p = p * r + 1.0 / 120.0;
+        p = p * r + 1.0 / 24.0;
+        p = p * r + 1.0 / 6.0;
+        p = p * r + 0.5;
+        p = p * r + 1.0;
+        p = p * r + 1.0;
+
+        std::uint64_t bits;
+        std::memcpy(&bits, &t, sizeof(bits));
+        bits = (bits + 1023) << 52;
+
+        double scale;
+        std::memcpy(&scale, &bits, sizeof(scale));
+
+        double e = p * scale;
+        e = (x < xmin ? 0.0 : e);
+        e = (x > xmax ? HUGE_VAL : e);
+
+        return e;
+    }
+
+
+    //! \brief A vectorizable version of `std::tanh`
+    inline double vtanh(double x)
+    {
+        double ax = std::abs(x);
+
+        // Small arguments suffer from cancellation in the exponential
+        // formula; use the Taylor series there:
+
+        double x2 = x * x;
+        double s = -1382.0 / 155925.0;
+        s = s * x2 + 62.0 / 2835.0;
+        s = s * x2 - 17.0 / 315.0;
+        s = s * x2 + 2.0 / 15.0;
+        s = s * x2 - 1.0 / 3.0;
+        s = s * x2 * x + x;
+
+        double e = vexp(-2.0 * ax);
+        double l = (1.0 - e) / (1.0 + e);
+        l = (x < 0.0 ? -l : l);
+
+        return (ax < 0.0625 ? s : l);
+    }
+
+
+    WZANN_TARGET_CLONES
+    void calculateLogistic(double const* x, double* fx, std::size_t n)
+    {
+        for (std::size_t i = 0; i < n; ++i) {
+            fx[i] = 1. / (1. + vexp(-x[i]));
+        }
+    }
+
+
+    WZANN_TARGET_CLONES
+    void calculateTanh(double const* x, double* fx, std::size_t n)
+    {
+        for (std::size_t i = 0; i < n; ++i) {
+            fx[i] = vtanh(x[i]);
+        }
+    }
+
+
+    WZANN_TARGET_CLONES
+    void calculateGaussian(double const* x, double* fx, std::size_t n)
+    {
+        for (std::size_t i = 0; i < n; ++i) {
+            fx[i] = vexp(-(x[i] * x[i]));
+        }
+    }
+
+
+    WZANN_TARGET_CLONES
+    void calculateReLU(double const* x, double* fx, std::size_t n)
+    {
+        for (std::size_t i = 0; i < n; ++i) {
+            fx[i] = (x[i] + 1. < 1. ? 0. : x[i]);
+        }
+    }
+
+
+    WZANN_TARGET_CLONES
+    void calculateLogisticDerivative(
+            double const* x,
+            double* fx,
+            std::size_t n)
+    {
+        // s * (1 - s) = e / (1 + e)^2, with e = exp(-|x|), as the
+        // derivative is symmetric; this does not suffer from cancellation
+        // for large |x|:
+
+        for (std::size_t i = 0; i < n; ++i) {
+            double e = vexp(-std::abs(x[i]));
+            fx[i] = e / ((1. + e) * (1. + e));
+        }
+    }
+
+
+    WZANN_TARGET_CLONES
+    void calculateTanhDerivative(
+            double const* x,
+            double* fx,
+            std::size_t n)
+    {
+        // 1 - tanh(x)^2 = 4e / (1 + e)^2, with e = exp(-2|x|):
+
+        for (std::size_t i = 0; i < n; ++i) {
+            double e = vexp(-2. * std::abs(x[i]));
+            fx[i] = 4. * e / ((1. + e) * (1. + e));
+        }
+    }
+
+
+    WZANN_TARGET_CLONES
+    void calculateGaussianDerivative(
+            double const* x,
+            double* fx,
+            std::size_t n)
+    {
+        for (std::size_t i = 0; i < n; ++i) {
+            fx[i] = -2. * x[i] * vexp(-(x[i] * x[i]));
+        }
+    }
+
+
+    WZANN_TARGET_CLONES
+    void calculateStep(double const* x, double* fx, std::size_t n)
+    {
+        for (std::size_t i = 0; i < n; ++i) {
+            fx[i] = (x[i] + 1. < 1. ? 0. : 1.);
+        }
+    }
+} // namespace
+
+
 namespace wzann {
 
 
@@ -92,4 +285,72 @@ namespace wzann {
 
         return fx;
     }
+
+
+    void calculate(
+            ActivationFunction f,
+            double const* x,
+            double* fx,
+            std::size_t n)
+    {
+        switch (f) {
+        case ActivationFunction::Null:
+            std::fill(fx, fx + n, 0.);
+            break;
+        case ActivationFunction::Identity:
+            if (fx != x) {
+                std::copy(x, x + n, fx);
+            }
+            break;
+        case ActivationFunction::BinaryStep:
+            calculateStep(x, fx, n);
+            break;
+        case ActivationFunction::Logistic:
+            calculateLogistic(x, fx, n);
+            break;
+        case ActivationFunction::Tanh:
+            calculateTanh(x, fx, n);
+            break;
+        case ActivationFunction::ReLU:
+            calculateReLU(x, fx, n);
+            break;
+        case ActivationFunction::Gaussian:
+            calculateGaussian(x, fx, n);
+            break;
+        default:
+            throw "Unknown activation function";
+        }
+    }
+
+
+    void calculateDerivative(
+            ActivationFunction f,
+            double const* x,
+            double* fx,
+            std::size_t n)
+    {
+        switch (f) {
+        case ActivationFunction::Null:
+        case ActivationFunction::Identity:
+            std::fill(fx, fx + n, 1.);
+            break;
+        case ActivationFunction::BinaryStep:
+            std::fill(fx, fx + n, 0.);
+            break;
+        case ActivationFunction::Logistic:
+            calculateLogisticDerivative(x, fx, n);
+            break;
+        case ActivationFunction::Tanh:
+            calculateTanhDerivative(x, fx, n);
+            break;
+        case ActivationFunction::ReLU:
+            calculateStep(x, fx, n);
+            break;
+        case ActivationFunction::Gaussian:
+            calculateGaussianDerivative(x, fx, n);
+            break;
+        default:
+            throw "Unknown activation function";
+        }
+    }
 }
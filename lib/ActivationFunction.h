@@ -2,6 +2,7 @@
 #define WZANN_ACTIVATIONFUNCTION_H_
 
 
+#include <cstddef>
 #include <cstdint>
 
 #include "enum.h"
@@ -66,6 +67,57 @@ namespace wzann {
     double calculateDerivative(ActivationFunction f, double x);
 
 
+    /*!
+     * \brief Calculates $f(x)$ for a whole array of arguments
+     *
+     * The activation function is dispatched once for the whole array,
+     * and the calculation of each function is written in a way that
+     * allows the compiler to vectorize it. Where the platform supports
+     * it, specialized versions for AVX-512 and AVX2 are selected at
+     * runtime; otherwise, SSE2 is used on x86_64. Exponential functions
+     * are evaluated with a vectorizable polynomial approximation, i.e.,
+     * results may differ from the scalar ::calculate() in the last few
+     * bits.
+     *
+     * \param f The function
+     *
+     * \param x The arguments
+     *
+     * \param fx Receives $f(x)$ for each argument; may be the same
+     *  array as `x`
+     *
+     * \param n The number of elements in both arrays
+     *
+     * \sa ActivationFunction
+     */
+    void calculate(
+            ActivationFunction f,
+            double const* x,
+            double* fx,
+            std::size_t n);
+
+
+    /*!
+     * \brief Calculates $f'(x)$ for a whole array of arguments
+     *
+     * \param f The function
+     *
+     * \param x The arguments
+     *
+     * \param fx Receives $f'(x)$ for each argument; may be the same
+     *  array as `x`
+     *
+     * \param n The number of elements in both arrays
+     *
+     * \sa calculate(ActivationFunction, double const*, double*, size_t)
+     */
+    void calculateDerivative(
+            ActivationFunction f,
+            double const* x,
+            double* fx,
+            std::size_t n);
+
+
     template <>
     inline libvariant::Variant to_variant(ActivationFunction const& af)
     {
@@ -0,0 +1,45 @@
+#include <cmath>
+
+#include "ClassRegistry.h"
+
+#include "AdaGradTrainingAlgorithm.h"
+
+
+namespace wzann {
+    const double AdaGradTrainingAlgorithm::DEFAULT_LEARNING_RATE = 0.01;
+
+
+    AdaGradTrainingAlgorithm::AdaGradTrainingAlgorithm():
+            AdaptiveGradientTrainingAlgorithm(DEFAULT_LEARNING_RATE)
+    {
+    }
+
+
+    void AdaGradTrainingAlgorithm::reset(Vector::size_type numWeights)
+    {
+        m_sumSquares.assign(numWeights, 0.0);
+    }
+
+
+    void AdaGradTrainingAlgorithm::update(
+            Vector& weights,
+            Vector const& gradient,
+            std::vector<char> const&)
+    {
+        auto const rate = learningRate();
+        auto const eps = epsilon();
+
+        for (Vector::size_type i = 0; i != weights.size(); ++i) {
+            auto const g = gradient[i];
+            auto& s = m_sumSquares[i];
+
+            s += g * g;
+            weights[i] -= rate * g / (std::sqrt(s) + eps);
+        }
+    }
+} // namespace wzann
+
+
+WZANN_REGISTER_CLASS(
+        wzann::AdaGradTrainingAlgorithm,
+        wzann::TrainingAlgorithm)
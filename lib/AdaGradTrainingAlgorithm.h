@@ -0,0 +1,54 @@
+#ifndef WZANN_ADAGRADTRAININGALGORITHM_H_
+#define WZANN_ADAGRADTRAININGALGORITHM_H_
+
+
+#include <vector>
+
+#include "Vector.h"
+#include "AdaptiveGradientTrainingAlgorithm.h"
+
+
+namespace wzann {
+
+
+    /*!
+     * \brief Trains a neural network using AdaGrad
+     *
+     * AdaGrad divides the gradient of each weight by the root of the sum
+     * of all its squared gradients so far. Steps shrink over the course of
+     * the training, fastest for the weights that have received large
+     * gradients.
+     */
+    class AdaGradTrainingAlgorithm : public AdaptiveGradientTrainingAlgorithm
+    {
+    public:
+
+
+        static const double DEFAULT_LEARNING_RATE;
+
+
+        //! \brief Creates a new training algorithm instance
+        AdaGradTrainingAlgorithm();
+
+
+    protected:
+
+
+        virtual void reset(Vector::size_type numWeights) override;
+
+
+        virtual void update(
+                Vector& weights,
+                Vector const& gradient,
+                std::vector<char> const& fixedWeights) override;
+
+
+    private:
+
+
+        //! \brief The sum of the squared gradients of each weight
+        Vector m_sumSquares;
+    };
+} // namespace wzann
+
+#endif // WZANN_ADAGRADTRAININGALGORITHM_H_
@@ -0,0 +1,91 @@
+#include <cmath>
+
+#include "ClassRegistry.h"
+
+#include "AdamTrainingAlgorithm.h"
+
+
+namespace wzann {
+    const double AdamTrainingAlgorithm::DEFAULT_LEARNING_RATE = 0.001;
+    const double AdamTrainingAlgorithm::DEFAULT_BETA1 = 0.9;
+    const double AdamTrainingAlgorithm::DEFAULT_BETA2 = 0.999;
+
+
+    AdamTrainingAlgorithm::AdamTrainingAlgorithm():
+            AdaptiveGradientTrainingAlgorithm(DEFAULT_LEARNING_RATE),
+            m_beta1(DEFAULT_BETA1),
+            m_beta2(DEFAULT_BETA2),
+            m_step(0)
+    {
+    }
+
+
+    double AdamTrainingAlgorithm::beta1() const
+    {
+        return m_beta1;
+    }
+
+
+    AdamTrainingAlgorithm& AdamTrainingAlgorithm::beta1(double beta1)
+    {
+        m_beta1 = beta1;
+        return *this;
+    }
+
+
+    double AdamTrainingAlgorithm::beta2() const
+    {
+        return m_beta2;
+    }
+
+
+    AdamTrainingAlgorithm& AdamTrainingAlgorithm::beta2(double beta2)
+    {
+        m_beta2 = beta2;
+        return *this;
+    }
+
+
+    void AdamTrainingAlgorithm::reset(Vector::size_type numWeights)
+    {
+        m_step = 0;
+        m_firstMoments.assign(numWeights, 0.0);
+        m_secondMoments.assign(numWeights, 0.0);
+    }
+
+
+    void AdamTrainingAlgorithm::update(
+            Vector& weights,
+            Vector const& gradient,
+            std::vector<char> const&)
+    {
+        ++m_step;
+
+        // Instead of correcting the bias of each moment, the learning rate
+        // absorbs both corrections:
+
+        auto const b1 = m_beta1;
+        auto const b2 = m_beta2;
+        auto const t = static_cast<double>(m_step);
+        auto const correction1 = 1.0 - std::pow(b1, t);
+        auto const correction2 = 1.0 - std::pow(b2, t);
+        auto const rate = learningRate();
+        auto const stepSize = rate * std::sqrt(correction2) / correction1;
+        auto const eps = epsilon() * std::sqrt(correction2);
+
+        for (Vector::size_type i = 0; i != weights.size(); ++i) {
+            auto const g = gradient[i];
+            auto& m = m_firstMoments[i];
+            auto& v = m_secondMoments[i];
+
+            m = b1 * m + (1.0 - b1) * g;
+            v = b2 * v + (1.0 - b2) * g * g;
+            weights[i] -= stepSize * m / (std::sqrt(v) + eps);
+        }
+    }
+} // namespace wzann
+
+
+WZANN_REGISTER_CLASS(
+        wzann::AdamTrainingAlgorithm,
+        wzann::TrainingAlgorithm)
@@ -0,0 +1,110 @@
+#ifndef WZANN_ADAMTRAININGALGORITHM_H_
+#define WZANN_ADAMTRAININGALGORITHM_H_
+
+
+#include <vector>
+#include <cstddef>
+
+#include "Vector.h"
+#include "AdaptiveGradientTrainingAlgorithm.h"
+
+
+namespace wzann {
+
+
+    /*!
+     * \brief Trains a neural network using Adam (adaptive moment
+     *  estimation)
+     *
+     * Adam keeps exponentially decaying averages of the gradient and of
+     * its square for each weight. Both are corrected for their bias
+     * towards zero in the first steps. The step of a weight is the
+     * learning rate times the first moment divided by the square root of
+     * the second moment, which makes the step size roughly independent of
+     * the gradient's magnitude.
+     *
+     * \sa AdamWTrainingAlgorithm
+     */
+    class AdamTrainingAlgorithm : public AdaptiveGradientTrainingAlgorithm
+    {
+    public:
+
+
+        static const double DEFAULT_LEARNING_RATE;
+
+
+        static const double DEFAULT_BETA1;
+
+
+        static const double DEFAULT_BETA2;
+
+
+        //! \brief Creates a new training algorithm instance
+        AdamTrainingAlgorithm();
+
+
+        //! \return The decay rate of the first moment estimates
+        double beta1() const;
+
+
+        /*!
+         * \brief Sets the decay rate of the first moment estimates
+         *
+         * \param[in] beta1 The new rate, in `[0, 1)`
+         *
+         * \return `*this`
+         */
+        AdamTrainingAlgorithm& beta1(double beta1);
+
+
+        //! \return The decay rate of the second moment estimates
+        double beta2() const;
+
+
+        /*!
+         * \brief Sets the decay rate of the second moment estimates
+         *
+         * \param[in] beta2 The new rate, in `[0, 1)`
+         *
+         * \return `*this`
+         */
+        AdamTrainingAlgorithm& beta2(double beta2);
+
+
+    protected:
+
+
+        virtual void reset(Vector::size_type numWeights) override;
+
+
+        virtual void update(
+                Vector& weights,
+                Vector const& gradient,
+                std::vector<char> const& fixedWeights) override;
+
+
+    private:
+
+
+        //! \brief The decay rate of the first moment estimates
+        double m_beta1;
+
+
+        //! \brief The decay rate of the second moment estimates
+        double m_beta2;
+
+
+        //! \brief The number of steps since the start of the training
+        std::size_t m_step;
+
+
+        //! \brief The first moment estimate of each weight's gradient
+        Vector m_firstMoments;
+
+
+        //! \brief The second moment estimate of each weight's gradient
+        Vector m_secondMoments;
+    };
+} // namespace wzann
+
+#endif // WZANN_ADAMTRAININGALGORITHM_H_
@@ -0,0 +1,54 @@
+#include "ClassRegistry.h"
+
+#include "AdamWTrainingAlgorithm.h"
+
+
+namespace wzann {
+    const double AdamWTrainingAlgorithm::DEFAULT_WEIGHT_DECAY = 0.01;
+
+
+    AdamWTrainingAlgorithm::AdamWTrainingAlgorithm():
+            AdamTrainingAlgorithm(),
+            m_weightDecay(DEFAULT_WEIGHT_DECAY)
+    {
+    }
+
+
+    double AdamWTrainingAlgorithm::weightDecay() const
+    {
+        return m_weightDecay;
+    }
+
+
+    AdamWTrainingAlgorithm& AdamWTrainingAlgorithm::weightDecay(
+            double weightDecay)
+    {
+        m_weightDecay = weightDecay;
+        return *this;
+    }
+
+
+    void AdamWTrainingAlgorithm::update(
+            Vector& weights,
+            Vector const& gradient,
+            std::vector<char> const& fixedWeights)
+    {
+        // The decay is decoupled from the gradient, so that it is not
+        // scaled by the moment estimates. Fixed weights stay unchanged:
+
+        auto const shrink = learningRate() * m_weightDecay;
+
+        for (Vector::size_type i = 0; i != weights.size(); ++i) {
+            if (! fixedWeights[i]) {
+                weights[i] -= shrink * weights[i];
+            }
+        }
+
+        AdamTrainingAlgorithm::update(weights, gradient, fixedWeights);
+    }
+} // namespace wzann
+
+
+WZANN_REGISTER_CLASS(
+        wzann::AdamWTrainingAlgorithm,
+        wzann::TrainingAlgorithm)
@@ -0,0 +1,72 @@
+#ifndef WZANN_ADAMWTRAININGALGORITHM_H_
+#define WZANN_ADAMWTRAININGALGORITHM_H_
+
+
+#include <vector>
+
+#include "Vector.h"
+#include "AdamTrainingAlgorithm.h"
+
+
+namespace wzann {
+
+
+    /*!
+     * \brief Trains a neural network using Adam with decoupled weight
+     *  decay
+     *
+     * In addition to Adam's step, each step shrinks every trainable weight
+     * by the learning rate times the weight decay factor. Unlike an L2
+     * penalty added to the error, this decay is not scaled by the moment
+     * estimates, so that all weights are regularized alike.
+     *
+     * \sa AdamTrainingAlgorithm
+     */
+    class AdamWTrainingAlgorithm : public AdamTrainingAlgorithm
+    {
+    public:
+
+
+        static const double DEFAULT_WEIGHT_DECAY;
+
+
+        //! \brief Creates a new training algorithm instance
+        AdamWTrainingAlgorithm();
+
+
+        //! \return The weight decay factor
+        double weightDecay() const;
+
+
+        /*!
+         * \brief Sets the weight decay factor
+         *
+         * \param[in] weightDecay The fraction of each weight that is
+         *  subtracted per step, times the learning rate
+         *
+         * \return `*this`
+         */
+        AdamWTrainingAlgorithm& weightDecay(double weightDecay);
+
+
+    protected:
+
+
+        virtual void update(
+                Vector& weights,
+                Vector const& gradient,
+                std::vector<char> const& fixedWeights) override;
+
+
+    private:
+
+
+        /*!
+         * \brief The fraction of each weight that is subtracted per step,
+         *  times the learning rate
+         */
+        double m_weightDecay;
+    };
+} // namespace wzann
+
+#endif // WZANN_ADAMWTRAININGALGORITHM_H_
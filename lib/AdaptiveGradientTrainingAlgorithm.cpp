@@ -0,0 +1,57 @@
+#include <cstddef>
+
+#include "AdaptiveGradientTrainingAlgorithm.h"
+
+
+namespace wzann {
+    AdaptiveGradientTrainingAlgorithm::AdaptiveGradientTrainingAlgorithm(
+            double learningRate):
+                MiniBatchTrainingAlgorithm(),
+                m_learningRate(learningRate),
+                m_batchSize(DEFAULT_BATCH_SIZE),
+                m_epsilon(DEFAULT_EPSILON)
+    {
+    }
+
+
+    double AdaptiveGradientTrainingAlgorithm::learningRate() const
+    {
+        return m_learningRate;
+    }
+
+
+    AdaptiveGradientTrainingAlgorithm&
+    AdaptiveGradientTrainingAlgorithm::learningRate(double rate)
+    {
+        m_learningRate = rate;
+        return *this;
+    }
+
+
+    std::size_t AdaptiveGradientTrainingAlgorithm::batchSize() const
+    {
+        return m_batchSize;
+    }
+
+
+    AdaptiveGradientTrainingAlgorithm&
+    AdaptiveGradientTrainingAlgorithm::batchSize(std::size_t batchSize)
+    {
+        m_batchSize = batchSize;
+        return *this;
+    }
+
+
+    double AdaptiveGradientTrainingAlgorithm::epsilon() const
+    {
+        return m_epsilon;
+    }
+
+
+    AdaptiveGradientTrainingAlgorithm&
+    AdaptiveGradientTrainingAlgorithm::epsilon(double epsilon)
+    {
+        m_epsilon = epsilon;
+        return *this;
+    }
+} // namespace wzann
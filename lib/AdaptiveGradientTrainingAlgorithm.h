@@ -0,0 +1,117 @@
+#ifndef WZANN_ADAPTIVEGRADIENTTRAININGALGORITHM_H_
+#define WZANN_ADAPTIVEGRADIENTTRAININGALGORITHM_H_
+
+
+#include <cstddef>
+
+#include "MiniBatchTrainingAlgorithm.h"
+
+
+namespace wzann {
+    /*!
+     * \brief Base class of the first-order training algorithms that adapt
+     *  the step size of each weight individually
+     *
+     * The mean gradient of each batch is handed to #update(), which
+     * derived classes implement. They keep their per-weight state, e.g.,
+     * moment estimates, in flat arrays in the order of
+     * NeuralNetwork::weights(), so that an update is one linear pass over
+     * the weights.
+     *
+     * Fixed weights have a gradient of zero. Their state remains zero, and
+     * so does their step.
+     *
+     * \sa AdamTrainingAlgorithm
+     *
+     * \sa AdamWTrainingAlgorithm
+     *
+     * \sa RMSPropTrainingAlgorithm
+     *
+     * \sa AdaGradTrainingAlgorithm
+     */
+    class AdaptiveGradientTrainingAlgorithm :
+            public MiniBatchTrainingAlgorithm
+    {
+    public:
+
+
+        const std::size_t DEFAULT_BATCH_SIZE = 32;
+
+
+        const double DEFAULT_EPSILON = 1e-8;
+
+
+        //! \return The learning rate, i.e., the maximum step size
+        double learningRate() const;
+
+
+        /*!
+         * \brief Sets the learning rate
+         *
+         * \param[in] rate The new rate
+         *
+         * \return `*this`
+         */
+        AdaptiveGradientTrainingAlgorithm& learningRate(double rate);
+
+
+        //! \return The number of training items per weight update
+        virtual std::size_t batchSize() const override;
+
+
+        /*!
+         * \brief Sets the number of training items whose gradients are
+         *  accumulated before the weights are updated
+         *
+         * \param[in] batchSize The batch size: `1` for online learning,
+         *  `0` for using the whole training set as one batch
+         *
+         * \return `*this`
+         */
+        AdaptiveGradientTrainingAlgorithm& batchSize(std::size_t batchSize);
+
+
+        //! \return The term that keeps the denominator of a step nonzero
+        double epsilon() const;
+
+
+        /*!
+         * \brief Sets the term that is added to the denominator of each
+         *  step for numerical stability
+         *
+         * \param[in] epsilon A small positive number
+         *
+         * \return `*this`
+         */
+        AdaptiveGradientTrainingAlgorithm& epsilon(double epsilon);
+
+
+    protected:
+
+
+        /*!
+         * \brief Initializes the common parameters
+         *
+         * \param[in] learningRate The default learning rate of the
+         *  algorithm
+         */
+        explicit AdaptiveGradientTrainingAlgorithm(double learningRate);
+
+
+    private:
+
+
+        //! \brief The learning rate
+        double m_learningRate;
+
+
+        //! \brief The number of items per weight update; 0 for all items
+        std::size_t m_batchSize;
+
+
+        //! \brief The term that keeps the denominator of a step nonzero
+        double m_epsilon;
+    };
+} // namespace wzann
+
+#endif // WZANN_ADAPTIVEGRADIENTTRAININGALGORITHM_H_
@@ -0,0 +1,171 @@
+#include <vector>
+#include <cstddef>
+#include <stdexcept>
+
+#include <boost/range.hpp>
+
+#include "Layer.h"
+#include "Neuron.h"
+#include "Connection.h"
+#include "NeuralNetwork.h"
+#include "ActivationFunction.h"
+#include "PerceptronNetworkPattern.h"
+
+#include "AveragingEnsemble.h"
+
+
+using boost::make_iterator_range;
+
+
+namespace wzann {
+    namespace {
+        //! \brief Index of the layer a neuron belongs to, or the size
+        NeuralNetwork::size_type layerIndex(
+                NeuralNetwork const& network,
+                Neuron const& neuron)
+        {
+            NeuralNetwork::size_type i = 0;
+
+            while (i != network.size() && ! network[i].contains(neuron)) {
+                ++i;
+            }
+
+            return i;
+        }
+    } // namespace
+
+
+    void checkEnsembleMember(NeuralNetwork const& network)
+    {
+        auto const numLayers = network.size();
+
+        if (numLayers < 2) {
+            throw std::invalid_argument(
+                    "Ensemble members need at least two layers");
+        }
+
+        for (auto const* c: make_iterator_range(network.connections())) {
+            auto const to = layerIndex(network, c->destination());
+
+            if (&(c->source()) == &(network.biasNeuron())
+                    ? (0 == to || numLayers == to)
+                    : layerIndex(network, c->source()) + 1 != to) {
+                throw std::invalid_argument(
+                        "Only layered feed-forward networks can be "
+                            "combined into an ensemble");
+            }
+        }
+    }
+
+
+    NeuralNetwork* averagingEnsemble(
+            std::vector<NeuralNetwork const*> const& members)
+    {
+        typedef NeuralNetwork::size_type size_type;
+
+        if (members.empty()) {
+            throw std::invalid_argument("An ensemble needs members");
+        }
+
+        for (auto const* member: members) {
+            checkEnsembleMember(*member);
+        }
+
+        auto const& first = *(members.front());
+        auto const numLayers = first.size();
+
+        // Each member's neurons start at an offset in the ensemble's
+        // layers, except in the shared input layer:
+
+        std::vector<std::vector<size_type>> offsets(
+                members.size(),
+                std::vector<size_type>(numLayers, 0));
+        std::vector<size_type> sizes(numLayers, 0);
+        sizes[0] = first[0].size();
+
+        for (std::size_t k = 0; k != members.size(); ++k) {
+            auto const& member = *(members[k]);
+
+            if (member.size() != numLayers
+                    || member[0].size() != first[0].size()
+                    || member[numLayers-1].size()
+                        != first[numLayers-1].size()) {
+                throw std::invalid_argument(
+                        "Ensemble members differ in their number of "
+                            "layers, inputs or outputs");
+            }
+
+            for (size_type l = 1; l != numLayers; ++l) {
+                offsets[k][l] = sizes[l];
+                sizes[l] += member[l].size();
+            }
+        }
+
+        PerceptronNetworkPattern pattern;
+
+        for (size_type l = 0; l != numLayers; ++l) {
+            pattern.addLayer({ sizes[l], first[l][0].activationFunction() });
+        }
+
+        pattern.addLayer({
+                first[numLayers-1].size(),
+                ActivationFunction::Identity });
+
+        auto* ensemble = new NeuralNetwork();
+        ensemble->configure(pattern);
+
+        for (auto* c: make_iterator_range(ensemble->connections())) {
+            c->weight(0.0).fixedWeight(true);
+        }
+
+        // Copy the members' neurons and connections:
+
+        auto ensembleNeuron = [&](
+                std::size_t k,
+                NeuralNetwork const& member,
+                Neuron const& neuron) -> Neuron const& {
+            if (&neuron == &(member.biasNeuron())) {
+                return ensemble->biasNeuron();
+            }
+
+            auto const l = layerIndex(member, neuron);
+            return (*ensemble)[l][offsets[k][l] + member[l].indexOf(neuron)];
+        };
+
+        for (std::size_t k = 0; k != members.size(); ++k) {
+            auto const& member = *(members[k]);
+
+            for (size_type l = (0 == k ? 0 : 1); l != numLayers; ++l) {
+                for (size_type i = 0; i != member[l].size(); ++i) {
+                    (*ensemble)[l][offsets[k][l] + i].activationFunction(
+                            member[l][i].activationFunction());
+                }
+            }
+
+            for (auto const* c: make_iterator_range(member.connections())) {
+                ensemble->connection(
+                        ensembleNeuron(k, member, c->source()),
+                        ensembleNeuron(k, member, c->destination()))
+                    ->fixedWeight(false)
+                    .weight(c->weight())
+                    .fixedWeight(c->fixedWeight());
+            }
+
+            // Average the outputs:
+
+            auto const& outputs = (*ensemble)[numLayers-1];
+            auto const& mean = (*ensemble)[numLayers];
+
+            for (size_type i = 0; i != mean.size(); ++i) {
+                ensemble->connection(
+                        outputs[offsets[k][numLayers-1] + i],
+                        mean[i])
+                    ->fixedWeight(false)
+                    .weight(1.0 / static_cast<double>(members.size()))
+                    .fixedWeight(true);
+            }
+        }
+
+        return ensemble;
+    }
+} // namespace wzann
@@ -0,0 +1,62 @@
+#ifndef WZANN_AVERAGINGENSEMBLE_H_
+#define WZANN_AVERAGINGENSEMBLE_H_
+
+
+#include <vector>
+
+
+namespace wzann {
+    class NeuralNetwork;
+
+
+    /*!
+     * \brief Checks whether a network can be a member of an
+     *  averagingEnsemble()
+     *
+     * The network needs at least two layers, and all its connections
+     * must lead either from the bias neuron or from one layer to the
+     * next. Members must further agree in their number of layers, inputs
+     * and outputs, which copies of one network do. Tools that train the
+     * members first can thus reject a network before the training.
+     *
+     * \param[in] network The network
+     *
+     * \throw std::invalid_argument If the network cannot be a member
+     */
+    void checkEnsembleMember(NeuralNetwork const& network);
+
+
+    /*!
+     * \brief Combines several networks into one network that outputs the
+     *  mean of their outputs
+     *
+     * The members share the input layer. Each further layer of the
+     * ensemble holds the corresponding layers of all members side by
+     * side, with the members' weights; an additional output layer with
+     * the identity activation function averages the members' outputs.
+     * All other connections of the ensemble have a fixed weight of `0.0`,
+     * as do the averaging connections of `1 / members.size()`. The
+     * ensemble therefore calculates exactly the mean of the members'
+     * outputs, but keeps a weight for each pair of neurons in adjacent
+     * layers, which is meant for a few small networks.
+     *
+     * The ensemble uses the PerceptronNetworkPattern. Hence, all members
+     * must be layered feed-forward networks, i.e., all their connections
+     * lead either from the bias neuron or from one layer to the next.
+     * Their hidden layers may differ in size.
+     *
+     * \param[in] members The networks to combine; they must have the same
+     *  number of layers, inputs and outputs
+     *
+     * \return A new network that the caller owns
+     *
+     * \throw std::invalid_argument If there are no members or if they
+     *  cannot be combined
+     *
+     * \sa checkEnsembleMember()
+     */
+    NeuralNetwork* averagingEnsemble(
+            std::vector<NeuralNetwork const*> const& members);
+} // namespace wzann
+
+#endif // WZANN_AVERAGINGENSEMBLE_H_
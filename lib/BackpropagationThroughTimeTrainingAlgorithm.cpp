@@ -0,0 +1,372 @@
+#include <limits>
+#include <cstddef>
+#include <stdexcept>
+#include <algorithm>
+
+#include <boost/range.hpp>
+
+#include "Layer.h"
+#include "Neuron.h"
+#include "TrainingSet.h"
+#include "TrainingItem.h"
+#include "ClassRegistry.h"
+#include "NeuralNetwork.h"
+#include "InferencePlan.h"
+#include "InferenceContext.h"
+#include "ActivationFunction.h"
+#include "ElmanNetworkPattern.h"
+#include "GradientAnalysisHelper.h"
+
+#include "BackpropagationThroughTimeTrainingAlgorithm.h"
+
+
+using boost::make_iterator_range;
+
+
+namespace wzann {
+    BackpropagationThroughTimeTrainingAlgorithm::
+            BackpropagationThroughTimeTrainingAlgorithm():
+                TrainingAlgorithm(),
+                m_learningRate(DEFAULT_LEARNING_RATE),
+                m_window(DEFAULT_WINDOW),
+                m_stride(DEFAULT_STRIDE)
+    {
+    }
+
+
+    double BackpropagationThroughTimeTrainingAlgorithm::learningRate() const
+    {
+        return m_learningRate;
+    }
+
+
+    BackpropagationThroughTimeTrainingAlgorithm&
+    BackpropagationThroughTimeTrainingAlgorithm::learningRate(double rate)
+    {
+        m_learningRate = rate;
+        return *this;
+    }
+
+
+    BackpropagationThroughTimeTrainingAlgorithm::size_type
+    BackpropagationThroughTimeTrainingAlgorithm::window() const
+    {
+        return m_window;
+    }
+
+
+    BackpropagationThroughTimeTrainingAlgorithm&
+    BackpropagationThroughTimeTrainingAlgorithm::window(size_type window)
+    {
+        m_window = window;
+        return *this;
+    }
+
+
+    BackpropagationThroughTimeTrainingAlgorithm::size_type
+    BackpropagationThroughTimeTrainingAlgorithm::stride() const
+    {
+        return m_stride;
+    }
+
+
+    BackpropagationThroughTimeTrainingAlgorithm&
+    BackpropagationThroughTimeTrainingAlgorithm::stride(size_type stride)
+    {
+        m_stride = stride;
+        return *this;
+    }
+
+
+    void BackpropagationThroughTimeTrainingAlgorithm::train(
+            NeuralNetwork& ann,
+            TrainingSet& trainingSet)
+    {
+        typedef ElmanNetworkPattern Elman;
+
+        auto const& plan = ann.compile();
+
+        if (plan.size() != Elman::OUTPUT + 1
+                || nullptr == plan.transition(Elman::CONTEXT, Elman::HIDDEN)
+                || plan.layerSize(Elman::CONTEXT)
+                    != plan.layerSize(Elman::HIDDEN)) {
+            throw std::invalid_argument(
+                    "Backpropagation through time requires an Elman "
+                    "network");
+        }
+
+        // Allocate the ring buffers and the gradients:
+
+        auto const window = std::max<size_type>(1, m_window);
+        auto const stride = (0 == m_stride || m_stride > window
+                ? window
+                : m_stride);
+
+        m_inputs.resize(plan.size());
+        m_results.resize(plan.size());
+        m_deltas.resize(plan.size());
+        m_biasGradients.resize(plan.size());
+
+        for (size_type i = 0; i != plan.size(); ++i) {
+            m_inputs[i].assign(window * plan.layerSize(i), 0.0);
+            m_results[i].assign(window * plan.layerSize(i), 0.0);
+            m_deltas[i].assign(plan.layerSize(i), 0.0);
+            m_biasGradients[i].assign(plan.layerSize(i), 0.0);
+        }
+
+        auto const outputSize = plan.layerSize(Elman::OUTPUT);
+        m_errors.assign(window * outputSize, 0.0);
+        m_relevant.assign(window, 0);
+        m_carry.assign(plan.layerSize(Elman::HIDDEN), 0.0);
+        m_transitionGradients.resize(plan.transitions().size());
+
+        // Each epoch runs through the sequence from the same state:
+
+        InferenceContext const initialContext(ann);
+        InferenceContext context;
+        Vector output;
+
+        size_t epochs = 0;
+        double error = std::numeric_limits<double>::max();
+        auto const& items = trainingSet.trainingItems;
+
+        for(; epochs < trainingSet.maxEpochs()
+                    && error > trainingSet.targetError();
+                ++epochs) {
+            error = 0.0;
+            size_t numRelevantItems = 0;
+            size_type step = 0;
+            size_type pending = 0;
+            context = initialContext;
+
+            for (auto const& item: items) {
+                auto const slot = step % window;
+
+                // The context layer's input is the state the hidden layer
+                // receives; it must be saved before it is overwritten:
+
+                auto const& state = context.layerInputs(Elman::CONTEXT);
+                std::copy(
+                        state.begin(),
+                        state.end(),
+                        m_inputs[Elman::CONTEXT].begin()
+                            + slot * state.size());
+
+                ann.calculate(item.input(), output, context);
+
+                for (size_type i = 0; i != plan.size(); ++i) {
+                    auto const offset = slot * plan.layerSize(i);
+                    auto const& results = context.layerOutputs(i);
+
+                    if (i != Elman::CONTEXT) {
+                        auto const& inputs = context.layerInputs(i);
+                        std::copy(
+                                inputs.begin(),
+                                inputs.end(),
+                                m_inputs[i].begin() + offset);
+                    }
+
+                    std::copy(
+                            results.begin(),
+                            results.end(),
+                            m_results[i].begin() + offset);
+                }
+
+                auto* errors = m_errors.data() + slot * outputSize;
+                std::fill(errors, errors + outputSize, 0.0);
+                m_relevant[slot] = item.outputRelevant();
+
+                if (item.outputRelevant()) {
+                    auto const expected = item.expectedOutput();
+                    error += GradientAnalysisHelper::errors(
+                            make_iterator_range(
+                                output.cbegin(),
+                                output.cend()),
+                            make_iterator_range(
+                                expected.cbegin(),
+                                expected.cend()),
+                            errors);
+                    ++numRelevantItems;
+                }
+
+                ++step;
+
+                if (++pending == stride) {
+                    update(ann, step, pending);
+                    pending = 0;
+                }
+            }
+
+            if (0 != pending) {
+                update(ann, step, pending);
+            }
+
+            // It's called MEAN square error for a reason:
+
+            error /= numRelevantItems;
+        }
+
+        // Store final training results:
+
+        setFinalError(trainingSet, error);
+        setFinalNumEpochs(trainingSet, epochs);
+    }
+
+
+    void BackpropagationThroughTimeTrainingAlgorithm::update(
+            NeuralNetwork& ann,
+            size_type numSteps,
+            size_type numInjected)
+    {
+        typedef ElmanNetworkPattern Elman;
+
+        auto const& plan = ann.compile();
+        auto const& transitions = plan.transitions();
+        auto const window = m_relevant.size();
+        auto const unrolled = std::min(numSteps, window);
+        auto const biasOutput = ann.biasOutput();
+        size_type numItems = 0;
+
+        for (size_type i = 0; i != transitions.size(); ++i) {
+            auto const& t = transitions[i];
+            m_transitionGradients[i].assign(t.rows * t.columns, 0.0);
+        }
+
+        for (auto& g: m_biasGradients) {
+            std::fill(g.begin(), g.end(), 0.0);
+        }
+
+        std::fill(m_carry.begin(), m_carry.end(), 0.0);
+
+        // Go back in time, starting with the latest step:
+
+        for (size_type s = 0; s != unrolled; ++s) {
+            auto const slot = (numSteps - 1 - s) % window;
+            auto const injected = (s < numInjected && m_relevant[slot]);
+
+            if (injected) {
+                ++numItems;
+            }
+
+            for (size_type l: { Elman::OUTPUT, Elman::HIDDEN }) {
+                auto& deltas = m_deltas[l];
+                auto const size = deltas.size();
+                auto const& layer = ann[l];
+                double const* inputs = m_inputs[l].data() + slot * size;
+
+                if (Elman::OUTPUT == l) {
+                    double const* errors = m_errors.data() + slot * size;
+
+                    for (size_type i = 0; i != size; ++i) {
+                        deltas[i] = (injected ? errors[i] : 0.0);
+                    }
+                } else {
+                    std::copy(m_carry.begin(), m_carry.end(), deltas.begin());
+
+                    for (auto const& t: transitions) {
+                        if (t.from != l || t.to <= l) {
+                            continue;
+                        }
+
+                        auto const& next = m_deltas[t.to];
+
+                        for (size_type r = 0; r != t.rows; ++r) {
+                            double const* w =
+                                    t.weights.data() + r * t.columns;
+
+                            for (size_type c = 0; c != t.columns; ++c) {
+                                deltas[c] += w[c] * next[r];
+                            }
+                        }
+                    }
+                }
+
+                for (size_type i = 0; i != size; ++i) {
+                    deltas[i] *= calculateDerivative(
+                            layer[i].activationFunction(),
+                            inputs[i]);
+                }
+
+                auto& biasGradients = m_biasGradients[l];
+
+                for (size_type i = 0; i != size; ++i) {
+                    biasGradients[i] += deltas[i] * biasOutput;
+                }
+            }
+
+            // The weights of all steps are shared, so their gradients add
+            // up. Connections from the context layer carry the state the
+            // hidden layer had one step earlier:
+
+            for (size_type i = 0; i != transitions.size(); ++i) {
+                auto const& t = transitions[i];
+
+                if (t.to != Elman::HIDDEN && t.to != Elman::OUTPUT) {
+                    continue;
+                }
+
+                auto const& deltas = m_deltas[t.to];
+                double const* sources = (Elman::CONTEXT == t.from
+                        ? m_inputs[t.from].data()
+                        : m_results[t.from].data()) + slot * t.columns;
+                double* g = m_transitionGradients[i].data();
+
+                for (size_type r = 0; r != t.rows; ++r) {
+                    for (size_type c = 0; c != t.columns; ++c) {
+                        g[r * t.columns + c] += deltas[r] * sources[c];
+                    }
+                }
+            }
+
+            // Hand the hidden layer's error to the step before:
+
+            auto const* recurrent = plan.transition(
+                    Elman::CONTEXT,
+                    Elman::HIDDEN);
+            auto const& hiddenDeltas = m_deltas[Elman::HIDDEN];
+            std::fill(m_carry.begin(), m_carry.end(), 0.0);
+
+            for (size_type r = 0; r != recurrent->rows; ++r) {
+                double const* w =
+                        recurrent->weights.data() + r * recurrent->columns;
+
+                for (size_type c = 0; c != recurrent->columns; ++c) {
+                    m_carry[c] += w[c] * hiddenDeltas[r];
+                }
+            }
+        }
+
+        if (0 == numItems) {
+            return;
+        }
+
+        // Apply the mean gradient. Fixed weights stay unchanged, as do
+        // connections from the bias neuron that are not part of the
+        // calculation:
+
+        auto const& fixed = ann.fixedWeights();
+        auto const rate = m_learningRate / static_cast<double>(numItems);
+        m_weights = ann.weights();
+
+        for (auto const& slot: plan.slots()) {
+            if (! fixed[slot.weight]) {
+                m_weights[slot.weight] -= rate
+                        * m_transitionGradients[slot.transition][slot.offset];
+            }
+        }
+
+        for (auto const& slot: plan.biasSlots()) {
+            if (! fixed[slot.weight] && plan.isBiasEntry(slot)) {
+                m_weights[slot.weight] -= rate
+                        * m_biasGradients[slot.layer][slot.neuron];
+            }
+        }
+
+        ann.swapWeights(m_weights);
+    }
+} // namespace wzann
+
+
+WZANN_REGISTER_CLASS(
+        wzann::BackpropagationThroughTimeTrainingAlgorithm,
+        wzann::TrainingAlgorithm)
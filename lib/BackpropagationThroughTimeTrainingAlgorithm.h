@@ -0,0 +1,200 @@
+#ifndef WZANN_BACKPROPAGATIONTHROUGHTIMETRAININGALGORITHM_H_
+#define WZANN_BACKPROPAGATIONTHROUGHTIMETRAININGALGORITHM_H_
+
+
+#include <vector>
+#include <cstddef>
+
+#include "Vector.h"
+#include "TrainingAlgorithm.h"
+
+
+namespace wzann {
+    class TrainingSet;
+    class NeuralNetwork;
+
+
+    /*!
+     * \brief Trains Elman networks with truncated backpropagation through
+     *  time
+     *
+     * The items of the training set are treated as one sequence, starting
+     * from the state the network's context layer has when the training
+     * begins. The network is unrolled over the last #window() time steps:
+     * The inputs and results of all layers at each of these steps are
+     * kept in ring buffers that are allocated once per training.
+     *
+     * Every #stride() steps, the output errors of these latest steps are
+     * propagated backwards through the unrolled network. The error of the
+     * hidden layer at one step also flows into the hidden layer of the
+     * step before, via the connections from the context layer, whose
+     * weights are shared by all steps. The gradients of all steps are
+     * summed up, averaged over the items whose errors were injected, and
+     * applied to the weights, scaled by the learning rate.
+     *
+     * The state of the network's neurons is not modified by the training.
+     *
+     * \sa ElmanNetworkPattern
+     */
+    class BackpropagationThroughTimeTrainingAlgorithm :
+            public TrainingAlgorithm
+    {
+    public:
+
+
+        typedef std::size_t size_type;
+
+
+        const double DEFAULT_LEARNING_RATE = 0.1;
+
+
+        const size_type DEFAULT_WINDOW = 8;
+
+
+        const size_type DEFAULT_STRIDE = 4;
+
+
+        //! \brief Creates a new training algorithm instance
+        BackpropagationThroughTimeTrainingAlgorithm();
+
+
+        //! \return The learning rate applied to each weight change
+        double learningRate() const;
+
+
+        /*!
+         * \brief Sets the learning rate
+         *
+         * \param[in] rate The new rate
+         *
+         * \return `*this`
+         */
+        BackpropagationThroughTimeTrainingAlgorithm& learningRate(
+                double rate);
+
+
+        //! \return The number of time steps the errors are propagated back
+        size_type window() const;
+
+
+        /*!
+         * \brief Sets the number of time steps the network is unrolled
+         *  over
+         *
+         * \param[in] window The number of time steps, at least `1`
+         *
+         * \return `*this`
+         */
+        BackpropagationThroughTimeTrainingAlgorithm& window(
+                size_type window);
+
+
+        //! \return The number of time steps between weight updates
+        size_type stride() const;
+
+
+        /*!
+         * \brief Sets the number of time steps between two weight updates
+         *
+         * The errors of these steps are injected at each update. A stride
+         * smaller than the window lets the errors of the oldest injected
+         * step flow further back in time.
+         *
+         * \param[in] stride The number of time steps; `0` and values
+         *  larger than the #window() select the window
+         *
+         * \return `*this`
+         */
+        BackpropagationThroughTimeTrainingAlgorithm& stride(
+                size_type stride);
+
+
+        /*!
+         * \brief Trains the neural network with the given trainingSet.
+         *
+         * \param[in] trainingSet A sequence of sample inputs and expected
+         *  outputs.
+         *
+         * \throw std::invalid_argument If the network is not laid out
+         *  like an Elman network
+         */
+        virtual void train(NeuralNetwork& ann, TrainingSet& trainingSet)
+                override;
+
+
+    private:
+
+
+        /*!
+         * \brief Propagates the errors of the latest time steps back and
+         *  applies the resulting gradient
+         *
+         * \param[inout] ann The network
+         *
+         * \param[in] numSteps The number of time steps so far
+         *
+         * \param[in] numInjected The number of latest steps whose errors
+         *  are injected
+         */
+        void update(
+                NeuralNetwork& ann,
+                size_type numSteps,
+                size_type numInjected);
+
+
+        //! \brief The learning rate applied to each weight change
+        double m_learningRate;
+
+
+        //! \brief The number of time steps the network is unrolled over
+        size_type m_window;
+
+
+        //! \brief The number of time steps between weight updates
+        size_type m_stride;
+
+
+        /*!
+         * \brief The inputs of each layer, one row per time step of the
+         *  window; for the context layer, the state it had before the step
+         */
+        std::vector<Vector> m_inputs;
+
+
+        //! \brief The results of each layer, one row per time step
+        std::vector<Vector> m_results;
+
+
+        //! \brief The output errors, one row per time step
+        Vector m_errors;
+
+
+        //! \brief Whether the output of each time step is relevant
+        std::vector<char> m_relevant;
+
+
+        //! \brief The deltas of each layer at the current time step
+        std::vector<Vector> m_deltas;
+
+
+        /*!
+         * \brief The error the hidden layer receives from the next time
+         *  step through the context layer
+         */
+        Vector m_carry;
+
+
+        //! \brief The gradient of each transition's weight matrix
+        std::vector<Vector> m_transitionGradients;
+
+
+        //! \brief The gradient of each layer's bias vector
+        std::vector<Vector> m_biasGradients;
+
+
+        //! \brief The network's weights, updated in place
+        Vector m_weights;
+    };
+} // namespace wzann
+
+#endif // WZANN_BACKPROPAGATIONTHROUGHTIMETRAININGALGORITHM_H_
@@ -1,33 +1,19 @@
-#include <cmath>
-#include <limits>
-#include <numeric>
+#include <vector>
+#include <cstddef>
 
-#include <boost/range.hpp>
-#include <boost/range/adaptor/reversed.hpp>
-
-#include "Layer.h"
-#include "Neuron.h"
 #include "Vector.h"
-#include "Connection.h"
-#include "TrainingSet.h"
-#include "NeuralNetwork.h"
-#include "ActivationFunction.h"
-#include "GradientAnalysisHelper.h"
+#include "ClassRegistry.h"
 
 #include "BackpropagationTrainingAlgorithm.h"
 
 
-using std::pow;
-using std::accumulate;
-
-using boost::adaptors::reverse;
-using boost::make_iterator_range;
-
-
 namespace wzann {
     BackpropagationTrainingAlgorithm::BackpropagationTrainingAlgorithm() :
-            TrainingAlgorithm(),
-            m_learningRate(DEFAULT_LEARNING_RATE)
+            MiniBatchTrainingAlgorithm(),
+            m_learningRate(DEFAULT_LEARNING_RATE),
+            m_batchSize(DEFAULT_BATCH_SIZE),
+            m_momentum(DEFAULT_MOMENTUM),
+            m_nesterov(false)
     {
     }
 
@@ -46,73 +32,73 @@ namespace wzann {
     }
 
 
-    void BackpropagationTrainingAlgorithm::train(
-            NeuralNetwork& ann,
-            TrainingSet& trainingSet)
+    std::size_t BackpropagationTrainingAlgorithm::batchSize() const
     {
-        // Initialize the state variables:
-
-        size_t epochs = 0;
-        double error = std::numeric_limits<double>::max();
-
-        for(; epochs < trainingSet.maxEpochs()
-                    && error > trainingSet.targetError();
-                ++epochs) {
-            error = 0.0;
-            size_t numRelevantItems = 0;
-
-            for (auto const& ti: trainingSet.trainingItems) {
-                GradientAnalysisHelper::NeuronDeltaMap neuronDeltas;
-                ConnectionDeltaMap connectionDeltas;
-
-                // First step: Feed forward and compare the network's
-                // output with the ideal teaching output:
-
-                const Vector actualOutput = ann.calculate(ti.input());
-                if (! ti.outputRelevant()) {
-                    continue;
-                }
-
-                numRelevantItems++;
-                Vector errorOutput;
-                errorOutput.reserve(actualOutput.size());
-                error += GradientAnalysisHelper::errors(
-                        make_iterator_range(actualOutput),
-                        make_iterator_range(ti.expectedOutput()),
-                        std::back_inserter(errorOutput));
-
-                // Propagate the error backwards:
-
-                for (auto* c: reverse(ann.connections())) {
-                    connectionDeltas[c] =
-                            GradientAnalysisHelper::neuronDelta(
-                                ann,
-                                c->destination(),
-                                neuronDeltas,
-                                errorOutput);
-                }
-
-                // Apply calculated delta values:
-
-                for (auto& cd: connectionDeltas) {
-                    auto* connection = cd.first;
-                    auto delta = cd.second;
-
-                    connection->weight(connection->weight()
-                            - (learningRate() * delta
-                               * connection->source().lastResult()));
-                }
-            }
-
-            // It's called MEAN square error for a reason:
-
-            error /= numRelevantItems;
-        }
+        return m_batchSize;
+    }
+
+
+    BackpropagationTrainingAlgorithm&
+    BackpropagationTrainingAlgorithm::batchSize(std::size_t batchSize)
+    {
+        m_batchSize = batchSize;
+        return *this;
+    }
+
+
+    double BackpropagationTrainingAlgorithm::momentum() const
+    {
+        return m_momentum;
+    }
+
+
+    BackpropagationTrainingAlgorithm&
+    BackpropagationTrainingAlgorithm::momentum(double momentum)
+    {
+        m_momentum = momentum;
+        return *this;
+    }
+
+
+    bool BackpropagationTrainingAlgorithm::nesterov() const
+    {
+        return m_nesterov;
+    }
 
-        // Store final training results:
 
-        setFinalError(trainingSet, error);
-        setFinalNumEpochs(trainingSet, epochs);
+    BackpropagationTrainingAlgorithm&
+    BackpropagationTrainingAlgorithm::nesterov(bool nesterov)
+    {
+        m_nesterov = nesterov;
+        return *this;
+    }
+
+
+    void BackpropagationTrainingAlgorithm::reset(
+            Vector::size_type numWeights)
+    {
+        m_velocity.assign(numWeights, 0.0);
+    }
+
+
+    void BackpropagationTrainingAlgorithm::update(
+            Vector& weights,
+            Vector const& gradient,
+            std::vector<char> const&)
+    {
+        for (Vector::size_type i = 0; i != weights.size(); ++i) {
+            auto const previous = m_velocity[i];
+            m_velocity[i] = momentum() * previous
+                    - learningRate() * gradient[i];
+
+            // Nesterov's accelerated gradient, reformulated so that the
+            // weights are always the look-ahead point:
+
+            weights[i] += (nesterov()
+                    ? (1.0 + momentum()) * m_velocity[i]
+                        - momentum() * previous
+                    : m_velocity[i]);
+        }
     }
 } // namespace wzann
 
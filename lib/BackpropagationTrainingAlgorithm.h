@@ -3,10 +3,10 @@
 
 
 #include <cmath>
-#include <unordered_map>
+#include <cstddef>
 
 #include "NeuralNetwork.h"
-#include "TrainingAlgorithm.h"
+#include "MiniBatchTrainingAlgorithm.h"
 
 
 namespace wzann {
@@ -15,18 +15,37 @@ namespace wzann {
     class NeuralNetwork;
 
 
-    class BackpropagationTrainingAlgorithm : public TrainingAlgorithm
+    /*!
+     * \brief The backpropagation of error training algorithm
+     *
+     * The gradient is calculated for a batch of training items and
+     * applied once per batch. The batch size ranges from one item
+     * (online learning, the default) over mini-batches of several items
+     * to the whole training set (batch learning). The gradient of a
+     * batch is averaged over its items.
+     *
+     * Optionally, weight changes carry momentum: Each change adds the
+     * previous change, scaled by the momentum factor, which smoothes the
+     * descent and speeds it up in flat regions of the error surface.
+     * With Nesterov's accelerated gradient, the gradient is effectively
+     * evaluated at the point the momentum is about to move the weights
+     * to.
+     */
+    class BackpropagationTrainingAlgorithm :
+            public MiniBatchTrainingAlgorithm
     {
     public:
 
-        typedef std::unordered_map<
-                Connection*,
-                double> ConnectionDeltaMap;
-
 
         const double DEFAULT_LEARNING_RATE = 0.7;
 
 
+        const std::size_t DEFAULT_BATCH_SIZE = 1;
+
+
+        const double DEFAULT_MOMENTUM = 0.0;
+
+
         /*!
          * Constructs a new instance of the Backpropagation training
          * algorithm.
@@ -58,20 +77,87 @@ namespace wzann {
         BackpropagationTrainingAlgorithm& learningRate(double rate);
 
 
+        //! \return The number of training items per weight update
+        virtual std::size_t batchSize() const override;
+
+
+        /*!
+         * \brief Sets the number of training items whose gradients are
+         *  accumulated before the weights are updated
+         *
+         * \param[in] batchSize The batch size: `1` for online learning,
+         *  `0` for using the whole training set as one batch
+         *
+         * \return `*this`
+         */
+        BackpropagationTrainingAlgorithm& batchSize(std::size_t batchSize);
+
+
+        //! \return The momentum factor
+        double momentum() const;
+
+
+        /*!
+         * \brief Sets the momentum factor, i.e., the fraction of the
+         *  previous weight change that is added to the current one
+         *
+         * \param[in] momentum The momentum factor, usually in `[0, 1)`;
+         *  `0.0` disables momentum
+         *
+         * \return `*this`
+         */
+        BackpropagationTrainingAlgorithm& momentum(double momentum);
+
+
+        //! \return Whether Nesterov's accelerated gradient is used
+        bool nesterov() const;
+
+
         /*!
-         * \brief Trains the neural network with the given trainingSet.
+         * \brief Chooses between classical momentum and Nesterov's
+         *  accelerated gradient
+         *
+         * Has no effect unless a momentum factor is set.
+         *
+         * \param[in] nesterov `true` for Nesterov's accelerated gradient
          *
-         * \param[in] trainingSet A set of sample inputs and expected
-         *  outputs.
+         * \return `*this`
          */
-        virtual void train(NeuralNetwork& ann, TrainingSet& trainingSet)
-                override;
+        BackpropagationTrainingAlgorithm& nesterov(bool nesterov);
+
+
+    protected:
+
+
+        virtual void reset(Vector::size_type numWeights) override;
+
+
+        virtual void update(
+                Vector& weights,
+                Vector const& gradient,
+                std::vector<char> const& fixedWeights) override;
 
 
     private:
 
         //! \brief The learning rate applied to each weight change
         double m_learningRate;
+
+
+        //! \brief The number of items per weight update; 0 for all items
+        std::size_t m_batchSize;
+
+
+        //! \brief The momentum factor
+        double m_momentum;
+
+
+        //! \brief Whether Nesterov's accelerated gradient is used
+        bool m_nesterov;
+
+
+        //! \brief The last change of each weight
+        Vector m_velocity;
     };
 } // namespace wzann
 
@@ -1,4 +1,7 @@
+#include "Layer.h"
 #include "Neuron.h"
+#include "NeuralNetwork.h"
+#include "ConnectionStore.h"
 #include "WeightFixedException.h"
 
 #include "Connection.h"
@@ -6,11 +9,12 @@
 
 namespace wzann {
     Connection::Connection(
+            ConnectionStore& store,
+            std::size_t position,
             Neuron& source,
-            Neuron& destination,
-            double weight):
-                m_weight(weight),
-                m_fixed(false),
+            Neuron& destination):
+                m_store(&store),
+                m_position(position),
                 m_sourceNeuron(&source),
                 m_destinationNeuron(&destination)
     {
@@ -19,16 +23,30 @@ namespace wzann {
 
     double Connection::weight() const
     {
-        return m_weight;
+        return m_store->m_weights[m_position];
     }
 
 
     Connection& Connection::weight(double weight)
     {
-        if (m_fixed) {
+        if (fixedWeight()) {
             throw WeightFixedException();
         } else {
-            m_weight = weight;
+            m_store->m_weights[m_position] = weight;
+
+            // The network this connection is part of is notified, so that
+            // it can keep its InferencePlan up to date:
+
+            auto* layer = destination().parent();
+            auto* network = (nullptr == layer ? nullptr : layer->parent());
+
+            if (nullptr != network) {
+                if (&source() == &(network->biasNeuron())) {
+                    network->m_plan.updateBias(*this);
+                } else {
+                    network->m_plan.invalidateWeights();
+                }
+            }
         }
 
         return *this;
@@ -37,17 +55,23 @@ namespace wzann {
 
     bool Connection::fixedWeight() const
     {
-        return m_fixed;
+        return (0 != m_store->m_fixedWeights[m_position]);
     }
 
 
     Connection& Connection::fixedWeight(bool fixed)
     {
-        m_fixed = fixed;
+        m_store->m_fixedWeights[m_position] = fixed;
         return *this;
     }
 
 
+    std::size_t Connection::position() const
+    {
+        return m_position;
+    }
+
+
     Neuron& Connection::source()
     {
         return *m_sourceNeuron;
@@ -88,7 +112,7 @@ namespace wzann {
 
     double Connection::operator *(double rhs) const
     {
-        return m_weight * rhs;
+        return weight() * rhs;
     }
 
 
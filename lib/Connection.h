@@ -2,9 +2,12 @@
 #define WZANN_CONNECTION_H_
 
 
+#include <cstddef>
+
+
 namespace wzann {
     class Neuron;
-    class NeuralNetwork;
+    class ConnectionStore;
 
 
     /*!
@@ -21,6 +24,10 @@ namespace wzann {
      * layouts, fixed connections exist. As such, every connection object
      * has a boolean switch to make the weight fixed.
      *
+     * The weight and the switch are not stored in the connection object
+     * itself, but in the ConnectionStore that owns it, which keeps the
+     * weights of all connections of a network in one contiguous vector.
+     *
      * Connection objects are created by ::NeuralNetwork objects through
      * their connect/disconnect methods; it is never created by an user
      * directly.
@@ -72,6 +79,15 @@ namespace wzann {
         Connection& fixedWeight(bool fixed);
 
 
+        /*!
+         * \brief Returns the position of this connection's weight in
+         *  the weight vector of its network
+         *
+         * \sa NeuralNetwork::weights()
+         */
+        std::size_t position() const;
+
+
         //! \brief The source neuron
         Neuron& source();
 
@@ -129,16 +145,26 @@ namespace wzann {
 
 
         friend class NeuralNetwork;
+        friend class ConnectionStore;
 
 
 
         /*!
          * \brief Creates a new connection
+         *
+         * \param[in] store The store that holds the connection's weight
+         *
+         * \param[in] position The position of the weight in the store
+         *
+         * \param[in] source The source neuron
+         *
+         * \param[in] destination The destination neuron
          */
         Connection(
+                ConnectionStore& store,
+                std::size_t position,
                 Neuron &source,
-                Neuron &destination,
-                double weight = 0.0);
+                Neuron &destination);
 
 
 
@@ -160,16 +186,14 @@ namespace wzann {
 
 
         /*!
-         * \brief The weight that is attached to this connection
+         * \brief The store that holds the weight of this connection and
+         *  whether it is fixed
          */
-        double m_weight;
+        ConnectionStore* m_store;
 
 
-        /*!
-         * \brief Whether the weight value of this connection is fixed
-         *  (i.e., cannot be trained) or may be changed.
-         */
-        bool m_fixed;
+        //! \brief The position of this connection's weight in #m_store
+        std::size_t m_position;
 
 
         /*!
@@ -0,0 +1,325 @@
+#include <new>
+#include <mutex>
+#include <memory>
+#include <vector>
+#include <cassert>
+#include <cstddef>
+#include <algorithm>
+
+#include "Neuron.h"
+#include "Connection.h"
+
+#include "ConnectionStore.h"
+
+
+namespace wzann {
+    const ConnectionStore::size_type ConnectionStore::MIN_BLOCK_SIZE;
+    const ConnectionStore::size_type ConnectionStore::MAX_BLOCK_SIZE;
+
+
+    void ConnectionStore::Adjacency::build(
+            ConnectionPtrVector const& connections,
+            std::vector<NeuronIndex> const& neurons,
+            size_type numNeurons)
+    {
+        // Counting sort: First, count the connections of each neuron,
+        // then place them at their final position:
+
+        offsets.assign(numNeurons + 1, 0);
+
+        for (auto n: neurons) {
+            ++offsets[n + 1];
+        }
+
+        for (size_type i = 1; i != offsets.size(); ++i) {
+            offsets[i] += offsets[i-1];
+        }
+
+        std::vector<size_type> positions(offsets.begin(), offsets.end() - 1);
+        entries.resize(connections.size());
+
+        for (size_type i = 0; i != connections.size(); ++i) {
+            entries[positions[neurons[i]]++] = connections[i];
+        }
+    }
+
+
+    void ConnectionStore::Adjacency::remove(
+            NeuronIndex neuron,
+            Connection* connection)
+    {
+        auto begin = entries.begin() + offsets[neuron];
+        auto end = entries.begin() + offsets[neuron + 1];
+        auto it = std::find(begin, end, connection);
+
+        assert(it != end);
+        entries.erase(it);
+
+        for (size_type i = neuron + 1; i != offsets.size(); ++i) {
+            --offsets[i];
+        }
+    }
+
+
+    ConnectionStore::ConnectionStore():
+            m_blockSize(0),
+            m_blockUsed(0),
+            m_indexed(true)
+    {
+    }
+
+
+    ConnectionStore::~ConnectionStore()
+    {
+        for (auto* c: m_connections) {
+            c->~Connection();
+        }
+    }
+
+
+    void* ConnectionStore::allocate()
+    {
+        if (! m_freeSlots.empty()) {
+            auto* slot = m_freeSlots.back();
+            m_freeSlots.pop_back();
+            return slot;
+        }
+
+        if (m_blockUsed == m_blockSize) {
+            m_blockSize = (0 == m_blockSize
+                    ? MIN_BLOCK_SIZE
+                    : std::min(2 * m_blockSize, MAX_BLOCK_SIZE));
+            m_blocks.emplace_back(new char[m_blockSize * sizeof(Connection)]);
+            m_blockUsed = 0;
+        }
+
+        return m_blocks.back().get() + sizeof(Connection) * m_blockUsed++;
+    }
+
+
+    ConnectionStore::NeuronIndex ConnectionStore::addNeuron(
+            Neuron const& neuron)
+    {
+        auto it = m_neuronIndexes.find(&neuron);
+
+        if (m_neuronIndexes.end() != it) {
+            return it->second;
+        }
+
+        auto index = static_cast<NeuronIndex>(m_neuronIndexes.size());
+        m_neuronIndexes.emplace(&neuron, index);
+        return index;
+    }
+
+
+    void ConnectionStore::index() const
+    {
+        if (m_indexed.load(std::memory_order_acquire)) {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(m_indexMutex);
+
+        if (m_indexed.load(std::memory_order_relaxed)) {
+            return;
+        }
+
+        m_sources.build(
+                m_connections,
+                m_sourceIndexes,
+                m_neuronIndexes.size());
+        m_destinations.build(
+                m_connections,
+                m_destinationIndexes,
+                m_neuronIndexes.size());
+        m_indexed.store(true, std::memory_order_release);
+    }
+
+
+    std::pair<ConnectionStore::size_type, ConnectionStore::size_type>
+    ConnectionStore::range(Adjacency const& adjacency, Neuron const& neuron)
+            const
+    {
+        auto it = m_neuronIndexes.find(&neuron);
+
+        if (m_neuronIndexes.end() == it) {
+            return std::make_pair(0, 0);
+        }
+
+        return std::make_pair(
+                adjacency.offsets[it->second],
+                adjacency.offsets[it->second + 1]);
+    }
+
+
+    Connection* ConnectionStore::create(Neuron& source, Neuron& destination)
+    {
+        auto* connection = new (allocate()) Connection(
+                *this,
+                size(),
+                source,
+                destination);
+
+        m_connections.push_back(connection);
+        m_weights.push_back(0.0);
+        m_fixedWeights.push_back(false);
+        m_sourceIndexes.push_back(addNeuron(source));
+        m_destinationIndexes.push_back(addNeuron(destination));
+        m_indexed.store(false, std::memory_order_release);
+
+        return connection;
+    }
+
+
+    void ConnectionStore::destroy(Connection* connection)
+    {
+        auto position = connection->m_position;
+        assert(position < size() && connection == m_connections[position]);
+
+        if (m_indexed.load(std::memory_order_acquire)) {
+            m_sources.remove(m_sourceIndexes[position], connection);
+            m_destinations.remove(
+                    m_destinationIndexes[position],
+                    connection);
+        }
+
+        m_connections.erase(m_connections.begin() + position);
+        m_weights.erase(m_weights.begin() + position);
+        m_fixedWeights.erase(m_fixedWeights.begin() + position);
+        m_sourceIndexes.erase(m_sourceIndexes.begin() + position);
+        m_destinationIndexes.erase(
+                m_destinationIndexes.begin() + position);
+
+        for (auto i = position; i != size(); ++i) {
+            m_connections[i]->m_position = i;
+        }
+
+        connection->~Connection();
+        m_freeSlots.push_back(connection);
+    }
+
+
+    void ConnectionStore::assign(
+            ConnectionStore const& other,
+            std::function<Neuron&(Neuron const&)> const& mapNeuron)
+    {
+        assert(0 == size() && m_neuronIndexes.empty());
+
+        // Neurons keep their index, so that the index vectors of the
+        // other store remain valid as they are:
+
+        std::vector<Neuron*> neurons(other.m_neuronIndexes.size());
+        m_neuronIndexes.reserve(neurons.size());
+
+        for (auto const& i: other.m_neuronIndexes) {
+            neurons[i.second] = &(mapNeuron(*(i.first)));
+            m_neuronIndexes.emplace(neurons[i.second], i.second);
+        }
+
+        m_weights = other.m_weights;
+        m_fixedWeights = other.m_fixedWeights;
+        m_sourceIndexes = other.m_sourceIndexes;
+        m_destinationIndexes = other.m_destinationIndexes;
+
+        if (0 == other.size()) {
+            return;
+        }
+
+        m_blockSize = std::max(other.size(), MIN_BLOCK_SIZE);
+        m_blockUsed = 0;
+        m_blocks.emplace_back(new char[m_blockSize * sizeof(Connection)]);
+
+        m_connections.reserve(other.size());
+        for (size_type i = 0; i != other.size(); ++i) {
+            m_connections.push_back(new (allocate()) Connection(
+                    *this,
+                    i,
+                    *(neurons[m_sourceIndexes[i]]),
+                    *(neurons[m_destinationIndexes[i]])));
+        }
+
+        m_indexed.store(false, std::memory_order_release);
+    }
+
+
+    ConnectionStore::size_type ConnectionStore::size() const
+    {
+        return m_connections.size();
+    }
+
+
+    Vector const& ConnectionStore::weights() const
+    {
+        return m_weights;
+    }
+
+
+    Vector& ConnectionStore::weights()
+    {
+        return m_weights;
+    }
+
+
+    std::vector<char> const& ConnectionStore::fixedWeights() const
+    {
+        return m_fixedWeights;
+    }
+
+
+    ConnectionStore::ConnectionPtrRange ConnectionStore::all()
+    {
+        return std::make_pair(m_connections.begin(), m_connections.end());
+    }
+
+
+    ConnectionStore::ConnectionPtrConstRange ConnectionStore::all() const
+    {
+        return std::make_pair(m_connections.cbegin(), m_connections.cend());
+    }
+
+
+    ConnectionStore::ConnectionPtrRange ConnectionStore::from(
+            Neuron const& neuron)
+    {
+        index();
+        auto r = range(m_sources, neuron);
+        return std::make_pair(
+                m_sources.entries.begin() + r.first,
+                m_sources.entries.begin() + r.second);
+    }
+
+
+    ConnectionStore::ConnectionPtrConstRange ConnectionStore::from(
+            Neuron const& neuron)
+            const
+    {
+        index();
+        auto r = range(m_sources, neuron);
+        return std::make_pair(
+                m_sources.entries.cbegin() + r.first,
+                m_sources.entries.cbegin() + r.second);
+    }
+
+
+    ConnectionStore::ConnectionPtrRange ConnectionStore::to(
+            Neuron const& neuron)
+    {
+        index();
+        auto r = range(m_destinations, neuron);
+        return std::make_pair(
+                m_destinations.entries.begin() + r.first,
+                m_destinations.entries.begin() + r.second);
+    }
+
+
+    ConnectionStore::ConnectionPtrConstRange ConnectionStore::to(
+            Neuron const& neuron)
+            const
+    {
+        index();
+        auto r = range(m_destinations, neuron);
+        return std::make_pair(
+                m_destinations.entries.cbegin() + r.first,
+                m_destinations.entries.cbegin() + r.second);
+    }
+} // namespace wzann
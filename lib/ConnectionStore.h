@@ -0,0 +1,334 @@
+#ifndef WZANN_CONNECTIONSTORE_H_
+#define WZANN_CONNECTIONSTORE_H_
+
+
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <functional>
+#include <unordered_map>
+
+#include "Vector.h"
+
+
+namespace wzann {
+    class Neuron;
+    class Connection;
+
+
+    /*!
+     * \brief Owns all Connection objects of a NeuralNetwork and indexes
+     *  them by source and destination neuron
+     *
+     * Connections are not allocated one by one. Instead, they are placed
+     * in an arena of contiguous blocks, whose sizes grow geometrically.
+     * Slots of removed connections are reused by new ones. Destroying
+     * the store frees a handful of blocks instead of every single
+     * connection.
+     *
+     * The connections originating from or leading to a neuron are kept
+     * in compressed sparse row (CSR) form: One vector holds the pointers
+     * to all connections, sorted by neuron, and an offset vector marks
+     * where the connections of each neuron begin. Thus, the connections
+     * of a neuron can be returned as a range of plain vector iterators.
+     *
+     * The weights of all connections are kept in one contiguous vector,
+     * in the order of the connections' creation, together with a mask
+     * that marks fixed weights. Optimizers can thus read and write all
+     * weights of a network at once, without going through the
+     * individual Connection objects.
+     *
+     * Neurons are identified by a dense index, which they receive when
+     * they take part in their first connection. Each connection records
+     * the indexes of its neurons, so that no hash lookups are necessary
+     * in order to build the index.
+     *
+     * Creating connections only marks the index as outdated. It is
+     * rebuilt in linear time by the next query, so that building a
+     * network connection by connection costs amortized constant time per
+     * connection. Removing a connection updates the index in place.
+     * Rebuilding is serialized, which means that the const query methods
+     * can be used by several threads concurrently.
+     *
+     * Adding or removing a connection invalidates all ranges that were
+     * obtained from the store before.
+     *
+     * \sa NeuralNetwork::connectNeurons()
+     */
+    class ConnectionStore
+    {
+        friend class Connection;
+
+
+    public:
+
+
+        typedef std::size_t size_type;
+
+        typedef std::vector<Connection*> ConnectionPtrVector;
+        typedef ConnectionPtrVector::iterator ConnectionPtrIterator;
+        typedef ConnectionPtrVector::const_iterator
+                ConnectionPtrConstIterator;
+        typedef std::pair<
+                ConnectionPtrIterator,
+                ConnectionPtrIterator> ConnectionPtrRange;
+        typedef std::pair<
+                ConnectionPtrConstIterator,
+                ConnectionPtrConstIterator> ConnectionPtrConstRange;
+
+
+        //! \brief Creates an empty store
+        ConnectionStore();
+
+
+        ConnectionStore(ConnectionStore const&) = delete;
+        ConnectionStore& operator =(ConnectionStore const&) = delete;
+
+
+        //! \brief Destroys all connections
+        ~ConnectionStore();
+
+
+        /*!
+         * \brief Creates a new connection between two neurons
+         *
+         * \param[in] source The neuron the connection originates from
+         *
+         * \param[in] destination The neuron the connection leads to
+         *
+         * \return The new connection, which has a weight of 0.0
+         */
+        Connection* create(Neuron& source, Neuron& destination);
+
+
+        /*!
+         * \brief Removes a connection from all indexes and destroys it
+         *
+         * \param[in] connection The connection, which must have been
+         *  created by this store
+         */
+        void destroy(Connection* connection);
+
+
+        /*!
+         * \brief Fills this empty store with copies of all connections
+         *  of another store
+         *
+         * The copies keep the weights, the fixed flags and the order of
+         * the original connections, but connect the neurons that
+         * `mapNeuron` returns for the original's neurons. Each distinct
+         * neuron is mapped exactly once, and all copies are placed in a
+         * single block of the arena, so that copying takes linear time.
+         *
+         * \param[in] other The store to copy
+         *
+         * \param[in] mapNeuron Maps a neuron of the other store to the
+         *  neuron that replaces it in this store
+         */
+        void assign(
+                ConnectionStore const& other,
+                std::function<Neuron&(Neuron const&)> const& mapNeuron);
+
+
+        //! \brief The number of connections in the store
+        size_type size() const;
+
+
+        /*!
+         * \brief The weights of all connections, in the order of their
+         *  creation
+         *
+         * \sa #all()
+         */
+        Vector const& weights() const;
+
+
+        /*!
+         * \brief Grants write access to the weights of all connections
+         *
+         * The vector must not be resized. Fixed weights are not
+         * protected; callers must leave them unchanged.
+         *
+         * \sa #fixedWeights()
+         */
+        Vector& weights();
+
+
+        /*!
+         * \brief Marks each entry of #weights() that belongs to a
+         *  connection with a fixed weight with a non-zero value
+         */
+        std::vector<char> const& fixedWeights() const;
+
+
+        //! \brief All connections in the order of their creation
+        ConnectionPtrRange all();
+
+
+        //! \sa #all()
+        ConnectionPtrConstRange all() const;
+
+
+        /*!
+         * \brief All connections originating from a neuron, in the
+         *  order of their creation
+         *
+         * \param[in] neuron The source neuron
+         */
+        ConnectionPtrRange from(Neuron const& neuron);
+
+
+        //! \sa #from()
+        ConnectionPtrConstRange from(Neuron const& neuron) const;
+
+
+        /*!
+         * \brief All connections leading to a neuron, in the order of
+         *  their creation
+         *
+         * \param[in] neuron The destination neuron
+         */
+        ConnectionPtrRange to(Neuron const& neuron);
+
+
+        //! \sa #to()
+        ConnectionPtrConstRange to(Neuron const& neuron) const;
+
+
+    private:
+
+
+        //! \brief The dense index of a neuron
+        typedef std::uint32_t NeuronIndex;
+
+
+        //! \brief Connections in CSR form, sorted by one of their neurons
+        struct Adjacency
+        {
+            //! \brief The connections, sorted by neuron
+            ConnectionPtrVector entries;
+
+
+            /*!
+             * \brief The position of each neuron's first connection in
+             *  #entries, followed by the total number of entries
+             */
+            std::vector<size_type> offsets;
+
+
+            /*!
+             * \brief Sorts connections by neuron, keeping their order
+             *  otherwise
+             *
+             * \param[in] connections All connections
+             *
+             * \param[in] neurons The neuron index of each connection
+             *
+             * \param[in] numNeurons The number of neuron indexes
+             */
+            void build(
+                    ConnectionPtrVector const& connections,
+                    std::vector<NeuronIndex> const& neurons,
+                    size_type numNeurons);
+
+
+            //! \brief Removes a connection of a neuron
+            void remove(NeuronIndex neuron, Connection* connection);
+        };
+
+
+        //! \brief The smallest number of slots in a block of the arena
+        static const size_type MIN_BLOCK_SIZE = 64;
+
+
+        //! \brief The largest number of slots in a block of the arena
+        static const size_type MAX_BLOCK_SIZE = 65536;
+
+
+        //! \brief Returns the index of a neuron, assigning a new one
+        NeuronIndex addNeuron(Neuron const& neuron);
+
+
+        //! \brief Returns an unused slot of the arena
+        void* allocate();
+
+
+        /*!
+         * \brief Rebuilds #m_sources and #m_destinations if connections
+         *  were created since they were last built
+         */
+        void index() const;
+
+
+        /*!
+         * \brief Returns the range of a neuron's connections in an
+         *  adjacency, which must be up to date
+         */
+        std::pair<size_type, size_type> range(
+                Adjacency const& adjacency,
+                Neuron const& neuron)
+                const;
+
+
+        //! \brief The blocks of the arena
+        std::vector<std::unique_ptr<char[]>> m_blocks;
+
+
+        //! \brief The number of slots in the last block of the arena
+        size_type m_blockSize;
+
+
+        //! \brief The number of slots taken in the last block
+        size_type m_blockUsed;
+
+
+        //! \brief Slots of destroyed connections, ready for reuse
+        std::vector<void*> m_freeSlots;
+
+
+        //! \brief All connections in the order of their creation
+        ConnectionPtrVector m_connections;
+
+
+        //! \brief The weight of each connection
+        Vector m_weights;
+
+
+        //! \brief Whether the weight of each connection is fixed
+        std::vector<char> m_fixedWeights;
+
+
+        //! \brief The index of each connection's source neuron
+        std::vector<NeuronIndex> m_sourceIndexes;
+
+
+        //! \brief The index of each connection's destination neuron
+        std::vector<NeuronIndex> m_destinationIndexes;
+
+
+        //! \brief Maps each neuron to its index
+        std::unordered_map<Neuron const*, NeuronIndex> m_neuronIndexes;
+
+
+        //! \brief Connections, sorted by their source neuron
+        mutable Adjacency m_sources;
+
+
+        //! \brief Connections, sorted by their destination neuron
+        mutable Adjacency m_destinations;
+
+
+        //! \brief Whether #m_sources and #m_destinations are up to date
+        mutable std::atomic<bool> m_indexed;
+
+
+        //! \brief Serializes rebuilding the adjacencies
+        mutable std::mutex m_indexMutex;
+    };
+} // namespace wzann
+
+#endif // WZANN_CONNECTIONSTORE_H_
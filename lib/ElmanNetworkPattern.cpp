@@ -3,6 +3,7 @@
 #include "Vector.h"
 #include "Connection.h"
 #include "NeuralNetwork.h"
+#include "InferenceContext.h"
 #include "ClassRegistry.h"
 #include "ActivationFunction.h"
 #include "LayerSizeMismatchException.h"
@@ -194,6 +195,62 @@ namespace wzann {
                 network[OUTPUT],
                 layerInput);
     }
+
+
+    void ElmanNetworkPattern::calculateWithContext(
+            NeuralNetwork const& network,
+            Vector const& input,
+            Vector& output,
+            InferenceContext& context)
+            const
+    {
+        auto* layerInput = context.workspace().data();
+        auto const hiddenSize = network[HIDDEN].size();
+
+        network.calculateLayerTransition(
+                network[INPUT],
+                network[HIDDEN],
+                network.calculateLayer(network[INPUT], input, context)
+                    .data(),
+                layerInput);
+
+        // The context layer remembers the hidden layer's results of the
+        // last calculation as its input. The hidden layer's inputs are
+        // overwritten below anyway, so they can hold the transition:
+
+        auto& rememberedValues = context.layerInputs(HIDDEN);
+        network.calculateLayerTransition(
+                network[CONTEXT],
+                network[HIDDEN],
+                context.layerInputs(CONTEXT).data(),
+                rememberedValues.data());
+
+        for (Layer::size_type i = 0; i != hiddenSize; ++i) {
+            layerInput[i] += rememberedValues[i];
+        }
+
+        auto const& hiddenOutput = network.calculateLayer(
+                network[HIDDEN],
+                layerInput,
+                context);
+
+        context.layerInputs(CONTEXT) = hiddenOutput;
+        network[CONTEXT].activate(
+                context.layerInputs(CONTEXT),
+                context.layerOutputs(CONTEXT));
+
+        network.calculateLayerTransition(
+                network[HIDDEN],
+                network[OUTPUT],
+                hiddenOutput.data(),
+                layerInput);
+
+        auto const& result = network.calculateLayer(
+                network[OUTPUT],
+                layerInput,
+                context);
+        output.assign(result.begin(), result.end());
+    }
 } // namespace wzann
 
 
@@ -86,6 +86,21 @@ namespace wzann {
          */
         virtual Vector calculate(NeuralNetwork& network, Vector const& input)
                 override;
+
+
+        /*!
+         * \brief Feed-forward calculation of an Elman network that keeps
+         *  the context layer's state in the InferenceContext
+         *
+         * \sa NeuralNetworkPattern#calculateWithContext()
+         */
+        virtual void calculateWithContext(
+                NeuralNetwork const& network,
+                Vector const& input,
+                Vector& output,
+                InferenceContext& context)
+                const
+                override;
     };
 } /* namespace wzann */
 
@@ -3,7 +3,6 @@
 
 
 #include <cmath>
-#include <unordered_map>
 
 #include <boost/range/iterator_range_core.hpp>
 
@@ -11,23 +10,17 @@
 
 
 namespace wzann {
-    class Neuron;
-    class NeuralNetwork;
-
-
     /*!
-     * \brief The GradientAnalysis class offers `neuron delta' calculation
-     *  functions usable in gradient descent algorithms.
+     * \brief The GradientAnalysis class offers the error function used
+     *  in gradient descent algorithms.
+     *
+     * Neuron deltas and gradients are calculated by the GradientEngine.
      */
     class GradientAnalysisHelper
     {
     public:
 
 
-        typedef std::unordered_map<
-                Neuron const*,
-                double> NeuronDeltaMap;
-
         GradientAnalysisHelper();
         virtual ~GradientAnalysisHelper();
 
@@ -79,36 +72,6 @@ namespace wzann {
 
             return error / 2.0;
         }
-
-
-        /*!
-         * \brief Calculates the neuron delta for one given neuron,
-         *  assuming it is an output layer neuron.
-         */
-        static double outputNeuronDelta(
-                Neuron const& neuron,
-                double error);
-
-
-        /*!
-         * \brief Calculates the neuron delta for a neuron in an hidden
-         *  layer.
-         */
-        static double hiddenNeuronDelta(
-                NeuralNetwork& ann,
-                Neuron const& neuron,
-                NeuronDeltaMap& neuronDeltas,
-                Vector const& outputError);
-
-
-        /*!
-         * \brief Calculates the delta value of a neuron.
-         */
-        static double neuronDelta(
-                NeuralNetwork& ann,
-                Neuron const& neuron,
-                NeuronDeltaMap& neuronDeltas,
-                Vector const& outputError);
     };
 } // namespace wzann
 
@@ -0,0 +1,320 @@
+#include <vector>
+#include <cassert>
+#include <algorithm>
+
+#include <boost/range.hpp>
+
+#include "Layer.h"
+#include "Neuron.h"
+#include "TrainingItem.h"
+#include "NeuralNetwork.h"
+#include "InferencePlan.h"
+#include "InferenceContext.h"
+#include "ActivationFunction.h"
+#include "GradientAnalysisHelper.h"
+
+#include "GradientEngine.h"
+
+
+using boost::make_iterator_range;
+
+
+namespace wzann {
+    const GradientEngine::size_type GradientEngine::BLOCK_SIZE;
+
+
+    GradientEngine::GradientEngine(NeuralNetwork& network):
+            m_network(network),
+            m_statefulNetwork(&network),
+            m_context(nullptr),
+            m_blockUsed(0),
+            m_error(0.0),
+            m_numItems(0)
+    {
+        clear();
+    }
+
+
+    GradientEngine::GradientEngine(
+            NeuralNetwork const& network,
+            InferenceContext& context):
+                m_network(network),
+                m_statefulNetwork(nullptr),
+                m_context(&context),
+                m_blockUsed(0),
+                m_error(0.0),
+                m_numItems(0)
+    {
+        clear();
+    }
+
+
+    void GradientEngine::clear()
+    {
+        auto const& plan = m_network.compile();
+        auto const numLayers = plan.size();
+
+        m_inputs.resize(numLayers);
+        m_results.resize(numLayers);
+        m_deltas.resize(numLayers);
+        m_biasGradients.resize(numLayers);
+
+        for (size_type i = 0; i != numLayers; ++i) {
+            m_inputs[i].assign(BLOCK_SIZE * plan.layerSize(i), 0.0);
+            m_results[i].assign(BLOCK_SIZE * plan.layerSize(i), 0.0);
+            m_deltas[i].clear();
+            m_biasGradients[i].clear();
+        }
+
+        // Only layers that connections lead to need deltas:
+
+        if (numLayers > 0) {
+            m_deltas.back().assign(
+                    BLOCK_SIZE * plan.layerSize(numLayers - 1),
+                    0.0);
+            m_errors.assign(m_deltas.back().size(), 0.0);
+        }
+
+        auto const& transitions = plan.transitions();
+        m_transitionGradients.resize(transitions.size());
+
+        for (size_type i = 0; i != transitions.size(); ++i) {
+            auto const& t = transitions[i];
+            m_transitionGradients[i].assign(t.rows * t.columns, 0.0);
+            m_deltas[t.to].assign(BLOCK_SIZE * t.rows, 0.0);
+        }
+
+        for (auto const& slot: plan.biasSlots()) {
+            auto const size = plan.layerSize(slot.layer);
+            m_biasGradients[slot.layer].assign(size, 0.0);
+            m_deltas[slot.layer].assign(BLOCK_SIZE * size, 0.0);
+        }
+
+        m_blockUsed = 0;
+        m_error = 0.0;
+        m_numItems = 0;
+    }
+
+
+    double GradientEngine::accumulate(TrainingItem const& item)
+    {
+        if (nullptr != m_context) {
+            m_network.calculate(item.input(), m_output, *m_context);
+        } else {
+            m_output = m_statefulNetwork->calculate(item.input());
+        }
+
+        auto const& output = m_output;
+
+        if (! item.outputRelevant()) {
+            return 0.0;
+        }
+
+        // Remember the output error and the state of all layers, which
+        // the calculation has left in the layers' arrays or the context:
+
+        auto const expected = item.expectedOutput();
+        auto const error = GradientAnalysisHelper::errors(
+                make_iterator_range(output),
+                make_iterator_range(expected),
+                m_errors.data() + m_blockUsed * output.size());
+
+        for (size_type i = 0; i != m_inputs.size(); ++i) {
+            auto const& layer = m_network[i];
+            auto const offset = m_blockUsed * layer.size();
+            auto const& inputs = (nullptr != m_context
+                    ? m_context->layerInputs(i)
+                    : layer.lastInputs());
+            auto const& results = (nullptr != m_context
+                    ? m_context->layerOutputs(i)
+                    : layer.lastResults());
+
+            std::copy(
+                    inputs.begin(),
+                    inputs.end(),
+                    m_inputs[i].begin() + offset);
+            std::copy(
+                    results.begin(),
+                    results.end(),
+                    m_results[i].begin() + offset);
+        }
+
+        m_error += error;
+        ++m_numItems;
+
+        if (++m_blockUsed == BLOCK_SIZE) {
+            backpropagate();
+        }
+
+        return error;
+    }
+
+
+    double GradientEngine::accumulate(
+            TrainingSet::TrainingItems::const_iterator first,
+            TrainingSet::TrainingItems::const_iterator last)
+    {
+        double error = 0.0;
+
+        for (; first != last; ++first) {
+            error += accumulate(*first);
+        }
+
+        return error;
+    }
+
+
+    double GradientEngine::error() const
+    {
+        return m_error;
+    }
+
+
+    GradientEngine::size_type GradientEngine::numItems() const
+    {
+        return m_numItems;
+    }
+
+
+    void GradientEngine::backpropagate()
+    {
+        if (0 == m_blockUsed) {
+            return;
+        }
+
+        auto const& plan = m_network.compile();
+        auto const& transitions = plan.transitions();
+        auto const numItems = m_blockUsed;
+        auto const numLayers = plan.size();
+
+        // Calculate the deltas, starting with the output layer and
+        // then going backwards layer by layer:
+
+        for (size_type l = numLayers; l-- != 0; ) {
+            auto& deltas = m_deltas[l];
+
+            if (deltas.empty()) {
+                continue;
+            }
+
+            auto const& layer = m_network[l];
+            auto const size = layer.size();
+            auto const& inputs = m_inputs[l];
+
+            if (l == numLayers - 1) {
+                std::copy(
+                        m_errors.begin(),
+                        m_errors.begin() + numItems * size,
+                        deltas.begin());
+            } else {
+                std::fill(
+                        deltas.begin(),
+                        deltas.begin() + numItems * size,
+                        0.0);
+
+                for (auto const& t: transitions) {
+                    if (t.from != l || t.to <= l) {
+                        continue;
+                    }
+
+                    auto const& next = m_deltas[t.to];
+                    assert(! next.empty());
+
+                    for (size_type r = 0; r != t.rows; ++r) {
+                        double const* w = t.weights.data() + r * t.columns;
+
+                        for (size_type n = 0; n != numItems; ++n) {
+                            double const d = next[n * t.rows + r];
+                            double* sum = deltas.data() + n * size;
+
+                            for (size_type c = 0; c != t.columns; ++c) {
+                                sum[c] += w[c] * d;
+                            }
+                        }
+                    }
+                }
+            }
+
+            for (size_type i = 0; i != size; ++i) {
+                auto const f = layer[i].activationFunction();
+
+                for (size_type n = 0; n != numItems; ++n) {
+                    deltas[n * size + i] *= calculateDerivative(
+                            f,
+                            inputs[n * size + i]);
+                }
+            }
+        }
+
+        // Add the gradients of the whole block. Each entry receives the
+        // items' contributions in order:
+
+        for (size_type i = 0; i != transitions.size(); ++i) {
+            auto const& t = transitions[i];
+            auto const& deltas = m_deltas[t.to];
+            auto const& results = m_results[t.from];
+
+            for (size_type r = 0; r != t.rows; ++r) {
+                double* g = m_transitionGradients[i].data() + r * t.columns;
+
+                for (size_type n = 0; n != numItems; ++n) {
+                    double const d = deltas[n * t.rows + r];
+                    double const* o = results.data() + n * t.columns;
+
+                    for (size_type c = 0; c != t.columns; ++c) {
+                        g[c] += d * o[c];
+                    }
+                }
+            }
+        }
+
+        auto const biasOutput = m_network.biasOutput();
+
+        for (size_type l = 0; l != numLayers; ++l) {
+            auto& g = m_biasGradients[l];
+
+            for (size_type n = 0; n != numItems && ! g.empty(); ++n) {
+                double const* d = m_deltas[l].data() + n * g.size();
+
+                for (size_type i = 0; i != g.size(); ++i) {
+                    g[i] += d[i] * biasOutput;
+                }
+            }
+        }
+
+        m_blockUsed = 0;
+    }
+
+
+    Vector const& GradientEngine::gradient()
+    {
+        backpropagate();
+
+        auto const& plan = m_network.compile();
+        auto const& fixed = m_network.fixedWeights();
+        m_gradient.assign(fixed.size(), 0.0);
+
+        for (auto const& slot: plan.slots()) {
+            m_gradient[slot.weight] =
+                    m_transitionGradients[slot.transition][slot.offset];
+        }
+
+        // Later connections from the bias neuron to the same neuron do
+        // not affect the error, so their gradient stays zero:
+
+        for (auto const& slot: plan.biasSlots()) {
+            if (plan.isBiasEntry(slot)) {
+                m_gradient[slot.weight] =
+                        m_biasGradients[slot.layer][slot.neuron];
+            }
+        }
+
+        for (size_type i = 0; i != fixed.size(); ++i) {
+            if (fixed[i]) {
+                m_gradient[i] = 0.0;
+            }
+        }
+
+        return m_gradient;
+    }
+} // namespace wzann
@@ -0,0 +1,222 @@
+#ifndef WZANN_GRADIENTENGINE_H_
+#define WZANN_GRADIENTENGINE_H_
+
+
+#include <vector>
+#include <cstddef>
+
+#include "Vector.h"
+#include "TrainingSet.h"
+
+
+namespace wzann {
+    class TrainingItem;
+    class NeuralNetwork;
+    class InferenceContext;
+
+
+    /*!
+     * \brief Calculates the gradient of the error function with respect
+     *  to all weights of a neural network
+     *
+     * The engine feeds training items forward through the network, just
+     * like NeuralNetwork::calculate() does, and records the input and
+     * result of every layer. It then propagates the errors backwards
+     * layer by layer, using the dense weight matrices of the network's
+     * InferencePlan instead of walking the connection graph:
+     *
+     * - The delta of an output neuron is
+     *   \f$\delta_i = (\mathit{actual}_i - \mathit{expected}_i)
+     *   f'(\mathit{net}_i)\f$.
+     * - The delta of any other neuron is
+     *   \f$\delta_i = f'(\mathit{net}_i) \sum_j w_{ji} \delta_j\f$,
+     *   summing over all connections to neurons in later layers.
+     *   Connections that lead to the same or to an earlier layer, i.e.,
+     *   recurrent connections, do not propagate any error.
+     * - The gradient of a connection is the delta of its destination
+     *   times the last result of its source.
+     *
+     * Items are processed in blocks of #BLOCK_SIZE: Their deltas and
+     * gradients are calculated together, so that each weight matrix is
+     * traversed once per block instead of once per item. The gradients
+     * of all items are summed up in the order of the items, until
+     * #clear() is called.
+     *
+     * An engine either calculates with the network itself, which updates
+     * the state of its neurons just like NeuralNetwork::calculate() does,
+     * or keeps all state in an InferenceContext. In the latter case, the
+     * network is not modified, and several engines, each with its own
+     * context, can work on the same network concurrently.
+     *
+     * The topology of the network must not change while the engine is
+     * accumulating gradients, and the weights must not change between
+     * feeding an item forward and retrieving the #gradient().
+     *
+     * \sa NeuralNetwork::compile()
+     */
+    class GradientEngine
+    {
+    public:
+
+
+        typedef std::size_t size_type;
+
+
+        //! \brief The number of items whose deltas are calculated together
+        static const size_type BLOCK_SIZE = 4;
+
+
+        /*!
+         * \brief Creates a new engine for a network
+         *
+         * \param[in] network The network whose gradient is calculated;
+         *  must outlive the engine
+         */
+        explicit GradientEngine(NeuralNetwork& network);
+
+
+        /*!
+         * \brief Creates a new engine that keeps the state of all
+         *  calculations in a context, leaving the network unmodified
+         *
+         * \param[in] network The network whose gradient is calculated;
+         *  must outlive the engine
+         *
+         * \param[inout] context The calculation state; must outlive the
+         *  engine. For recurrent networks, it carries the recurrent state
+         *  from one item to the next.
+         *
+         * \sa NeuralNetwork::calculate(Vector const&, Vector&,
+         *  InferenceContext&) const
+         */
+        GradientEngine(
+                NeuralNetwork const& network,
+                InferenceContext& context);
+
+
+        GradientEngine(GradientEngine const&) = delete;
+        GradientEngine& operator =(GradientEngine const&) = delete;
+
+
+        /*!
+         * \brief Discards the accumulated gradient and error
+         *
+         * Also adapts the engine to the current topology of the network.
+         */
+        void clear();
+
+
+        /*!
+         * \brief Feeds one item forward and adds its gradient
+         *
+         * Items whose output is not relevant are only fed forward, so
+         * that the state of recurrent networks is kept up to date.
+         *
+         * \param[in] item The training item
+         *
+         * \return The error of the item,
+         *  \f$\frac{1}{2}\sum_i (\mathit{expected}_i -
+         *  \mathit{actual}_i)^2\f$, or 0.0 if its output is not relevant
+         */
+        double accumulate(TrainingItem const& item);
+
+
+        /*!
+         * \brief Feeds a range of items forward and adds their gradients
+         *
+         * \param[in] first The first item
+         *
+         * \param[in] last The item after the last one
+         *
+         * \return The sum of the errors of all relevant items
+         *
+         * \sa #accumulate(TrainingItem const&)
+         */
+        double accumulate(
+                TrainingSet::TrainingItems::const_iterator first,
+                TrainingSet::TrainingItems::const_iterator last);
+
+
+        //! \brief The sum of the errors of all items since #clear()
+        double error() const;
+
+
+        //! \brief The number of relevant items since #clear()
+        size_type numItems() const;
+
+
+        /*!
+         * \brief Returns the accumulated gradient
+         *
+         * \return The sum of the gradients of all items since #clear(),
+         *  in the order of NeuralNetwork::weights(). Entries of fixed
+         *  weights are 0.0.
+         */
+        Vector const& gradient();
+
+
+    private:
+
+
+        //! \brief Calculates deltas and gradients of the pending block
+        void backpropagate();
+
+
+        //! \brief The network
+        NeuralNetwork const& m_network;
+
+
+        //! \brief The network, if the engine calculates with its neurons
+        NeuralNetwork* m_statefulNetwork;
+
+
+        //! \brief The calculation state, if the network is left untouched
+        InferenceContext* m_context;
+
+
+        //! \brief The output of the last calculation
+        Vector m_output;
+
+
+        //! \brief The inputs of each layer, one row per item of the block
+        std::vector<Vector> m_inputs;
+
+
+        //! \brief The results of each layer, one row per item of the block
+        std::vector<Vector> m_results;
+
+
+        //! \brief The deltas of each layer, one row per item of the block
+        std::vector<Vector> m_deltas;
+
+
+        //! \brief The output errors, one row per item of the block
+        Vector m_errors;
+
+
+        //! \brief The number of items in the pending block
+        size_type m_blockUsed;
+
+
+        //! \brief The gradient of each transition's weight matrix
+        std::vector<Vector> m_transitionGradients;
+
+
+        //! \brief The gradient of each layer's bias vector
+        std::vector<Vector> m_biasGradients;
+
+
+        //! \brief The gradient in the order of the network's weights
+        Vector m_gradient;
+
+
+        //! \brief The sum of all errors since #clear()
+        double m_error;
+
+
+        //! \brief The number of relevant items since #clear()
+        size_type m_numItems;
+    };
+} // namespace wzann
+
+#endif // WZANN_GRADIENTENGINE_H_
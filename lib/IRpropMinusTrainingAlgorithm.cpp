@@ -0,0 +1,16 @@
+#include "ClassRegistry.h"
+
+#include "IRpropMinusTrainingAlgorithm.h"
+
+
+namespace wzann {
+    IRpropMinusTrainingAlgorithm::IRpropMinusTrainingAlgorithm() :
+            RpropTrainingAlgorithm(Variant::IRpropMinus)
+    {
+    }
+} // namespace wzann
+
+
+WZANN_REGISTER_CLASS(
+        wzann::IRpropMinusTrainingAlgorithm,
+        wzann::TrainingAlgorithm)
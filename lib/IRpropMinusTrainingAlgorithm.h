@@ -0,0 +1,32 @@
+#ifndef WZANN_IRPROPMINUSTRAININGALGORITHM_H_
+#define WZANN_IRPROPMINUSTRAININGALGORITHM_H_
+
+
+#include "RpropTrainingAlgorithm.h"
+
+
+namespace wzann {
+
+
+    /*!
+     * \brief Trains a neural network using the iRPROP- algorithm
+     *
+     * iRPROP- is an improved version of RPROP without weight
+     * backtracking: If the sign of a weight's gradient changes, only the
+     * step size of the weight is decreased, and the weight is left
+     * unchanged for this iteration. It is the simplest RPROP variant and
+     * often performs nearly as well as iRPROP+.
+     *
+     * \sa RpropTrainingAlgorithm
+     */
+    class IRpropMinusTrainingAlgorithm : public RpropTrainingAlgorithm
+    {
+    public:
+
+
+        //! \brief Creates a new training algorithm instance
+        IRpropMinusTrainingAlgorithm();
+    };
+} // namespace wzann
+
+#endif // WZANN_IRPROPMINUSTRAININGALGORITHM_H_
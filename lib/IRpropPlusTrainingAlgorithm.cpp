@@ -0,0 +1,16 @@
+#include "ClassRegistry.h"
+
+#include "IRpropPlusTrainingAlgorithm.h"
+
+
+namespace wzann {
+    IRpropPlusTrainingAlgorithm::IRpropPlusTrainingAlgorithm() :
+            RpropTrainingAlgorithm(Variant::IRpropPlus)
+    {
+    }
+} // namespace wzann
+
+
+WZANN_REGISTER_CLASS(
+        wzann::IRpropPlusTrainingAlgorithm,
+        wzann::TrainingAlgorithm)
@@ -0,0 +1,32 @@
+#ifndef WZANN_IRPROPPLUSTRAININGALGORITHM_H_
+#define WZANN_IRPROPPLUSTRAININGALGORITHM_H_
+
+
+#include "RpropTrainingAlgorithm.h"
+
+
+namespace wzann {
+
+
+    /*!
+     * \brief Trains a neural network using the iRPROP+ algorithm
+     *
+     * iRPROP+ is an improved version of RPROP with weight backtracking:
+     * If the sign of a weight's gradient changes, the last change of the
+     * weight is only reverted if the overall error has increased, too.
+     *
+     * Some research suggests that iRPROP+ is the optimum RPROP algorithm.
+     *
+     * \sa RpropTrainingAlgorithm
+     */
+    class IRpropPlusTrainingAlgorithm : public RpropTrainingAlgorithm
+    {
+    public:
+
+
+        //! \brief Creates a new training algorithm instance
+        IRpropPlusTrainingAlgorithm();
+    };
+} // namespace wzann
+
+#endif // WZANN_IRPROPPLUSTRAININGALGORITHM_H_
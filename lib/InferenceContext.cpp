@@ -0,0 +1,119 @@
+#include <cassert>
+
+#include <boost/range.hpp>
+
+#include "Layer.h"
+#include "Neuron.h"
+#include "NeuralNetwork.h"
+
+#include "InferenceContext.h"
+
+
+using boost::make_iterator_range;
+
+
+namespace wzann {
+    InferenceContext::InferenceContext()
+    {
+    }
+
+
+    InferenceContext::InferenceContext(NeuralNetwork const& network)
+    {
+        load(network);
+    }
+
+
+    InferenceContext& InferenceContext::load(NeuralNetwork const& network)
+    {
+        m_layerInputs.resize(network.size());
+        m_layerOutputs.resize(network.size());
+        m_workspace.clear();
+
+        size_type i = 0;
+        for (auto const& layer: make_iterator_range(network.layers())) {
+            auto& inputs = m_layerInputs[i];
+            auto& outputs = m_layerOutputs[i];
+
+            inputs = layer.lastInputs();
+            outputs = layer.lastResults();
+
+            if (layer.size() > m_workspace.size()) {
+                m_workspace.resize(layer.size());
+            }
+
+            ++i;
+        }
+
+        return *this;
+    }
+
+
+    void InferenceContext::store(NeuralNetwork& network) const
+    {
+        assert(matches(network));
+
+        size_type i = 0;
+        for (auto& layer: make_iterator_range(network.layers())) {
+            layer.m_lastInputs = m_layerInputs[i];
+            layer.m_lastResults = m_layerOutputs[i];
+
+            ++i;
+        }
+    }
+
+
+    bool InferenceContext::matches(NeuralNetwork const& network) const
+    {
+        if (network.size() != size()) {
+            return false;
+        }
+
+        size_type i = 0;
+        for (auto const& layer: make_iterator_range(network.layers())) {
+            if (layer.size() != m_layerInputs[i].size()) {
+                return false;
+            }
+
+            ++i;
+        }
+
+        return true;
+    }
+
+
+    InferenceContext::size_type InferenceContext::size() const
+    {
+        return m_layerInputs.size();
+    }
+
+
+    Vector& InferenceContext::layerInputs(size_type layer)
+    {
+        return m_layerInputs[layer];
+    }
+
+
+    Vector const& InferenceContext::layerInputs(size_type layer) const
+    {
+        return m_layerInputs[layer];
+    }
+
+
+    Vector& InferenceContext::layerOutputs(size_type layer)
+    {
+        return m_layerOutputs[layer];
+    }
+
+
+    Vector const& InferenceContext::layerOutputs(size_type layer) const
+    {
+        return m_layerOutputs[layer];
+    }
+
+
+    Vector& InferenceContext::workspace()
+    {
+        return m_workspace;
+    }
+} // namespace wzann
@@ -0,0 +1,152 @@
+#ifndef WZANN_INFERENCECONTEXT_H_
+#define WZANN_INFERENCECONTEXT_H_
+
+
+#include <vector>
+#include <cstddef>
+
+#include "Vector.h"
+
+
+namespace wzann {
+    class NeuralNetwork;
+
+
+    /*!
+     * \brief Holds all the state of a calculation that would otherwise be
+     *  stored in the neurons of a NeuralNetwork
+     *
+     * A call to NeuralNetwork::calculate(Vector const&) stores the last
+     * input and result of each neuron in the neuron objects themselves.
+     * Recurrent networks, such as the Elman network, also derive their
+     * state from these values. This means that one network object
+     * cannot be used by several threads at the same time.
+     *
+     * An InferenceContext keeps a copy of this state, one vector of
+     * inputs and one vector of results per layer. It is passed to
+     * NeuralNetwork::calculate(Vector const&, InferenceContext&) const,
+     * which leaves the network untouched. Thus, any number of threads can
+     * share one network, as long as each thread uses its own context.
+     *
+     * For recurrent networks, the context carries the recurrent state
+     * from one calculation to the next. Use one context per independent
+     * sequence.
+     *
+     * All buffers of a context are allocated when it is loaded. Reusing
+     * a context for many calculations thus does not allocate any memory.
+     *
+     * \sa NeuralNetwork::calculate(Vector const&, InferenceContext&)
+     */
+    class InferenceContext
+    {
+    public:
+
+
+        typedef std::size_t size_type;
+
+
+        //! \brief Creates an empty context
+        InferenceContext();
+
+
+        /*!
+         * \brief Creates a context for a particular network
+         *
+         * The context is initialized with the current state of the
+         * network's neurons.
+         *
+         * \param[in] network The network the context is used with
+         */
+        explicit InferenceContext(NeuralNetwork const& network);
+
+
+        /*!
+         * \brief Re-initializes the context from the current state of a
+         *  network's neurons
+         *
+         * \param[in] network The network
+         *
+         * \return `*this`
+         */
+        InferenceContext& load(NeuralNetwork const& network);
+
+
+        /*!
+         * \brief Writes the state stored in the context back to the
+         *  neurons of a network
+         *
+         * \param[inout] network The network; it must have the same
+         *  layout as the network the context was loaded from
+         */
+        void store(NeuralNetwork& network) const;
+
+
+        /*!
+         * \brief Checks whether the context can be used with a network,
+         *  i.e., whether the number and sizes of the layers match
+         *
+         * \param[in] network The network
+         *
+         * \return `true` if the context matches the network's layout
+         */
+        bool matches(NeuralNetwork const& network) const;
+
+
+        //! \brief The number of layers the context holds state for
+        size_type size() const;
+
+
+        /*!
+         * \brief The inputs of the neurons of a layer, as they were
+         *  presented at the last activation
+         *
+         * \param[in] layer The index of the layer
+         */
+        Vector& layerInputs(size_type layer);
+
+
+        //! \sa #layerInputs()
+        Vector const& layerInputs(size_type layer) const;
+
+
+        /*!
+         * \brief The results of the neurons of a layer at their last
+         *  activation
+         *
+         * \param[in] layer The index of the layer
+         */
+        Vector& layerOutputs(size_type layer);
+
+
+        //! \sa #layerOutputs()
+        Vector const& layerOutputs(size_type layer) const;
+
+
+        /*!
+         * \brief A scratch buffer for intermediate results, such as the
+         *  result of a layer transition
+         *
+         * The workspace has room for at least as many elements as the
+         * widest layer of the network has neurons. Its contents are not
+         * preserved between calculations.
+         */
+        Vector& workspace();
+
+
+    private:
+
+
+        //! \brief The last input of each neuron, per layer
+        std::vector<Vector> m_layerInputs;
+
+
+        //! \brief The last result of each neuron, per layer
+        std::vector<Vector> m_layerOutputs;
+
+
+        //! \brief Scratch buffer the size of the widest layer
+        Vector m_workspace;
+    };
+} // namespace wzann
+
+#endif // WZANN_INFERENCECONTEXT_H_
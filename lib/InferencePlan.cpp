@@ -0,0 +1,427 @@
+#include <tuple>
+#include <vector>
+#include <cassert>
+#include <cstddef>
+#include <algorithm>
+#include <unordered_map>
+
+#include <boost/range.hpp>
+
+#include "Layer.h"
+#include "Neuron.h"
+#include "Connection.h"
+#include "NeuralNetwork.h"
+
+#include "InferencePlan.h"
+
+
+using boost::make_iterator_range;
+
+
+namespace wzann {
+    InferencePlan::InferencePlan():
+            m_weights(nullptr),
+            m_compiled(false),
+            m_weightsValid(false)
+    {
+    }
+
+
+    void InferencePlan::compile(NeuralNetwork const& network)
+    {
+        m_layers.clear();
+        m_layerSizes.clear();
+        m_transitions.clear();
+        m_biases.clear();
+        m_biasConnections.clear();
+        m_slots.clear();
+        m_biasSlots.clear();
+        m_weights = &(network.weights());
+
+        std::unordered_map<Layer const*, size_type> layerIndexes;
+        for (auto const& layer: make_iterator_range(network.layers())) {
+            layerIndexes[&layer] = m_layers.size();
+            m_layers.push_back(&layer);
+            m_layerSizes.push_back(layer.size());
+            m_biases.emplace_back(layer.size(), 0.0);
+            m_biasConnections.emplace_back(layer.size(), nullptr);
+        }
+
+        m_transitionIndexes.assign(size() * size(), -1);
+
+        // Resolve the coordinates of all connections once. The bias
+        // neuron is marked by a source layer index of size(). The
+        // connections appear in the order of their weights:
+
+        typedef std::tuple<
+                Connection const*,
+                size_type,
+                size_type,
+                size_type,
+                size_type> ResolvedConnection;
+        std::vector<ResolvedConnection> resolved;
+        resolved.reserve(std::distance(
+                network.connections().first,
+                network.connections().second));
+
+        for (auto const* c: make_iterator_range(network.connections())) {
+            auto const& dst = c->destination();
+            auto dstLayer = layerIndexes.at(dst.parent());
+            auto dstNeuron = dst.parent()->indexOf(dst);
+
+            if (&(c->source()) == &(network.biasNeuron())) {
+                resolved.emplace_back(c, size(), 0, dstLayer, dstNeuron);
+                continue;
+            }
+
+            auto const& src = c->source();
+            auto srcLayer = layerIndexes.at(src.parent());
+            auto srcNeuron = src.parent()->indexOf(src);
+            auto& transitionIndex = m_transitionIndexes[
+                    srcLayer * size() + dstLayer];
+
+            if (transitionIndex < 0) {
+                transitionIndex = static_cast<std::ptrdiff_t>(
+                        m_transitions.size());
+                m_transitions.push_back({
+                        srcLayer,
+                        dstLayer,
+                        m_layerSizes[dstLayer],
+                        m_layerSizes[srcLayer],
+                        Vector(m_layerSizes[dstLayer]
+                            * m_layerSizes[srcLayer], 0.0) });
+            }
+
+            resolved.emplace_back(
+                    c,
+                    srcLayer,
+                    srcNeuron,
+                    dstLayer,
+                    dstNeuron);
+        }
+
+        // Now that no transition will be added anymore, we can safely
+        // record the position of each weight. Only the first connection
+        // from the bias neuron to a neuron counts; bias weights are
+        // maintained separately:
+
+        m_slots.reserve(resolved.size());
+        for (auto const& r: resolved) {
+            auto weight = static_cast<size_type>(&r - resolved.data());
+            auto srcLayer = std::get<1>(r);
+            auto dstLayer = std::get<3>(r);
+            auto dstNeuron = std::get<4>(r);
+
+            if (srcLayer == size()) {
+                auto& bc = m_biasConnections[dstLayer][dstNeuron];
+
+                if (nullptr == bc) {
+                    bc = std::get<0>(r);
+                }
+
+                m_biasSlots.push_back({ weight, dstLayer, dstNeuron });
+            } else {
+                auto transition = static_cast<size_type>(
+                        m_transitionIndexes[srcLayer * size() + dstLayer]);
+                m_slots.push_back({
+                        weight,
+                        transition,
+                        dstNeuron * m_layerSizes[srcLayer]
+                            + std::get<2>(r) });
+            }
+        }
+
+        m_compiled.store(true, std::memory_order_release);
+        updateWeights();
+    }
+
+
+    void InferencePlan::updateWeights()
+    {
+        assert(isCompiled());
+
+        for (auto& t: m_transitions) {
+            std::fill(t.weights.begin(), t.weights.end(), 0.0);
+        }
+
+        // Multiple connections between the same two neurons add up:
+
+        auto const& weights = *m_weights;
+        for (auto const& slot: m_slots) {
+            m_transitions[slot.transition].weights[slot.offset]
+                += weights[slot.weight];
+        }
+
+        for (size_type i = 0; i != size(); ++i) {
+            for (size_type j = 0; j != m_layerSizes[i]; ++j) {
+                auto const* bc = m_biasConnections[i][j];
+
+                if (nullptr != bc) {
+                    m_biases[i][j] = bc->weight();
+                }
+            }
+        }
+
+        m_weightsValid.store(true, std::memory_order_release);
+    }
+
+
+    void InferencePlan::connectBias(Connection const& connection)
+    {
+        if (! isCompiled()) {
+            return;
+        }
+
+        auto const& neuron = connection.destination();
+        auto layer = layerIndex(*(neuron.parent()));
+        auto index = neuron.parent()->indexOf(neuron);
+
+        m_biasSlots.push_back({ connection.position(), layer, index });
+
+        if (nullptr == m_biasConnections[layer][index]) {
+            m_biasConnections[layer][index] = &connection;
+            m_biases[layer][index] = connection.weight();
+        }
+    }
+
+
+    void InferencePlan::disconnectBias(
+            Connection const& connection,
+            NeuralNetwork const& network)
+    {
+        if (! isCompiled()) {
+            return;
+        }
+
+        auto const& neuron = connection.destination();
+        auto layer = layerIndex(*(neuron.parent()));
+        auto index = neuron.parent()->indexOf(neuron);
+
+        m_biasSlots.erase(std::find_if(
+                m_biasSlots.begin(),
+                m_biasSlots.end(),
+                [&connection](BiasSlot const& slot) {
+            return slot.weight == connection.position();
+        }));
+
+        if (&connection != m_biasConnections[layer][index]) {
+            return;
+        }
+
+        // The next connection from the bias neuron, if any, takes over:
+
+        m_biasConnections[layer][index] = nullptr;
+        m_biases[layer][index] = 0.0;
+
+        for (auto const* c: make_iterator_range(
+                network.connectionsTo(neuron))) {
+            if (c != &connection
+                    && &(c->source()) == &(network.biasNeuron())) {
+                m_biasConnections[layer][index] = c;
+                m_biases[layer][index] = c->weight();
+                break;
+            }
+        }
+    }
+
+
+    void InferencePlan::removeWeight(size_type position)
+    {
+        if (! isCompiled()) {
+            return;
+        }
+
+        for (auto& slot: m_slots) {
+            assert(slot.weight != position);
+
+            if (slot.weight > position) {
+                --slot.weight;
+            }
+        }
+
+        for (auto& slot: m_biasSlots) {
+            assert(slot.weight != position);
+
+            if (slot.weight > position) {
+                --slot.weight;
+            }
+        }
+    }
+
+
+    void InferencePlan::updateBias(Connection const& connection)
+    {
+        if (! isCompiled()) {
+            return;
+        }
+
+        auto const& neuron = connection.destination();
+        auto layer = layerIndex(*(neuron.parent()));
+        auto index = neuron.parent()->indexOf(neuron);
+
+        if (&connection == m_biasConnections[layer][index]) {
+            m_biases[layer][index] = connection.weight();
+        }
+    }
+
+
+    void InferencePlan::invalidate()
+    {
+        m_compiled.store(false, std::memory_order_release);
+        m_weightsValid.store(false, std::memory_order_release);
+    }
+
+
+    void InferencePlan::invalidateWeights()
+    {
+        m_weightsValid.store(false, std::memory_order_release);
+    }
+
+
+    bool InferencePlan::isCompiled() const
+    {
+        return m_compiled.load(std::memory_order_acquire);
+    }
+
+
+    bool InferencePlan::hasValidWeights() const
+    {
+        return m_weightsValid.load(std::memory_order_acquire);
+    }
+
+
+    InferencePlan::size_type InferencePlan::size() const
+    {
+        return m_layers.size();
+    }
+
+
+    InferencePlan::size_type InferencePlan::layerSize(size_type layer)
+            const
+    {
+        return m_layerSizes[layer];
+    }
+
+
+    InferencePlan::size_type InferencePlan::layerIndex(Layer const& layer)
+            const
+    {
+        auto it = std::find(m_layers.begin(), m_layers.end(), &layer);
+        assert(it != m_layers.end());
+        return static_cast<size_type>(it - m_layers.begin());
+    }
+
+
+    InferencePlan::Transition const* InferencePlan::transition(
+            size_type from,
+            size_type to)
+            const
+    {
+        auto index = m_transitionIndexes[from * size() + to];
+        return (index < 0 ? nullptr : &(m_transitions[index]));
+    }
+
+
+    std::vector<InferencePlan::Transition> const&
+    InferencePlan::transitions() const
+    {
+        return m_transitions;
+    }
+
+
+    bool InferencePlan::isRecurrent() const
+    {
+        return std::any_of(
+                m_transitions.begin(),
+                m_transitions.end(),
+                [](Transition const& t) { return t.to <= t.from; });
+    }
+
+
+    std::vector<InferencePlan::Slot> const& InferencePlan::slots() const
+    {
+        return m_slots;
+    }
+
+
+    std::vector<InferencePlan::BiasSlot> const& InferencePlan::biasSlots()
+            const
+    {
+        return m_biasSlots;
+    }
+
+
+    bool InferencePlan::isBiasEntry(BiasSlot const& slot) const
+    {
+        auto const* connection = m_biasConnections[slot.layer][slot.neuron];
+        return connection->position() == slot.weight;
+    }
+
+
+    Vector const& InferencePlan::bias(size_type layer) const
+    {
+        return m_biases[layer];
+    }
+
+
+    void InferencePlan::transfer(
+            Transition const& transition,
+            double const* input,
+            double* output)
+    {
+        double const* w = transition.weights.data();
+
+        for (size_type r = 0; r != transition.rows; ++r) {
+            double sum = 0.0;
+
+            for (size_type c = 0; c != transition.columns; ++c) {
+                sum += input[c] * w[c];
+            }
+
+            output[r] = sum;
+            w += transition.columns;
+        }
+    }
+
+
+    void InferencePlan::transferBatch(
+            Transition const& transition,
+            double const* input,
+            size_type numSamples,
+            double* output)
+    {
+        const size_type blockSize = 4;
+        auto const cols = transition.columns;
+        auto const rows = transition.rows;
+
+        size_type n = 0;
+        for (; n + blockSize <= numSamples; n += blockSize) {
+            double const* in0 = input + (n + 0) * cols;
+            double const* in1 = input + (n + 1) * cols;
+            double const* in2 = input + (n + 2) * cols;
+            double const* in3 = input + (n + 3) * cols;
+            double const* w = transition.weights.data();
+
+            for (size_type r = 0; r != rows; ++r) {
+                double s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0;
+
+                for (size_type c = 0; c != cols; ++c) {
+                    s0 += in0[c] * w[c];
+                    s1 += in1[c] * w[c];
+                    s2 += in2[c] * w[c];
+                    s3 += in3[c] * w[c];
+                }
+
+                output[(n + 0) * rows + r] = s0;
+                output[(n + 1) * rows + r] = s1;
+                output[(n + 2) * rows + r] = s2;
+                output[(n + 3) * rows + r] = s3;
+                w += cols;
+            }
+        }
+
+        for (; n != numSamples; ++n) {
+            transfer(transition, input + n * cols, output + n * rows);
+        }
+    }
+} // namespace wzann
@@ -0,0 +1,418 @@
+#ifndef WZANN_INFERENCEPLAN_H_
+#define WZANN_INFERENCEPLAN_H_
+
+
+#include <atomic>
+#include <vector>
+#include <cstddef>
+#include <utility>
+
+#include "Vector.h"
+
+
+namespace wzann {
+    class Layer;
+    class Connection;
+    class NeuralNetwork;
+
+
+    /*!
+     * \brief A compiled, dense representation of the connection graph of
+     *  a NeuralNetwork that is used for fast inference
+     *
+     * The connection graph of a NeuralNetwork is made up of Connection
+     * objects that are indexed by their source and destination neurons.
+     * Walking this graph for each calculation is expensive, since every
+     * connection requires a number of hash lookups in order to find the
+     * index of the neurons it connects.
+     *
+     * An InferencePlan resolves all these lookups once: Each pair of
+     * layers that is connected by at least one connection becomes a
+     * Transition, which contains a contiguous, row-major weight matrix
+     * with one row per destination neuron and one column per source
+     * neuron. Connections originating from the bias neuron are collected
+     * in a dense bias vector per layer. Bias vectors are maintained
+     * incrementally: Adding, removing or re-weighting a connection from
+     * the bias neuron only touches the one affected entry.
+     *
+     * The plan is owned by the NeuralNetwork it was compiled from. The
+     * network invalidates the plan whenever its topology changes, i.e.,
+     * when neurons are connected or disconnected. When only the weight of
+     * a connection changes, the plan's topology stays valid and only
+     * the weight values are refreshed, which does not require any lookup.
+     *
+     * The state flags are atomic, so that readers can check whether the
+     * plan is up to date without locking; the owning network serializes
+     * compilation itself.
+     *
+     * \sa NeuralNetwork::compile()
+     */
+    class InferencePlan
+    {
+    public:
+
+
+        typedef std::size_t size_type;
+
+
+        /*!
+         * \brief The dense weight matrix of all connections leading from
+         *  one layer to another
+         */
+        struct Transition
+        {
+            //! \brief Index of the originating layer
+            size_type from;
+
+
+            //! \brief Index of the destination layer
+            size_type to;
+
+
+            //! \brief Number of rows, i.e., neurons in the destination layer
+            size_type rows;
+
+
+            //! \brief Number of columns, i.e., neurons in the source layer
+            size_type columns;
+
+
+            //! \brief Row-major weight matrix of `rows * columns` weights
+            Vector weights;
+        };
+
+
+        /*!
+         * \brief The position of a connection's weight in one of the
+         *  weight matrices
+         */
+        struct Slot
+        {
+            //! \brief Position of the weight in NeuralNetwork::weights()
+            size_type weight;
+
+
+            //! \brief Index of the transition in #transitions()
+            size_type transition;
+
+
+            //! \brief Position in the transition's weight matrix
+            size_type offset;
+        };
+
+
+        //! \brief The neuron a connection from the bias neuron leads to
+        struct BiasSlot
+        {
+            //! \brief Position of the weight in NeuralNetwork::weights()
+            size_type weight;
+
+
+            //! \brief Index of the destination layer
+            size_type layer;
+
+
+            //! \brief Index of the destination neuron in its layer
+            size_type neuron;
+        };
+
+
+        //! \brief Creates a new, empty and invalid plan
+        InferencePlan();
+
+
+        InferencePlan(InferencePlan const&) = delete;
+        InferencePlan& operator =(InferencePlan const&) = delete;
+
+
+        /*!
+         * \brief Compiles the connection graph of the given network
+         *
+         * All previously existing information in the plan is discarded.
+         *
+         * \param[in] network The network to compile
+         */
+        void compile(NeuralNetwork const& network);
+
+
+        /*!
+         * \brief Refreshes all weights, including the bias vectors, from
+         *  the network's weight vector without re-evaluating the topology
+         *  of the network
+         */
+        void updateWeights();
+
+
+        /*!
+         * \brief Takes a new connection from the bias neuron into account
+         *
+         * If the destination neuron has no bias connection yet, the new
+         * connection becomes its bias connection.
+         *
+         * \param[in] connection The new connection from the bias neuron
+         */
+        void connectBias(Connection const& connection);
+
+
+        /*!
+         * \brief Removes a connection from the bias neuron from the plan
+         *
+         * If it was the destination neuron's bias connection, the next
+         * connection from the bias neuron to the same neuron takes over.
+         *
+         * \param[in] connection The connection that is being removed; it
+         *  is still part of the network, but is not considered anymore
+         *
+         * \param[in] network The network the plan was compiled from
+         */
+        void disconnectBias(
+                Connection const& connection,
+                NeuralNetwork const& network);
+
+
+        /*!
+         * \brief Takes the removal of one entry of the network's weight
+         *  vector into account
+         *
+         * Removing a connection from the bias neuron keeps the plan
+         * compiled, but moves the weights of all connections created
+         * after it one position to the front.
+         *
+         * \param[in] position The position of the removed weight
+         */
+        void removeWeight(size_type position);
+
+
+        /*!
+         * \brief Refreshes the weight of one bias connection
+         *
+         * \param[in] connection The connection from the bias neuron
+         *  whose weight has changed
+         */
+        void updateBias(Connection const& connection);
+
+
+        /*!
+         * \brief Marks the whole plan as outdated
+         *
+         * The next use of the plan requires a complete re-compilation.
+         */
+        void invalidate();
+
+
+        /*!
+         * \brief Marks the weights stored in this plan as outdated
+         *
+         * The topology information of the plan stays valid; only the
+         * weight values need to be refreshed.
+         */
+        void invalidateWeights();
+
+
+        //! \brief Whether the topology of the plan is up to date
+        bool isCompiled() const;
+
+
+        //! \brief Whether the weights stored in the plan are up to date
+        bool hasValidWeights() const;
+
+
+        //! \brief The number of layers the plan was compiled for
+        size_type size() const;
+
+
+        /*!
+         * \brief Returns the number of neurons in a layer
+         *
+         * \param[in] layer The index of the layer
+         *
+         * \return The layer's size at the time of compilation
+         */
+        size_type layerSize(size_type layer) const;
+
+
+        /*!
+         * \brief Looks up the index of a layer
+         *
+         * \param[in] layer The layer
+         *
+         * \return The index of the layer in its network
+         */
+        size_type layerIndex(Layer const& layer) const;
+
+
+        /*!
+         * \brief Retrieves the transition between two layers
+         *
+         * \param[in] from The index of the originating layer
+         *
+         * \param[in] to The index of the destination layer
+         *
+         * \return The transition, or `nullptr` if no connection exists
+         *  between the two layers
+         */
+        Transition const* transition(size_type from, size_type to) const;
+
+
+        //! \brief All transitions between connected layers
+        std::vector<Transition> const& transitions() const;
+
+
+        /*!
+         * \brief Whether a transition leads from a layer to itself or to
+         *  an earlier one
+         *
+         * The results of such networks depend on the inputs calculated
+         * before, e.g., through the context layer of an Elman network, so
+         * a sequence of inputs must be calculated in order with one
+         * InferenceContext.
+         */
+        bool isRecurrent() const;
+
+
+        /*!
+         * \brief The positions of the weights of all connections between
+         *  two layers in the transitions' weight matrices
+         */
+        std::vector<Slot> const& slots() const;
+
+
+        /*!
+         * \brief The destinations of all connections from the bias
+         *  neuron, including those that are not part of a bias vector
+         *  because an earlier connection leads to the same neuron
+         */
+        std::vector<BiasSlot> const& biasSlots() const;
+
+
+        /*!
+         * \brief Whether the connection of a bias slot determines its
+         *  neuron's entry of the bias vector
+         *
+         * Only the first connection from the bias neuron to a neuron is
+         * part of the calculation; the weights of later ones have no
+         * effect on the network's output.
+         *
+         * \param[in] slot One of the #biasSlots()
+         */
+        bool isBiasEntry(BiasSlot const& slot) const;
+
+
+        /*!
+         * \brief Returns the weights of all connections from the bias
+         *  neuron to the neurons of a layer
+         *
+         * Neurons that are not connected to the bias neuron have a
+         * weight of 0.0.
+         *
+         * \param[in] layer The index of the layer
+         *
+         * \return The layer's bias vector
+         */
+        Vector const& bias(size_type layer) const;
+
+
+        /*!
+         * \brief Calculates the product of a transition's weight matrix
+         *  and the output of the originating layer
+         *
+         * \param[in] transition The transition
+         *
+         * \param[in] input The output of the originating layer; must have
+         *  as many elements as the originating layer has neurons
+         *
+         * \param[out] output The input of the destination layer; must have
+         *  room for as many elements as the destination layer has neurons
+         */
+        static void transfer(
+                Transition const& transition,
+                double const* input,
+                double* output);
+
+
+        /*!
+         * \brief Calculates the transition of a whole batch of samples
+         *  as one matrix-matrix product
+         *
+         * Both matrices are stored row-major with one sample per row.
+         * Samples are processed in small blocks, so that each row of the
+         * weight matrix is loaded once per block instead of once per
+         * sample.
+         *
+         * \param[in] transition The transition
+         *
+         * \param[in] input The outputs of the originating layer,
+         *  `numSamples` rows with `transition.columns` elements each
+         *
+         * \param[in] numSamples The number of samples in the batch
+         *
+         * \param[out] output The inputs of the destination layer;
+         *  must have room for `numSamples` rows with `transition.rows`
+         *  elements each
+         */
+        static void transferBatch(
+                Transition const& transition,
+                double const* input,
+                size_type numSamples,
+                double* output);
+
+
+    private:
+
+
+        //! \brief All layers of the network, indexed by their position
+        std::vector<Layer const*> m_layers;
+
+
+        //! \brief The size of each layer
+        std::vector<size_type> m_layerSizes;
+
+
+        //! \brief All transitions between connected layers
+        std::vector<Transition> m_transitions;
+
+
+        /*!
+         * \brief Maps `from * size() + to` to the index of a transition
+         *  in #m_transitions, or -1 if there is no such transition
+         */
+        std::vector<std::ptrdiff_t> m_transitionIndexes;
+
+
+        //! \brief The bias weight vector of each layer
+        std::vector<Vector> m_biases;
+
+
+        /*!
+         * \brief The connection from the bias neuron that determines
+         *  each entry of #m_biases, or `nullptr`
+         */
+        std::vector<std::vector<Connection const*>> m_biasConnections;
+
+
+        //! \brief The weight vector of the compiled network
+        Vector const* m_weights;
+
+
+        /*!
+         * \brief Maps the weight of each connection between two layers,
+         *  given by its position in #m_weights, to its position in one of
+         *  the weight matrices
+         */
+        std::vector<Slot> m_slots;
+
+
+        //! \brief The destinations of all connections from the bias neuron
+        std::vector<BiasSlot> m_biasSlots;
+
+
+        //! \brief Whether the topology is compiled
+        std::atomic<bool> m_compiled;
+
+
+        //! \brief Whether the weights stored in the plan are up to date
+        std::atomic<bool> m_weightsValid;
+    };
+} // namespace wzann
+
+#endif // WZANN_INFERENCEPLAN_H_
@@ -1,11 +1,14 @@
 #include <cstddef>
 #include <cassert>
+#include <algorithm>
 #include <functional>
 
 #include <boost/ptr_container/ptr_vector.hpp>
 
 #include "Neuron.h"
 #include "Layer.h"
+#include "ActivationFunction.h"
+#include "NeuralNetwork.h"
 
 
 namespace wzann {
@@ -59,23 +62,80 @@ namespace wzann {
     {
         assert(neuronInputs.size() == size());
 
-        Vector result;
-        result.reserve(size());
+        m_lastInputs = neuronInputs;
+
+        if (hasUniformActivationFunction()) {
+            calculate(
+                    m_activationFunctions.front(),
+                    m_lastInputs.data(),
+                    m_lastResults.data(),
+                    m_lastResults.size());
+        } else {
+            for (size_type i = 0; i != size(); ++i) {
+                m_lastResults[i] = calculate(
+                        m_activationFunctions[i],
+                        m_lastInputs[i]);
+            }
+        }
+
+        return m_lastResults;
+    }
 
-        auto iit = neuronInputs.begin();
-        auto nit = begin();
 
-        for (; iit != neuronInputs.end() && nit != end(); iit++, nit++) {
-            result.push_back(nit->activate(*iit));
+    void Layer::activate(Vector const& neuronInputs, Vector& results) const
+    {
+        assert(neuronInputs.size() == size());
+        results.resize(size());
+
+        if (hasUniformActivationFunction()) {
+            calculate(
+                    m_activationFunctions.front(),
+                    neuronInputs.data(),
+                    results.data(),
+                    results.size());
+            return;
+        }
+
+        for (size_type i = 0; i != size(); ++i) {
+            results[i] = calculate(
+                    m_activationFunctions[i],
+                    neuronInputs[i]);
+        }
+    }
+
+
+    bool Layer::hasUniformActivationFunction() const
+    {
+        if (m_activationFunctions.empty()) {
+            return false;
         }
 
-        return result;
+        auto const f = m_activationFunctions.front();
+        return std::all_of(
+                m_activationFunctions.begin(),
+                m_activationFunctions.end(),
+                [f](ActivationFunction const& af) {
+            return af == f;
+        });
+    }
+
+
+    Vector const& Layer::lastInputs() const
+    {
+        return m_lastInputs;
+    }
+
+
+    Vector const& Layer::lastResults() const
+    {
+        return m_lastResults;
     }
 
 
     Layer::size_type Layer::indexOf(Neuron const& neuron) const
     {
-       return m_neuronIndexes.at(const_cast<Neuron *>(&neuron));
+        assert(neuron.parent() == this);
+        return neuron.m_index;
     }
 
 
@@ -111,9 +171,21 @@ namespace wzann {
 
     Layer& Layer::addNeuron(Neuron* const& neuron)
     {
+        m_activationFunctions.push_back(neuron->activationFunction());
+        m_lastInputs.push_back(neuron->lastInput());
+        m_lastResults.push_back(neuron->lastResult());
+
+        if (nullptr == neuron->m_parent) {
+            delete neuron->m_detached;
+        }
+
         neuron->m_parent = this;
+        neuron->m_index = size();
         m_neurons.push_back(neuron);
-        m_neuronIndexes[neuron] = size()-1;
+
+        if (nullptr != m_parent) {
+            m_parent->m_plan.invalidate();
+        }
 
         return *this;
     }
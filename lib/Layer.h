@@ -5,7 +5,6 @@
 #include <vector>
 #include <cstddef>
 #include <functional>
-#include <unordered_map>
 
 #include <boost/ptr_container/ptr_vector.hpp>
 
@@ -23,10 +22,19 @@ namespace wzann {
 
     /*!
      * \brief Represents a layer in a neural network
+     *
+     * The layer stores the state of its neurons, i.e., their activation
+     * functions and the last input and result of each neuron, in
+     * contiguous arrays (structure of arrays). The Neuron objects merely
+     * refer to their position in these arrays. Thus, activating a whole
+     * layer works on plain arrays, without touching the neuron objects
+     * at all.
      */
     class Layer
     {
+        friend class Neuron;
         friend class NeuralNetwork;
+        friend class InferenceContext;
 
 
     public:
@@ -128,6 +136,54 @@ namespace wzann {
         Vector activate(Vector const& neuronInputs);
 
 
+        /*!
+         * \brief Calculates the activation of all neurons in this layer
+         *  without changing their state
+         *
+         * \param[in] neuronInputs The inputs to this layer's neurons
+         *
+         * \param[out] results Receives the results of the activation;
+         *  may be the same object as `neuronInputs`
+         *
+         * \sa #activate(Vector const&)
+         */
+        void activate(Vector const& neuronInputs, Vector& results) const;
+
+
+        /*!
+         * \brief Checks whether all neurons in this layer use the same
+         *  activation function
+         *
+         * Layers with a uniform activation function are activated with
+         * the array version of ::calculate(), i.e., the activation
+         * function is dispatched once for the whole layer.
+         *
+         * \return `true` if the layer is not empty and all neurons have
+         *  the same activation function
+         */
+        bool hasUniformActivationFunction() const;
+
+
+        /*!
+         * \brief Returns the last input of all neurons in this layer
+         *
+         * \return The inputs, in the order of the neurons
+         *
+         * \sa Neuron#lastInput()
+         */
+        Vector const& lastInputs() const;
+
+
+        /*!
+         * \brief Returns the last result of all neurons in this layer
+         *
+         * \return The results, in the order of the neurons
+         *
+         * \sa Neuron#lastResult()
+         */
+        Vector const& lastResults() const;
+
+
         /*!
          * \brief Returns the index of a particular neuron
          *
@@ -189,7 +245,8 @@ namespace wzann {
          * \brief Adds a neuron to the layer
          *
          * The takes ownership of the neuron, which will be deleted when
-         * the Layer is deleted.
+         * the Layer is deleted. The neuron's state moves into the
+         * layer's arrays, and the neuron's own copy of it is freed.
          *
          * \return `this`
          */
@@ -211,8 +268,16 @@ namespace wzann {
         boost::ptr_vector<Neuron> m_neurons;
 
 
-        //! \brief Maps Neurons to their index for faster #indexOf()
-        std::unordered_map<Neuron *, size_t> m_neuronIndexes;
+        //! \brief The activation function of each neuron
+        std::vector<ActivationFunction> m_activationFunctions;
+
+
+        //! \brief The last input of each neuron
+        Vector m_lastInputs;
+
+
+        //! \brief The last result of each neuron
+        Vector m_lastResults;
 
 
         //! The parent network we're contained in.
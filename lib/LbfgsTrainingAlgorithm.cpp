@@ -0,0 +1,263 @@
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+#include "TrainingSet.h"
+#include "ClassRegistry.h"
+#include "NeuralNetwork.h"
+#include "GradientEngine.h"
+
+#include "LbfgsTrainingAlgorithm.h"
+
+
+namespace wzann {
+    const double LbfgsTrainingAlgorithm::ARMIJO_PARAMETER = 1e-4;
+
+
+    LbfgsTrainingAlgorithm::LbfgsTrainingAlgorithm():
+            TrainingAlgorithm(),
+            m_historySize(DEFAULT_HISTORY_SIZE),
+            m_lineSearchSteps(DEFAULT_LINE_SEARCH_STEPS)
+    {
+    }
+
+
+    LbfgsTrainingAlgorithm::size_type LbfgsTrainingAlgorithm::historySize()
+            const
+    {
+        return m_historySize;
+    }
+
+
+    LbfgsTrainingAlgorithm& LbfgsTrainingAlgorithm::historySize(
+            size_type historySize)
+    {
+        m_historySize = historySize;
+        return *this;
+    }
+
+
+    LbfgsTrainingAlgorithm::size_type
+    LbfgsTrainingAlgorithm::lineSearchSteps() const
+    {
+        return m_lineSearchSteps;
+    }
+
+
+    LbfgsTrainingAlgorithm& LbfgsTrainingAlgorithm::lineSearchSteps(
+            size_type steps)
+    {
+        m_lineSearchSteps = steps;
+        return *this;
+    }
+
+
+    void LbfgsTrainingAlgorithm::direction(
+            Vector const& gradient,
+            size_type historyUsed,
+            size_type newest,
+            Vector& direction)
+    {
+        auto const W = gradient.size();
+        auto const m = m_rho.size();
+        direction = gradient;
+
+        if (0 == historyUsed) {
+            for (auto& d: direction) {
+                d = -d;
+            }
+
+            return;
+        }
+
+        // First loop, from the newest to the oldest epoch:
+
+        for (size_type k = 0; k != historyUsed; ++k) {
+            auto const row = (newest + m - k) % m;
+            double const* s = m_weightChanges.data() + row * W;
+            double const* y = m_gradientChanges.data() + row * W;
+            double alpha = 0.0;
+
+            for (size_type i = 0; i != W; ++i) {
+                alpha += s[i] * direction[i];
+            }
+
+            alpha *= m_rho[row];
+            m_alpha[row] = alpha;
+
+            for (size_type i = 0; i != W; ++i) {
+                direction[i] -= alpha * y[i];
+            }
+        }
+
+        // Scale by the curvature of the newest epoch:
+
+        {
+            double const* y = m_gradientChanges.data() + newest * W;
+            double yy = 0.0;
+
+            for (size_type i = 0; i != W; ++i) {
+                yy += y[i] * y[i];
+            }
+
+            auto const gamma = 1.0 / (m_rho[newest] * yy);
+
+            for (auto& d: direction) {
+                d *= gamma;
+            }
+        }
+
+        // Second loop, from the oldest to the newest epoch:
+
+        for (size_type k = historyUsed; k-- != 0; ) {
+            auto const row = (newest + m - k) % m;
+            double const* s = m_weightChanges.data() + row * W;
+            double const* y = m_gradientChanges.data() + row * W;
+            double beta = 0.0;
+
+            for (size_type i = 0; i != W; ++i) {
+                beta += y[i] * direction[i];
+            }
+
+            beta *= m_rho[row];
+
+            for (size_type i = 0; i != W; ++i) {
+                direction[i] += s[i] * (m_alpha[row] - beta);
+            }
+        }
+
+        for (auto& d: direction) {
+            d = -d;
+        }
+    }
+
+
+    void LbfgsTrainingAlgorithm::train(
+            NeuralNetwork& ann,
+            TrainingSet& trainingSet)
+    {
+        auto const W = ann.weights().size();
+        auto const m = std::max<size_type>(1, m_historySize);
+        auto const numSteps = std::max<size_type>(1, m_lineSearchSteps);
+
+        m_weightChanges.assign(m * W, 0.0);
+        m_gradientChanges.assign(m * W, 0.0);
+        m_rho.assign(m, 0.0);
+        m_alpha.assign(m, 0.0);
+
+        GradientEngine engine(ann);
+        Vector weights = ann.weights();
+        Vector gradient;
+        Vector trial(W);
+        Vector trialGradient;
+        Vector d;
+
+        double error = meanGradient(
+                ann,
+                trainingSet,
+                engine,
+                weights,
+                gradient);
+        size_t epochs = 0;
+        size_type historyUsed = 0;
+        size_type newest = m - 1;
+        bool stalled = false;
+
+        for (; epochs < trainingSet.maxEpochs()
+                    && error > trainingSet.targetError()
+                    && ! stalled;
+                ++epochs) {
+            direction(gradient, historyUsed, newest, d);
+
+            double slope = 0.0;
+
+            for (size_type i = 0; i != W; ++i) {
+                slope += gradient[i] * d[i];
+            }
+
+            if (! (slope < 0.0)) {
+                historyUsed = 0;
+                direction(gradient, historyUsed, newest, d);
+                slope = 0.0;
+
+                for (size_type i = 0; i != W; ++i) {
+                    slope += gradient[i] * d[i];
+                }
+
+                if (! (slope < 0.0)) {
+                    stalled = true;
+                    continue;
+                }
+            }
+
+            // Without a history, the direction is not scaled yet:
+
+            double step = (0 == historyUsed
+                    ? std::min(1.0, 1.0 / std::sqrt(-slope))
+                    : 1.0);
+            double trialError = error;
+            bool accepted = false;
+
+            for (size_type s = 0; s != numSteps; ++s) {
+                for (size_type i = 0; i != W; ++i) {
+                    trial[i] = weights[i] + step * d[i];
+                }
+
+                trialError = meanGradient(
+                        ann,
+                        trainingSet,
+                        engine,
+                        trial,
+                        trialGradient);
+
+                if (trialError <= error + ARMIJO_PARAMETER * step * slope) {
+                    accepted = true;
+                    break;
+                }
+
+                step /= 2.0;
+            }
+
+            if (! accepted) {
+                ann.weights(weights);
+                stalled = (0 == historyUsed);
+                historyUsed = 0;
+                continue;
+            }
+
+            // Remember the changes, provided that the curvature is
+            // positive, which keeps the approximation positive definite:
+
+            auto const row = (newest + 1) % m;
+            double* s = m_weightChanges.data() + row * W;
+            double* y = m_gradientChanges.data() + row * W;
+            double sy = 0.0;
+
+            for (size_type i = 0; i != W; ++i) {
+                s[i] = trial[i] - weights[i];
+                y[i] = trialGradient[i] - gradient[i];
+                sy += s[i] * y[i];
+            }
+
+            if (sy > std::numeric_limits<double>::epsilon()) {
+                m_rho[row] = 1.0 / sy;
+                newest = row;
+                historyUsed = std::min(historyUsed + 1, m);
+            }
+
+            weights.swap(trial);
+            gradient.swap(trialGradient);
+            error = trialError;
+        }
+
+        // Store final training results:
+
+        setFinalError(trainingSet, error);
+        setFinalNumEpochs(trainingSet, epochs);
+    }
+} // namespace wzann
+
+
+WZANN_REGISTER_CLASS(
+        wzann::LbfgsTrainingAlgorithm,
+        wzann::TrainingAlgorithm)
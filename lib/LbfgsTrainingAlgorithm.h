@@ -0,0 +1,148 @@
+#ifndef WZANN_LBFGSTRAININGALGORITHM_H_
+#define WZANN_LBFGSTRAININGALGORITHM_H_
+
+
+#include <cstddef>
+
+#include "Vector.h"
+#include "TrainingAlgorithm.h"
+
+
+namespace wzann {
+    class TrainingSet;
+    class NeuralNetwork;
+
+
+    /*!
+     * \brief Trains a neural network using the limited-memory BFGS
+     *  quasi-Newton method
+     *
+     * L-BFGS approximates the inverse Hessian of the error function from
+     * the weight and gradient changes of the last #historySize() epochs
+     * and descends along the resulting quasi-Newton direction. Each epoch
+     * uses the gradient of the whole training set.
+     *
+     * The step length is found by a backtracking line search that halves
+     * the step until the error decreases sufficiently (Armijo condition).
+     * Each trial step calculates the error and the gradient in the same
+     * pass, so that the gradient of the accepted step is reused for the
+     * next direction. Usually, the first trial is accepted, which makes
+     * an epoch cost one pass through the training set.
+     *
+     * If the line search fails, the history is discarded and the next
+     * epoch starts with the steepest descent; if that fails, too, the
+     * training stops.
+     *
+     * All state is kept in flat arrays in the order of
+     * NeuralNetwork::weights(). Fixed weights have a gradient of zero and
+     * remain unchanged.
+     */
+    class LbfgsTrainingAlgorithm : public TrainingAlgorithm
+    {
+    public:
+
+
+        typedef std::size_t size_type;
+
+
+        const size_type DEFAULT_HISTORY_SIZE = 10;
+
+
+        const size_type DEFAULT_LINE_SEARCH_STEPS = 20;
+
+
+        //! \brief Sufficient decrease parameter of the Armijo condition
+        static const double ARMIJO_PARAMETER;
+
+
+        //! \brief Creates a new training algorithm instance
+        LbfgsTrainingAlgorithm();
+
+
+        //! \return The number of epochs whose changes are remembered
+        size_type historySize() const;
+
+
+        /*!
+         * \brief Sets the number of weight and gradient changes used to
+         *  approximate the inverse Hessian
+         *
+         * \param[in] historySize The number of epochs, at least `1`
+         *
+         * \return `*this`
+         */
+        LbfgsTrainingAlgorithm& historySize(size_type historySize);
+
+
+        //! \return The maximum number of trial steps per epoch
+        size_type lineSearchSteps() const;
+
+
+        /*!
+         * \brief Sets the maximum number of trial steps of the line search
+         *
+         * \param[in] steps The number of trial steps, at least `1`
+         *
+         * \return `*this`
+         */
+        LbfgsTrainingAlgorithm& lineSearchSteps(size_type steps);
+
+
+        /*!
+         * \brief Trains the neural network with the given trainingSet.
+         *
+         * \param[in] trainingSet A set of sample inputs and expected
+         *  outputs.
+         */
+        virtual void train(NeuralNetwork& ann, TrainingSet& trainingSet)
+                override;
+
+
+    private:
+
+
+        /*!
+         * \brief Calculates the quasi-Newton direction with the two-loop
+         *  recursion
+         *
+         * \param[in] gradient The current gradient
+         *
+         * \param[in] historyUsed The number of remembered epochs
+         *
+         * \param[in] newest The index of the newest remembered epoch
+         *
+         * \param[out] direction Receives the direction
+         */
+        void direction(
+                Vector const& gradient,
+                size_type historyUsed,
+                size_type newest,
+                Vector& direction);
+
+
+        //! \brief The number of epochs whose changes are remembered
+        size_type m_historySize;
+
+
+        //! \brief The maximum number of trial steps per epoch
+        size_type m_lineSearchSteps;
+
+
+        //! \brief The weight changes, one row per remembered epoch
+        Vector m_weightChanges;
+
+
+        //! \brief The gradient changes, one row per remembered epoch
+        Vector m_gradientChanges;
+
+
+        //! \brief The reciprocal curvature of each remembered epoch
+        Vector m_rho;
+
+
+        //! \brief Scratch space of the two-loop recursion
+        Vector m_alpha;
+    };
+} // namespace wzann
+
+#endif // WZANN_LBFGSTRAININGALGORITHM_H_
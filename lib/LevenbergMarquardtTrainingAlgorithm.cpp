@@ -0,0 +1,460 @@
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+#include <boost/range.hpp>
+
+#include "Layer.h"
+#include "Neuron.h"
+#include "TrainingItem.h"
+#include "ClassRegistry.h"
+#include "NeuralNetwork.h"
+#include "InferencePlan.h"
+#include "InferenceContext.h"
+#include "ActivationFunction.h"
+#include "GradientAnalysisHelper.h"
+
+#include "LevenbergMarquardtTrainingAlgorithm.h"
+
+
+using boost::make_iterator_range;
+
+
+namespace wzann {
+    const LevenbergMarquardtTrainingAlgorithm::size_type
+            LevenbergMarquardtTrainingAlgorithm::BLOCK_SIZE;
+
+
+    LevenbergMarquardtTrainingAlgorithm::
+            LevenbergMarquardtTrainingAlgorithm():
+                TrainingAlgorithm(),
+                m_damping(DEFAULT_DAMPING),
+                m_dampingFactor(DEFAULT_DAMPING_FACTOR),
+                m_maxDamping(DEFAULT_MAX_DAMPING),
+                m_numParameters(0)
+    {
+    }
+
+
+    double LevenbergMarquardtTrainingAlgorithm::damping() const
+    {
+        return m_damping;
+    }
+
+
+    LevenbergMarquardtTrainingAlgorithm&
+    LevenbergMarquardtTrainingAlgorithm::damping(double damping)
+    {
+        m_damping = damping;
+        return *this;
+    }
+
+
+    double LevenbergMarquardtTrainingAlgorithm::dampingFactor() const
+    {
+        return m_dampingFactor;
+    }
+
+
+    LevenbergMarquardtTrainingAlgorithm&
+    LevenbergMarquardtTrainingAlgorithm::dampingFactor(double factor)
+    {
+        m_dampingFactor = factor;
+        return *this;
+    }
+
+
+    double LevenbergMarquardtTrainingAlgorithm::maxDamping() const
+    {
+        return m_maxDamping;
+    }
+
+
+    LevenbergMarquardtTrainingAlgorithm&
+    LevenbergMarquardtTrainingAlgorithm::maxDamping(double maxDamping)
+    {
+        m_maxDamping = maxDamping;
+        return *this;
+    }
+
+
+    bool LevenbergMarquardtTrainingAlgorithm::solve(
+            Vector& matrix,
+            Vector& rhs,
+            size_type n)
+    {
+        // Decompose the matrix into L * L^T, row by row:
+
+        for (size_type j = 0; j != n; ++j) {
+            double* lj = matrix.data() + j * n;
+            double s = lj[j];
+
+            for (size_type k = 0; k != j; ++k) {
+                s -= lj[k] * lj[k];
+            }
+
+            if (! (s > 0.0)) {
+                return false;
+            }
+
+            lj[j] = std::sqrt(s);
+
+            for (size_type i = j + 1; i != n; ++i) {
+                double* li = matrix.data() + i * n;
+                double v = li[j];
+
+                for (size_type k = 0; k != j; ++k) {
+                    v -= li[k] * lj[k];
+                }
+
+                li[j] = v / lj[j];
+            }
+        }
+
+        // Solve L * y = rhs, then L^T * x = y:
+
+        for (size_type i = 0; i != n; ++i) {
+            double const* li = matrix.data() + i * n;
+            double v = rhs[i];
+
+            for (size_type k = 0; k != i; ++k) {
+                v -= li[k] * rhs[k];
+            }
+
+            rhs[i] = v / li[i];
+        }
+
+        for (size_type i = n; i-- != 0; ) {
+            double v = rhs[i];
+
+            for (size_type k = i + 1; k != n; ++k) {
+                v -= matrix[k * n + i] * rhs[k];
+            }
+
+            rhs[i] = v / matrix[i * n + i];
+        }
+
+        return true;
+    }
+
+
+    double LevenbergMarquardtTrainingAlgorithm::accumulate(
+            NeuralNetwork const& ann,
+            TrainingSet::TrainingItems const& items,
+            InferenceContext const& initialContext)
+    {
+        auto const P = m_numParameters;
+        auto const numLayers = m_inputs.size();
+        auto const outputSize = ann[numLayers - 1].size();
+
+        m_hessian.assign(P * P, 0.0);
+        m_gradient.assign(P, 0.0);
+
+        InferenceContext context(initialContext);
+        Vector output;
+        double error = 0.0;
+        size_type numItems = 0;
+        size_type blockUsed = 0;
+
+        for (auto const& item: items) {
+            ann.calculate(item.input(), output, context);
+
+            if (! item.outputRelevant()) {
+                continue;
+            }
+
+            // Remember the state of all layers and the output errors:
+
+            for (size_type i = 0; i != numLayers; ++i) {
+                auto const offset = blockUsed * ann[i].size();
+                auto const& inputs = context.layerInputs(i);
+                auto const& results = context.layerOutputs(i);
+
+                std::copy(
+                        inputs.begin(),
+                        inputs.end(),
+                        m_inputs[i].begin() + offset);
+                std::copy(
+                        results.begin(),
+                        results.end(),
+                        m_results[i].begin() + offset);
+            }
+
+            auto const expected = item.expectedOutput();
+            error += GradientAnalysisHelper::errors(
+                    make_iterator_range(output.cbegin(), output.cend()),
+                    make_iterator_range(expected.cbegin(), expected.cend()),
+                    m_errors.data() + blockUsed * outputSize);
+            m_numErrors[blockUsed] = std::min(expected.size(), outputSize);
+            ++numItems;
+
+            if (++blockUsed == BLOCK_SIZE) {
+                accumulateBlock(ann, blockUsed);
+                blockUsed = 0;
+            }
+        }
+
+        if (0 != blockUsed) {
+            accumulateBlock(ann, blockUsed);
+        }
+
+        return error / numItems;
+    }
+
+
+    void LevenbergMarquardtTrainingAlgorithm::accumulateBlock(
+            NeuralNetwork const& ann,
+            size_type numItems)
+    {
+        auto const& plan = ann.compile();
+        auto const& transitions = plan.transitions();
+        auto const P = m_numParameters;
+        auto const numLayers = plan.size();
+        auto const outputSize = plan.layerSize(numLayers - 1);
+        auto const numRows = numItems * outputSize;
+
+        // Each Jacobian row belongs to one output of one item. Its deltas
+        // are those of a backward pass that starts with a unit error at
+        // this output:
+
+        for (size_type l = numLayers; l-- != 0; ) {
+            auto const& layer = ann[l];
+            auto const size = layer.size();
+            auto& deltas = m_deltas[l];
+            auto const& inputs = m_inputs[l];
+
+            std::fill(deltas.begin(), deltas.begin() + numRows * size, 0.0);
+
+            if (l == numLayers - 1) {
+                for (size_type row = 0; row != numRows; ++row) {
+                    auto const k = row % outputSize;
+
+                    if (k < m_numErrors[row / outputSize]) {
+                        deltas[row * size + k] = 1.0;
+                    }
+                }
+            } else {
+                for (auto const& t: transitions) {
+                    if (t.from != l || t.to <= l) {
+                        continue;
+                    }
+
+                    for (size_type row = 0; row != numRows; ++row) {
+                        double const* next =
+                                m_deltas[t.to].data() + row * t.rows;
+                        double* sum = deltas.data() + row * size;
+
+                        for (size_type r = 0; r != t.rows; ++r) {
+                            double const d = next[r];
+
+                            if (0.0 == d) {
+                                continue;
+                            }
+
+                            double const* w =
+                                    t.weights.data() + r * t.columns;
+
+                            for (size_type c = 0; c != t.columns; ++c) {
+                                sum[c] += w[c] * d;
+                            }
+                        }
+                    }
+                }
+            }
+
+            for (size_type i = 0; i != size; ++i) {
+                auto const f = layer[i].activationFunction();
+
+                for (size_type row = 0; row != numRows; ++row) {
+                    auto const n = row / outputSize;
+                    deltas[row * size + i] *= calculateDerivative(
+                            f,
+                            inputs[n * size + i]);
+                }
+            }
+        }
+
+        // Build the rows of the Jacobian and add them to J^T J and J^T e:
+
+        auto const biasOutput = ann.biasOutput();
+        m_jacobian.assign(P, 0.0);
+
+        for (size_type row = 0; row != numRows; ++row) {
+            auto const n = row / outputSize;
+            auto const k = row % outputSize;
+
+            if (k >= m_numErrors[n]) {
+                continue;
+            }
+
+            double* jacobian = m_jacobian.data();
+
+            for (auto const& slot: plan.slots()) {
+                auto const column = m_columns[slot.weight];
+
+                if (column < 0) {
+                    continue;
+                }
+
+                auto const& t = transitions[slot.transition];
+                auto const r = slot.offset / t.columns;
+                auto const c = slot.offset % t.columns;
+                jacobian[column] = m_deltas[t.to][row * t.rows + r]
+                        * m_results[t.from][n * t.columns + c];
+            }
+
+            for (auto const& slot: plan.biasSlots()) {
+                auto const column = m_columns[slot.weight];
+
+                if (column < 0) {
+                    continue;
+                }
+
+                auto const size = plan.layerSize(slot.layer);
+                jacobian[column] = biasOutput
+                        * m_deltas[slot.layer][row * size + slot.neuron];
+            }
+
+            auto const e = m_errors[n * outputSize + k];
+
+            for (size_type i = 0; i != P; ++i) {
+                auto const a = jacobian[i];
+
+                if (0.0 == a) {
+                    continue;
+                }
+
+                double* h = m_hessian.data() + i * P;
+
+                for (size_type j = 0; j <= i; ++j) {
+                    h[j] += a * jacobian[j];
+                }
+
+                m_gradient[i] += a * e;
+            }
+        }
+    }
+
+
+    void LevenbergMarquardtTrainingAlgorithm::train(
+            NeuralNetwork& ann,
+            TrainingSet& trainingSet)
+    {
+        auto const& plan = ann.compile();
+        auto const& fixed = ann.fixedWeights();
+        auto const numLayers = plan.size();
+        auto const outputSize = plan.layerSize(numLayers - 1);
+
+        // Each trainable weight is one column of the Jacobian. Later
+        // connections from the bias neuron to the same neuron have no
+        // effect on the output, so they are left out like fixed ones:
+
+        std::vector<char> excluded(fixed.begin(), fixed.end());
+
+        for (auto const& slot: plan.biasSlots()) {
+            if (! plan.isBiasEntry(slot)) {
+                excluded[slot.weight] = 1;
+            }
+        }
+
+        m_columns.assign(fixed.size(), -1);
+        m_numParameters = 0;
+
+        for (Vector::size_type i = 0; i != excluded.size(); ++i) {
+            if (! excluded[i]) {
+                m_columns[i] = static_cast<std::ptrdiff_t>(
+                        m_numParameters++);
+            }
+        }
+
+        auto const P = m_numParameters;
+
+        m_inputs.resize(numLayers);
+        m_results.resize(numLayers);
+        m_deltas.resize(numLayers);
+
+        for (size_type i = 0; i != numLayers; ++i) {
+            auto const size = plan.layerSize(i);
+            m_inputs[i].assign(BLOCK_SIZE * size, 0.0);
+            m_results[i].assign(BLOCK_SIZE * size, 0.0);
+            m_deltas[i].assign(BLOCK_SIZE * outputSize * size, 0.0);
+        }
+
+        m_errors.assign(BLOCK_SIZE * outputSize, 0.0);
+        m_numErrors.assign(BLOCK_SIZE, 0);
+
+        // Recurrent networks start each pass from the same state:
+
+        InferenceContext const initialContext(ann);
+        auto const& items = trainingSet.trainingItems;
+
+        size_t epochs = 0;
+        double error = std::numeric_limits<double>::max();
+        double damping = m_damping;
+        bool stalled = (0 == P);
+
+        for (; epochs < trainingSet.maxEpochs()
+                    && error > trainingSet.targetError()
+                    && ! stalled;
+                ++epochs) {
+            auto const currentError = accumulate(ann, items, initialContext);
+            error = currentError;
+
+            // Raise the damping until a step reduces the error:
+
+            for (;;) {
+                if (damping > m_maxDamping) {
+                    stalled = true;
+                    break;
+                }
+
+                m_system = m_hessian;
+                m_step = m_gradient;
+
+                for (size_type i = 0; i != P; ++i) {
+                    m_system[i * P + i] += damping;
+                }
+
+                if (! solve(m_system, m_step, P)) {
+                    damping *= m_dampingFactor;
+                    continue;
+                }
+
+                m_weights = ann.weights();
+
+                for (Vector::size_type i = 0; i != m_weights.size(); ++i) {
+                    if (m_columns[i] >= 0) {
+                        m_weights[i] -= m_step[m_columns[i]];
+                    }
+                }
+
+                ann.swapWeights(m_weights);
+                auto const trialError = TrainingAlgorithm::meanError(
+                        ann,
+                        trainingSet,
+                        initialContext);
+
+                if (trialError < currentError) {
+                    error = trialError;
+                    damping /= m_dampingFactor;
+                    break;
+                }
+
+                // Revert the step:
+
+                ann.swapWeights(m_weights);
+                damping *= m_dampingFactor;
+            }
+        }
+
+        // Store final training results:
+
+        setFinalError(trainingSet, error);
+        setFinalNumEpochs(trainingSet, epochs);
+    }
+} // namespace wzann
+
+
+WZANN_REGISTER_CLASS(
+        wzann::LevenbergMarquardtTrainingAlgorithm,
+        wzann::TrainingAlgorithm)
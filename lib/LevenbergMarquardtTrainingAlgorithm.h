@@ -0,0 +1,233 @@
+#ifndef WZANN_LEVENBERGMARQUARDTTRAININGALGORITHM_H_
+#define WZANN_LEVENBERGMARQUARDTTRAININGALGORITHM_H_
+
+
+#include <vector>
+#include <cstddef>
+
+#include "Vector.h"
+#include "TrainingSet.h"
+#include "TrainingAlgorithm.h"
+
+
+namespace wzann {
+    class NeuralNetwork;
+    class InferenceContext;
+
+
+    /*!
+     * \brief Trains a neural network using the Levenberg-Marquardt
+     *  algorithm
+     *
+     * Levenberg-Marquardt minimizes the sum of squared errors by solving
+     * the damped normal equations
+     * \f$(J^T J + \mu I)\,\delta = -J^T e\f$
+     * in each epoch, where \f$J\f$ is the Jacobian of the errors of all
+     * outputs for all training items with respect to the trainable
+     * weights, and \f$e\f$ are these errors. A small damping \f$\mu\f$
+     * gives a Gauss-Newton step, a large one a short step along the
+     * gradient. The damping is lowered after each step that reduces the
+     * error, and raised until a step does. If no step reduces the error
+     * even at the #maxDamping(), the training stops.
+     *
+     * The Jacobian is calculated for blocks of #BLOCK_SIZE items at a
+     * time: The outputs of all items of a block are propagated backwards
+     * together, using the weight matrices of the network's InferencePlan,
+     * and the block's rows are added to \f$J^T J\f$ and \f$J^T e\f$
+     * right away, so that the whole Jacobian is never stored. Fixed
+     * weights are not part of the Jacobian and remain unchanged. Just
+     * like in GradientEngine, connections that lead to the same or to an
+     * earlier layer do not propagate any error.
+     *
+     * The algorithm keeps a matrix of the squared number of trainable
+     * weights, which makes it suitable for networks with up to a few
+     * thousand weights.
+     */
+    class LevenbergMarquardtTrainingAlgorithm : public TrainingAlgorithm
+    {
+    public:
+
+
+        typedef std::size_t size_type;
+
+
+        //! \brief The number of items whose Jacobian rows are built together
+        static const size_type BLOCK_SIZE = 16;
+
+
+        const double DEFAULT_DAMPING = 1e-3;
+
+
+        const double DEFAULT_DAMPING_FACTOR = 10.0;
+
+
+        const double DEFAULT_MAX_DAMPING = 1e10;
+
+
+        //! \brief Creates a new training algorithm instance
+        LevenbergMarquardtTrainingAlgorithm();
+
+
+        //! \return The damping at the start of the training
+        double damping() const;
+
+
+        /*!
+         * \brief Sets the damping at the start of the training
+         *
+         * \param[in] damping The initial damping, greater than `0.0`
+         *
+         * \return `*this`
+         */
+        LevenbergMarquardtTrainingAlgorithm& damping(double damping);
+
+
+        //! \return The factor by which the damping is raised or lowered
+        double dampingFactor() const;
+
+
+        /*!
+         * \brief Sets the factor by which the damping is raised after a
+         *  failed step and lowered after a successful one
+         *
+         * \param[in] factor The factor, greater than `1.0`
+         *
+         * \return `*this`
+         */
+        LevenbergMarquardtTrainingAlgorithm& dampingFactor(double factor);
+
+
+        //! \return The damping at which the training gives up
+        double maxDamping() const;
+
+
+        /*!
+         * \brief Sets the damping above which the training stops
+         *
+         * \param[in] maxDamping The maximum damping
+         *
+         * \return `*this`
+         */
+        LevenbergMarquardtTrainingAlgorithm& maxDamping(double maxDamping);
+
+
+        /*!
+         * \brief Trains the neural network with the given trainingSet.
+         *
+         * \param[in] trainingSet A set of sample inputs and expected
+         *  outputs.
+         */
+        virtual void train(NeuralNetwork& ann, TrainingSet& trainingSet)
+                override;
+
+
+    private:
+
+
+        /*!
+         * \brief Calculates \f$J^T J\f$ and \f$J^T e\f$ for the network's
+         *  current weights
+         *
+         * \param[in] ann The network
+         *
+         * \param[in] items The training items
+         *
+         * \param[in] initialContext The state each pass starts from
+         *
+         * \return The mean error of the network
+         */
+        double accumulate(
+                NeuralNetwork const& ann,
+                TrainingSet::TrainingItems const& items,
+                InferenceContext const& initialContext);
+
+
+        //! \brief Adds the Jacobian rows of the pending block
+        void accumulateBlock(NeuralNetwork const& ann, size_type numItems);
+
+
+        /*!
+         * \brief Solves a symmetric positive definite system of linear
+         *  equations using the Cholesky decomposition
+         *
+         * \param[inout] matrix The lower triangle of the row-major
+         *  `n * n` system matrix; receives its Cholesky factor
+         *
+         * \param[inout] rhs The right-hand side; receives the solution
+         *
+         * \param[in] n The number of equations
+         *
+         * \return `false` if the matrix is not positive definite
+         */
+        static bool solve(Vector& matrix, Vector& rhs, size_type n);
+
+
+        //! \brief The damping at the start of the training
+        double m_damping;
+
+
+        //! \brief The factor by which the damping is raised or lowered
+        double m_dampingFactor;
+
+
+        //! \brief The damping at which the training gives up
+        double m_maxDamping;
+
+
+        /*!
+         * \brief The Jacobian column of each weight, or -1 if it is fixed
+         *  or does not affect the output
+         */
+        std::vector<std::ptrdiff_t> m_columns;
+
+
+        //! \brief The number of trainable weights
+        size_type m_numParameters;
+
+
+        //! \brief The inputs of each layer, one row per item of the block
+        std::vector<Vector> m_inputs;
+
+
+        //! \brief The results of each layer, one row per item of the block
+        std::vector<Vector> m_results;
+
+
+        //! \brief The output errors, one row per item of the block
+        Vector m_errors;
+
+
+        //! \brief The number of outputs with an error, per item
+        std::vector<size_type> m_numErrors;
+
+
+        //! \brief The deltas of each layer, one row per Jacobian row
+        std::vector<Vector> m_deltas;
+
+
+        //! \brief The Jacobian rows of the pending block
+        Vector m_jacobian;
+
+
+        //! \brief The lower triangle of \f$J^T J\f$
+        Vector m_hessian;
+
+
+        //! \brief \f$J^T e\f$
+        Vector m_gradient;
+
+
+        //! \brief The damped system of the current step
+        Vector m_system;
+
+
+        //! \brief The current step
+        Vector m_step;
+
+
+        //! \brief The weights of the current trial
+        Vector m_weights;
+    };
+} // namespace wzann
+
+#endif // WZANN_LEVENBERGMARQUARDTTRAININGALGORITHM_H_
@@ -0,0 +1,82 @@
+#include <limits>
+#include <cstddef>
+#include <algorithm>
+
+#include "Vector.h"
+#include "TrainingSet.h"
+#include "NeuralNetwork.h"
+#include "GradientEngine.h"
+
+#include "MiniBatchTrainingAlgorithm.h"
+
+
+namespace wzann {
+    void MiniBatchTrainingAlgorithm::train(
+            NeuralNetwork& ann,
+            TrainingSet& trainingSet)
+    {
+        // Initialize the state variables:
+
+        size_t epochs = 0;
+        double error = std::numeric_limits<double>::max();
+        GradientEngine gradientEngine(ann);
+        Vector weights;
+        Vector meanGradient;
+
+        reset(ann.weights().size());
+
+        auto const& items = trainingSet.trainingItems;
+        auto const batch = (0 == batchSize() ? items.size() : batchSize());
+
+        for(; epochs < trainingSet.maxEpochs()
+                    && error > trainingSet.targetError();
+                ++epochs) {
+            error = 0.0;
+            size_t numRelevantItems = 0;
+
+            for (auto first = items.begin(); first != items.end(); ) {
+                auto last = first + std::min<std::ptrdiff_t>(
+                        batch,
+                        items.end() - first);
+
+                // Feed the batch forward and compare the network's output
+                // with the ideal teaching output; then propagate the error
+                // backwards:
+
+                gradientEngine.clear();
+                error += gradientEngine.accumulate(first, last);
+                first = last;
+
+                if (0 == gradientEngine.numItems()) {
+                    continue;
+                }
+
+                numRelevantItems += gradientEngine.numItems();
+
+                // Apply the mean gradient of the batch:
+
+                auto const& gradient = gradientEngine.gradient();
+                auto const n = static_cast<double>(
+                        gradientEngine.numItems());
+                meanGradient.resize(gradient.size());
+
+                for (Vector::size_type i = 0; i != gradient.size(); ++i) {
+                    meanGradient[i] = gradient[i] / n;
+                }
+
+                weights = ann.weights();
+                update(weights, meanGradient, ann.fixedWeights());
+                ann.swapWeights(weights);
+            }
+
+            // It's called MEAN square error for a reason:
+
+            error /= numRelevantItems;
+        }
+
+        // Store final training results:
+
+        setFinalError(trainingSet, error);
+        setFinalNumEpochs(trainingSet, epochs);
+    }
+} // namespace wzann
@@ -0,0 +1,83 @@
+#ifndef WZANN_MINIBATCHTRAININGALGORITHM_H_
+#define WZANN_MINIBATCHTRAININGALGORITHM_H_
+
+
+#include <vector>
+#include <cstddef>
+
+#include "Vector.h"
+#include "TrainingAlgorithm.h"
+
+
+namespace wzann {
+    class TrainingSet;
+    class NeuralNetwork;
+
+
+    /*!
+     * \brief Base class of the first-order training algorithms that
+     *  update the weights once per batch of training items
+     *
+     * In each epoch, the training set is split into consecutive batches
+     * of #batchSize() items. The gradient of a batch is averaged over its
+     * relevant items and handed to #update(), which applies the step rule
+     * of the derived class. The error of the epoch is the mean error of
+     * all relevant items, as calculated during the epoch.
+     *
+     * Fixed weights have a gradient of zero, so a step rule that only
+     * scales the gradient leaves them unchanged.
+     *
+     * \sa BackpropagationTrainingAlgorithm
+     *
+     * \sa AdaptiveGradientTrainingAlgorithm
+     */
+    class MiniBatchTrainingAlgorithm : public TrainingAlgorithm
+    {
+    public:
+
+
+        /*!
+         * \return The number of training items per weight update: `1`
+         *  for online learning, `0` for the whole training set
+         */
+        virtual std::size_t batchSize() const = 0;
+
+
+        /*!
+         * \brief Trains the neural network with the given trainingSet.
+         *
+         * \param[in] trainingSet A set of sample inputs and expected
+         *  outputs.
+         */
+        virtual void train(NeuralNetwork& ann, TrainingSet& trainingSet)
+                override;
+
+
+    protected:
+
+
+        /*!
+         * \brief Discards all per-weight state at the start of a training
+         *
+         * \param[in] numWeights The number of the network's weights
+         */
+        virtual void reset(Vector::size_type numWeights) = 0;
+
+
+        /*!
+         * \brief Applies one step to the weights
+         *
+         * \param[inout] weights The weights of the network
+         *
+         * \param[in] gradient The mean gradient of the last batch
+         *
+         * \param[in] fixedWeights Whether each weight is fixed
+         */
+        virtual void update(
+                Vector& weights,
+                Vector const& gradient,
+                std::vector<char> const& fixedWeights) = 0;
+    };
+} // namespace wzann
+
+#endif // WZANN_MINIBATCHTRAININGALGORITHM_H_
@@ -1,6 +1,8 @@
+#include <mutex>
 #include <memory>
 #include <vector>
 #include <cstddef>
+#include <cassert>
 #include <algorithm>
 #include <unordered_map>
 
@@ -13,6 +15,8 @@
 #include "Layer.h"
 #include "Neuron.h"
 #include "Connection.h"
+#include "InferencePlan.h"
+#include "InferenceContext.h"
 #include "ActivationFunction.h"
 #include "NeuralNetworkPattern.h"
 #include "NoConnectionException.h"
@@ -23,7 +27,6 @@
 #include "WzannGlobal.h"
 
 
-using std::make_pair;
 using boost::make_iterator_range;
 
 
@@ -49,70 +52,28 @@ namespace wzann {
 
         // Clone connections. We have already cloned the neurons, which
         // means that we cannot simply clone all connections because we'd
-        // end up with pointers to the original. Instead, we need to map
-        // via the index in the layer and create connections of our own:
-
-        for (auto connectionSources: rhs.m_connectionSources) {
-            auto foreignNeuron = connectionSources.first;
-
-            ConnectionPtrConstRange connections;
-            int srcLayerIndex   = -1;
-            int srcNeuronIndex  = -1;
-
-            if (&(rhs.biasNeuron()) == foreignNeuron) {
-                connections = rhs.connectionsFrom(*foreignNeuron);
-            } else {
-                // First, find the index of the source neuron:
-
-                for (size_type i = 0; i != rhs.size(); ++i) {
-                    if (! rhs[i].contains(*foreignNeuron)) {
-                        continue;
-                    }
-
-                    srcLayerIndex = i;
-                    srcNeuronIndex = rhs[i].indexOf(*foreignNeuron);
-                    break;
-                }
-
-                assert(srcLayerIndex >= 0 && srcNeuronIndex >= 0);
+        // end up with pointers to the original. Instead, we map each
+        // neuron via the index of its layer and its index in the layer.
+        // Both are known without searching, so that copying all
+        // connections takes linear time:
+
+        std::unordered_map<Layer const*, size_type> layerIndexes;
+        for (size_type i = 0; i != rhs.size(); ++i) {
+            layerIndexes.emplace(&(rhs[i]), i);
+        }
 
-                connections = rhs.connectionsFrom(*foreignNeuron);
+        m_connections.assign(
+                rhs.m_connections,
+                [this, &rhs, &layerIndexes](Neuron const& foreignNeuron)
+                -> Neuron& {
+            if (&(rhs.biasNeuron()) == &foreignNeuron) {
+                return biasNeuron();
             }
 
-            assert(connections.second-connections.first > 0);
-
-            // Find the index of the destination neurons and re-create:
-
-            for (Connection *c: make_iterator_range(connections)) {
-                int dstLayerIndex = -1;
-                int dstNeuronIndex = -1;
-
-                for (size_type i = 0; i != rhs.size(); ++i) {
-                    if (!rhs[i].contains(c->destination())) {
-                        continue;
-                    }
-
-                    dstLayerIndex = i;
-                    dstNeuronIndex = rhs[i].indexOf(c->destination());
-                    break;
-                }
-
-                assert(dstLayerIndex >= 0 && dstNeuronIndex >= 0);
-
-                // Now, re-create the connection here:
-
-                auto &srcNeuron = (&(rhs.biasNeuron()) == foreignNeuron
-                        ? biasNeuron()
-                        : (*this)[srcLayerIndex][srcNeuronIndex]);
-                auto &dstNeuron = (*this)[dstLayerIndex][dstNeuronIndex];
-
-                auto &newConnection = connectNeurons(
-                        srcNeuron,
-                        dstNeuron);
-                newConnection.weight(c->weight());
-                newConnection.fixedWeight(c->fixedWeight());
-            }
-        }
+            auto const* layer = foreignNeuron.parent();
+            return (*this)[layerIndexes.at(layer)][
+                    layer->indexOf(foreignNeuron)];
+        });
 
         // Make sure the cloned pattern has the correct parent object:
 
@@ -124,9 +85,6 @@ namespace wzann {
 
     NeuralNetwork::~NeuralNetwork()
     {
-        for (auto* c: m_connections) {
-            delete c;
-        }
     }
 
 
@@ -148,6 +106,12 @@ namespace wzann {
     }
 
 
+    double NeuralNetwork::biasOutput() const
+    {
+        return wzann::calculate(m_biasNeuron->activationFunction(), 1.0);
+    }
+
+
     bool NeuralNetwork::contains(Neuron const& neuron) const
     {
         if (&(biasNeuron()) == &neuron) {
@@ -166,10 +130,10 @@ namespace wzann {
             Neuron const& to)
             const
     {
-        auto it = m_connectionSources.find(const_cast<Neuron*>(&from));
-        return it != m_connectionSources.end() && std::any_of(
-                it->second.begin(),
-                it->second.end(),
+        auto connections = connectionsFrom(from);
+        return std::any_of(
+                connections.first,
+                connections.second,
                 [&to](Connection const* const& c) {
             return &(c->destination()) == &to;
         });
@@ -200,86 +164,113 @@ namespace wzann {
 
     NeuralNetwork::ConnectionPtrRange NeuralNetwork::connections()
     {
-        return make_pair(m_connections.begin(), m_connections.end());
+        return m_connections.all();
     }
 
 
     NeuralNetwork::ConnectionPtrConstRange NeuralNetwork::connections()
             const
     {
-        return make_pair(m_connections.cbegin(), m_connections.cend());
+        return m_connections.all();
     }
 
 
     NeuralNetwork::ConnectionPtrConstRange
     NeuralNetwork::connectionsFrom(Neuron const& neuron) const
     {
-        auto *n = const_cast<Neuron *>(&neuron);
-        auto it = m_connectionSources.find(n);
-
-        if (m_connectionSources.end() == it) {
-            return make_pair(
-                    ConnectionPtrConstIterator(),
-                    ConnectionPtrConstIterator());
-        } else {
-            return std::make_pair(
-                    m_connectionSources.at(n).begin(),
-                    m_connectionSources.at(n).end());
-        }
+        return m_connections.from(neuron);
     }
 
 
     NeuralNetwork::ConnectionPtrRange
     NeuralNetwork::connectionsFrom(Neuron const& neuron)
     {
-        auto *n = const_cast<Neuron *>(&neuron);
-        auto it = m_connectionSources.find(n);
-
-        if (m_connectionSources.end() == it) {
-            return make_pair(
-                    ConnectionPtrIterator(),
-                    ConnectionPtrIterator());
-        } else {
-            return std::make_pair(
-                    m_connectionSources.at(n).begin(),
-                    m_connectionSources.at(n).end());
-        }
+        return m_connections.from(neuron);
     }
 
 
     NeuralNetwork::ConnectionPtrConstRange
     NeuralNetwork::connectionsTo(Neuron const& neuron) const
     {
-        auto* n = const_cast<Neuron*>(&neuron);
-        auto it = m_connectionDestinations.find(n);
-
-        if (m_connectionDestinations.end() == it) {
-            return make_pair(
-                    ConnectionPtrConstIterator(),
-                    ConnectionPtrConstIterator());
-        } else {
-            return std::make_pair(
-                    m_connectionDestinations.at(n).begin(),
-                    m_connectionDestinations.at(n).end());
-        }
-   }
+        return m_connections.to(neuron);
+    }
 
 
     NeuralNetwork::ConnectionPtrRange
     NeuralNetwork::connectionsTo(const Neuron &neuron)
     {
-        auto *n = const_cast<Neuron *>(&neuron);
-        auto it = m_connectionDestinations.find(n);
+        return m_connections.to(neuron);
+    }
 
-        if (m_connectionDestinations.end() == it) {
-            return make_pair(
-                    ConnectionPtrIterator(),
-                    ConnectionPtrIterator());
-        } else {
-            return std::make_pair(
-                    m_connectionDestinations.at(n).begin(),
-                    m_connectionDestinations.at(n).end());
+
+    Vector const& NeuralNetwork::weights() const
+    {
+        return m_connections.weights();
+    }
+
+
+    NeuralNetwork& NeuralNetwork::weights(Vector const& weights)
+    {
+        assert(weights.size() == m_connections.size());
+
+        auto& w = m_connections.weights();
+        std::copy(weights.begin(), weights.end(), w.begin());
+        m_plan.invalidateWeights();
+
+        return *this;
+    }
+
+
+    void NeuralNetwork::swapWeights(Vector& weights)
+    {
+        assert(weights.size() == m_connections.size());
+
+        m_connections.weights().swap(weights);
+        m_plan.invalidateWeights();
+    }
+
+
+    std::vector<char> const& NeuralNetwork::fixedWeights() const
+    {
+        return m_connections.fixedWeights();
+    }
+
+
+    Vector NeuralNetwork::trainableWeights() const
+    {
+        auto const& w = m_connections.weights();
+        auto const& fixed = m_connections.fixedWeights();
+
+        Vector result;
+        result.reserve(w.size());
+
+        for (size_type i = 0; i != w.size(); ++i) {
+            if (! fixed[i]) {
+                result.push_back(w[i]);
+            }
+        }
+
+        return result;
+    }
+
+
+    NeuralNetwork& NeuralNetwork::trainableWeights(Vector const& weights)
+    {
+        auto& w = m_connections.weights();
+        auto const& fixed = m_connections.fixedWeights();
+        auto it = weights.begin();
+
+        for (size_type i = 0; i != w.size(); ++i) {
+            if (! fixed[i]) {
+                assert(it != weights.end());
+                w[i] = *it++;
+            }
         }
+
+        assert(it == weights.end());
+        m_plan.invalidateWeights();
+
+        return *this;
     }
 
 
@@ -298,12 +289,16 @@ namespace wzann {
         Neuron& src = const_cast<Neuron&>(from),
                 &dst = const_cast<Neuron&>(to);
 
-        auto* connection = new Connection(src, dst, 0.0);
+        auto* connection = m_connections.create(src, dst);
+
+        // A new bias connection does not change the topology of the
+        // compiled plan, only one entry of a bias vector:
 
-        m_connections.push_back(connection);
-        assert(m_connections.back() == connection);
-        m_connectionSources[&src].push_back(connection);
-        m_connectionDestinations[&dst].push_back(connection);
+        if (&src == m_biasNeuron.get()) {
+            m_plan.connectBias(*connection);
+        } else {
+            m_plan.invalidate();
+        }
 
         return *connection;
     }
@@ -313,30 +308,28 @@ namespace wzann {
             Neuron const& from,
             Neuron const& to)
     {
+        auto connections = connectionsFrom(from);
         auto connection = std::find_if(
-                m_connections.begin(),
-                m_connections.end(),
-                [&from, &to](Connection* const& c) {
-            return &(c->source()) == &from
-                    && &(c->destination()) == &to;
+                connections.first,
+                connections.second,
+                [&to](Connection* const& c) {
+            return &(c->destination()) == &to;
         });
 
-        if (connection == m_connections.end()) {
+        if (connection == connections.second) {
             throw NoConnectionException(from, to);
         }
 
-        auto &sources = m_connectionSources[const_cast<Neuron*>(&from)];
-        std::remove(sources.begin(), sources.end(), *connection);
+        auto* c = *connection;
 
-        auto &destinations = m_connectionDestinations.at(
-                const_cast<Neuron*>(&to));
-        std::remove(
-                destinations.begin(),
-                destinations.end(),
-                *connection);
+        if (&from == m_biasNeuron.get()) {
+            m_plan.disconnectBias(*c, *this);
+            m_plan.removeWeight(c->position());
+        } else {
+            m_plan.invalidate();
+        }
 
-        m_connections.erase(connection);
-        delete *connection;
+        m_connections.destroy(c);
     }
 
 
@@ -344,6 +337,7 @@ namespace wzann {
     {
         layer->m_parent = this;
         m_layers.push_back(layer);
+        m_plan.invalidate();
         return *this;
     }
 
@@ -399,10 +393,29 @@ namespace wzann {
     }
 
 
+    InferencePlan const& NeuralNetwork::compile() const
+    {
+        if (m_plan.hasValidWeights()) {
+            return m_plan;
+        }
+
+        std::lock_guard<std::mutex> lock(m_planMutex);
+
+        if (! m_plan.isCompiled()) {
+            m_plan.compile(*this);
+        } else if (! m_plan.hasValidWeights()) {
+            m_plan.updateWeights();
+        }
+
+        return m_plan;
+    }
+
+
     Vector NeuralNetwork::calculateLayerTransition(
             Layer const& from,
             Layer const& to,
             Vector const& input)
+            const
     {
 #ifdef WZANN_DEBUG
         auto fromLayerSize = from.size();
@@ -411,27 +424,30 @@ namespace wzann {
         }
 #endif
 
-        Vector output;
-        auto toLayerSize = to.size();
-        output.resize(toLayerSize, 0.0);
-
-        for (Layer::size_type t = 0; t != toLayerSize; ++t) {
-            const Neuron &toNeuron = to[t];
-            auto connections = connectionsTo(toNeuron);
-
-            for (const auto &c: make_iterator_range(connections)) {
-                assert(&(c->destination()) == &toNeuron);
+        Vector output(to.size(), 0.0);
+        calculateLayerTransition(from, to, input.data(), output.data());
+        return output;
+    }
 
-                if (! from.contains(c->source())) {
-                    continue;
-                }
 
-                auto s = from.indexOf(c->source());
-                output[t] += input.at(s) * c->weight();
-            }
+    void NeuralNetwork::calculateLayerTransition(
+            Layer const& from,
+            Layer const& to,
+            double const* input,
+            double* output)
+            const
+    {
+        auto const& plan = compile();
+        auto const* transition = plan.transition(
+                plan.layerIndex(from),
+                plan.layerIndex(to));
+
+        if (nullptr == transition) {
+            std::fill(output, output + to.size(), 0.0);
+            return;
         }
 
-        return output;
+        InferencePlan::transfer(*transition, input, output);
     }
 
 
@@ -439,23 +455,54 @@ namespace wzann {
             Layer &layer,
             Vector const& input)
     {
+        assert(input.size() == layer.size());
+
+        auto const& plan = compile();
+        auto const& bias = plan.bias(plan.layerIndex(layer));
+        auto const bo = biasOutput();
+
         Vector biasedInput(input.size());
+        for (Vector::size_type i = 0; i != input.size(); ++i) {
+            biasedInput[i] = input[i] + bo * bias[i];
+        }
+
+        return layer.activate(biasedInput);
+    }
 
-        auto it = layer.begin();
-        for (Vector::size_type i = 0; i != input.size(); ++i, it++) {
-            auto &neuron = *it;
-            biasedInput[i] = input[i];
 
-            if (! connectionExists(biasNeuron(), neuron)) {
-                continue;
-            }
+    Vector const& NeuralNetwork::calculateLayer(
+            Layer const& layer,
+            Vector const& input,
+            InferenceContext& context)
+            const
+    {
+        assert(input.size() == layer.size());
+        return calculateLayer(layer, input.data(), context);
+    }
 
-            auto const& c = connection(biasNeuron(), neuron);
-            biasedInput[i] += biasNeuron().activate(1.0) * c->weight();
+
+    Vector const& NeuralNetwork::calculateLayer(
+            Layer const& layer,
+            double const* input,
+            InferenceContext& context)
+            const
+    {
+        auto const& plan = compile();
+        auto const index = plan.layerIndex(layer);
+        auto const& bias = plan.bias(index);
+        auto const bo = biasOutput();
+
+        auto& biasedInput = context.layerInputs(index);
+        biasedInput.resize(layer.size());
+
+        for (Vector::size_type i = 0; i != biasedInput.size(); ++i) {
+            biasedInput[i] = input[i] + bo * bias[i];
         }
 
-        assert(it == layer.end());
-        return layer.activate(biasedInput);
+        auto& output = context.layerOutputs(index);
+        layer.activate(biasedInput, output);
+
+        return output;
     }
 
 
@@ -468,10 +515,139 @@ namespace wzann {
                     input.size());
         }
 
+        m_biasNeuron->activate(1.0);
         return m_pattern->calculate(*this, input);
     }
 
 
+    Vector NeuralNetwork::calculate(
+            Vector const& input,
+            InferenceContext& context)
+            const
+    {
+        Vector output;
+        calculate(input, output, context);
+        return output;
+    }
+
+
+    void NeuralNetwork::calculate(
+            Vector const& input,
+            Vector& output,
+            InferenceContext& context)
+            const
+    {
+        if (static_cast<Layer::size_type>(input.size())
+                != m_layers.front().size()) {
+            throw LayerSizeMismatchException(
+                    m_layers.front().size(),
+                    input.size());
+        }
+
+        if (! context.matches(*this)) {
+            context.load(*this);
+        }
+
+        m_pattern->calculateWithContext(*this, input, output, context);
+    }
+
+
+    void NeuralNetwork::calculateLayerTransitionBatch(
+            Layer const& from,
+            Layer const& to,
+            Vector const& input,
+            size_type numSamples,
+            Vector& output)
+            const
+    {
+#ifdef WZANN_DEBUG
+        if (input.size() != numSamples * from.size()) {
+            throw LayerSizeMismatchException(
+                    numSamples * from.size(),
+                    input.size());
+        }
+#endif
+
+        auto const& plan = compile();
+        auto const* transition = plan.transition(
+                plan.layerIndex(from),
+                plan.layerIndex(to));
+
+        if (nullptr == transition) {
+            output.assign(numSamples * to.size(), 0.0);
+            return;
+        }
+
+        output.resize(numSamples * to.size());
+        InferencePlan::transferBatch(
+                *transition,
+                input.data(),
+                numSamples,
+                output.data());
+    }
+
+
+    void NeuralNetwork::calculateLayerBatch(
+            Layer const& layer,
+            Vector const& input,
+            size_type numSamples,
+            Vector& output)
+            const
+    {
+        assert(input.size() == numSamples * layer.size());
+
+        auto const& plan = compile();
+        auto const& bias = plan.bias(plan.layerIndex(layer));
+        auto const bo = biasOutput();
+
+        output.resize(input.size());
+        auto const layerSize = layer.size();
+
+        for (size_type n = 0; n != numSamples; ++n) {
+            for (size_type i = 0; i != layerSize; ++i) {
+                auto const k = n * layerSize + i;
+                output[k] = input[k] + bo * bias[i];
+            }
+        }
+
+        if (layer.hasUniformActivationFunction()) {
+            wzann::calculate(
+                    layer[0].activationFunction(),
+                    output.data(),
+                    output.data(),
+                    output.size());
+            return;
+        }
+
+        for (size_type i = 0; i != layerSize; ++i) {
+            auto const f = layer[i].activationFunction();
+
+            for (size_type n = 0; n != numSamples; ++n) {
+                auto& v = output[n * layerSize + i];
+                v = wzann::calculate(f, v);
+            }
+        }
+    }
+
+
+    NeuralNetwork::size_type NeuralNetwork::calculateBatch(
+            Vector const& inputs,
+            Vector& outputs)
+    {
+        auto const inputSize = m_layers.front().size();
+
+        if (0 == inputSize || inputs.size() % inputSize != 0) {
+            throw LayerSizeMismatchException(inputSize, inputs.size());
+        }
+
+        auto const numSamples = inputs.size() / inputSize;
+        outputs.resize(numSamples * m_layers.back().size());
+        m_pattern->calculateBatch(*this, inputs, numSamples, outputs);
+
+        return numSamples;
+    }
+
+
     bool NeuralNetwork::operator ==(const NeuralNetwork &other) const
     {
         bool equal = true;
@@ -487,7 +663,7 @@ namespace wzann {
             return equal;
         }
 
-        for (auto const* connection: m_connections) {
+        for (auto const* connection: make_iterator_range(connections())) {
             int dstLayer = -1;
             for (size_type l = 0; l != size(); ++l) {
                 if (&((*this)[l]) == connection->destination().parent()) {
@@ -2,10 +2,10 @@
 #define WZANN_NEURALNETWORK_H_
 
 
+#include <mutex>
 #include <vector>
 #include <memory>
 #include <cstddef>
-#include <unordered_map>
 
 #include <boost/range.hpp>
 #include <boost/ptr_container/ptr_vector.hpp>
@@ -17,6 +17,9 @@
 #include "Neuron.h"
 #include "Vector.h"
 #include "Connection.h"
+#include "InferencePlan.h"
+#include "ConnectionStore.h"
+#include "InferenceContext.h"
 #include "JsonSerializable.h"
 #include "LibVariantSupport.h"
 #include "NeuralNetworkPattern.h"
@@ -73,6 +76,8 @@ namespace wzann {
      */
     class NeuralNetwork
     {
+        friend class Layer;
+        friend class Connection;
         friend class NeuralNetworkPattern;
         friend class AbstractTrainingStrategy;
 
@@ -94,21 +99,14 @@ namespace wzann {
                 LayerConstIterator,
                 LayerConstIterator> LayerConstRange;
 
-        typedef std::vector<Connection*> ConnectionsPtrVector;
-        typedef ConnectionsPtrVector::iterator
+        typedef ConnectionStore::ConnectionPtrVector ConnectionsPtrVector;
+        typedef ConnectionStore::ConnectionPtrIterator
                 ConnectionPtrIterator;
-        typedef ConnectionsPtrVector::const_iterator
+        typedef ConnectionStore::ConnectionPtrConstIterator
                 ConnectionPtrConstIterator;
-        typedef std::pair<
-                ConnectionPtrIterator,
-                ConnectionPtrIterator> ConnectionPtrRange;
-        typedef std::pair<
-                ConnectionPtrConstIterator,
-                ConnectionPtrConstIterator> ConnectionPtrConstRange;
-
-        typedef std::unordered_map<
-                Neuron*,
-                ConnectionsPtrVector> NeuronConnectionsMap;
+        typedef ConnectionStore::ConnectionPtrRange ConnectionPtrRange;
+        typedef ConnectionStore::ConnectionPtrConstRange
+                ConnectionPtrConstRange;
 
         typedef boost::ptr_vector<Connection>::iterator
                 ConnectionIterator;
@@ -162,6 +160,17 @@ namespace wzann {
         Neuron& biasNeuron();
 
 
+        /*!
+         * \brief Returns the output of the bias neuron
+         *
+         * The bias neuron always receives an input of 1.0; this method
+         * calculates its output without changing the neuron's state.
+         *
+         * \return The output of the bias neuron
+         */
+        double biasOutput() const;
+
+
         /*!
          * Checks whether a certain neuron is part of this
          * network or not.
@@ -317,6 +326,77 @@ namespace wzann {
         ConnectionPtrConstRange connectionsTo(const Neuron &neuron) const;
 
 
+        /*!
+         * \brief Returns the weights of all connections as one flat
+         *  vector
+         *
+         * The weights appear in the same order as the connections in
+         * #connections(). This is the parameter vector of the network
+         * that optimizers work on.
+         *
+         * \return The weights of all connections
+         *
+         * \sa #fixedWeights()
+         */
+        Vector const& weights() const;
+
+
+        /*!
+         * \brief Replaces the weights of all connections at once
+         *
+         * Fixed weights are not checked; their entries must hold the
+         * current values.
+         *
+         * \param[in] weights The new weights, in the order of
+         *  #weights(); must have the same size
+         *
+         * \return `*this`
+         */
+        NeuralNetwork& weights(Vector const& weights);
+
+
+        /*!
+         * \brief Exchanges the weights of all connections with the
+         *  contents of a vector in constant time
+         *
+         * Optimizers that keep several candidate weight vectors can thus
+         * make one of them the network's weights without copying.
+         *
+         * \param[inout] weights The new weights, in the order of
+         *  #weights(); must have the same size. Receives the previous
+         *  weights of the network.
+         */
+        void swapWeights(Vector& weights);
+
+
+        /*!
+         * \brief Marks each entry of #weights() that belongs to a
+         *  connection with a fixed weight with a non-zero value
+         */
+        std::vector<char> const& fixedWeights() const;
+
+
+        /*!
+         * \brief Returns the weights of all connections whose weight is
+         *  not fixed, i.e., all trainable weights
+         *
+         * \return The trainable weights, in the order of #weights()
+         */
+        Vector trainableWeights() const;
+
+
+        /*!
+         * \brief Sets the weights of all connections whose weight is not
+         *  fixed
+         *
+         * \param[in] weights The new trainable weights, in the order of
+         *  #trainableWeights()
+         *
+         * \return `*this`
+         */
+        NeuralNetwork& trainableWeights(Vector const& weights);
+
+
         /*!
          * \brief Allows to iterate over all layers in the ANN
          *
@@ -432,6 +512,27 @@ namespace wzann {
         NeuralNetwork& configure(NeuralNetworkPattern const& pattern);
 
 
+        /*!
+         * \brief Compiles the connection graph into a dense
+         *  InferencePlan
+         *
+         * There is normally no need to call this method explicitly, as
+         * the network compiles its plan lazily as soon as it is needed
+         * for a calculation. The plan is recompiled after the topology
+         * of the network has changed, i.e., after neurons have been
+         * connected or disconnected; if only connection weights have
+         * changed, the plan's weights are refreshed.
+         *
+         * Compilation is thread-safe: If several threads calculate
+         * with the same network, only one of them compiles the plan.
+         *
+         * \return The up-to-date inference plan of this network
+         *
+         * \sa InferencePlan
+         */
+        InferencePlan const& compile() const;
+
+
         /*!
          * \brief Calculates the transition of values from one layer
          *  to another.
@@ -446,8 +547,10 @@ namespace wzann {
          *
          * It is the responsibility of the caller to ensure that
          * a connection between the two layers actually exist.
-         * Otherwise, due to technical reasons, the result
-         * vector contains 0.0 for each neuron.
+         * Otherwise, the result vector contains 0.0 for each neuron.
+         *
+         * Both layers must be part of this network. The calculation
+         * uses the network's compiled InferencePlan.
          *
          * \param fromLayer The index of the originating layer
          *
@@ -467,13 +570,44 @@ namespace wzann {
         Vector calculateLayerTransition(
                 Layer const& from,
                 Layer const& to,
-                Vector const& input);
+                Vector const& input)
+                const;
+
+
+        /*!
+         * \brief Calculates the transition of values from one layer to
+         *  another into a caller-provided buffer
+         *
+         * This overload does not allocate any memory.
+         *
+         * \param[in] from The originating layer
+         *
+         * \param[in] to The destination layer
+         *
+         * \param[in] input The output of the originating layer, one value
+         *  per neuron in `from`
+         *
+         * \param[out] output Receives the input of the destination layer;
+         *  must have room for one value per neuron in `to`
+         *
+         * \sa #calculateLayerTransition(Layer const&, Layer const&,
+         *  Vector const&)
+         */
+        void calculateLayerTransition(
+                Layer const& from,
+                Layer const& to,
+                double const* input,
+                double* output)
+                const;
 
 
         /*!
          * \brief Activates a whole layer of neurons with the given
          *  input, taking the bias neuron into account.
          *
+         * The bias weights are taken from the compiled InferencePlan;
+         * the state of the bias neuron itself is not changed.
+         *
          * \param[in] layer The layer to activate
          *
          * \param[in] input The input to the layer's neurons
@@ -484,6 +618,56 @@ namespace wzann {
         Vector calculateLayer(Layer &layer, Vector const& input);
 
 
+        /*!
+         * \brief Activates a whole layer of neurons with the given
+         *  input, taking the bias neuron into account, and stores the
+         *  state of the neurons in a context instead of the neurons
+         *
+         * \param[in] layer The layer to activate
+         *
+         * \param[in] input The input to the layer's neurons
+         *
+         * \param[inout] context The context that receives the inputs
+         *  and results of the neurons
+         *
+         * \return The result of the activation of each neuron in the
+         *  layer, which is stored in the context
+         *
+         * \sa #calculateLayer(Layer&, Vector const&)
+         */
+        Vector const& calculateLayer(
+                Layer const& layer,
+                Vector const& input,
+                InferenceContext& context)
+                const;
+
+
+        /*!
+         * \brief Activates a whole layer of neurons, reading its input
+         *  from a buffer
+         *
+         * Once the context has been loaded, this overload does not
+         * allocate any memory. The input may point into the context,
+         * e.g., into its workspace or the layer's own inputs.
+         *
+         * \param[in] layer The layer to activate
+         *
+         * \param[in] input The input to the layer's neurons, one value
+         *  per neuron
+         *
+         * \param[inout] context The context that receives the inputs
+         *  and results of the neurons
+         *
+         * \return The result of the activation of each neuron in the
+         *  layer, which is stored in the context
+         */
+        Vector const& calculateLayer(
+                Layer const& layer,
+                double const* input,
+                InferenceContext& context)
+                const;
+
+
         /*!
          * \brief Calculates a complete pass of the neural network.
          *
@@ -491,10 +675,157 @@ namespace wzann {
          *  which is a vector that maps 1:1 an input value to an
          *  input neuron. If the size of the vector does not match
          *  the number of input neurons, an exception is thrown.
+         *
+         * The bias neuron is activated once per pass, so that training
+         * algorithms can rely on its last result.
          */
         Vector calculate(Vector const& input);
 
 
+        /*!
+         * \brief Calculates a complete pass of the neural network without
+         *  modifying it
+         *
+         * All state that results from the calculation, i.e., the inputs
+         * and results of the neurons as well as the state of recurrent
+         * networks, is kept in the given context. As long as the network
+         * itself is not modified, any number of threads can use this
+         * method concurrently, each with its own context.
+         *
+         * If the context does not match the layout of the network, it is
+         * initialized from the current state of the network's neurons.
+         *
+         * \param[in] input The input to the neural network
+         *
+         * \param[inout] context The per-thread calculation state
+         *
+         * \return The output of the neural network
+         *
+         * \throw LayerSizeMismatchException If the size of the input does
+         *  not match the size of the input layer
+         *
+         * \sa InferenceContext
+         */
+        Vector calculate(Vector const& input, InferenceContext& context)
+                const;
+
+
+        /*!
+         * \brief Calculates a complete pass of the neural network without
+         *  modifying it, writing the result into a caller-provided vector
+         *
+         * Intermediate results are kept in the buffers of the context.
+         * Once the context is loaded and the output vector has reached
+         * the size of the output layer, a calculation does not allocate
+         * any memory. This makes the overload suitable for latency
+         * sensitive code that calculates many small inputs in a row.
+         *
+         * \param[in] input The input to the neural network
+         *
+         * \param[out] output Receives the output of the neural network;
+         *  it is resized to the size of the output layer
+         *
+         * \param[inout] context The per-thread calculation state
+         *
+         * \throw LayerSizeMismatchException If the size of the input does
+         *  not match the size of the input layer
+         *
+         * \sa #calculate(Vector const&, InferenceContext&) const
+         */
+        void calculate(
+                Vector const& input,
+                Vector& output,
+                InferenceContext& context)
+                const;
+
+
+        /*!
+         * \brief Calculates the transition of a batch of samples from one
+         *  layer to another
+         *
+         * This is the batch equivalent of ::calculateLayerTransition():
+         * All matrices are stored row-major in a Vector, one sample per
+         * row.
+         *
+         * \param[in] from The originating layer
+         *
+         * \param[in] to The destination layer
+         *
+         * \param[in] input The outputs of the `from` layer,
+         *  `numSamples * from.size()` values
+         *
+         * \param[in] numSamples The number of samples in the batch
+         *
+         * \param[out] output Receives the inputs of the `to` layer,
+         *  `numSamples * to.size()` values
+         *
+         * \sa #calculateLayerTransition()
+         */
+        void calculateLayerTransitionBatch(
+                Layer const& from,
+                Layer const& to,
+                Vector const& input,
+                size_type numSamples,
+                Vector& output)
+                const;
+
+
+        /*!
+         * \brief Activates a whole layer of neurons for a batch of
+         *  samples, taking the bias neuron into account
+         *
+         * Other than ::calculateLayer(), this method does not change the
+         * state of the neurons, i.e., their last input and last result
+         * stay untouched.
+         *
+         * \param[in] layer The layer to activate
+         *
+         * \param[in] input The inputs to the layer's neurons,
+         *  `numSamples * layer.size()` values
+         *
+         * \param[in] numSamples The number of samples in the batch
+         *
+         * \param[out] output Receives the activation of each neuron for
+         *  each sample; may be the same object as `input`
+         *
+         * \sa #calculateLayer()
+         */
+        void calculateLayerBatch(
+                Layer const& layer,
+                Vector const& input,
+                size_type numSamples,
+                Vector& output)
+                const;
+
+
+        /*!
+         * \brief Calculates a complete pass of the neural network for a
+         *  whole batch of samples
+         *
+         * The samples are given as one contiguous, row-major matrix: Each
+         * row contains the input of one sample and has as many elements
+         * as the input layer has neurons. The outputs are written to
+         * the caller-provided matrix in the same layout, one row per
+         * sample. Its storage is re-used if it is already big enough.
+         *
+         * Samples are calculated in order. For feed-forward networks, the
+         * pattern calculates the batch as a series of matrix-matrix
+         * products; recurrent patterns fall back to calculating the
+         * samples one after another, so that their state carries over
+         * from one sample to the next.
+         *
+         * \param[in] inputs The input matrix
+         *
+         * \param[out] outputs The output matrix
+         *
+         * \return The number of samples calculated
+         *
+         * \throw LayerSizeMismatchException If the number of elements in
+         *  `inputs` is not a multiple of the input layer's size
+         */
+        size_type calculateBatch(Vector const& inputs, Vector& outputs);
+
+
         //! Checks for equality of two ANNs.
         bool operator ==(const NeuralNetwork& other) const;
 
@@ -514,22 +845,11 @@ namespace wzann {
         boost::ptr_vector<Layer> m_layers;
 
 
-        //! \brief All connections between neurons in this NeuralNetwork
-        ConnectionsPtrVector m_connections;
-
-
-        /*!
-         * \brief A hash that indexes all connection originating
-         *  from a certain neuron.
-         */
-        NeuronConnectionsMap m_connectionSources;
-
-
         /*!
-         * \brief A hash that indexes all connections that lead to a
-         *  certain neuron.
+         * \brief All connections between neurons in this NeuralNetwork,
+         *  indexed by their source and destination neurons
          */
-        NeuronConnectionsMap m_connectionDestinations;
+        ConnectionStore m_connections;
 
 
         /*!
@@ -541,6 +861,28 @@ namespace wzann {
          * works when values are calculated with it.
          */
         std::unique_ptr<NeuralNetworkPattern> m_pattern;
+
+
+        /*!
+         * \brief The dense representation of the connection graph that
+         *  is used for calculations
+         *
+         * \sa #compile()
+         */
+        mutable InferencePlan m_plan;
+
+
+        //! \brief Serializes the compilation of #m_plan
+        mutable std::mutex m_planMutex;
+
+
+        /*!
+         * \brief Serializes calculations that need to use the neurons'
+         *  state although the network is accessed via a const reference
+         *
+         * \sa NeuralNetworkPattern::calculateWithContext()
+         */
+        mutable std::mutex m_calculationMutex;
     };
 
 
@@ -559,43 +901,42 @@ namespace wzann {
         o["layers"] = layers;
 
         libvariant::Variant::List connections;
-        for (auto const& connectionSources: network.m_connectionSources) {
-            for (auto const& c: connectionSources.second) {
-                int srcLayer = -1,
-                        dstLayer = -1,
-                        srcNeuron = -1,
-                        dstNeuron = -1;
-                libvariant::Variant connection;
-
-                for (NeuralNetwork::size_type i = 0;
-                        i != network.m_layers.size(); ++i) {
-                    for (NeuralNetwork::size_type j = 0;
-                            j != network.m_layers.at(i).size(); ++j) {
-                        auto const& n = network.layerAt(i)->neuronAt(j);
-
-                        if (n == &(c->source())) {
-                            srcLayer = i;
-                            srcNeuron = j;
-                        } else if (n == &(c->destination())) {
-                            dstLayer = i;
-                            dstNeuron = j;
-                        }
+        for (auto const* c: boost::make_iterator_range(
+                network.connections())) {
+            int srcLayer = -1,
+                    dstLayer = -1,
+                    srcNeuron = -1,
+                    dstNeuron = -1;
+            libvariant::Variant connection;
+
+            for (NeuralNetwork::size_type i = 0;
+                    i != network.m_layers.size(); ++i) {
+                for (NeuralNetwork::size_type j = 0;
+                        j != network.m_layers.at(i).size(); ++j) {
+                    auto const& n = network.layerAt(i)->neuronAt(j);
+
+                    if (n == &(c->source())) {
+                        srcLayer = i;
+                        srcNeuron = j;
+                    } else if (n == &(c->destination())) {
+                        dstLayer = i;
+                        dstNeuron = j;
                     }
                 }
+            }
 
-                connection["srcLayer"] = srcLayer;
-                connection["srcNeuron"] = srcNeuron;
-                connection["dstLayer"] = dstLayer;
-                connection["dstNeuron"] = dstNeuron;
-                connection["weight"] = c->weight();
-                connection["fixedWeight"] = c->fixedWeight();
+            connection["srcLayer"] = srcLayer;
+            connection["srcNeuron"] = srcNeuron;
+            connection["dstLayer"] = dstLayer;
+            connection["dstNeuron"] = dstNeuron;
+            connection["weight"] = c->weight();
+            connection["fixedWeight"] = c->fixedWeight();
 
-                if (-1 == srcNeuron) {
-                    connection["srcNeuron"] = "BIAS";
-                }
-
-                connections.push_back(connection);
+            if (-1 == srcNeuron) {
+                connection["srcNeuron"] = "BIAS";
             }
+
+            connections.push_back(connection);
         }
         o["connections"] = connections;
 
@@ -1,6 +1,11 @@
+#include <mutex>
+#include <cstddef>
+#include <algorithm>
+
 #include "Layer.h"
 #include "Connection.h"
 #include "NeuralNetwork.h"
+#include "InferenceContext.h"
 #include "ActivationFunction.h"
 #include "NeuralNetworkPattern.h"
 
@@ -40,6 +45,54 @@ namespace wzann {
     }
 
 
+    void NeuralNetworkPattern::calculateBatch(
+            NeuralNetwork& network,
+            Vector const& inputs,
+            size_t numSamples,
+            Vector& outputs)
+    {
+        auto const inputSize = network.inputLayer().size();
+        auto const outputSize = network.outputLayer().size();
+
+        for (size_t n = 0; n != numSamples; ++n) {
+            auto const in = inputs.begin() + n * inputSize;
+            auto const output = calculate(
+                    network,
+                    Vector(in, in + inputSize));
+
+            std::copy(
+                    output.begin(),
+                    output.end(),
+                    outputs.begin() + n * outputSize);
+        }
+    }
+
+
+    void NeuralNetworkPattern::calculateWithContext(
+            NeuralNetwork const& network,
+            Vector const& input,
+            Vector& output,
+            InferenceContext& context)
+            const
+    {
+        // The stateful calculation needs to modify the neurons, so we
+        // have to swap the context's state in and out:
+
+        auto& ann = const_cast<NeuralNetwork&>(network);
+        std::lock_guard<std::mutex> lock(ann.m_calculationMutex);
+
+        InferenceContext networkState(network);
+        context.store(ann);
+
+        output = const_cast<NeuralNetworkPattern*>(this)->calculate(
+                ann,
+                input);
+
+        context.load(network);
+        networkState.store(ann);
+    }
+
+
     bool NeuralNetworkPattern::operator ==(
             NeuralNetworkPattern const& other)
             const
@@ -22,6 +22,7 @@ using std::pair;
 namespace wzann {
     class Layer;
     class NeuralNetwork;
+    class InferenceContext;
 
 
     class NeuralNetworkPattern
@@ -129,6 +130,65 @@ namespace wzann {
                 Vector const& input) = 0;
 
 
+        /*!
+         * \brief Runs a batch of samples through the neural network
+         *
+         * The default implementation calls #calculate() for each sample
+         * in order. Patterns whose calculation does not depend on
+         * earlier samples should override this method and calculate
+         * the whole batch at once.
+         *
+         * \param network The network that is used for the calculation
+         *
+         * \param inputs The row-major input matrix, one sample per row
+         *
+         * \param numSamples The number of samples (rows) in `inputs`
+         *
+         * \param outputs The row-major output matrix; it is already
+         *  sized to hold `numSamples` rows of output layer size
+         *
+         * \sa NeuralNetwork::calculateBatch()
+         */
+        virtual void calculateBatch(
+                NeuralNetwork& network,
+                Vector const& inputs,
+                size_t numSamples,
+                Vector& outputs);
+
+
+        /*!
+         * \brief Runs a vector of values through the neural network
+         *  without modifying the network
+         *
+         * All state of the calculation must be kept in the context, so
+         * that several threads can calculate with the same network
+         * concurrently. Patterns should override this method.
+         *
+         * The default implementation is a fallback for patterns that only
+         * implement #calculate(): It copies the context's state into the
+         * network's neurons, runs #calculate() and copies the resulting
+         * state back into the context. Calculations with such patterns
+         * are correct, but run one thread at a time and allocate memory.
+         *
+         * \param network The network that is used for the calculation
+         *
+         * \param input The input values
+         *
+         * \param output Receives the result of the calculation
+         *
+         * \param context The state of the calculation
+         *
+         * \sa NeuralNetwork::calculate(Vector const&, Vector&,
+         *  InferenceContext&)
+         */
+        virtual void calculateWithContext(
+                NeuralNetwork const& network,
+                Vector const& input,
+                Vector& output,
+                InferenceContext& context)
+                const;
+
+
         /*!
          * \brief Configures any network to the layout the pattern
          *  represents. The layer sizes are given in the
@@ -4,21 +4,23 @@
 #include "Neuron.h"
 
 
-using std::shared_ptr;
-
 
 namespace wzann {
     Neuron::Neuron():
             m_parent(nullptr),
-            m_activationFunction(ActivationFunction::Null),
-            m_lastInput(0.0),
-            m_lastResult(0.0)
+            m_detached(new DetachedState {
+                    ActivationFunction::Null,
+                    0.0,
+                    0.0 })
     {
     }
 
 
     Neuron::~Neuron()
     {
+        if (nullptr == m_parent) {
+            delete m_detached;
+        }
     }
 
 
@@ -26,10 +28,9 @@ namespace wzann {
     {
         Neuron *n = new Neuron();
 
-        n->m_parent = m_parent;
-        n->m_lastInput = m_lastInput;
-        n->m_lastResult = m_lastResult;
-        n->m_activationFunction = m_activationFunction;
+        n->m_detached->lastInput = lastInput();
+        n->m_detached->lastResult = lastResult();
+        n->m_detached->activationFunction = activationFunction();
 
         return n;
     }
@@ -43,43 +44,62 @@ namespace wzann {
 
     double Neuron::lastResult() const
     {
-        return m_lastResult;
+        return (nullptr == m_parent
+                ? m_detached->lastResult
+                : m_parent->m_lastResults[m_index]);
     }
 
 
     double Neuron::lastInput() const
     {
-        return m_lastInput;
+        return (nullptr == m_parent
+                ? m_detached->lastInput
+                : m_parent->m_lastInputs[m_index]);
     }
 
 
     ActivationFunction Neuron::activationFunction() const
     {
-        return m_activationFunction;
+        return (nullptr == m_parent
+                ? m_detached->activationFunction
+                : m_parent->m_activationFunctions[m_index]);
     }
 
 
     Neuron& Neuron::activationFunction(
             ActivationFunction activationFunction)
     {
-        m_activationFunction = activationFunction;
+        if (nullptr == m_parent) {
+            m_detached->activationFunction = activationFunction;
+        } else {
+            m_parent->m_activationFunctions[m_index] = activationFunction;
+        }
+
         return *this;
     }
 
 
     double Neuron::activate(double sum)
     {
-        m_lastInput = sum;
-        m_lastResult = calculate(m_activationFunction, sum);
-        return m_lastResult;
+        auto result = calculate(activationFunction(), sum);
+
+        if (nullptr == m_parent) {
+            m_detached->lastInput = sum;
+            m_detached->lastResult = result;
+        } else {
+            m_parent->m_lastInputs[m_index] = sum;
+            m_parent->m_lastResults[m_index] = result;
+        }
+
+        return result;
     }
 
 
     bool Neuron::operator ==(Neuron const& other) const
     {
-        return (this->m_activationFunction == other.m_activationFunction
-                && this->m_lastInput == other.m_lastInput
-                && this->m_lastResult == other.m_lastResult);
+        return (activationFunction() == other.activationFunction()
+                && lastInput() == other.lastInput()
+                && lastResult() == other.lastResult());
     }
 
 
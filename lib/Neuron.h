@@ -2,6 +2,8 @@
 #define WZANN_NEURON_H_
 
 
+#include <cstddef>
+
 #include "LibVariantSupport.h"
 #include "ActivationFunction.h"
 
@@ -19,6 +21,13 @@ namespace wzann {
      * a cache, storing the last input it received and the last result
      * of its activation.
      *
+     * As long as a neuron does not belong to a Layer, it keeps this
+     * state in a small, separately allocated block. Once it is added to
+     * a layer, the state moves into the layer's contiguous arrays and
+     * the block is freed, so that the neuron becomes a handle that only
+     * knows its layer and its position therein. This allows the layer to
+     * process the state of all its neurons at once.
+     *
      * \sa #activationFunction()
      *
      * \sa #activate()
@@ -54,7 +63,7 @@ namespace wzann {
         Neuron(Neuron&&) = delete;
 
 
-        virtual ~Neuron();
+        ~Neuron();
 
 
         /*!
@@ -146,24 +155,35 @@ namespace wzann {
     private:
 
 
-        //! Our parent layer
-        Layer* m_parent;
+        //! \brief The state of a neuron that does not belong to a layer
+        struct DetachedState
+        {
+            //! \brief The activation function used by #activate()
+            ActivationFunction activationFunction;
 
 
-        /*!
-         * \brief The activation function used for neuron activation
-         *
-         * \sa #activate()
-         */
-        ActivationFunction m_activationFunction;
+            //! \brief The input that was presented to #activate()
+            double lastInput;
+
+
+            //! \brief The result of the last activation
+            double lastResult;
+        };
+
+
+        //! Our parent layer
+        Layer* m_parent;
 
 
-        //! Caches the input that was presented to #activate().
-        double m_lastInput;
+        union {
+            //! \brief The position of the neuron in its parent layer,
+            //!  if #m_parent is set
+            std::size_t m_index;
 
 
-        //! Caches the result of the last activation
-        double m_lastResult;
+            //! \brief The neuron's own state, if #m_parent is not set
+            DetachedState* m_detached;
+        };
     };
 
 
@@ -189,9 +209,9 @@ namespace wzann {
                 variant["activationFunction"]);
         auto* n = new Neuron();
 
-        n->m_lastInput = variant["lastInput"].AsDouble();
-        n->m_lastResult = variant["lastResult"].AsDouble();
-        n->m_activationFunction = ActivationFunction(*af);
+        n->m_detached->lastInput = variant["lastInput"].AsDouble();
+        n->m_detached->lastResult = variant["lastResult"].AsDouble();
+        n->m_detached->activationFunction = ActivationFunction(*af);
 
         delete af;
         return n;
@@ -0,0 +1,33 @@
+#include <thread>
+#include <cstddef>
+#include <algorithm>
+
+#include "WorkerPool.h"
+
+#include "ParallelFor.h"
+
+
+namespace wzann {
+    std::size_t effectiveNumThreads(std::size_t numThreads)
+    {
+        if (0 == numThreads) {
+            numThreads = std::thread::hardware_concurrency();
+        }
+
+        return std::max<std::size_t>(numThreads, 1);
+    }
+
+
+    void parallelFor(
+            std::size_t numTasks,
+            std::size_t numThreads,
+            std::function<void(std::size_t)> const& task)
+    {
+        WorkerPool pool(std::max<std::size_t>(
+                1,
+                std::min(effectiveNumThreads(numThreads), numTasks)));
+        pool.run(numTasks, [&task](std::size_t, std::size_t i) {
+            task(i);
+        });
+    }
+} // namespace wzann
@@ -0,0 +1,53 @@
+#ifndef WZANN_PARALLELFOR_H_
+#define WZANN_PARALLELFOR_H_
+
+
+#include <cstddef>
+#include <functional>
+
+
+namespace wzann {
+
+
+    /*!
+     * \brief Returns the number of threads to use for a requested number
+     *
+     * \param[in] numThreads The requested number of threads; `0` selects
+     *  the number of hardware threads
+     *
+     * \return The number of threads, at least 1
+     */
+    std::size_t effectiveNumThreads(std::size_t numThreads);
+
+
+    /*!
+     * \brief Runs a number of independent tasks on several threads
+     *
+     * Each task is identified by its index in `[0, numTasks)`. Threads
+     * pick the next pending task until all tasks are done; the calling
+     * thread takes part in the work. Which thread runs a particular task
+     * is not deterministic. Tasks should therefore store their results
+     * by task index, so that callers can combine them in a fixed order
+     * afterwards.
+     *
+     * If tasks throw, the remaining tasks are still run, and the
+     * exception of the task with the lowest index is rethrown once all
+     * threads have finished.
+     *
+     * \param[in] numTasks The number of tasks
+     *
+     * \param[in] numThreads The maximum number of threads; `0` selects
+     *  the number of hardware threads. No more threads than tasks are
+     *  started.
+     *
+     * \param[in] task The work, called once with the index of each task
+     *
+     * \sa WorkerPool
+     */
+    void parallelFor(
+            std::size_t numTasks,
+            std::size_t numThreads,
+            std::function<void(std::size_t)> const& task);
+} // namespace wzann
+
+#endif // WZANN_PARALLELFOR_H_
@@ -1,3 +1,4 @@
+#include <cstddef>
 #include <utility>
 
 #include "Layer.h"
@@ -5,6 +6,7 @@
 #include "Vector.h"
 #include "Connection.h"
 #include "NeuralNetwork.h"
+#include "InferenceContext.h"
 #include "ClassRegistry.h"
 #include "ActivationFunction.h"
 #include "NeuralNetworkPattern.h"
@@ -107,6 +109,72 @@ namespace wzann {
 
         return output;
     }
+
+
+    void PerceptronNetworkPattern::calculateWithContext(
+            NeuralNetwork const& network,
+            Vector const& input,
+            Vector& output,
+            InferenceContext& context)
+            const
+    {
+        // Each transition goes to the workspace, from which the next
+        // layer reads its input. Nothing is allocated:
+
+        auto* layerInput = context.workspace().data();
+        auto const* result = &(network.calculateLayer(
+                network[0],
+                input.data(),
+                context));
+
+        for (size_t i = 1; i != network.size(); ++i) {
+            network.calculateLayerTransition(
+                    network[i-1],
+                    network[i],
+                    result->data(),
+                    layerInput);
+            result = &(network.calculateLayer(
+                    network[i],
+                    layerInput,
+                    context));
+        }
+
+        output.assign(result->begin(), result->end());
+    }
+
+
+    void PerceptronNetworkPattern::calculateBatch(
+            NeuralNetwork& network,
+            Vector const& inputs,
+            size_t numSamples,
+            Vector& outputs)
+    {
+        // The last layer writes directly into the caller's matrix:
+
+        auto const last = network.size() - 1;
+        Vector layerInput;
+        Vector layerOutput;
+
+        network.calculateLayerBatch(
+                network[0],
+                inputs,
+                numSamples,
+                (0 == last ? outputs : layerOutput));
+
+        for (size_t i = 1; i != network.size(); ++i) {
+            network.calculateLayerTransitionBatch(
+                    network[i-1],
+                    network[i],
+                    layerOutput,
+                    numSamples,
+                    layerInput);
+            network.calculateLayerBatch(
+                    network[i],
+                    layerInput,
+                    numSamples,
+                    (i == last ? outputs : layerOutput));
+        }
+    }
 } // namespace wzann
 
 
@@ -71,6 +71,35 @@ namespace wzann {
                 NeuralNetwork& network,
                 Vector const& input)
                 override;
+
+
+        /*!
+         * \brief Calculates the result of running an input vector through
+         *  a Perceptron, keeping all state in the context
+         *
+         * \sa NeuralNetworkPattern#calculateWithContext
+         */
+        virtual void calculateWithContext(
+                NeuralNetwork const& network,
+                Vector const& input,
+                Vector& output,
+                InferenceContext& context)
+                const
+                override;
+
+
+        /*!
+         * \brief Calculates a batch of samples layer by layer, using one
+         *  matrix-matrix product per layer transition
+         *
+         * \sa NeuralNetworkPattern#calculateBatch
+         */
+        virtual void calculateBatch(
+                NeuralNetwork& network,
+                Vector const& inputs,
+                size_t numSamples,
+                Vector& outputs)
+                override;
     };
 } // namespace wzann
 
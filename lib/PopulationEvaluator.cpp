@@ -0,0 +1,332 @@
+#include <cassert>
+#include <stdexcept>
+#include <algorithm>
+
+#include "Layer.h"
+#include "Neuron.h"
+#include "TrainingSet.h"
+#include "TrainingItem.h"
+#include "NeuralNetwork.h"
+#include "InferencePlan.h"
+#include "LayerSizeMismatchException.h"
+
+#include "PopulationEvaluator.h"
+
+
+namespace wzann {
+    PopulationEvaluator::PopulationEvaluator(NeuralNetwork const& network):
+            m_weights(network.weights()),
+            m_fixedWeights(network.fixedWeights()),
+            m_numParameters(0),
+            m_biasOutput(network.biasOutput()),
+            m_populationSize(0)
+    {
+        if (! supports(network)) {
+            throw std::invalid_argument(
+                    "PopulationEvaluator can only evaluate networks "
+                    "whose layers connect to the next layer only");
+        }
+
+        auto const& plan = network.compile();
+
+        for (InferencePlan::size_type i = 0; i != plan.size(); ++i) {
+            auto const& layer = network[i];
+            m_layerSizes.push_back(plan.layerSize(i));
+            m_activationFunctions.emplace_back();
+
+            for (Layer::size_type j = 0; j != layer.size(); ++j) {
+                m_activationFunctions.back().push_back(
+                        layer[j].activationFunction());
+            }
+        }
+
+        // Transitions are calculated in the order of their destination
+        // layers; #supports() guarantees that each leads to the next:
+
+        auto const& transitions = plan.transitions();
+        std::vector<size_type> order(transitions.size());
+
+        for (size_type i = 0; i != transitions.size(); ++i) {
+            order[i] = i;
+        }
+
+        std::stable_sort(order.begin(), order.end(), [&transitions](
+                size_type a,
+                size_type b) {
+            return transitions[a].to < transitions[b].to;
+        });
+
+        std::vector<size_type> position(transitions.size());
+
+        for (size_type i = 0; i != order.size(); ++i) {
+            auto const& t = transitions[order[i]];
+            m_transitions.push_back({ t.from, t.to, t.rows, t.columns });
+            position[order[i]] = i;
+        }
+
+        m_weightArrays.resize(m_transitions.size() + m_layerSizes.size());
+        m_targets.resize(m_weights.size());
+
+        for (auto const& slot: plan.slots()) {
+            m_targets[slot.weight] = {
+                position[slot.transition],
+                slot.offset,
+                true
+            };
+        }
+
+        std::vector<std::vector<char>> biasUsed(m_layerSizes.size());
+
+        for (size_type i = 0; i != m_layerSizes.size(); ++i) {
+            biasUsed[i].assign(m_layerSizes[i], 0);
+        }
+
+        for (auto const& slot: plan.biasSlots()) {
+            auto& used = biasUsed[slot.layer][slot.neuron];
+            m_targets[slot.weight] = {
+                m_transitions.size() + slot.layer,
+                slot.neuron,
+                ! used
+            };
+            used = 1;
+        }
+
+        m_numParameters = static_cast<size_type>(std::count(
+                m_fixedWeights.begin(),
+                m_fixedWeights.end(),
+                0));
+
+        m_inputs.resize(m_layerSizes.size());
+        m_results.resize(m_layerSizes.size());
+    }
+
+
+    bool PopulationEvaluator::supports(NeuralNetwork const& network)
+    {
+        // The network's calculation is that of its pattern, e.g., the
+        // PerceptronNetworkPattern, which only feeds each layer into the
+        // next. Any other transition would make the evaluator compute a
+        // different function:
+
+        for (auto const& transition: network.compile().transitions()) {
+            if (transition.to != transition.from + 1) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+
+    PopulationEvaluator::size_type PopulationEvaluator::numParameters() const
+    {
+        return m_numParameters;
+    }
+
+
+    PopulationEvaluator::size_type PopulationEvaluator::populationSize()
+            const
+    {
+        return m_populationSize;
+    }
+
+
+    void PopulationEvaluator::load(
+            Vector const& parameters,
+            size_type populationSize)
+    {
+        assert(parameters.size() == populationSize * m_numParameters);
+
+        auto const P = populationSize;
+        m_populationSize = P;
+
+        // Weights that have no connection remain 0.0:
+
+        for (size_type i = 0; i != m_transitions.size(); ++i) {
+            auto const& t = m_transitions[i];
+            m_weightArrays[i].assign(t.rows * t.columns * P, 0.0);
+        }
+
+        for (size_type i = 0; i != m_layerSizes.size(); ++i) {
+            m_weightArrays[m_transitions.size() + i].assign(
+                    m_layerSizes[i] * P,
+                    0.0);
+            m_inputs[i].assign(m_layerSizes[i] * P, 0.0);
+            m_results[i].assign(m_layerSizes[i] * P, 0.0);
+        }
+
+        // Multiple connections between the same two neurons add up, as
+        // in the InferencePlan:
+
+        size_type k = 0;
+
+        for (size_type i = 0; i != m_weights.size(); ++i) {
+            auto const& target = m_targets[i];
+            auto const fixed = m_fixedWeights[i];
+
+            if (! target.used) {
+                k += (fixed ? 0 : 1);
+                continue;
+            }
+
+            double* lanes = m_weightArrays[target.array].data()
+                    + target.element * P;
+
+            if (fixed) {
+                for (size_type p = 0; p != P; ++p) {
+                    lanes[p] += m_weights[i];
+                }
+
+                continue;
+            }
+
+            for (size_type p = 0; p != P; ++p) {
+                lanes[p] += parameters[p * m_numParameters + k];
+            }
+
+            ++k;
+        }
+    }
+
+
+    void PopulationEvaluator::forward(double const* input)
+    {
+        auto const P = m_populationSize;
+        auto t = m_transitions.begin();
+
+        for (size_type l = 0; l != m_layerSizes.size(); ++l) {
+            auto const size = m_layerSizes[l];
+            double* in = m_inputs[l].data();
+
+            if (0 == l) {
+                for (size_type i = 0; i != size; ++i) {
+                    std::fill(in + i * P, in + (i + 1) * P, input[i]);
+                }
+            } else {
+                std::fill(in, in + size * P, 0.0);
+            }
+
+            // Each weight is multiplied with the source's results of all
+            // individuals at once:
+
+            for (; t != m_transitions.end() && t->to == l; ++t) {
+                auto const& weights =
+                        m_weightArrays[t - m_transitions.begin()];
+                double const* results = m_results[t->from].data();
+
+                for (size_type r = 0; r != t->rows; ++r) {
+                    double* sum = in + r * P;
+
+                    for (size_type c = 0; c != t->columns; ++c) {
+                        double const* x = results + c * P;
+                        double const* w = weights.data()
+                                + (r * t->columns + c) * P;
+
+                        for (size_type p = 0; p != P; ++p) {
+                            sum[p] += x[p] * w[p];
+                        }
+                    }
+                }
+            }
+
+            double const* bias =
+                    m_weightArrays[m_transitions.size() + l].data();
+
+            for (size_type i = 0; i != size * P; ++i) {
+                in[i] += m_biasOutput * bias[i];
+            }
+
+            double* out = m_results[l].data();
+
+            for (size_type i = 0; i != size; ++i) {
+                wzann::calculate(
+                        m_activationFunctions[l][i],
+                        in + i * P,
+                        out + i * P,
+                        P);
+            }
+        }
+    }
+
+
+    void PopulationEvaluator::calculate(
+            Vector const& inputs,
+            size_type numSamples,
+            Vector& outputs)
+    {
+        auto const P = m_populationSize;
+        auto const inputSize = m_layerSizes.front();
+        auto const outputSize = m_layerSizes.back();
+
+        if (inputs.size() != numSamples * inputSize) {
+            throw LayerSizeMismatchException(
+                    numSamples * inputSize,
+                    inputs.size());
+        }
+
+        outputs.resize(P * numSamples * outputSize);
+
+        for (size_type n = 0; n != numSamples; ++n) {
+            forward(inputs.data() + n * inputSize);
+            double const* result = m_results.back().data();
+
+            for (size_type o = 0; o != outputSize; ++o) {
+                for (size_type p = 0; p != P; ++p) {
+                    outputs[(p * numSamples + n) * outputSize + o] =
+                            result[o * P + p];
+                }
+            }
+        }
+    }
+
+
+    void PopulationEvaluator::meanErrors(
+            TrainingSet const& trainingSet,
+            Vector& errors)
+    {
+        auto const P = m_populationSize;
+        auto const inputSize = m_layerSizes.front();
+        size_type numRelevantItems = 0;
+        Vector itemErrors(P);
+
+        errors.assign(P, 0.0);
+
+        for (auto const& item: trainingSet.trainingItems) {
+            auto const input = item.input();
+
+            if (input.size() != inputSize) {
+                throw LayerSizeMismatchException(inputSize, input.size());
+            }
+
+            forward(input.data());
+
+            if (! item.outputRelevant()) {
+                continue;
+            }
+
+            ++numRelevantItems;
+            auto const expected = item.expectedOutput();
+            double const* result = m_results.back().data();
+            std::fill(itemErrors.begin(), itemErrors.end(), 0.0);
+
+            auto const numOutputs = std::min(
+                    expected.size(),
+                    m_layerSizes.back());
+
+            for (size_type o = 0; o != numOutputs; ++o) {
+                for (size_type p = 0; p != P; ++p) {
+                    double const d = expected[o] - result[o * P + p];
+                    itemErrors[p] += d * d;
+                }
+            }
+
+            for (size_type p = 0; p != P; ++p) {
+                errors[p] += itemErrors[p] / 2.0;
+            }
+        }
+
+        for (auto& error: errors) {
+            error /= static_cast<double>(numRelevantItems);
+        }
+    }
+} // namespace wzann
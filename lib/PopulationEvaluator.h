@@ -0,0 +1,233 @@
+#ifndef WZANN_POPULATIONEVALUATOR_H_
+#define WZANN_POPULATIONEVALUATOR_H_
+
+
+#include <vector>
+#include <cstddef>
+
+#include "Vector.h"
+#include "ActivationFunction.h"
+
+
+namespace wzann {
+    class TrainingSet;
+    class NeuralNetwork;
+
+
+    /*!
+     * \brief Calculates the outputs of many weight vectors of one network
+     *  topology in a single pass
+     *
+     * Population-based training algorithms evaluate a large number of
+     * individuals that share the topology of one network and differ only
+     * in their weights. Instead of applying each individual's weights to
+     * the network and calculating every input one individual at a time,
+     * the evaluator holds the weights of the whole population, laid out
+     * so that the individuals are the innermost dimension: The weight
+     * matrix of each layer transition is stored as
+     * `[row][column][individual]`, and so are the activations of each
+     * layer. The multiply-add of a weight then runs across all
+     * individuals with contiguous memory access, which the compiler can
+     * vectorize, and each weight matrix is traversed once per input for
+     * the whole population.
+     *
+     * The evaluator copies the topology, the fixed weights and the
+     * activation functions from a network when it is created. Later
+     * changes to the network are not reflected. Only networks whose
+     * layer transitions all lead from a layer to the next one can be
+     * evaluated, such as those created by the PerceptronNetworkPattern;
+     * recurrent networks and connections that skip a layer are not
+     * supported. Results agree with
+     * NeuralNetwork::calculate() up to the last few bits, as the
+     * activation functions are evaluated with their array versions.
+     *
+     * An evaluator is not thread-safe. Threads should use one evaluator
+     * each, e.g., for a part of the population.
+     *
+     * \sa NeuralNetwork::trainableWeights()
+     */
+    class PopulationEvaluator
+    {
+    public:
+
+
+        typedef std::size_t size_type;
+
+
+        /*!
+         * \brief Creates an evaluator for the topology of a network
+         *
+         * \param[in] network The network
+         *
+         * \throw std::invalid_argument If the evaluator does not
+         *  #supports() the network
+         */
+        explicit PopulationEvaluator(NeuralNetwork const& network);
+
+
+        /*!
+         * \brief Whether the evaluator can evaluate a network
+         *
+         * \param[in] network The network
+         *
+         * \return `true` if every layer transition of the network leads
+         *  from a layer to the next one
+         *
+         * \sa InferencePlan::transitions()
+         */
+        static bool supports(NeuralNetwork const& network);
+
+
+        //! \brief The number of trainable weights of one individual
+        size_type numParameters() const;
+
+
+        //! \brief The number of individuals currently loaded
+        size_type populationSize() const;
+
+
+        /*!
+         * \brief Loads the weights of a population
+         *
+         * \param[in] parameters The trainable weights of all individuals,
+         *  one after another, each in the order of
+         *  NeuralNetwork::trainableWeights(); must have
+         *  `populationSize * numParameters()` elements
+         *
+         * \param[in] populationSize The number of individuals
+         */
+        void load(Vector const& parameters, size_type populationSize);
+
+
+        /*!
+         * \brief Calculates the outputs of all loaded individuals for a
+         *  batch of inputs
+         *
+         * \param[in] inputs The inputs, one after another
+         *
+         * \param[in] numSamples The number of inputs
+         *
+         * \param[out] outputs Receives the outputs, ordered by individual,
+         *  then by input: The output for input `n` of individual `p`
+         *  starts at `(p * numSamples + n) * outputSize`.
+         */
+        void calculate(
+                Vector const& inputs,
+                size_type numSamples,
+                Vector& outputs);
+
+
+        /*!
+         * \brief Calculates the mean error of each loaded individual on
+         *  a training set
+         *
+         * The error of an item is
+         * \f$\frac{1}{2}\sum_i (\mathit{expected}_i -
+         * \mathit{actual}_i)^2\f$; items whose output is not relevant
+         * are skipped.
+         *
+         * \param[in] trainingSet The training set
+         *
+         * \param[out] errors Receives the mean error of each individual
+         */
+        void meanErrors(TrainingSet const& trainingSet, Vector& errors);
+
+
+    private:
+
+
+        //! \brief The layout of a layer transition
+        struct Transition
+        {
+            //! \brief Index of the originating layer
+            size_type from;
+
+            //! \brief Index of the destination layer
+            size_type to;
+
+            //! \brief Number of neurons in the destination layer
+            size_type rows;
+
+            //! \brief Number of neurons in the source layer
+            size_type columns;
+        };
+
+
+        //! \brief The place of a weight in #m_weightArrays
+        struct Target
+        {
+            //! \brief The index of the array
+            size_type array;
+
+            //! \brief The element within one individual's matrix
+            size_type element;
+
+            /*!
+             * \brief Whether the weight is used; like in the
+             *  InferencePlan, only the first connection from the bias
+             *  neuron to a neuron is
+             */
+            bool used;
+        };
+
+
+        /*!
+         * \brief Calculates one input for all individuals, leaving the
+         *  results in #m_results
+         */
+        void forward(double const* input);
+
+
+        //! \brief The size of each layer
+        std::vector<size_type> m_layerSizes;
+
+
+        //! \brief The activation function of each neuron, per layer
+        std::vector<std::vector<ActivationFunction>> m_activationFunctions;
+
+
+        //! \brief All transitions, ordered by their destination layer
+        std::vector<Transition> m_transitions;
+
+
+        /*!
+         * \brief The interleaved weight matrix of each transition,
+         *  followed by the interleaved bias vector of each layer
+         */
+        std::vector<Vector> m_weightArrays;
+
+
+        //! \brief The place of each of the network's weights
+        std::vector<Target> m_targets;
+
+
+        //! \brief The network's weights, of which the fixed ones are used
+        Vector m_weights;
+
+
+        //! \brief Whether each weight is fixed
+        std::vector<char> m_fixedWeights;
+
+
+        //! \brief The number of trainable weights
+        size_type m_numParameters;
+
+
+        //! \brief The output of the bias neuron
+        double m_biasOutput;
+
+
+        //! \brief The number of loaded individuals
+        size_type m_populationSize;
+
+
+        //! \brief The interleaved inputs of each layer
+        std::vector<Vector> m_inputs;
+
+
+        //! \brief The interleaved results of each layer
+        std::vector<Vector> m_results;
+    };
+} // namespace wzann
+
+#endif // WZANN_POPULATIONEVALUATOR_H_
@@ -1,113 +1,314 @@
-#include <limits>
-#include <cstddef>
-#include <ostream>
+#include <memory>
+#include <vector>
 #include <algorithm>
-#include <functional>
 
-#include "Connection.h"
-#include "NeuralNetwork.h"
+#include <boost/random/mersenne_twister.hpp>
+#include <boost/random/uniform_real_distribution.hpp>
 
-#include "TrainingAlgorithm.h"
-#include "ParticleSwarmOptimization.h"
+#include "TrainingSet.h"
+#include "ParallelFor.h"
+#include "ClassRegistry.h"
+#include "NeuralNetwork.h"
+#include "InferenceContext.h"
+#include "PopulationEvaluator.h"
 
 #include "PsoTrainingAlgorithm.h"
 
-#include "Winzent-ANN_global.h"
+
+namespace wzann {
+    constexpr PsoTrainingAlgorithm::size_type
+    PsoTrainingAlgorithm::PARTICLES_PER_CHUNK;
+
+
+    PsoTrainingAlgorithm::PsoTrainingAlgorithm():
+            TrainingAlgorithm(),
+            m_swarmSize(DEFAULT_SWARM_SIZE),
+            m_inertia(DEFAULT_INERTIA),
+            m_cognitiveWeight(DEFAULT_COGNITIVE_WEIGHT),
+            m_socialWeight(DEFAULT_SOCIAL_WEIGHT),
+            m_maxVelocity(DEFAULT_MAX_VELOCITY),
+            m_lowerBoundary(DEFAULT_LOWER_BOUNDARY),
+            m_upperBoundary(DEFAULT_UPPER_BOUNDARY),
+            m_numThreads(0)
+    {
+    }
 
 
-namespace Winzent {
-    namespace ANN {
+    PsoTrainingAlgorithm::size_type PsoTrainingAlgorithm::swarmSize() const
+    {
+        return m_swarmSize;
+    }
+
+
+    PsoTrainingAlgorithm& PsoTrainingAlgorithm::swarmSize(
+            size_type swarmSize)
+    {
+        m_swarmSize = swarmSize;
+        return *this;
+    }
+
+
+    double PsoTrainingAlgorithm::inertia() const
+    {
+        return m_inertia;
+    }
+
+
+    PsoTrainingAlgorithm& PsoTrainingAlgorithm::inertia(double inertia)
+    {
+        m_inertia = inertia;
+        return *this;
+    }
+
+
+    double PsoTrainingAlgorithm::cognitiveWeight() const
+    {
+        return m_cognitiveWeight;
+    }
+
+
+    PsoTrainingAlgorithm& PsoTrainingAlgorithm::cognitiveWeight(
+            double weight)
+    {
+        m_cognitiveWeight = weight;
+        return *this;
+    }
+
+
+    double PsoTrainingAlgorithm::socialWeight() const
+    {
+        return m_socialWeight;
+    }
+
+
+    PsoTrainingAlgorithm& PsoTrainingAlgorithm::socialWeight(double weight)
+    {
+        m_socialWeight = weight;
+        return *this;
+    }
+
+
+    double PsoTrainingAlgorithm::maxVelocity() const
+    {
+        return m_maxVelocity;
+    }
+
+
+    PsoTrainingAlgorithm& PsoTrainingAlgorithm::maxVelocity(
+            double maxVelocity)
+    {
+        m_maxVelocity = maxVelocity;
+        return *this;
+    }
+
+
+    double PsoTrainingAlgorithm::lowerBoundary() const
+    {
+        return m_lowerBoundary;
+    }
 
 
-        PsoTrainingAlgorithm::PsoTrainingAlgorithm():
-                TrainingAlgorithm(),
-                Algorithm::ParticleSwarmOptimization()
-        {
-            lowerBoundary(-1000.0);
-            upperBoundary(1000.0);
+    PsoTrainingAlgorithm& PsoTrainingAlgorithm::lowerBoundary(
+            double boundary)
+    {
+        m_lowerBoundary = boundary;
+        return *this;
+    }
+
+
+    double PsoTrainingAlgorithm::upperBoundary() const
+    {
+        return m_upperBoundary;
+    }
+
+
+    PsoTrainingAlgorithm& PsoTrainingAlgorithm::upperBoundary(
+            double boundary)
+    {
+        m_upperBoundary = boundary;
+        return *this;
+    }
+
+
+    PsoTrainingAlgorithm::size_type PsoTrainingAlgorithm::numThreads() const
+    {
+        return m_numThreads;
+    }
+
+
+    PsoTrainingAlgorithm& PsoTrainingAlgorithm::numThreads(
+            size_type numThreads)
+    {
+        m_numThreads = numThreads;
+        return *this;
+    }
+
+
+    void PsoTrainingAlgorithm::train(
+            NeuralNetwork& ann,
+            TrainingSet& trainingSet)
+    {
+        auto const S = std::max<size_type>(1, m_swarmSize);
+        auto const weights = ann.trainableWeights();
+        auto const D = weights.size();
+        auto const lower = m_lowerBoundary;
+        auto const upper = m_upperBoundary;
+        auto const maxVelocity = m_maxVelocity;
+
+        // The swarm, as a structure of arrays, one particle after another:
+
+        Vector positions(S * D);
+        Vector velocities(S * D);
+        Vector bestPositions;
+        Vector errors(S);
+        Vector bestErrors;
+
+        boost::random::mt11213b rng;
+        boost::random::uniform_real_distribution<double> spread(
+                -maxVelocity,
+                maxVelocity);
+        boost::random::uniform_real_distribution<double> chance(0.0, 1.0);
+
+        for (size_type p = 0; p != S; ++p) {
+            for (size_type d = 0; d != D; ++d) {
+                auto const offset = (0 == p ? 0.0 : spread(rng));
+                positions[p * D + d] = std::min(
+                        std::max(weights[d] + offset, lower),
+                        upper);
+                velocities[p * D + d] = spread(rng);
+            }
+        }
+
+        // Each chunk of particles is evaluated by an evaluator of its own,
+        // or, for recurrent networks, on a copy of the network:
+
+        auto const numChunks =
+                (S + PARTICLES_PER_CHUNK - 1) / PARTICLES_PER_CHUNK;
+        std::vector<std::unique_ptr<PopulationEvaluator>> evaluators;
+        std::vector<std::unique_ptr<NeuralNetwork>> networks;
+
+        for (size_type c = 0; c != numChunks; ++c) {
+            if (PopulationEvaluator::supports(ann)) {
+                evaluators.emplace_back(new PopulationEvaluator(ann));
+            } else {
+                networks.emplace_back(new NeuralNetwork(ann));
+            }
         }
 
+        InferenceContext const initialContext(ann);
+
+        auto evaluate = [&]() {
+            parallelFor(numChunks, m_numThreads, [&](size_type c) {
+                auto const begin = c * PARTICLES_PER_CHUNK;
+                auto const end = std::min(S, begin + PARTICLES_PER_CHUNK);
 
-        void PsoTrainingAlgorithm::applyPosition(
-                const QVector<qreal> &position,
-                NeuralNetwork &neuralNetwork)
-        {
-            size_t i = 0;
-            neuralNetwork.eachConnection([&i, &position](
-                    Connection *const &connection) {
-                if (connection->fixedWeight()) {
+                if (! evaluators.empty()) {
+                    Vector chunk(
+                            positions.begin() + begin * D,
+                            positions.begin() + end * D);
+                    Vector chunkErrors;
+                    evaluators[c]->load(chunk, end - begin);
+                    evaluators[c]->meanErrors(trainingSet, chunkErrors);
+                    std::copy(
+                            chunkErrors.begin(),
+                            chunkErrors.end(),
+                            errors.begin() + begin);
                     return;
                 }
 
-                connection->weight(position.at(i++));
+                for (size_type p = begin; p != end; ++p) {
+                    networks[c]->trainableWeights(Vector(
+                            positions.begin() + p * D,
+                            positions.begin() + (p + 1) * D));
+                    errors[p] = meanError(
+                            *networks[c],
+                            trainingSet,
+                            initialContext);
+                }
             });
-        }
+        };
+
+        evaluate();
+        bestPositions = positions;
+        bestErrors = errors;
 
+        auto const globalBestIndex = [&]() {
+            return static_cast<size_type>(
+                    std::min_element(bestErrors.begin(), bestErrors.end())
+                        - bestErrors.begin());
+        };
 
-        void PsoTrainingAlgorithm::evaluateParticle(
-                Algorithm::detail::Particle &particle,
-                NeuralNetwork &ann,
-                const TrainingSet &trainingSet)
-        {
-            applyPosition(particle.currentPosition, ann);
-            qreal errorSum = 0;
-            size_t i = 0;
+        auto g = globalBestIndex();
+        Vector globalBest(
+                bestPositions.begin() + g * D,
+                bestPositions.begin() + (g + 1) * D);
+        double globalBestError = bestErrors[g];
 
-            for (const auto &item: trainingSet.trainingItems) {
-                auto actual = ann.calculate(item.input());
+        Vector r1(D);
+        Vector r2(D);
+        size_t epochs = 0;
 
-                if (! item.outputRelevant()) {
-                    continue;
+        for (; epochs < trainingSet.maxEpochs()
+                    && globalBestError > trainingSet.targetError();
+                ++epochs) {
+            for (size_type p = 0; p != S; ++p) {
+                for (size_type d = 0; d != D; ++d) {
+                    r1[d] = chance(rng);
+                    r2[d] = chance(rng);
                 }
 
-                auto expected = item.expectedOutput();
-                errorSum += calculateMeanSquaredError(actual, expected);
-                i += 1;
-            }
+                double* x = positions.data() + p * D;
+                double* v = velocities.data() + p * D;
+                double const* best = bestPositions.data() + p * D;
+                double const* swarmBest = globalBest.data();
+                double const* cognitive = r1.data();
+                double const* social = r2.data();
 
-            particle.currentFitness = errorSum / static_cast<qreal>(i);
-        }
+                for (size_type d = 0; d != D; ++d) {
+                    auto const velocity = m_inertia * v[d]
+                            + m_cognitiveWeight * cognitive[d]
+                                * (best[d] - x[d])
+                            + m_socialWeight * social[d]
+                                * (swarmBest[d] - x[d]);
+                    v[d] = std::min(
+                            std::max(velocity, -maxVelocity),
+                            maxVelocity);
+                    x[d] = std::min(std::max(x[d] + v[d], lower), upper);
+                }
+            }
 
+            evaluate();
 
-        void PsoTrainingAlgorithm::train(
-                NeuralNetwork &ann,
-                TrainingSet &trainingSet)
-        {
-            size_t dimensions = 0;
-            ann.eachConnection([&dimensions](const Connection *const &c) {
-                if (! c->fixedWeight()) {
-                    ++dimensions;
+            for (size_type p = 0; p != S; ++p) {
+                if (errors[p] < bestErrors[p]) {
+                    bestErrors[p] = errors[p];
+                    std::copy(
+                            positions.begin() + p * D,
+                            positions.begin() + (p + 1) * D,
+                            bestPositions.begin() + p * D);
                 }
-            });
-
-            maxIterations(trainingSet.maxEpochs());
+            }
 
-            auto result = run(
-                    dimensions,
-                    [this, &ann, &trainingSet](
-                        Algorithm::detail::Particle &particle) {
-                evaluateParticle(particle, ann, trainingSet);
-                return particle.currentFitness <= trainingSet.targetError();
-            });
+            g = globalBestIndex();
 
-            setFinalError(trainingSet, result.bestParticle.bestFitness);
-            setFinalNumEpochs(trainingSet, result.iterationsUsed);
-            applyPosition(result.bestParticle.bestPosition, ann);
+            if (bestErrors[g] < globalBestError) {
+                globalBestError = bestErrors[g];
+                std::copy(
+                        bestPositions.begin() + g * D,
+                        bestPositions.begin() + (g + 1) * D,
+                        globalBest.begin());
+            }
         }
-    }
-}
 
+        // Store final training results:
 
-#if 0
-namespace std {
-    ostream& operator <<(
-            ostream& os,
-            Winzent::ANN::PsoTrainingAlgorithm const& pso)
-    {
-        auto const& algorithm = static_cast<
-                Winzent::Algorithm::ParticleSwarmOptimization const&>(pso);
-        os << algorithm;
-        return os;
+        ann.trainableWeights(globalBest);
+        setFinalError(trainingSet, globalBestError);
+        setFinalNumEpochs(trainingSet, epochs);
     }
-}
-#endif
+} // namespace wzann
+
+
+WZANN_REGISTER_CLASS(
+        wzann::PsoTrainingAlgorithm,
+        wzann::TrainingAlgorithm)
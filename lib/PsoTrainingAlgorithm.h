@@ -2,103 +2,234 @@
 #define WZANN_PSOTRAININGALGORITHM_H_
 
 
-#include <ostream>
+#include <cstddef>
 
-#include <ParticleSwarmOptimization.h>
-
-#include "TrainingSet.h"
-#include "NeuralNetwork.h"
+#include "Vector.h"
 #include "TrainingAlgorithm.h"
 
 
 namespace wzann {
+    class TrainingSet;
+    class NeuralNetwork;
+
+
+    /*!
+     * \brief Trains a neural network using Particle Swarm Optimization
+     *
+     * Each particle of the swarm is a candidate vector of trainable
+     * weights. In each epoch, every particle \f$i\f$ changes its velocity
+     * to
+     * \f$v_i \gets \omega v_i + c_1 r_1 (p_i - x_i) + c_2 r_2 (g - x_i)\f$
+     * and moves to \f$x_i \gets x_i + v_i\f$, where \f$p_i\f$ is the best
+     * position the particle has found, \f$g\f$ the best position of the
+     * whole swarm, \f$\omega\f$ the #inertia(), \f$c_1\f$ the
+     * #cognitiveWeight(), \f$c_2\f$ the #socialWeight(), and \f$r_1\f$,
+     * \f$r_2\f$ are uniformly distributed random numbers from
+     * \f$[0, 1)\f$, drawn for each weight. Velocities are limited to
+     * #maxVelocity(), positions to the range from #lowerBoundary() to
+     * #upperBoundary(). The fitness of a particle is the mean error of
+     * the training set, so no gradient is needed.
+     *
+     * The swarm is stored as a structure of arrays: The positions,
+     * velocities and best positions of all particles are each kept in one
+     * contiguous vector, one particle after another. The update of a
+     * particle draws its random numbers first and then runs a branchless
+     * loop over its weights, which the compiler can vectorize.
+     *
+     * The particles are evaluated in chunks of a fixed size, concurrently
+     * on #numThreads() threads. Each chunk has its own PopulationEvaluator,
+     * which calculates all of its particles in one pass. Networks the
+     * evaluator does not support, i.e., recurrent ones, are evaluated one
+     * particle at a time on a copy of the network per chunk. The result
+     * does not depend on the number of threads.
+     *
+     * The first particle starts at the network's current weights, the
+     * others at random positions up to #maxVelocity() away from them. The
+     * network receives the best weights found. Fixed weights remain
+     * unchanged.
+     */
+    class PsoTrainingAlgorithm : public TrainingAlgorithm
+    {
+    public:
+
+
+        typedef std::size_t size_type;
+
+
+        const size_type DEFAULT_SWARM_SIZE = 40;
+
+
+        const double DEFAULT_INERTIA = 0.7298;
+
+
+        const double DEFAULT_COGNITIVE_WEIGHT = 1.49618;
+
+
+        const double DEFAULT_SOCIAL_WEIGHT = 1.49618;
+
+
+        const double DEFAULT_MAX_VELOCITY = 1.0;
+
+
+        const double DEFAULT_LOWER_BOUNDARY = -100.0;
+
+
+        const double DEFAULT_UPPER_BOUNDARY = 100.0;
+
+
+        //! \brief The number of particles evaluated together
+        static constexpr size_type PARTICLES_PER_CHUNK = 16;
+
+
+        //! \brief Creates a new instance with default parameters
+        PsoTrainingAlgorithm();
+
+
+        //! \return The number of particles
+        size_type swarmSize() const;
+
+
+        /*!
+         * \brief Sets the number of particles
+         *
+         * \return `*this`
+         */
+        PsoTrainingAlgorithm& swarmSize(size_type swarmSize);
+
+
+        //! \return The factor by which a particle keeps its velocity
+        double inertia() const;
+
+
+        /*!
+         * \brief Sets the factor by which a particle keeps its velocity
+         *
+         * \return `*this`
+         */
+        PsoTrainingAlgorithm& inertia(double inertia);
+
+
+        //! \return The attraction of a particle's own best position
+        double cognitiveWeight() const;
+
+
+        /*!
+         * \brief Sets the attraction of a particle's own best position
+         *
+         * \return `*this`
+         */
+        PsoTrainingAlgorithm& cognitiveWeight(double weight);
+
+
+        //! \return The attraction of the swarm's best position
+        double socialWeight() const;
+
+
+        /*!
+         * \brief Sets the attraction of the swarm's best position
+         *
+         * \return `*this`
+         */
+        PsoTrainingAlgorithm& socialWeight(double weight);
+
+
+        //! \return The maximum change of a weight per epoch
+        double maxVelocity() const;
+
+
+        /*!
+         * \brief Sets the maximum change of a weight per epoch
+         *
+         * \return `*this`
+         */
+        PsoTrainingAlgorithm& maxVelocity(double maxVelocity);
+
+
+        //! \return The smallest value a weight can take
+        double lowerBoundary() const;
+
+
+        /*!
+         * \brief Sets the smallest value a weight can take
+         *
+         * \return `*this`
+         */
+        PsoTrainingAlgorithm& lowerBoundary(double boundary);
+
+
+        //! \return The largest value a weight can take
+        double upperBoundary() const;
+
+
+        /*!
+         * \brief Sets the largest value a weight can take
+         *
+         * \return `*this`
+         */
+        PsoTrainingAlgorithm& upperBoundary(double boundary);
+
+
+        //! \return The number of threads that evaluate the particles
+        size_type numThreads() const;
+
+
+        /*!
+         * \brief Sets the number of threads that evaluate the particles
+         *
+         * \param[in] numThreads The number of threads; `0` selects the
+         *  number of hardware threads. The default is `0`.
+         *
+         * \return `*this`
+         */
+        PsoTrainingAlgorithm& numThreads(size_type numThreads);
 
 
         /*!
-         * \brief Trains an Artificial Neural Network using Particle Swarm
+         * \brief Trains the given neural network using Particle Swarm
          *  Optimization
          *
-         * \sa Winzent::Algorithm::ParticleSwarmOptimization
+         * \param[inout] ann The neural network to train
+         *
+         * \param[in] trainingSet The training data
          */
-        class PsoTrainingAlgorithm :
-                public TrainingAlgorithm,
-                public Algorithm::ParticleSwarmOptimization
-        {
-        public:
-
-
-            /*!
-             * \brief Constructs a new instance with default parameters
-             *  (mostly 0).
-             */
-            PsoTrainingAlgorithm();
-
-
-            /*!
-             * \brief Applies the particle's current position to a
-             *  Artificial Neural Network
-             *
-             * \param[in] particle The particle whose position data should
-             *  be applied
-             *
-             * \param[inout] neuralNetwork The ANN to which the particle's
-             *  position data is applied
-             *
-             * \sa Algorithm::detail::Particle::currentPosition
-             */
-            static void applyPosition(
-                    const QVector<qreal> &position,
-                    NeuralNetwork &neuralNetwork);
-
-
-            /*!
-             * \brief Evaluates a particle's fitness to solve the training
-             *  set with the supplied ANN.
-             *
-             * \param[inout] particle The particle that carries the ANN's
-             *  parameters
-             *
-             * \param[inout] ann The Artificial Neural Network to which we
-             *  apply the particle's position in order to evaluate it
-             *
-             * \param[in] trainingSet The training set holding the data that
-             *  this method uses to evaluate the particle
-             */
-            void evaluateParticle(
-                    Algorithm::detail::Particle &particle,
-                    NeuralNetwork &ann,
-                    const TrainingSet &trainingSet);
-
-
-            /*!
-             * \brief Trains the given Artificial Neural Network (ANN) using
-             *  Particle Swarm Optimization
-             *
-             * \param[in] ann The Artifical Neural Network to train
-             *
-             * \param[in] trainingSet The training data
-             */
-            virtual void train(NeuralNetwork &ann, TrainingSet &trainingSet)
-                    override;
-
-
-        private:
-
-
-            //! The actual algorithm implementation
-            Algorithm::ParticleSwarmOptimization m_Pso;
-        };
-    }
-}
-
-
-#if 0
-namespace std {
-    ostream &operator <<(
-            ostream &os,
-            Winzent::ANN::PsoTrainingAlgorithm const& pso);
-}
-#endif
-
-
-#endif
+        virtual void train(NeuralNetwork& ann, TrainingSet& trainingSet)
+                override;
+
+
+    private:
+
+
+        //! \brief The number of particles
+        size_type m_swarmSize;
+
+
+        //! \brief The factor by which a particle keeps its velocity
+        double m_inertia;
+
+
+        //! \brief The attraction of a particle's own best position
+        double m_cognitiveWeight;
+
+
+        //! \brief The attraction of the swarm's best position
+        double m_socialWeight;
+
+
+        //! \brief The maximum change of a weight per epoch
+        double m_maxVelocity;
+
+
+        //! \brief The smallest value a weight can take
+        double m_lowerBoundary;
+
+
+        //! \brief The largest value a weight can take
+        double m_upperBoundary;
+
+
+        //! \brief The number of threads that evaluate the particles
+        size_type m_numThreads;
+    };
+} // namespace wzann
+
+#endif // WZANN_PSOTRAININGALGORITHM_H_
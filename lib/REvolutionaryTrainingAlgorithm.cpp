@@ -1,5 +1,6 @@
 #include <limits>
 #include <cmath>
+#include <vector>
 #include <cstdlib>
 #include <algorithm>
 
@@ -13,6 +14,10 @@
 #include "NeuralNetwork.h"
 
 #include "TrainingSet.h"
+#include "TrainingItem.h"
+#include "WorkerPool.h"
+#include "ParallelFor.h"
+#include "InferenceContext.h"
 #include "TrainingAlgorithm.h"
 
 #include "ClassRegistry.h"
@@ -24,23 +29,19 @@ using std::exp;
 using std::fabs;
 using std::numeric_limits;
 
-using boost::make_iterator_range;
-
 using wzalgorithm::REvol;
 
 
 namespace wzann {
+    const std::size_t REvolutionaryTrainingAlgorithm::EVALUATION_CHUNK_SIZE;
+
+
     void REvolutionaryTrainingAlgorithm::getWeights(
             NeuralNetwork const& ann,
             wzalgorithm::vector_t& parameters)
     {
-        for (auto const& c : make_iterator_range(ann.connections())) {
-            if (c->fixedWeight()) {
-                continue;
-            }
-
-            parameters.push_back(c->weight());
-        }
+        auto const weights = ann.trainableWeights();
+        parameters.insert(parameters.end(), weights.begin(), weights.end());
     }
 
 
@@ -48,29 +49,15 @@ namespace wzann {
             wzalgorithm::vector_t const& parameters,
             NeuralNetwork& ann)
     {
-        auto pit = parameters.begin();
-        auto connectionsRange = ann.connections();
-        auto cit = connectionsRange.first;
-
-        while (pit != parameters.end() && cit != connectionsRange.second) {
-            if ((*cit)->fixedWeight()) {
-                cit++;
-                continue;
-            }
-
-            (*cit)->weight(*pit);
-            cit++;
-            pit++;
-        }
-
-        assert(pit == parameters.end());
-        assert(cit == connectionsRange.second);
+        ann.trainableWeights(parameters);
     }
 
 
     REvolutionaryTrainingAlgorithm::REvolutionaryTrainingAlgorithm():
             TrainingAlgorithm(),
-            REvol()
+            REvol(),
+            m_numThreads(1),
+            m_racing(false)
     {
         eamin(1e-32);
         ebmin(1e-7);
@@ -81,39 +68,304 @@ namespace wzann {
     }
 
 
+    std::size_t REvolutionaryTrainingAlgorithm::numThreads() const
+    {
+        return m_numThreads;
+    }
+
+
+    REvolutionaryTrainingAlgorithm&
+    REvolutionaryTrainingAlgorithm::numThreads(std::size_t numThreads)
+    {
+        m_numThreads = numThreads;
+        return *this;
+    }
+
+
+    bool REvolutionaryTrainingAlgorithm::racing() const
+    {
+        return m_racing;
+    }
+
+
+    REvolutionaryTrainingAlgorithm& REvolutionaryTrainingAlgorithm::racing(
+            bool racing)
+    {
+        m_racing = racing;
+        return *this;
+    }
+
+
     bool REvolutionaryTrainingAlgorithm::individualSucceeds(
             REvol::Individual& individual,
             NeuralNetwork& ann,
             TrainingSet const& trainingSet)
     {
-        applyParameters(individual.parameters, ann);
+        return individualSucceeds(individual, ann, trainingSet, 1);
+    }
 
-        double error = 0.0;
-        size_t numRelevantItems = 0;
 
-        for (auto const& ti : trainingSet.trainingItems) {
+    class REvolutionaryTrainingAlgorithm::Evaluation
+    {
+    public:
 
-            // First step: Feed forward and compare the network's
-            // output with the ideal teaching output:
 
-            const auto actual = ann.calculate(ti.input());
-            if (! ti.outputRelevant()) {
-                continue;
-            }
-            numRelevantItems++;
-            auto const& expected = ti.expectedOutput();
-
-            double lerror = 0.0;
-            for (auto ait = actual.begin(), eit = expected.begin();
-                    ait != actual.end() && eit != expected.end();
-                    ait++, eit++) {
-                lerror += std::pow(*eit - *ait, 2);
+        /*!
+         * \param[in] racingWindow The number of complete evaluations
+         *  whose errors racing compares with; `0` disables racing
+         *
+         * \param[in] minEvaluations The number of evaluations that are
+         *  always complete
+         */
+        Evaluation(
+                NeuralNetwork const& ann,
+                TrainingSet const& trainingSet,
+                std::size_t numThreads,
+                std::size_t racingWindow,
+                std::size_t minEvaluations);
+
+
+        /*!
+         * \return The worst error of the recent complete evaluations, or
+         *  infinity as long as racing does not apply
+         */
+        double threshold() const;
+
+
+        //! \brief Notes the error of a complete evaluation
+        void record(double error);
+
+
+        //! \brief The number of items per chunk
+        std::size_t const chunkSize;
+
+
+        //! \brief The number of chunks of the training set
+        std::size_t const numChunks;
+
+
+        //! \brief The threads that calculate the chunks
+        WorkerPool pool;
+
+
+        //! \brief The state of the network that each chunk starts from
+        InferenceContext const initialContext;
+
+
+        //! \brief The context of each worker of the #pool
+        std::vector<InferenceContext> contexts;
+
+
+        //! \brief The output buffer of each worker of the #pool
+        std::vector<Vector> outputs;
+
+
+        //! \brief The sum of the errors of each chunk
+        std::vector<double> chunkErrors;
+
+
+        //! \brief The number of relevant items of the training set
+        std::size_t numRelevantItems;
+
+
+        //! \brief The number of complete evaluations racing compares with
+        std::size_t racingWindow;
+
+
+        //! \brief The number of evaluations that are always complete
+        std::size_t minEvaluations;
+
+
+        //! \brief The number of complete evaluations so far
+        std::size_t numEvaluations;
+
+
+        //! \brief The errors of the last complete evaluations, cyclically
+        std::vector<double> recentErrors;
+    };
+
+
+    REvolutionaryTrainingAlgorithm::Evaluation::Evaluation(
+            NeuralNetwork const& ann,
+            TrainingSet const& trainingSet,
+            std::size_t numThreads,
+            std::size_t racingWindow,
+            std::size_t minEvaluations):
+                chunkSize(ann.compile().isRecurrent()
+                    ? std::max<size_t>(1, trainingSet.trainingItems.size())
+                    : EVALUATION_CHUNK_SIZE),
+                numChunks((trainingSet.trainingItems.size() + chunkSize - 1)
+                    / chunkSize),
+                pool(std::max<size_t>(
+                    1,
+                    std::min(effectiveNumThreads(numThreads), numChunks))),
+                initialContext(ann),
+                contexts(pool.numWorkers(), initialContext),
+                outputs(pool.numWorkers()),
+                chunkErrors(numChunks, 0.0),
+                numRelevantItems(std::count_if(
+                    trainingSet.trainingItems.begin(),
+                    trainingSet.trainingItems.end(),
+                    [](TrainingItem const& item) {
+                        return item.outputRelevant();
+                    })),
+                racingWindow(racingWindow),
+                minEvaluations(minEvaluations),
+                numEvaluations(0)
+    {
+        recentErrors.reserve(racingWindow);
+    }
+
+
+    double REvolutionaryTrainingAlgorithm::Evaluation::threshold() const
+    {
+        if (0 == racingWindow || numEvaluations < minEvaluations) {
+            return numeric_limits<double>::infinity();
+        }
+
+        return *std::max_element(recentErrors.begin(), recentErrors.end());
+    }
+
+
+    void REvolutionaryTrainingAlgorithm::Evaluation::record(double error)
+    {
+        if (0 == racingWindow) {
+            return;
+        }
+
+        if (recentErrors.size() < racingWindow) {
+            recentErrors.push_back(error);
+        } else {
+            recentErrors[numEvaluations % racingWindow] = error;
+        }
+
+        ++numEvaluations;
+    }
+
+
+    bool REvolutionaryTrainingAlgorithm::individualSucceeds(
+            REvol::Individual& individual,
+            NeuralNetwork& ann,
+            TrainingSet const& trainingSet,
+            std::size_t numThreads)
+    {
+        return individualSucceeds(
+                individual,
+                ann,
+                trainingSet,
+                numThreads,
+                numeric_limits<double>::infinity());
+    }
+
+
+    bool REvolutionaryTrainingAlgorithm::individualSucceeds(
+            REvol::Individual& individual,
+            NeuralNetwork& ann,
+            TrainingSet const& trainingSet,
+            std::size_t numThreads,
+            double threshold)
+    {
+        Evaluation evaluation(ann, trainingSet, numThreads, 0, 0);
+        return individualSucceeds(
+                individual,
+                ann,
+                trainingSet,
+                evaluation,
+                threshold);
+    }
+
+
+    bool REvolutionaryTrainingAlgorithm::individualSucceeds(
+            REvol::Individual& individual,
+            NeuralNetwork& ann,
+            TrainingSet const& trainingSet,
+            Evaluation& evaluation,
+            double threshold)
+    {
+        applyParameters(individual.parameters, ann);
+
+        // The state of a recurrent network carries over from one item to
+        // the next, hence the training set is one chunk then. The chunks
+        // are fixed, and so is the sum of their errors. Without racing,
+        // all chunks are calculated at once; racing calculates one chunk
+        // per worker at a time:
+
+        auto const& items = trainingSet.trainingItems;
+        auto const chunkSize = evaluation.chunkSize;
+        auto const numChunks = evaluation.numChunks;
+        auto const n = static_cast<double>(evaluation.numRelevantItems);
+        auto const roundSize = (std::isinf(threshold)
+                ? numChunks
+                : evaluation.pool.numWorkers());
+
+        double error = 0.0;
+        bool complete = true;
+
+        for (size_t begin = 0; begin < numChunks && complete;
+                begin += roundSize) {
+            auto const end = std::min(numChunks, begin + roundSize);
+
+            evaluation.pool.run(end - begin, [&](
+                    size_t worker,
+                    size_t task) {
+                auto const chunk = begin + task;
+                auto first = items.begin() + chunk * chunkSize;
+                auto last = items.begin() + std::min(
+                        items.size(),
+                        (chunk + 1) * chunkSize);
+
+                auto& context = evaluation.contexts[worker];
+                auto& actual = evaluation.outputs[worker];
+                double chunkError = 0.0;
+                context = evaluation.initialContext;
+
+                for (auto const& ti:
+                        boost::make_iterator_range(first, last)) {
+                    // First step: Feed forward and compare the network's
+                    // output with the ideal teaching output:
+
+                    ann.calculate(ti.input(), actual, context);
+
+                    if (! ti.outputRelevant()) {
+                        continue;
+                    }
+
+                    auto const& expected = ti.expectedOutput();
+                    double lerror = 0.0;
+
+                    for (auto ait = actual.cbegin(),
+                                eit = expected.cbegin();
+                            ait != actual.end() && eit != expected.end();
+                            ait++, eit++) {
+                        lerror += std::pow(*eit - *ait, 2);
+                    }
+
+                    chunkError += lerror / 2.0;
+                }
+
+                evaluation.chunkErrors[chunk] = chunkError;
+            });
+
+            // The errors are not negative, so the sum so far is a lower
+            // bound of the individual's error. Deciding chunk by chunk
+            // keeps the result independent of the number of threads:
+
+            for (auto chunk = begin; chunk != end; ++chunk) {
+                error += evaluation.chunkErrors[chunk];
+
+                if (chunk + 1 != numChunks && error / n > threshold) {
+                    complete = false;
+                    break;
+                }
             }
+        }
+
+        error /= n;
 
-            error += lerror / 2.0;
+        if (complete) {
+            evaluation.record(error);
         }
 
-        error /= static_cast<double>(numRelevantItems);
         individual.restrictions[0] = error;
         return error <= trainingSet.targetError();
     }
@@ -133,11 +385,27 @@ namespace wzann {
             origin.scatter.push_back(0.2);
         }
 
+        // The threads and their contexts serve all individuals:
+
+        auto const window = populationSize()
+                * static_cast<size_t>(std::max<std::ptrdiff_t>(1, startTTL()));
+        Evaluation evaluation(
+                ann,
+                trainingSet,
+                numThreads(),
+                (m_racing ? window : 0),
+                populationSize());
+
         auto result = REvol::run(
                 origin,
-                [this, &trainingSet, &ann](
+                [&trainingSet, &ann, &evaluation](
                     wzalgorithm::REvol::Individual &individual) {
-            return individualSucceeds(individual, ann, trainingSet);
+            return individualSucceeds(
+                    individual,
+                    ann,
+                    trainingSet,
+                    evaluation,
+                    evaluation.threshold());
         });
 
         applyParameters(result.bestIndividual.parameters, ann);
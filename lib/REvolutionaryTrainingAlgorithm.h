@@ -26,6 +26,23 @@ namespace wzann {
     public:
 
 
+        /*!
+         * \brief The number of training items that are evaluated together
+         *  as one unit of work
+         *
+         * The training set is split into chunks of this size, regardless
+         * of the number of threads. Each chunk is calculated from the
+         * network's initial state, and the errors of the chunks are added
+         * up in their order, so that the error of an individual does not
+         * depend on the number of threads. Recurrent networks carry their
+         * state from one item to the next; for them, the whole training
+         * set is one chunk.
+         *
+         * \sa InferencePlan::isRecurrent()
+         */
+        static const std::size_t EVALUATION_CHUNK_SIZE = 256;
+
+
         /*!
          * \brief Creates a new instance of the multi-part evolutionary
          *  training algorithm for training artificial neural networks.
@@ -33,6 +50,70 @@ namespace wzann {
         REvolutionaryTrainingAlgorithm();
 
 
+        //! \return The number of threads that evaluate an individual
+        std::size_t numThreads() const;
+
+
+        /*!
+         * \brief Sets the number of threads that evaluate an individual
+         *
+         * REvol creates and evaluates one individual at a time. Thus,
+         * the threads share the work of evaluating an individual: Each
+         * thread calculates chunks of the training set with its own
+         * InferenceContext, leaving the network's neurons untouched.
+         * #train() starts the threads and creates their contexts once
+         * and keeps them for all individuals.
+         *
+         * There is one chunk per #EVALUATION_CHUNK_SIZE items, and a
+         * recurrent network's training set is a single chunk. Training
+         * sets of up to #EVALUATION_CHUNK_SIZE items and recurrent
+         * networks are therefore evaluated by one thread.
+         *
+         * \param[in] numThreads The number of threads; `0` selects the
+         *  number of hardware threads. The default is `1`.
+         *
+         * \return `*this`
+         *
+         * \sa #EVALUATION_CHUNK_SIZE
+         */
+        REvolutionaryTrainingAlgorithm& numThreads(std::size_t numThreads);
+
+
+        //! \return Whether evaluations stop early for hopeless individuals
+        bool racing() const;
+
+
+        /*!
+         * \brief Enables or disables racing
+         *
+         * Most offspring are worse than the population. In racing mode,
+         * #train() keeps the errors of the last #populationSize() times
+         * #startTTL() complete evaluations. Once the initial population
+         * is evaluated, each individual is evaluated chunk by chunk, in
+         * the order of the training set. The evaluation stops as soon as
+         * the sum of the chunks' errors so far, divided by the number of
+         * all relevant items, exceeds the worst of these errors. As the
+         * errors of the items are not negative, this partial sum is a
+         * lower bound of the individual's error. The individual receives
+         * the lower bound, which still rates it worse than all
+         * individuals evaluated recently.
+         *
+         * The decision is made chunk by chunk in a fixed order, so that
+         * the result does not depend on the number of threads. Racing
+         * only pays off for training sets that span several chunks; it
+         * has no effect on recurrent networks, whose training set is one
+         * chunk.
+         *
+         * \param[in] racing `true` to enable racing; the default is
+         *  `false`
+         *
+         * \return `*this`
+         *
+         * \sa #EVALUATION_CHUNK_SIZE
+         */
+        REvolutionaryTrainingAlgorithm& racing(bool racing);
+
+
         /*!
          * \brief Reads the current weight vector of an artificial neural
          *  network and writes it to the supplied paramter vector
@@ -90,6 +171,68 @@ namespace wzann {
                 TrainingSet const& trainingSet);
 
 
+        /*!
+         * \brief Evaluates one individual using several threads
+         *
+         * \param[inout] individual The individual
+         *
+         * \param[in] ann The Artificial Neural Network the individual
+         *  applies to
+         *
+         * \param[in] trainingSet The training set that should be used to
+         *  evaluate the individual
+         *
+         * \param[in] numThreads The number of threads; `0` selects the
+         *  number of hardware threads
+         *
+         * \return `true` if the current individual satisfies the target
+         *  error set in the trainingSet, `false` otherwise.
+         *
+         * \sa #individualSucceeds(wzalgorithm::REvol::Individual&,
+         *  NeuralNetwork&, TrainingSet const&)
+         */
+        static bool individualSucceeds(
+                wzalgorithm::REvol::Individual& individual,
+                NeuralNetwork& ann,
+                TrainingSet const& trainingSet,
+                std::size_t numThreads);
+
+
+        /*!
+         * \brief Evaluates one individual, stopping once its error is
+         *  known to exceed a threshold
+         *
+         * The chunks of the training set are calculated in their order.
+         * Once the sum of their errors, divided by the number of all
+         * relevant items, exceeds the threshold, the evaluation stops,
+         * and the individual receives this lower bound of its error.
+         *
+         * \param[inout] individual The individual
+         *
+         * \param[in] ann The Artificial Neural Network the individual
+         *  applies to
+         *
+         * \param[in] trainingSet The training set that should be used to
+         *  evaluate the individual
+         *
+         * \param[in] numThreads The number of threads; `0` selects the
+         *  number of hardware threads
+         *
+         * \param[in] threshold The error above which the evaluation stops
+         *
+         * \return `true` if the current individual satisfies the target
+         *  error set in the trainingSet, `false` otherwise.
+         *
+         * \sa #racing()
+         */
+        static bool individualSucceeds(
+                wzalgorithm::REvol::Individual& individual,
+                NeuralNetwork& ann,
+                TrainingSet const& trainingSet,
+                std::size_t numThreads,
+                double threshold);
+
+
         /*!
          * \brief Trains the Neural Network using Ruppert's evolutionary
          *  training algorithm.
@@ -98,6 +241,39 @@ namespace wzann {
          */
         virtual void train(NeuralNetwork& ann, TrainingSet& trainingSet)
                 override;
+
+
+    private:
+
+
+        /*!
+         * \brief The threads and buffers that evaluate individuals,
+         *  kept from one individual to the next
+         */
+        class Evaluation;
+
+
+        /*!
+         * \brief Evaluates one individual with the workers of an
+         *  Evaluation
+         *
+         * \sa #individualSucceeds(wzalgorithm::REvol::Individual&,
+         *  NeuralNetwork&, TrainingSet const&, std::size_t, double)
+         */
+        static bool individualSucceeds(
+                wzalgorithm::REvol::Individual& individual,
+                NeuralNetwork& ann,
+                TrainingSet const& trainingSet,
+                Evaluation& evaluation,
+                double threshold);
+
+
+        //! \brief The number of threads that evaluate an individual
+        std::size_t m_numThreads;
+
+
+        //! \brief Whether racing is enabled
+        bool m_racing;
     };
 } // namespace wzann
 
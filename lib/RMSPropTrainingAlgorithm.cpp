@@ -0,0 +1,61 @@
+#include <cmath>
+
+#include "ClassRegistry.h"
+
+#include "RMSPropTrainingAlgorithm.h"
+
+
+namespace wzann {
+    const double RMSPropTrainingAlgorithm::DEFAULT_LEARNING_RATE = 0.001;
+    const double RMSPropTrainingAlgorithm::DEFAULT_DECAY = 0.9;
+
+
+    RMSPropTrainingAlgorithm::RMSPropTrainingAlgorithm():
+            AdaptiveGradientTrainingAlgorithm(DEFAULT_LEARNING_RATE),
+            m_decay(DEFAULT_DECAY)
+    {
+    }
+
+
+    double RMSPropTrainingAlgorithm::decay() const
+    {
+        return m_decay;
+    }
+
+
+    RMSPropTrainingAlgorithm& RMSPropTrainingAlgorithm::decay(double decay)
+    {
+        m_decay = decay;
+        return *this;
+    }
+
+
+    void RMSPropTrainingAlgorithm::reset(Vector::size_type numWeights)
+    {
+        m_meanSquares.assign(numWeights, 0.0);
+    }
+
+
+    void RMSPropTrainingAlgorithm::update(
+            Vector& weights,
+            Vector const& gradient,
+            std::vector<char> const&)
+    {
+        auto const rho = m_decay;
+        auto const rate = learningRate();
+        auto const eps = epsilon();
+
+        for (Vector::size_type i = 0; i != weights.size(); ++i) {
+            auto const g = gradient[i];
+            auto& v = m_meanSquares[i];
+
+            v = rho * v + (1.0 - rho) * g * g;
+            weights[i] -= rate * g / (std::sqrt(v) + eps);
+        }
+    }
+} // namespace wzann
+
+
+WZANN_REGISTER_CLASS(
+        wzann::RMSPropTrainingAlgorithm,
+        wzann::TrainingAlgorithm)
@@ -0,0 +1,75 @@
+#ifndef WZANN_RMSPROPTRAININGALGORITHM_H_
+#define WZANN_RMSPROPTRAININGALGORITHM_H_
+
+
+#include <vector>
+
+#include "Vector.h"
+#include "AdaptiveGradientTrainingAlgorithm.h"
+
+
+namespace wzann {
+
+
+    /*!
+     * \brief Trains a neural network using RMSProp
+     *
+     * RMSProp keeps an exponentially decaying average of the squared
+     * gradient of each weight and divides the gradient by its root before
+     * applying it. Weights with consistently large gradients thus take
+     * smaller steps, and vice versa.
+     */
+    class RMSPropTrainingAlgorithm : public AdaptiveGradientTrainingAlgorithm
+    {
+    public:
+
+
+        static const double DEFAULT_LEARNING_RATE;
+
+
+        static const double DEFAULT_DECAY;
+
+
+        //! \brief Creates a new training algorithm instance
+        RMSPropTrainingAlgorithm();
+
+
+        //! \return The decay rate of the mean squared gradients
+        double decay() const;
+
+
+        /*!
+         * \brief Sets the decay rate of the mean squared gradients
+         *
+         * \param[in] decay The new rate, in `[0, 1)`
+         *
+         * \return `*this`
+         */
+        RMSPropTrainingAlgorithm& decay(double decay);
+
+
+    protected:
+
+
+        virtual void reset(Vector::size_type numWeights) override;
+
+
+        virtual void update(
+                Vector& weights,
+                Vector const& gradient,
+                std::vector<char> const& fixedWeights) override;
+
+
+    private:
+
+
+        //! \brief The decay rate of the mean squared gradients
+        double m_decay;
+
+
+        //! \brief The mean squared gradient of each weight
+        Vector m_meanSquares;
+    };
+} // namespace wzann
+
+#endif // WZANN_RMSPROPTRAININGALGORITHM_H_
@@ -1,19 +1,15 @@
 #include <cmath>
 #include <limits>
-#include <numeric>
+#include <memory>
+#include <vector>
 #include <algorithm>
 
-#include <boost/range.hpp>
-#include <boost/range/adaptor/reversed.hpp>
-
-#include "Layer.h"
-#include "Neuron.h"
-#include "Connection.h"
 #include "TrainingSet.h"
 #include "ClassRegistry.h"
 #include "NeuralNetwork.h"
-#include "ActivationFunction.h"
-#include "GradientAnalysisHelper.h"
+#include "ParallelFor.h"
+#include "GradientEngine.h"
+#include "InferenceContext.h"
 
 #include "RpropTrainingAlgorithm.h"
 
@@ -21,11 +17,6 @@
 using std::fabs;
 using std::max;
 using std::min;
-using std::accumulate;
-
-using boost::adaptors::reverse;
-using boost::make_iterator_range;
-
 
 namespace wzann {
     const double RpropTrainingAlgorithm::ETA_POSITIVE =  1.2;
@@ -39,8 +30,30 @@ namespace wzann {
 
 
     RpropTrainingAlgorithm::RpropTrainingAlgorithm() :
-            TrainingAlgorithm()
+            RpropTrainingAlgorithm(Variant::RpropPlus)
+    {
+    }
+
+
+    RpropTrainingAlgorithm::RpropTrainingAlgorithm(Variant variant) :
+            TrainingAlgorithm(),
+            m_variant(variant),
+            m_numThreads(1)
+    {
+    }
+
+
+    std::size_t RpropTrainingAlgorithm::numThreads() const
+    {
+        return m_numThreads;
+    }
+
+
+    RpropTrainingAlgorithm& RpropTrainingAlgorithm::numThreads(
+            std::size_t numThreads)
     {
+        m_numThreads = numThreads;
+        return *this;
     }
 
 
@@ -62,58 +75,75 @@ namespace wzann {
             NeuralNetwork &ann,
             TrainingSet &trainingSet)
     {
-        ConnectionGradientMap currentGradients;
-        ConnectionGradientMap lastGradients;
-        ConnectionGradientMap updateValues;
-        ConnectionGradientMap lastWeightChange;
+        auto const numWeights = ann.weights().size();
+        Vector lastGradients(numWeights, 0.0);
+        Vector updateValues(numWeights, DEFAULT_INITIAL_UPDATE);
+        Vector lastWeightChanges(numWeights, 0.0);
+        Vector weights;
         double error = std::numeric_limits<double>::max();
+        double lastError = std::numeric_limits<double>::max();
         size_t epoch = 0;
 
+        // One gradient engine per shard of the training set. A single
+        // engine calculates with the network itself, so that recurrent
+        // networks keep their state as usual:
+
+        auto const& items = trainingSet.trainingItems;
+        auto const numShards = std::max<size_t>(1, std::min(
+                effectiveNumThreads(numThreads()),
+                items.size()));
+
+        std::vector<InferenceContext> contexts(numShards);
+        std::vector<std::unique_ptr<GradientEngine>> gradientEngines;
+
+        for (size_t i = 0; i != numShards; ++i) {
+            gradientEngines.emplace_back(1 == numShards
+                    ? new GradientEngine(ann)
+                    : new GradientEngine(ann, contexts[i]));
+        }
+
+        std::vector<double> shardErrors(numShards);
+        std::vector<Vector const*> shardGradients(numShards);
+        Vector summedGradient;
+
         for(; epoch < trainingSet.maxEpochs()
                     && error > trainingSet.targetError();
                 ++epoch) {
-            error = 0.0;
-            currentGradients.clear();
-            size_t numRelevantItems = 0;
+            // Forward pass and backpropagation of all items, one shard
+            // per thread:
 
-            // Forward pass:
+            parallelFor(numShards, numShards, [&](size_t shard) {
+                auto& gradientEngine = *(gradientEngines[shard]);
 
-            for (auto const& ti: trainingSet.trainingItems) {
-                const Vector actualOutput = ann.calculate(ti.input());
-                if (! ti.outputRelevant()) {
-                    continue;
+                if (numShards > 1) {
+                    contexts[shard].load(ann);
                 }
 
-                numRelevantItems++;
-                Vector errorOutput;
-                errorOutput.reserve(actualOutput.size());
-                error += GradientAnalysisHelper::errors(
-                        make_iterator_range(actualOutput),
-                        make_iterator_range(ti.expectedOutput()),
-                        std::back_inserter(errorOutput));
-
-                GradientAnalysisHelper::NeuronDeltaMap neuronDeltas;
+                gradientEngine.clear();
+                shardErrors[shard] = gradientEngine.accumulate(
+                        items.begin() + shard * items.size() / numShards,
+                        items.begin()
+                            + (shard + 1) * items.size() / numShards);
+                shardGradients[shard] = &(gradientEngine.gradient());
+            });
 
-                // Calculate error delta of all neurons
-                // in the forward pass:
+            // Add up the shards' results in a fixed order, so that the
+            // result does not depend on the scheduling of the threads:
 
-                for (auto* c: reverse(ann.connections())) {
-                    if (c->fixedWeight()) {
-                        continue;
-                    }
-
-                    auto const& dstNeuron = c->destination();
-                    auto delta = GradientAnalysisHelper::neuronDelta(
-                            ann,
-                            c->destination(),
-                            neuronDeltas,
-                            errorOutput);
-                    neuronDeltas[&dstNeuron] = delta;
+            lastError = error;
+            error = 0.0;
+            size_t numRelevantItems = 0;
+            summedGradient = *(shardGradients.front());
 
-                    // Add up gradients. The default-constructed value
-                    // in for value-initalization is zero initialization:
+            for (size_t shard = 0; shard != numShards; ++shard) {
+                error += shardErrors[shard];
+                numRelevantItems += gradientEngines[shard]->numItems();
 
-                    currentGradients[c] += delta*c->source().lastResult();
+                if (shard > 0) {
+                    auto const& gradient = *(shardGradients[shard]);
+                    for (size_t i = 0; i != gradient.size(); ++i) {
+                        summedGradient[i] += gradient[i];
+                    }
                 }
             }
 
@@ -121,44 +151,65 @@ namespace wzann {
 
             error /= numRelevantItems;
 
-            // Now, learn:
+            // Now, learn. Fixed weights have a gradient of zero and thus
+            // never change:
 
-            for (auto const& gradient: currentGradients) {
-                auto* c = gradient.first;
+            auto const& fixedWeights = ann.fixedWeights();
+            weights = ann.weights();
 
-                int change = sgn(currentGradients[c] * lastGradients[c]);
-                double dw = 0.0;
-
-                double updateValue = DEFAULT_INITIAL_UPDATE;
-                if (updateValues.find(c) != updateValues.end()) {
-                    updateValue = updateValues[c];
+            for (size_t i = 0; i != numWeights; ++i) {
+                if (fixedWeights[i]) {
+                    continue;
                 }
 
+                auto const gradient = summedGradient[i];
+                int change = sgn(gradient * lastGradients[i]);
+                double dw = 0.0;
+
                 if (0 == change) {
-                    double delta = updateValue;
-                    dw = sgn(currentGradients[c]) * delta;
-                    lastGradients[c] = currentGradients[c];
+                    dw = sgn(gradient) * updateValues[i];
+                    lastGradients[i] = gradient;
+
+                    if (Variant::RpropPlus != m_variant) {
+                        lastWeightChanges[i] = dw;
+                    }
                 } else if (change > 0) { // Retained sign, increase step:
-                    double delta = updateValue * ETA_POSITIVE;
+                    double delta = updateValues[i] * ETA_POSITIVE;
                     delta = min(delta, MAX_STEP);
-                    dw = sgn(currentGradients[c]) * delta;
-                    updateValues[c] = delta;
-                    lastGradients[c] = currentGradients[c];
-                    lastWeightChange[c] = dw;
+                    dw = sgn(gradient) * delta;
+                    updateValues[i] = delta;
+                    lastGradients[i] = gradient;
+                    lastWeightChanges[i] = dw;
                 } else { // change < 0 --- Last delta was too big
-                    double delta = updateValue * ETA_NEGATIVE;
-                    delta = max(delta, DELTA_MIN);
-                    updateValues[c] = delta;
-                    dw = -lastWeightChange[c];
+                    if (Variant::RpropPlus == m_variant) {
+                        double delta = updateValues[i] * ETA_NEGATIVE;
+                        updateValues[i] = max(delta, DELTA_MIN);
+                        dw = -lastWeightChanges[i];
+                    } else {
+                        // The improved variants shrink the step by the
+                        // magnitude of ETA_NEGATIVE:
+
+                        double delta = updateValues[i] * fabs(ETA_NEGATIVE);
+                        updateValues[i] = max(delta, DELTA_MIN);
+
+                        if (Variant::IRpropPlus == m_variant
+                                && error > lastError) {
+                            dw = -lastWeightChanges[i];
+                        }
+
+                        lastWeightChanges[i] = 0.0;
+                    }
 
                     // Set the previous gradent to zero so that there will
                     // be no adjustment the next iteration:
 
-                    lastGradients[c] = 0.0;
+                    lastGradients[i] = 0.0;
                 }
 
-                c->weight(c->weight() - dw);
+                weights[i] -= dw;
             }
+
+            ann.swapWeights(weights);
         }
 
         setFinalError(trainingSet, error);
@@ -2,10 +2,10 @@
 #define WZANN_RPROPTRAININGALGORITHM_H_
 
 
-#include <unordered_map>
+#include <cstddef>
 
 #include "TrainingSet.h"
-#include "BackpropagationTrainingAlgorithm.h"
+#include "TrainingAlgorithm.h"
 
 
 namespace wzann {
@@ -14,25 +14,39 @@ namespace wzann {
 
 
     /*!
-     * \brief Trains a neural network using the iRPROP+ algorithm.
+     * \brief Trains a neural network using the Resilient BackPropagation
+     *  (RPROP) algorithm.
      *
-     * iRPROP+ is an improved version of the original Resilient
-     * BackPropagation training algorithm. It uses weight backtracking which
-     * reverts the weight change of the last iteration if the sign of the
-     * gradient changes in the current iteration.
+     * RPROP adapts an individual step size for each weight, using only
+     * the sign of the full-batch gradient. This class implements RPROP
+     * with weight backtracking, which reverts the weight change of the
+     * last iteration whenever the sign of the gradient changes in the
+     * current iteration.
      *
-     * Some research suggests that iRPROP+ is the optimum RPROP algorithm.
+     * The improved variants iRPROP+ and iRPROP- are available as
+     * IRpropPlusTrainingAlgorithm and IRpropMinusTrainingAlgorithm.
+     *
+     * The state of the algorithm is kept in flat arrays in the order of
+     * NeuralNetwork::weights(), and all weights are updated in one pass
+     * over these arrays.
+     *
+     * The gradient of each epoch can be calculated by several threads:
+     * The training items are split into one contiguous shard per thread,
+     * and each thread calculates the gradient of its shard with its own
+     * InferenceContext. The gradients of the shards are then added up in
+     * the order of the shards. Thus, a training run with a particular
+     * number of threads always yields the same result, no matter how the
+     * threads are scheduled.
+     *
+     * With several threads, each shard of a recurrent network's training
+     * set starts from the network's state at the beginning of the epoch,
+     * and the state of the network's neurons is not updated.
      */
     class RpropTrainingAlgorithm : public TrainingAlgorithm
     {
     public:
 
 
-        typedef std::unordered_map<
-                Connection*,
-                double> ConnectionGradientMap;
-
-
         /*!
          * \brief Positive step value
          */
@@ -88,6 +102,21 @@ namespace wzann {
         RpropTrainingAlgorithm();
 
 
+        //! \return The number of threads that calculate the gradient
+        std::size_t numThreads() const;
+
+
+        /*!
+         * \brief Sets the number of threads that calculate the gradient
+         *
+         * \param[in] numThreads The number of threads; `0` selects the
+         *  number of hardware threads. The default is `1`.
+         *
+         * \return `*this`
+         */
+        RpropTrainingAlgorithm& numThreads(std::size_t numThreads);
+
+
         /*!
          * \brief Trains the neural network
          *
@@ -95,6 +124,43 @@ namespace wzann {
          */
         virtual void train(NeuralNetwork& ann, TrainingSet& trainingSet)
                 override;
+
+
+    protected:
+
+
+        //! \brief The RPROP variants
+        enum class Variant
+        {
+            //! \brief RPROP with unconditional weight backtracking
+            RpropPlus,
+
+            //! \brief Backtracks only if the error has increased
+            IRpropPlus,
+
+            //! \brief Never backtracks
+            IRpropMinus
+        };
+
+
+        /*!
+         * \brief Creates a new training algorithm instance that
+         *  implements a particular RPROP variant
+         *
+         * \param[in] variant The variant
+         */
+        explicit RpropTrainingAlgorithm(Variant variant);
+
+
+    private:
+
+
+        //! \brief The RPROP variant
+        Variant m_variant;
+
+
+        //! \brief The number of threads that calculate the gradient
+        std::size_t m_numThreads;
     };
 } // namespace wzann
 
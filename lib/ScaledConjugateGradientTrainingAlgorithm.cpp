@@ -0,0 +1,223 @@
+#include <cmath>
+#include <algorithm>
+
+#include "TrainingSet.h"
+#include "ClassRegistry.h"
+#include "NeuralNetwork.h"
+#include "GradientEngine.h"
+
+#include "ScaledConjugateGradientTrainingAlgorithm.h"
+
+
+namespace wzann {
+    ScaledConjugateGradientTrainingAlgorithm::
+            ScaledConjugateGradientTrainingAlgorithm():
+                TrainingAlgorithm(),
+                m_sigma(DEFAULT_SIGMA),
+                m_lambda(DEFAULT_LAMBDA)
+    {
+    }
+
+
+    double ScaledConjugateGradientTrainingAlgorithm::sigma() const
+    {
+        return m_sigma;
+    }
+
+
+    ScaledConjugateGradientTrainingAlgorithm&
+    ScaledConjugateGradientTrainingAlgorithm::sigma(double sigma)
+    {
+        m_sigma = sigma;
+        return *this;
+    }
+
+
+    double ScaledConjugateGradientTrainingAlgorithm::lambda() const
+    {
+        return m_lambda;
+    }
+
+
+    ScaledConjugateGradientTrainingAlgorithm&
+    ScaledConjugateGradientTrainingAlgorithm::lambda(double lambda)
+    {
+        m_lambda = lambda;
+        return *this;
+    }
+
+
+    void ScaledConjugateGradientTrainingAlgorithm::train(
+            NeuralNetwork& ann,
+            TrainingSet& trainingSet)
+    {
+        auto const W = ann.weights().size();
+        auto const& fixedWeights = ann.fixedWeights();
+        auto const numTrainable = std::max<std::ptrdiff_t>(1, std::count(
+                fixedWeights.begin(),
+                fixedWeights.end(),
+                0));
+
+        GradientEngine engine(ann);
+        Vector weights = ann.weights();
+        Vector gradient;
+        Vector trial(W);
+        Vector trialGradient;
+        Vector direction(W);
+
+        double error = meanGradient(
+                ann,
+                trainingSet,
+                engine,
+                weights,
+                gradient);
+        double lambda = m_lambda;
+        double lambdaBar = 0.0;
+        double delta = 0.0;
+        bool success = true;
+        std::ptrdiff_t numSteps = 0;
+
+        for (Vector::size_type i = 0; i != W; ++i) {
+            direction[i] = -gradient[i];
+        }
+
+        size_t epochs = 0;
+        bool stalled = false;
+
+        for (; epochs < trainingSet.maxEpochs()
+                    && error > trainingSet.targetError()
+                    && ! stalled;
+                ++epochs) {
+            double mu = 0.0;
+
+            for (Vector::size_type i = 0; i != W; ++i) {
+                mu -= direction[i] * gradient[i];
+            }
+
+            // Restart if the direction does not descend any more:
+
+            if (! (mu > 0.0)) {
+                mu = 0.0;
+
+                for (Vector::size_type i = 0; i != W; ++i) {
+                    direction[i] = -gradient[i];
+                    mu += gradient[i] * gradient[i];
+                }
+
+                numSteps = 0;
+                success = true;
+            }
+
+            double pp = 0.0;
+
+            for (auto const& p: direction) {
+                pp += p * p;
+            }
+
+            if (0.0 == pp) {
+                stalled = true;
+                continue;
+            }
+
+            // Estimate the curvature along the direction:
+
+            if (success) {
+                auto const sigma = m_sigma / std::sqrt(pp);
+
+                for (Vector::size_type i = 0; i != W; ++i) {
+                    trial[i] = weights[i] + sigma * direction[i];
+                }
+
+                meanGradient(ann, trainingSet, engine, trial, trialGradient);
+                delta = 0.0;
+
+                for (Vector::size_type i = 0; i != W; ++i) {
+                    delta += direction[i]
+                            * (trialGradient[i] - gradient[i]);
+                }
+
+                delta /= sigma;
+            }
+
+            // Scale it, and make it positive:
+
+            delta += (lambda - lambdaBar) * pp;
+
+            if (delta <= 0.0) {
+                lambdaBar = 2.0 * (lambda - delta / pp);
+                delta = -delta + lambda * pp;
+                lambda = lambdaBar;
+            }
+
+            // Try the step and compare with the quadratic model:
+
+            auto const alpha = mu / delta;
+
+            for (Vector::size_type i = 0; i != W; ++i) {
+                trial[i] = weights[i] + alpha * direction[i];
+            }
+
+            auto const trialError = meanGradient(
+                    ann,
+                    trainingSet,
+                    engine,
+                    trial,
+                    trialGradient);
+            auto comparison = 2.0 * delta * (error - trialError) / (mu * mu);
+
+            if (std::isnan(comparison)) {
+                comparison = -1.0;
+            }
+
+            if (comparison >= 0.0) {
+                double beta = 0.0;
+
+                for (Vector::size_type i = 0; i != W; ++i) {
+                    beta += trialGradient[i]
+                            * (trialGradient[i] - gradient[i]);
+                }
+
+                beta /= mu;
+
+                if (++numSteps >= numTrainable) {
+                    beta = 0.0;
+                    numSteps = 0;
+                }
+
+                for (Vector::size_type i = 0; i != W; ++i) {
+                    direction[i] = -trialGradient[i] + beta * direction[i];
+                }
+
+                weights.swap(trial);
+                gradient.swap(trialGradient);
+                error = trialError;
+                lambdaBar = 0.0;
+                success = true;
+
+                if (comparison >= 0.75) {
+                    lambda /= 4.0;
+                }
+            } else {
+                ann.weights(weights);
+                lambdaBar = lambda;
+                success = false;
+            }
+
+            if (comparison < 0.25) {
+                lambda += delta * (1.0 - comparison) / pp;
+            }
+
+            stalled = ! std::isfinite(lambda);
+        }
+
+        // Store final training results:
+
+        setFinalError(trainingSet, error);
+        setFinalNumEpochs(trainingSet, epochs);
+    }
+} // namespace wzann
+
+
+WZANN_REGISTER_CLASS(
+        wzann::ScaledConjugateGradientTrainingAlgorithm,
+        wzann::TrainingAlgorithm)
@@ -0,0 +1,104 @@
+#ifndef WZANN_SCALEDCONJUGATEGRADIENTTRAININGALGORITHM_H_
+#define WZANN_SCALEDCONJUGATEGRADIENTTRAININGALGORITHM_H_
+
+
+#include "Vector.h"
+#include "TrainingAlgorithm.h"
+
+
+namespace wzann {
+    class TrainingSet;
+    class NeuralNetwork;
+
+
+    /*!
+     * \brief Trains a neural network using Møller's scaled conjugate
+     *  gradient algorithm
+     *
+     * Scaled conjugate gradient descends along conjugate directions of
+     * the error function of the whole training set. Instead of a line
+     * search, it estimates the curvature along the direction from the
+     * difference of two gradients, which are #sigma() apart, and takes
+     * the Newton step for this curvature. A Levenberg-Marquardt-like
+     * scale, starting at #lambda(), keeps the curvature positive and is
+     * adapted to how well the quadratic model predicted the error.
+     *
+     * Each epoch costs two passes through the training set: one for the
+     * curvature, and one that calculates the error and the gradient of
+     * the trial step together, so that the gradient of an accepted step
+     * is reused for the next direction. The direction is reset to the
+     * steepest descent after as many steps as there are trainable
+     * weights.
+     *
+     * All state is kept in flat arrays in the order of
+     * NeuralNetwork::weights(). Fixed weights have a gradient of zero and
+     * remain unchanged.
+     */
+    class ScaledConjugateGradientTrainingAlgorithm : public TrainingAlgorithm
+    {
+    public:
+
+
+        const double DEFAULT_SIGMA = 1e-4;
+
+
+        const double DEFAULT_LAMBDA = 1e-6;
+
+
+        //! \brief Creates a new training algorithm instance
+        ScaledConjugateGradientTrainingAlgorithm();
+
+
+        //! \return The distance used to estimate the curvature
+        double sigma() const;
+
+
+        /*!
+         * \brief Sets the distance, relative to the length of the
+         *  direction, at which the second gradient is calculated
+         *
+         * \param[in] sigma The distance, greater than `0.0`
+         *
+         * \return `*this`
+         */
+        ScaledConjugateGradientTrainingAlgorithm& sigma(double sigma);
+
+
+        //! \return The initial scale
+        double lambda() const;
+
+
+        /*!
+         * \brief Sets the scale added to the curvature at the start of the
+         *  training
+         *
+         * \param[in] lambda The initial scale, greater than `0.0`
+         *
+         * \return `*this`
+         */
+        ScaledConjugateGradientTrainingAlgorithm& lambda(double lambda);
+
+
+        /*!
+         * \brief Trains the neural network with the given trainingSet.
+         *
+         * \param[in] trainingSet A set of sample inputs and expected
+         *  outputs.
+         */
+        virtual void train(NeuralNetwork& ann, TrainingSet& trainingSet)
+                override;
+
+
+    private:
+
+
+        //! \brief The distance used to estimate the curvature
+        double m_sigma;
+
+
+        //! \brief The initial scale
+        double m_lambda;
+    };
+} // namespace wzann
+
+#endif // WZANN_SCALEDCONJUGATEGRADIENTTRAININGALGORITHM_H_
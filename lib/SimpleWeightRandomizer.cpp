@@ -12,9 +12,13 @@ using boost::make_iterator_range;
 
 
 namespace wzann {
+    constexpr std::uint32_t SimpleWeightRandomizer::defaultSeed;
+
+
     SimpleWeightRandomizer::SimpleWeightRandomizer():
             m_minWeight(defaultMinWeight),
-            m_maxWeight(defaultMaxWeight)
+            m_maxWeight(defaultMaxWeight),
+            m_seed(defaultSeed)
     {
     }
 
@@ -47,9 +51,22 @@ namespace wzann {
     }
 
 
+    std::uint32_t SimpleWeightRandomizer::seed() const
+    {
+        return m_seed;
+    }
+
+
+    SimpleWeightRandomizer &SimpleWeightRandomizer::seed(std::uint32_t seed)
+    {
+        m_seed = seed;
+        return *this;
+    }
+
+
     void SimpleWeightRandomizer::randomize(NeuralNetwork& neuralNetwork)
     {
-        boost::random::mt11213b rng;
+        boost::random::mt11213b rng(m_seed);
         boost::random::uniform_real_distribution<double> rDistribution(
                 m_minWeight,
                 m_maxWeight);
@@ -2,6 +2,8 @@
 #define WINZENT_ANN_SIMPLEWEIGHTRANDOMIZER_H
 
 
+#include <cstdint>
+
 #include "WeightRandomizer.h"
 
 
@@ -26,6 +28,12 @@ namespace wzann {
         static constexpr double defaultMaxWeight = +0.1;
 
 
+        /*!
+         * \brief The default seed of the random number generator
+         */
+        static constexpr std::uint32_t defaultSeed = 5489u;
+
+
         /*!
          * \brief Constructs a new instance of the simple weight
          *  randomizer
@@ -73,6 +81,28 @@ namespace wzann {
         SimpleWeightRandomizer& maxWeight(double weight);
 
 
+        /*!
+         * \brief Retrieves the seed of the random number generator.
+         *
+         * \return The seed
+         */
+        std::uint32_t seed() const;
+
+
+        /*!
+         * \brief Sets the seed of the random number generator.
+         *
+         * Each call to #randomize() starts from this seed, so randomizing
+         * the same network twice yields the same weights. Different seeds
+         * yield different initializations.
+         *
+         * \param[in] seed The new seed
+         *
+         * \return `*this`
+         */
+        SimpleWeightRandomizer& seed(std::uint32_t seed);
+
+
         /*!
          * \brief Randomizes the weights of the artificial neural network
          *  by assigning a random number from [minWeight, maxWeight) to
@@ -96,6 +126,10 @@ namespace wzann {
 
         //! \brief The absolute maximum weight of this instance
         double m_maxWeight;
+
+
+        //! \brief The seed of the random number generator
+        std::uint32_t m_seed;
     };
 } // namespace wzann
 
@@ -1,212 +1,313 @@
-#include <limits>
 #include <cmath>
-#include <cstddef>
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <utility>
 #include <algorithm>
 
-#include <log4cxx/logger.h>
+#include <boost/random/mersenne_twister.hpp>
+#include <boost/random/uniform_real_distribution.hpp>
 
-#include <QtDebug>
-#include <QTextStream>
-
-#include "QtContainerOutput.h"
-
-#include "TrainingAlgorithm.h"
-#include "NeuralNetwork.h"
-#include "Layer.h"
-#include "Neuron.h"
-#include "Connection.h"
 #include "TrainingSet.h"
+#include "ParallelFor.h"
+#include "ClassRegistry.h"
+#include "NeuralNetwork.h"
+#include "InferenceContext.h"
+
 #include "SimulatedAnnealingTrainingAlgorithm.h"
 
 
-using std::exp;
-using std::log;
+namespace wzann {
+    SimulatedAnnealingTrainingAlgorithm::SimulatedAnnealingTrainingAlgorithm():
+            TrainingAlgorithm(),
+            m_startTemperature(DEFAULT_START_TEMPERATURE),
+            m_stopTemperature(DEFAULT_STOP_TEMPERATURE),
+            m_cycles(DEFAULT_CYCLES),
+            m_stepSize(DEFAULT_STEP_SIZE),
+            m_replicas(DEFAULT_REPLICAS),
+            m_exchangeInterval(DEFAULT_EXCHANGE_INTERVAL),
+            m_numThreads(0)
+    {
+    }
 
 
-namespace Winzent {
-    namespace ANN {
+    SimulatedAnnealingTrainingAlgorithm::SimulatedAnnealingTrainingAlgorithm(
+            double startTemperature,
+            double stopTemperature,
+            size_type cycles):
+                SimulatedAnnealingTrainingAlgorithm()
+    {
+        m_startTemperature = startTemperature;
+        m_stopTemperature = stopTemperature;
+        m_cycles = cycles;
+    }
 
 
-        const double SimulatedAnnealingTrainingAlgorithm::CUT = 0.5;
+    double SimulatedAnnealingTrainingAlgorithm::startTemperature() const
+    {
+        return m_startTemperature;
+    }
 
 
-        SimulatedAnnealingTrainingAlgorithm::SimulatedAnnealingTrainingAlgorithm(
-                double startTemperature,
-                double stopTemperature,
-                size_t cycles):
-                    TrainingAlgorithm(),
-                    m_startTemperature(startTemperature),
-                    m_stopTemperature(stopTemperature),
-                    m_cycles(cycles)
-        {
-        }
+    SimulatedAnnealingTrainingAlgorithm&
+    SimulatedAnnealingTrainingAlgorithm::startTemperature(double temperature)
+    {
+        m_startTemperature = temperature;
+        return *this;
+    }
 
 
-        double SimulatedAnnealingTrainingAlgorithm::startTemperature() const
-        {
-            return m_startTemperature;
-        }
+    double SimulatedAnnealingTrainingAlgorithm::stopTemperature() const
+    {
+        return m_stopTemperature;
+    }
 
 
-        double SimulatedAnnealingTrainingAlgorithm::stopTemperature() const
-        {
-            return m_stopTemperature;
-        }
+    SimulatedAnnealingTrainingAlgorithm&
+    SimulatedAnnealingTrainingAlgorithm::stopTemperature(double temperature)
+    {
+        m_stopTemperature = temperature;
+        return *this;
+    }
 
 
-        size_t SimulatedAnnealingTrainingAlgorithm::cycles() const
-        {
-            return m_cycles;
-        }
+    SimulatedAnnealingTrainingAlgorithm::size_type
+    SimulatedAnnealingTrainingAlgorithm::cycles() const
+    {
+        return m_cycles;
+    }
 
 
-        Vector SimulatedAnnealingTrainingAlgorithm::getParameters(
-                const NeuralNetwork &neuralNetwork)
-        {
-            Vector r;
+    SimulatedAnnealingTrainingAlgorithm&
+    SimulatedAnnealingTrainingAlgorithm::cycles(size_type cycles)
+    {
+        m_cycles = cycles;
+        return *this;
+    }
 
-            const_cast<NeuralNetwork &>(neuralNetwork).eachConnection(
-                        [&r](const Connection *const &c) {
-                if (!c->fixedWeight()) {
-                    r << c->weight();
-                }
-            });
 
-            return r;
-        }
+    double SimulatedAnnealingTrainingAlgorithm::stepSize() const
+    {
+        return m_stepSize;
+    }
 
 
-        void SimulatedAnnealingTrainingAlgorithm::applyParameters(
-                const Vector &parameters,
-                NeuralNetwork &neuralNetwork)
-        {
-            int i = 0;
-            neuralNetwork.eachConnection([&i, &parameters](
-                    Connection *const &c) {
-                if (!c->fixedWeight()) {
-                    c->weight(parameters.at(i++));
-                }
-            });
-        }
+    SimulatedAnnealingTrainingAlgorithm&
+    SimulatedAnnealingTrainingAlgorithm::stepSize(double stepSize)
+    {
+        m_stepSize = stepSize;
+        return *this;
+    }
 
 
-        void SimulatedAnnealingTrainingAlgorithm::randomize(
-                Vector &parameters,
-                const double &temperature)
-        {
-
-            std::for_each(parameters.begin(), parameters.end(),
-                        [this, &temperature](double &w) {
-                double add = CUT - qrand() / static_cast<double>(RAND_MAX);
-                add /= startTemperature();
-                add *= temperature;
-
-                w += add;
-
-                LOG4CXX_DEBUG(
-                        logger,
-                         "w = "
-                            << w - add
-                            << " + "
-                            << add
-                            << " = "
-                            << w);
-            });
-        }
+    SimulatedAnnealingTrainingAlgorithm::size_type
+    SimulatedAnnealingTrainingAlgorithm::replicas() const
+    {
+        return m_replicas;
+    }
+
 
+    SimulatedAnnealingTrainingAlgorithm&
+    SimulatedAnnealingTrainingAlgorithm::replicas(size_type replicas)
+    {
+        m_replicas = replicas;
+        return *this;
+    }
 
-        double SimulatedAnnealingTrainingAlgorithm::iterate(
-                NeuralNetwork &network,
-                TrainingSet const &trainingSet)
-        {
-            // Initialze state: Safe the best known network configuration and
-            // the score (i. e., error value) of that network:
 
-            Vector bestParameters;
-            double bestScore     = std::numeric_limits<double>::max();
-            double temperature   = startTemperature();
+    SimulatedAnnealingTrainingAlgorithm::size_type
+    SimulatedAnnealingTrainingAlgorithm::exchangeInterval() const
+    {
+        return m_exchangeInterval;
+    }
 
-            // Execute all circles, plus one to get the score of the current
-            // solution:
 
-            for (auto i = 0; i < cycles(); ++i) {
-                double score         = 0.0;
-                size_t trainingItems= 0;
+    SimulatedAnnealingTrainingAlgorithm&
+    SimulatedAnnealingTrainingAlgorithm::exchangeInterval(size_type steps)
+    {
+        m_exchangeInterval = steps;
+        return *this;
+    }
 
-                Vector parameters = getParameters(network);
-                randomize(parameters, temperature);
-                applyParameters(parameters, network);
 
-                for (const auto &item: trainingSet.trainingItems) {
-                    Vector actualOutput = network.calculate(
-                            item.input());
+    SimulatedAnnealingTrainingAlgorithm::size_type
+    SimulatedAnnealingTrainingAlgorithm::numThreads() const
+    {
+        return m_numThreads;
+    }
 
-                    if (! item.outputRelevant()) {
-                        continue;
-                    }
 
-                    Vector expectedOutput = item.expectedOutput();
-                    score += calculateMeanSquaredError(
-                            actualOutput,
-                            expectedOutput);
-                    ++trainingItems;
-                }
+    SimulatedAnnealingTrainingAlgorithm&
+    SimulatedAnnealingTrainingAlgorithm::numThreads(size_type numThreads)
+    {
+        m_numThreads = numThreads;
+        return *this;
+    }
 
-                score /= static_cast<double>(trainingItems);
 
-                // Accept the solution if its better (score < bestScore)
+    void SimulatedAnnealingTrainingAlgorithm::train(
+            NeuralNetwork& ann,
+            TrainingSet& trainingSet)
+    {
+        auto const numReplicas = std::max<size_type>(1, m_replicas);
+        auto const cycles = std::max<size_type>(1, m_cycles);
+        auto const targetError = trainingSet.targetError();
+        InferenceContext const initialContext(ann);
 
-                LOG4CXX_DEBUG(
-                        logger,
-                        "Score: "
-                            << score
-                            << ", bestScore: "
-                            << bestScore);
+        // Each replica has its own network to evaluate weights with,
+        // its own random numbers and its own best weights:
 
-                if (score < bestScore) {
-                    bestParameters  = parameters;
-                    bestScore       = score;
+        std::vector<std::unique_ptr<NeuralNetwork>> networks;
+        std::vector<boost::random::mt11213b> rngs;
 
-                    LOG4CXX_DEBUG(
-                            logger,
-                            "Accepted solution " << bestParameters
-                                << ", score:" << score);
+        for (size_type r = 0; r != numReplicas; ++r) {
+            networks.emplace_back(new NeuralNetwork(ann));
+            rngs.emplace_back(static_cast<std::uint32_t>(r));
+        }
+
+        Vector best = ann.trainableWeights();
+        double bestError = meanError(ann, trainingSet, initialContext);
+
+        std::vector<Vector> current(numReplicas, best);
+        std::vector<Vector> candidate(numReplicas, best);
+        std::vector<double> errors(numReplicas, bestError);
+        std::vector<Vector> replicaBest(numReplicas, best);
+        std::vector<double> replicaBestErrors(numReplicas, bestError);
+
+        auto step = [&](size_type r, double temperature) {
+            boost::random::uniform_real_distribution<double> change(
+                    -0.5,
+                    0.5);
+            boost::random::uniform_real_distribution<double> chance(
+                    0.0,
+                    1.0);
+            auto const scale = m_stepSize * temperature / m_startTemperature;
+            auto& rng = rngs[r];
+
+            for (size_type i = 0; i != best.size(); ++i) {
+                candidate[r][i] = current[r][i] + scale * change(rng);
+            }
+
+            networks[r]->trainableWeights(candidate[r]);
+            auto const error = meanError(
+                    *networks[r],
+                    trainingSet,
+                    initialContext);
+
+            if (error <= errors[r]
+                    || chance(rng) < std::exp(
+                        -(error - errors[r]) / temperature)) {
+                current[r].swap(candidate[r]);
+                errors[r] = error;
+
+                if (error < replicaBestErrors[r]) {
+                    replicaBest[r] = current[r];
+                    replicaBestErrors[r] = error;
                 }
+            }
+        };
 
-                temperature *= exp(log(stopTemperature() / startTemperature())
-                        / static_cast<double>(cycles() - 1));
+        auto collectBest = [&]() {
+            for (size_type r = 0; r != numReplicas; ++r) {
+                if (replicaBestErrors[r] < bestError) {
+                    best = replicaBest[r];
+                    bestError = replicaBestErrors[r];
+                }
             }
+        };
 
-            applyParameters(bestParameters, network);
-            return bestScore;
+        // Parallel tempering spaces the replicas' temperatures
+        // geometrically, the coldest first:
+
+        std::vector<double> temperatures(numReplicas, m_startTemperature);
+
+        for (size_type r = 0; r + 1 < numReplicas; ++r) {
+            temperatures[r] = m_stopTemperature * std::pow(
+                    m_startTemperature / m_stopTemperature,
+                    static_cast<double>(r)
+                        / static_cast<double>(numReplicas - 1));
         }
 
+        auto const exchangeInterval = std::max<size_type>(
+                1,
+                m_exchangeInterval);
+        boost::random::mt11213b exchangeRng(
+                static_cast<std::uint32_t>(numReplicas));
+        boost::random::uniform_real_distribution<double> chance(0.0, 1.0);
+        size_type parity = 0;
+        size_t epochs = 0;
+
+        for (; epochs < trainingSet.maxEpochs() && bestError > targetError;
+                ++epochs) {
+            if (1 == numReplicas) {
+
+                // Anneal from the best weights known so far:
+
+                current[0] = best;
+                errors[0] = bestError;
+                auto const cooling = (1 == cycles
+                        ? 1.0
+                        : std::pow(
+                            m_stopTemperature / m_startTemperature,
+                            1.0 / static_cast<double>(cycles - 1)));
+                auto temperature = m_startTemperature;
+
+                for (size_type c = 0;
+                        c != cycles && replicaBestErrors[0] > targetError;
+                        ++c) {
+                    step(0, temperature);
+                    temperature *= cooling;
+                }
 
-        void SimulatedAnnealingTrainingAlgorithm::train(
-                NeuralNetwork &ann,
-                TrainingSet &trainingSet)
-        {
-            // Init state:
+                collectBest();
+                continue;
+            }
 
-            double error     = std::numeric_limits<double>::max();
-            size_t epoch    = -1;
+            for (size_type done = 0;
+                    done < cycles && bestError > targetError;
+                    done += exchangeInterval) {
+                auto const numSteps = std::min(
+                        exchangeInterval,
+                        cycles - done);
+
+                parallelFor(numReplicas, m_numThreads, [&](size_type r) {
+                    for (size_type s = 0;
+                            s != numSteps
+                                && replicaBestErrors[r] > targetError;
+                            ++s) {
+                        step(r, temperatures[r]);
+                    }
+                });
 
-            while (error > trainingSet.targetError()
-                   && ++epoch < trainingSet.maxEpochs()) {
-                error = iterate(ann, trainingSet);
+                collectBest();
 
-                LOG4CXX_DEBUG(
-                        logger,
-                        "Epoch #" << epoch << ": "
-                            << "error: " << error
-                            << " targetError: " << trainingSet.targetError());
+                // Exchange the weights of neighboring replicas:
 
-            }
+                for (size_type r = parity; r + 1 < numReplicas; r += 2) {
+                    auto const delta = (errors[r] - errors[r+1])
+                            * (1.0 / temperatures[r]
+                                - 1.0 / temperatures[r+1]);
 
-            // We're done, restore the cache size and save information:
+                    if (delta >= 0.0
+                            || chance(exchangeRng) < std::exp(delta)) {
+                        current[r].swap(current[r+1]);
+                        std::swap(errors[r], errors[r+1]);
+                    }
+                }
 
-            setFinalNumEpochs(trainingSet, epoch);
-            setFinalError(trainingSet, error);
+                parity = 1 - parity;
+            }
         }
+
+        // Store final training results:
+
+        ann.trainableWeights(best);
+        setFinalError(trainingSet, bestError);
+        setFinalNumEpochs(trainingSet, epochs);
     }
-}
+} // namespace wzann
+
+
+WZANN_REGISTER_CLASS(
+        wzann::SimulatedAnnealingTrainingAlgorithm,
+        wzann::TrainingAlgorithm)
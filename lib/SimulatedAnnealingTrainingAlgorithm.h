@@ -1,166 +1,234 @@
-/*!
- * \file
- * \author Eric MSP Veith <eveith@veith-m.de>
- * \date 2013-03-21
- */
+#ifndef WZANN_SIMULATEDANNEALINGTRAININGALGORITHM_H_
+#define WZANN_SIMULATEDANNEALINGTRAININGALGORITHM_H_
 
 
-#ifndef SIMULATEDANNEALINGTRAININGALGORITHM_H
-#define SIMULATEDANNEALINGTRAININGALGORITHM_H
+#include <cstddef>
 
+#include "TrainingAlgorithm.h"
 
-#include <QtGlobal>
 
-#include <cstddef>
+namespace wzann {
+    class TrainingSet;
+    class NeuralNetwork;
+
+
+    /*!
+     * \brief Trains a neural network using simulated annealing, optionally
+     *  with parallel tempering
+     *
+     * Simulated annealing needs no gradient, which makes it suitable for
+     * networks with non-differentiable activation functions, such as
+     * ActivationFunction::BinaryStep. In each step, it adds a uniformly
+     * distributed random number from
+     * \f$[-\frac{s}{2}, \frac{s}{2}) \cdot T / T_0\f$ to each trainable
+     * weight, where \f$s\f$ is the #stepSize(), \f$T\f$ the current and
+     * \f$T_0\f$ the #startTemperature(). The new weights are accepted if
+     * they lower the mean error \f$E\f$ of the training set, and else with
+     * the probability \f$\exp(-\Delta E / T)\f$. Temperatures are
+     * therefore measured in units of the error.
+     *
+     * With one replica, each epoch cools the temperature geometrically
+     * from #startTemperature() to #stopTemperature() in #cycles() steps,
+     * starting from the best weights found so far.
+     *
+     * With several #replicas(), the algorithm uses parallel tempering:
+     * Each replica keeps its own weights at a fixed temperature; the
+     * temperatures are spaced geometrically between #stopTemperature()
+     * and #startTemperature(). In each epoch, every replica takes
+     * #cycles() steps, and after every #exchangeInterval() steps,
+     * neighboring replicas swap their weights with the probability
+     * \f$\min(1, \exp((E_i - E_j)(1/T_i - 1/T_j)))\f$, alternating between
+     * even and odd pairs. Hot replicas explore the error surface, cold
+     * ones refine the best solutions. The replicas take their steps
+     * concurrently on #numThreads() threads. Each replica has a random
+     * number generator of its own, so that the result does not depend on
+     * the number of threads.
+     *
+     * In both modes, the network receives the best weights found, and
+     * the training stops once their error reaches the target error.
+     * Fixed weights remain unchanged.
+     */
+    class SimulatedAnnealingTrainingAlgorithm : public TrainingAlgorithm
+    {
+    public:
+
+
+        typedef std::size_t size_type;
+
+
+        const double DEFAULT_START_TEMPERATURE = 1e-2;
+
+
+        const double DEFAULT_STOP_TEMPERATURE = 1e-5;
+
+
+        const size_type DEFAULT_CYCLES = 100;
+
+
+        const double DEFAULT_STEP_SIZE = 1.0;
+
+
+        const size_type DEFAULT_REPLICAS = 1;
+
+
+        const size_type DEFAULT_EXCHANGE_INTERVAL = 10;
+
+
+        //! \brief Creates a new training algorithm instance
+        SimulatedAnnealingTrainingAlgorithm();
+
+
+        /*!
+         * \brief Creates a new training algorithm instance with the given
+         *  cooling schedule
+         *
+         * \param[in] startTemperature The temperature at which each epoch
+         *  starts
+         *
+         * \param[in] stopTemperature The temperature at which each epoch
+         *  ends
+         *
+         * \param[in] cycles The number of steps per epoch
+         */
+        SimulatedAnnealingTrainingAlgorithm(
+                double startTemperature,
+                double stopTemperature,
+                size_type cycles);
+
+
+        //! \return The highest temperature
+        double startTemperature() const;
+
+
+        /*!
+         * \brief Sets the temperature at which each epoch starts, or the
+         *  temperature of the hottest replica
+         *
+         * \return `*this`
+         */
+        SimulatedAnnealingTrainingAlgorithm& startTemperature(
+                double temperature);
+
+
+        //! \return The lowest temperature
+        double stopTemperature() const;
+
+
+        /*!
+         * \brief Sets the temperature at which each epoch ends, or the
+         *  temperature of the coldest replica
+         *
+         * \return `*this`
+         */
+        SimulatedAnnealingTrainingAlgorithm& stopTemperature(
+                double temperature);
+
+
+        //! \return The number of steps per epoch
+        size_type cycles() const;
+
+
+        //! \brief Sets the number of steps per epoch
+        SimulatedAnnealingTrainingAlgorithm& cycles(size_type cycles);
+
+
+        //! \return The width of a step at the start temperature
+        double stepSize() const;
+
+
+        /*!
+         * \brief Sets the width of the range a weight changes by in a step
+         *  at the start temperature
+         *
+         * \return `*this`
+         */
+        SimulatedAnnealingTrainingAlgorithm& stepSize(double stepSize);
+
+
+        //! \return The number of replicas
+        size_type replicas() const;
+
+
+        /*!
+         * \brief Sets the number of replicas
+         *
+         * \param[in] replicas The number of replicas; `1` selects plain
+         *  simulated annealing, more select parallel tempering
+         *
+         * \return `*this`
+         */
+        SimulatedAnnealingTrainingAlgorithm& replicas(size_type replicas);
+
+
+        //! \return The number of steps between two exchanges
+        size_type exchangeInterval() const;
 
-#include "TrainingAlgorithm.h"
 
+        /*!
+         * \brief Sets the number of steps each replica takes between two
+         *  exchanges of parallel tempering
+         *
+         * \return `*this`
+         */
+        SimulatedAnnealingTrainingAlgorithm& exchangeInterval(
+                size_type steps);
 
-namespace Winzent {
-    namespace ANN {
 
+        //! \return The number of threads that run the replicas
+        size_type numThreads() const;
 
-        class NeuralNetwork;
-        class TrainingSet;
-
-
-        class SimulatedAnnealingTrainingAlgorithm: public TrainingAlgorithm
-        {
-        private:
 
+        /*!
+         * \brief Sets the number of threads that run the replicas
+         *
+         * \param[in] numThreads The number of threads; `0` selects the
+         *  number of hardware threads. The default is `0`.
+         *
+         * \return `*this`
+         */
+        SimulatedAnnealingTrainingAlgorithm& numThreads(
+                size_type numThreads);
 
-            /*!
-             * Cutoff value for random data.
-             */
-            static const qreal CUT;
 
+        /*!
+         * \brief Trains the neural network using simulated annealing.
+         *
+         * \param[in] trainingSet A set of training data
+         */
+        virtual void train(NeuralNetwork& ann, TrainingSet& trainingSet)
+                override;
 
-            /*!
-             * The temperature at which the simulated annealing process starts.
-             */
-            qreal m_startTemperature;
 
+    private:
 
-            /*!
-             * The temperature at which the simulated annealing process stops.
-             */
-            qreal m_stopTemperature;
 
+        //! \brief The highest temperature
+        double m_startTemperature;
 
-            /*!
-             * The number of cycles to run at a certain temperature.
-             */
-            size_t m_cycles;
 
+        //! \brief The lowest temperature
+        double m_stopTemperature;
 
-            /*!
-             * \brief Extracts all weights as parameter vector from the given
-             *  Neural Network
-             *
-             * \param[in] network The network to extract all trainable weights
-             *  from
-             *
-             * \return The parameter vector
-             */
-            static Vector getParameters(const NeuralNetwork &network);
 
+        //! \brief The number of steps per epoch
+        size_type m_cycles;
 
-            /*!
-             * \brief Applies the given parameters vector (i. e., weights) to
-             *  the supplied neural network
-             *
-             * \param[in] parameters The vector of weights
-             *
-             * \param[inout] network The ANN to apply the parameters to
-             */
-            static void applyParameters(
-                    const Vector &parameters,
-                    NeuralNetwork &network);
 
+        //! \brief The width of a step at the start temperature
+        double m_stepSize;
 
-            /*!
-             * Randomizes the weights of a given neural network according to the
-             * current state/temperature of the algorithm.
-             *
-             * \param[inout] network The neural network to randomize.
-             */
-            void randomize(Vector &parameters, const qreal &temperature);
 
+        //! \brief The number of replicas
+        size_type m_replicas;
 
-            /*!
-             * Do one iteration of #m_cycles cycles
-             *
-             * \param[inout] network The network that is to be trained. This
-             *  network will be modified, so pass a copy if you do not want
-             *  this.
-             *
-             * \param[in] trainingSet The set of training data
-             *
-             * \return The error at the end of the iteration
-             */
-            qreal iterate(
-                    NeuralNetwork &network,
-                    TrainingSet const &trainingSet);
 
+        //! \brief The number of steps between two exchanges
+        size_type m_exchangeInterval;
 
-        public:
 
+        //! \brief The number of threads that run the replicas
+        size_type m_numThreads;
+    };
+} // namespace wzann
 
-            /*!
-             * Constructs a new instance of this training algorithm
-             *
-             * \param[in] network The network to be trained
-             *
-             * \param[in] startTemperature The temperature value at which the
-             *  training starts.
-             *
-             * \param[in] stopTemperature The temperature at which an epoch
-             *  ends.
-             *
-             * \param[in] cycles The number of cycles needed to reach the
-             *  stopTemperature
-             */
-            explicit SimulatedAnnealingTrainingAlgorithm(
-                    qreal startTemperature,
-                    qreal stopTemperature,
-                    size_t cycles);
-
-
-            /*!
-             * \return The starting temperature
-             */
-            qreal startTemperature() const;
-
-
-            /*!
-             * \return The stopping temperature
-             */
-            qreal stopTemperature() const;
-
-
-            /*!
-             * \return The current temperature
-             */
-            qreal temperature() const;
-
-
-            /*!
-             * \return The number of cycles per temperature
-             */
-            size_t cycles() const;
-
-
-            /*!
-             * Trains the neural network using simulated annealing.
-             *
-             * \param trainingSet A set of training data
-             */
-            virtual void train(
-                    NeuralNetwork &ann,
-                    TrainingSet &trainingSet)
-                    override;
-        };
-    }
-}
-
-#endif // SIMULATEDANNEALINGTRAININGALGORITHM_H
+#endif // WZANN_SIMULATEDANNEALINGTRAININGALGORITHM_H_
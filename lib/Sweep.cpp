@@ -0,0 +1,341 @@
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <utility>
+#include <algorithm>
+#include <stdexcept>
+
+#include <boost/random/mersenne_twister.hpp>
+#include <boost/random/uniform_int_distribution.hpp>
+#include <boost/random/uniform_real_distribution.hpp>
+
+#include "TrainingSet.h"
+#include "ParallelFor.h"
+#include "NeuralNetwork.h"
+#include "InferenceContext.h"
+
+#include "Sweep.h"
+
+
+namespace wzann {
+    double Sweep::Trial::score() const
+    {
+        auto const error = (std::isnan(verificationError)
+                ? trainingError
+                : verificationError);
+
+        // Diverged trials rank last, which also keeps the ranking a strict
+        // weak ordering:
+
+        return (std::isfinite(error)
+                ? error
+                : std::numeric_limits<double>::infinity());
+    }
+
+
+    Sweep::Sweep():
+            m_numSamples(0),
+            m_seed(0),
+            m_numThreads(0),
+            m_minEpochs(0),
+            m_halvingRate(DEFAULT_HALVING_RATE)
+    {
+    }
+
+
+    Sweep& Sweep::values(std::string const& name, std::vector<double> values)
+    {
+        if (values.empty()) {
+            throw std::invalid_argument(
+                    "Parameter '" + name + "' has no values");
+        }
+
+        Parameter parameter;
+        parameter.values = std::move(values);
+        parameter.min = 0.0;
+        parameter.max = 0.0;
+        parameter.logarithmic = false;
+        parameter.integral = false;
+        m_parameters[name] = std::move(parameter);
+        return *this;
+    }
+
+
+    Sweep& Sweep::uniform(std::string const& name, double min, double max)
+    {
+        m_parameters[name] = Parameter { {}, min, max, false, false };
+        return *this;
+    }
+
+
+    Sweep& Sweep::logUniform(std::string const& name, double min, double max)
+    {
+        if (! (min > 0.0)) {
+            throw std::invalid_argument(
+                    "Parameter '" + name + "' needs a positive minimum");
+        }
+
+        m_parameters[name] = Parameter { {}, min, max, true, false };
+        return *this;
+    }
+
+
+    Sweep& Sweep::uniformInteger(
+            std::string const& name,
+            long min,
+            long max)
+    {
+        m_parameters[name] = Parameter {
+                {},
+                static_cast<double>(min),
+                static_cast<double>(max),
+                false,
+                true };
+        return *this;
+    }
+
+
+    Sweep::size_type Sweep::numSamples() const
+    {
+        return m_numSamples;
+    }
+
+
+    Sweep& Sweep::numSamples(size_type numSamples)
+    {
+        m_numSamples = numSamples;
+        return *this;
+    }
+
+
+    std::uint32_t Sweep::seed() const
+    {
+        return m_seed;
+    }
+
+
+    Sweep& Sweep::seed(std::uint32_t seed)
+    {
+        m_seed = seed;
+        return *this;
+    }
+
+
+    Sweep::size_type Sweep::numThreads() const
+    {
+        return m_numThreads;
+    }
+
+
+    Sweep& Sweep::numThreads(size_type numThreads)
+    {
+        m_numThreads = numThreads;
+        return *this;
+    }
+
+
+    Sweep::epoch_t Sweep::minEpochs() const
+    {
+        return m_minEpochs;
+    }
+
+
+    Sweep& Sweep::minEpochs(epoch_t minEpochs)
+    {
+        m_minEpochs = minEpochs;
+        return *this;
+    }
+
+
+    Sweep::size_type Sweep::halvingRate() const
+    {
+        return m_halvingRate;
+    }
+
+
+    Sweep& Sweep::halvingRate(size_type halvingRate)
+    {
+        m_halvingRate = halvingRate;
+        return *this;
+    }
+
+
+    std::vector<Sweep::Configuration> Sweep::configurations() const
+    {
+        std::vector<Configuration> configurations;
+
+        if (0 == m_numSamples) {
+            size_type numConfigurations = 1;
+
+            for (auto const& p: m_parameters) {
+                if (p.second.values.empty()) {
+                    throw std::invalid_argument(
+                            "A grid search cannot sample parameter '"
+                                + p.first + "' from a range");
+                }
+
+                numConfigurations *= p.second.values.size();
+            }
+
+            // Count through the grid with the last parameter as the
+            // least significant digit:
+
+            configurations.resize(numConfigurations);
+
+            for (size_type i = 0; i != numConfigurations; ++i) {
+                auto index = i;
+
+                for (auto p = m_parameters.rbegin();
+                        p != m_parameters.rend();
+                        ++p) {
+                    auto const& values = p->second.values;
+                    configurations[i][p->first] =
+                            values[index % values.size()];
+                    index /= values.size();
+                }
+            }
+
+            return configurations;
+        }
+
+        boost::random::mt11213b rng(m_seed);
+        configurations.resize(m_numSamples);
+
+        for (auto& configuration: configurations) {
+            for (auto const& p: m_parameters) {
+                auto const& parameter = p.second;
+                double value;
+
+                if (! parameter.values.empty()) {
+                    boost::random::uniform_int_distribution<size_type> d(
+                            0,
+                            parameter.values.size() - 1);
+                    value = parameter.values[d(rng)];
+                } else if (parameter.integral) {
+                    boost::random::uniform_int_distribution<long> d(
+                            static_cast<long>(parameter.min),
+                            static_cast<long>(parameter.max));
+                    value = static_cast<double>(d(rng));
+                } else if (parameter.logarithmic) {
+                    boost::random::uniform_real_distribution<double> d(
+                            std::log(parameter.min),
+                            std::log(parameter.max));
+                    value = std::exp(d(rng));
+                } else {
+                    boost::random::uniform_real_distribution<double> d(
+                            parameter.min,
+                            parameter.max);
+                    value = d(rng);
+                }
+
+                configuration[p.first] = value;
+            }
+        }
+
+        return configurations;
+    }
+
+
+    std::vector<Sweep::Trial> Sweep::run(
+            NeuralNetwork const& ann,
+            TrainingSet const& trainingSet,
+            TrainingSet const* verificationSet,
+            TrainingAlgorithmFactory const& factory) const
+    {
+        auto configurations = this->configurations();
+        std::vector<Trial> trials(configurations.size());
+
+        for (size_type i = 0; i != trials.size(); ++i) {
+            auto& trial = trials[i];
+            trial.configuration = std::move(configurations[i]);
+            trial.budget = 0;
+            trial.epochs = 0;
+            trial.trainingError = std::numeric_limits<double>::quiet_NaN();
+            trial.verificationError =
+                    std::numeric_limits<double>::quiet_NaN();
+            trial.pruned = false;
+        }
+
+        auto const maxEpochs = trainingSet.maxEpochs();
+        auto const halvingRate = std::max<size_type>(2, m_halvingRate);
+        auto budget = (0 == m_minEpochs
+                ? maxEpochs
+                : std::min(m_minEpochs, maxEpochs));
+
+        std::vector<size_type> alive(trials.size());
+        std::iota(alive.begin(), alive.end(), 0);
+
+        while (! alive.empty()) {
+
+            // Trials that stopped early would only repeat themselves:
+
+            std::vector<size_type> pending;
+
+            for (auto const& i: alive) {
+                if (0 == trials[i].budget
+                        || trials[i].epochs == trials[i].budget) {
+                    pending.push_back(i);
+                }
+            }
+
+            std::vector<std::unique_ptr<TrainingAlgorithm>> algorithms;
+
+            for (auto const& i: pending) {
+                algorithms.emplace_back(factory(trials[i].configuration));
+            }
+
+            parallelFor(pending.size(), m_numThreads, [&](size_type j) {
+                auto& trial = trials[pending[j]];
+                NeuralNetwork network(ann);
+                TrainingSet ts(trainingSet);
+                ts.maxEpochs(budget);
+
+                algorithms[j]->train(network, ts);
+                algorithms[j].reset();
+
+                trial.budget = budget;
+                trial.epochs = ts.epochs();
+                trial.trainingError = ts.error();
+
+                if (nullptr != verificationSet) {
+                    auto const error = TrainingAlgorithm::meanError(
+                            network,
+                            *verificationSet,
+                            InferenceContext(network));
+                    trial.verificationError = (std::isfinite(error)
+                            ? error
+                            : std::numeric_limits<double>::infinity());
+                }
+            });
+
+            if (budget >= maxEpochs) {
+                break;
+            }
+
+            // Keep the best trials of this rung:
+
+            std::stable_sort(
+                    alive.begin(),
+                    alive.end(),
+                    [&trials](size_type a, size_type b) {
+                        return trials[a].score() < trials[b].score();
+                    });
+
+            auto const numKept = std::max<size_type>(
+                    1,
+                    alive.size() / halvingRate);
+
+            for (auto i = numKept; i < alive.size(); ++i) {
+                trials[alive[i]].pruned = true;
+            }
+
+            alive.resize(numKept);
+            budget = (1 == alive.size() || budget > maxEpochs / halvingRate
+                    ? maxEpochs
+                    : budget * halvingRate);
+        }
+
+        return trials;
+    }
+} // namespace wzann
@@ -0,0 +1,316 @@
+#ifndef WZANN_SWEEP_H_
+#define WZANN_SWEEP_H_
+
+
+#include <map>
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+#include "TrainingAlgorithm.h"
+
+
+namespace wzann {
+    class TrainingSet;
+    class NeuralNetwork;
+
+
+    /*!
+     * \brief Searches the hyperparameters of a training algorithm
+     *
+     * A sweep trains the same network with many configurations of a
+     * training algorithm and reports how well each of them did. The
+     * search space consists of named parameters, each either a list of
+     * #values() or a range (#uniform(), #logUniform(), #uniformInteger()).
+     * The sweep does not interpret the names; a factory supplied to #run()
+     * creates a training algorithm for each configuration.
+     *
+     * Without #numSamples(), the sweep tries every combination of the
+     * parameters' values (grid search), which requires all parameters to
+     * be lists. Otherwise, it draws the given number of configurations at
+     * random, using #seed().
+     *
+     * Trials run concurrently on #numThreads() threads. Each trial trains
+     * its own copy of the network; the training set is shared and only
+     * copied for the trials that are running.
+     *
+     * With #minEpochs() set, the sweep prunes hopeless trials early by
+     * successive halving: All trials train for #minEpochs() epochs first.
+     * Only the best `1 / halvingRate()` of them are trained again, from the
+     * start, with #halvingRate() times as many epochs, and so on, until the
+     * remaining trials have trained for TrainingSet::maxEpochs(). Trials
+     * are ranked by their verification error if a verification set is
+     * given, and by their training error otherwise. Trials that stopped
+     * before using up their epochs, e.g., because they reached the target
+     * error, are not trained again.
+     */
+    class Sweep
+    {
+    public:
+
+
+        typedef std::size_t size_type;
+
+
+        typedef TrainingAlgorithm::epoch_t epoch_t;
+
+
+        //! \brief Values of all parameters, by name
+        typedef std::map<std::string, double> Configuration;
+
+
+        /*!
+         * \brief Creates a training algorithm for a configuration; the
+         *  caller owns the result
+         */
+        typedef std::function<TrainingAlgorithm*(Configuration const&)>
+                TrainingAlgorithmFactory;
+
+
+        //! \brief The outcome of training one configuration
+        struct Trial
+        {
+            //! \brief The configuration of the training algorithm
+            Configuration configuration;
+
+
+            //! \brief The maximum number of epochs of the last training
+            epoch_t budget;
+
+
+            //! \brief The number of epochs of the last training
+            epoch_t epochs;
+
+
+            //! \brief The training error of the last training
+            double trainingError;
+
+
+            //! \brief The verification error, infinity if it is not
+            //!  finite, or NaN without a verification set
+            double verificationError;
+
+
+            //! \brief Whether successive halving stopped the trial early
+            bool pruned;
+
+
+            /*!
+             * \return The error trials are ranked by: the verification
+             *  error if there is one, else the training error; infinity
+             *  if that is not finite
+             */
+            double score() const;
+        };
+
+
+        const size_type DEFAULT_HALVING_RATE = 3;
+
+
+        //! \brief Creates an empty sweep
+        Sweep();
+
+
+        /*!
+         * \brief Adds a parameter that takes one of a list of values
+         *
+         * A parameter that already exists is replaced.
+         *
+         * \param[in] name The name of the parameter
+         *
+         * \param[in] values The values, at least one
+         *
+         * \return `*this`
+         */
+        Sweep& values(std::string const& name, std::vector<double> values);
+
+
+        /*!
+         * \brief Adds a parameter drawn uniformly from `[min, max)`
+         *
+         * \return `*this`
+         */
+        Sweep& uniform(std::string const& name, double min, double max);
+
+
+        /*!
+         * \brief Adds a parameter whose logarithm is drawn uniformly,
+         *  e.g., for learning rates; `min` must be positive
+         *
+         * \return `*this`
+         */
+        Sweep& logUniform(std::string const& name, double min, double max);
+
+
+        /*!
+         * \brief Adds a parameter drawn uniformly from the integers in
+         *  `[min, max]`
+         *
+         * \return `*this`
+         */
+        Sweep& uniformInteger(
+                std::string const& name,
+                long min,
+                long max);
+
+
+        //! \return The number of random configurations; `0` for a grid
+        size_type numSamples() const;
+
+
+        /*!
+         * \brief Sets the number of configurations drawn at random
+         *
+         * \param[in] numSamples The number of configurations; `0` selects
+         *  grid search
+         *
+         * \return `*this`
+         */
+        Sweep& numSamples(size_type numSamples);
+
+
+        //! \return The seed of the random search
+        std::uint32_t seed() const;
+
+
+        //! \brief Sets the seed of the random search
+        Sweep& seed(std::uint32_t seed);
+
+
+        //! \return The maximum number of concurrent trials
+        size_type numThreads() const;
+
+
+        /*!
+         * \brief Sets the maximum number of concurrent trials
+         *
+         * \param[in] numThreads The number of threads; `0` selects the
+         *  number of hardware threads
+         *
+         * \return `*this`
+         */
+        Sweep& numThreads(size_type numThreads);
+
+
+        //! \return The number of epochs of the first rung
+        epoch_t minEpochs() const;
+
+
+        /*!
+         * \brief Sets the number of epochs all trials train for before
+         *  the first ones are pruned
+         *
+         * \param[in] minEpochs The number of epochs; `0` disables
+         *  successive halving, so that all trials train for
+         *  TrainingSet::maxEpochs()
+         *
+         * \return `*this`
+         */
+        Sweep& minEpochs(epoch_t minEpochs);
+
+
+        //! \return The factor by which each rung reduces the trials
+        size_type halvingRate() const;
+
+
+        /*!
+         * \brief Sets the factor by which each rung of successive halving
+         *  reduces the number of trials and multiplies their epochs
+         *
+         * \param[in] halvingRate The factor, at least `2`
+         *
+         * \return `*this`
+         */
+        Sweep& halvingRate(size_type halvingRate);
+
+
+        /*!
+         * \brief Lists the configurations of the sweep
+         *
+         * \return All combinations of values for a grid, in the order in
+         *  which the parameters' names sort, the last one varying
+         *  fastest; or #numSamples() random configurations
+         *
+         * \throw std::invalid_argument If a grid contains a range
+         */
+        std::vector<Configuration> configurations() const;
+
+
+        /*!
+         * \brief Trains the network with all configurations
+         *
+         * \param[in] ann The network; each trial trains a copy
+         *
+         * \param[in] trainingSet The training set; its
+         *  TrainingSet::maxEpochs() is the budget of the last rung
+         *
+         * \param[in] verificationSet The verification set, or `nullptr`
+         *
+         * \param[in] factory Creates the training algorithm of each
+         *  trial; it is only called by the calling thread
+         *
+         * \return One trial per configuration, in the order of
+         *  #configurations()
+         */
+        std::vector<Trial> run(
+                NeuralNetwork const& ann,
+                TrainingSet const& trainingSet,
+                TrainingSet const* verificationSet,
+                TrainingAlgorithmFactory const& factory) const;
+
+
+    private:
+
+
+        //! \brief A dimension of the search space
+        struct Parameter
+        {
+            //! \brief The values of a list, or empty for a range
+            std::vector<double> values;
+
+
+            //! \brief The lower bound of a range
+            double min;
+
+
+            //! \brief The upper bound of a range
+            double max;
+
+
+            //! \brief Whether the logarithm is drawn uniformly
+            bool logarithmic;
+
+
+            //! \brief Whether only integers are drawn
+            bool integral;
+        };
+
+
+        //! \brief The parameters, by name
+        std::map<std::string, Parameter> m_parameters;
+
+
+        //! \brief The number of random configurations
+        size_type m_numSamples;
+
+
+        //! \brief The seed of the random search
+        std::uint32_t m_seed;
+
+
+        //! \brief The maximum number of concurrent trials
+        size_type m_numThreads;
+
+
+        //! \brief The number of epochs of the first rung
+        epoch_t m_minEpochs;
+
+
+        //! \brief The factor by which each rung reduces the trials
+        size_type m_halvingRate;
+    };
+} // namespace wzann
+
+#endif // WZANN_SWEEP_H_
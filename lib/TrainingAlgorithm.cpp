@@ -3,6 +3,8 @@
 
 #include "TrainingSet.h"
 #include "NeuralNetwork.h"
+#include "GradientEngine.h"
+#include "InferenceContext.h"
 #include "LayerSizeMismatchException.h"
 
 #include "TrainingAlgorithm.h"
@@ -49,6 +51,67 @@ namespace wzann {
     }
 
 
+    double TrainingAlgorithm::meanError(
+            NeuralNetwork const& network,
+            TrainingSet const& trainingSet,
+            InferenceContext const& initialContext)
+    {
+        InferenceContext context(initialContext);
+        Vector output;
+        double error = 0.0;
+        size_t numRelevantItems = 0;
+
+        for (auto const& item: trainingSet.trainingItems) {
+            network.calculate(item.input(), output, context);
+
+            if (! item.outputRelevant()) {
+                continue;
+            }
+
+            auto const expected = item.expectedOutput();
+            auto e = expected.cbegin();
+            double itemError = 0.0;
+
+            for (auto a = output.cbegin();
+                    a != output.cend() && e != expected.cend();
+                    ++a, ++e) {
+                itemError += (*e - *a) * (*e - *a);
+            }
+
+            error += itemError / 2.0;
+            ++numRelevantItems;
+        }
+
+        return error / static_cast<double>(numRelevantItems);
+    }
+
+
+    double TrainingAlgorithm::meanGradient(
+            NeuralNetwork& ann,
+            TrainingSet const& trainingSet,
+            GradientEngine& engine,
+            Vector const& weights,
+            Vector& gradient)
+    {
+        ann.weights(weights);
+
+        engine.clear();
+        engine.accumulate(
+                trainingSet.trainingItems.begin(),
+                trainingSet.trainingItems.end());
+
+        auto const n = static_cast<double>(engine.numItems());
+        auto const& sum = engine.gradient();
+        gradient.resize(sum.size());
+
+        for (Vector::size_type i = 0; i != sum.size(); ++i) {
+            gradient[i] = sum[i] / n;
+        }
+
+        return engine.error() / n;
+    }
+
+
     void TrainingAlgorithm::setFinalError(
             TrainingSet& trainingSet,
             double error)
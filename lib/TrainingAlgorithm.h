@@ -10,6 +10,8 @@
 namespace wzann {
     class TrainingSet;
     class NeuralNetwork;
+    class GradientEngine;
+    class InferenceContext;
 
 
     /*!
@@ -47,6 +49,35 @@ namespace wzann {
                 const Vector& expectedOutput);
 
 
+        /*!
+         * \brief Calculates the mean error of a network on a training set
+         *
+         * The items are calculated one after another, so that the state
+         * of recurrent networks carries over from one item to the next.
+         * The error of an item is
+         * \f$\frac{1}{2}\sum_i (\mathit{expected}_i -
+         * \mathit{actual}_i)^2\f$; items whose output is not relevant
+         * are calculated, but not counted. The network is not changed,
+         * so several threads can evaluate it concurrently.
+         *
+         * \param[in] network The network
+         *
+         * \param[in] trainingSet The training set
+         *
+         * \param[in] initialContext The state the calculation starts
+         *  from; it is copied
+         *
+         * \return The mean error of all relevant items
+         *
+         * \throw LayerSizeMismatchException If an item's input does not
+         *  match the network's input layer
+         */
+        static double meanError(
+                NeuralNetwork const& network,
+                TrainingSet const& trainingSet,
+                InferenceContext const& initialContext);
+
+
         TrainingAlgorithm();
 
 
@@ -83,6 +114,31 @@ namespace wzann {
     protected:
 
 
+        /*!
+         * \brief Applies weights to a network and calculates the mean
+         *  error and gradient of the whole training set
+         *
+         * \param[inout] ann The network
+         *
+         * \param[in] trainingSet The training set
+         *
+         * \param[inout] engine The gradient engine of the network
+         *
+         * \param[in] weights The weights, in the order of
+         *  NeuralNetwork::weights()
+         *
+         * \param[out] gradient Receives the mean gradient
+         *
+         * \return The mean error
+         */
+        static double meanGradient(
+                NeuralNetwork& ann,
+                TrainingSet const& trainingSet,
+                GradientEngine& engine,
+                Vector const& weights,
+                Vector& gradient);
+
+
         /*!
          * \brief Sets the final error of a training set.
          *
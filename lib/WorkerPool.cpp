@@ -0,0 +1,124 @@
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <cstddef>
+#include <exception>
+
+#include "ParallelFor.h"
+
+#include "WorkerPool.h"
+
+
+namespace wzann {
+    WorkerPool::WorkerPool(std::size_t numThreads):
+            m_task(nullptr),
+            m_numTasks(0),
+            m_nextTask(0),
+            m_batch(0),
+            m_numBusy(0),
+            m_stop(false)
+    {
+        numThreads = effectiveNumThreads(numThreads);
+        m_threads.reserve(numThreads - 1);
+
+        for (std::size_t i = 1; i < numThreads; ++i) {
+            m_threads.emplace_back(&WorkerPool::work, this, i);
+        }
+    }
+
+
+    WorkerPool::~WorkerPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+
+        m_wakeUp.notify_all();
+
+        for (auto& thread: m_threads) {
+            thread.join();
+        }
+    }
+
+
+    std::size_t WorkerPool::numWorkers() const
+    {
+        return m_threads.size() + 1;
+    }
+
+
+    void WorkerPool::run(std::size_t numTasks, Task const& task)
+    {
+        if (0 == numTasks) {
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_task = &task;
+            m_numTasks = numTasks;
+            m_nextTask = 0;
+            m_exceptions.assign(numTasks, nullptr);
+            m_numBusy = m_threads.size();
+            ++m_batch;
+        }
+
+        m_wakeUp.notify_all();
+        runTasks(0);
+
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_done.wait(lock, [this]() { return 0 == m_numBusy; });
+        }
+
+        for (auto const& exception: m_exceptions) {
+            if (exception) {
+                std::rethrow_exception(exception);
+            }
+        }
+    }
+
+
+    void WorkerPool::work(std::size_t worker)
+    {
+        std::size_t batch = 0;
+
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_wakeUp.wait(lock, [this, batch]() {
+                    return m_stop || m_batch != batch;
+                });
+
+                if (m_stop) {
+                    return;
+                }
+
+                batch = m_batch;
+            }
+
+            runTasks(worker);
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            if (0 == --m_numBusy) {
+                m_done.notify_one();
+            }
+        }
+    }
+
+
+    void WorkerPool::runTasks(std::size_t worker)
+    {
+        auto const numTasks = m_numTasks;
+
+        for (auto i = m_nextTask++; i < numTasks; i = m_nextTask++) {
+            try {
+                (*m_task)(worker, i);
+            } catch (...) {
+                m_exceptions[i] = std::current_exception();
+            }
+        }
+    }
+} // namespace wzann
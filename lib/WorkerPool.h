@@ -0,0 +1,144 @@
+#ifndef WZANN_WORKERPOOL_H_
+#define WZANN_WORKERPOOL_H_
+
+
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <condition_variable>
+
+
+namespace wzann {
+
+
+    /*!
+     * \brief A fixed set of threads that run batches of independent tasks
+     *
+     * Unlike parallelFor(), which starts and joins its threads on every
+     * call, a pool starts its threads once and keeps them waiting for the
+     * next batch. This suits callers that run many short batches, such
+     * as the evaluation of one individual after another.
+     *
+     * Each thread of the pool is a worker with an index in
+     * `[0, numWorkers())`; the thread that calls #run() is worker `0` and
+     * takes part in the work. Tasks receive the index of the worker that
+     * runs them, so that callers can keep buffers per worker and reuse
+     * them from one batch to the next. Which worker runs a particular
+     * task is not deterministic. Tasks should therefore store their
+     * results by task index.
+     *
+     * A pool is not thread-safe: only one thread may call #run() at a
+     * time.
+     *
+     * \sa parallelFor()
+     */
+    class WorkerPool
+    {
+    public:
+
+
+        //! \brief A task, called with the worker's and the task's index
+        typedef std::function<void(std::size_t, std::size_t)> Task;
+
+
+        /*!
+         * \brief Starts the threads of the pool
+         *
+         * \param[in] numThreads The number of workers, including the
+         *  calling thread; `0` selects the number of hardware threads
+         *
+         * \sa effectiveNumThreads()
+         */
+        explicit WorkerPool(std::size_t numThreads);
+
+
+        WorkerPool(WorkerPool const&) = delete;
+
+
+        WorkerPool& operator=(WorkerPool const&) = delete;
+
+
+        //! \brief Stops and joins the threads of the pool
+        ~WorkerPool();
+
+
+        //! \brief The number of workers, including the calling thread
+        std::size_t numWorkers() const;
+
+
+        /*!
+         * \brief Runs a batch of tasks and waits until all are done
+         *
+         * If tasks throw, the remaining tasks are still run, and the
+         * exception of the task with the lowest index is rethrown once
+         * all workers have finished. The pool stays usable.
+         *
+         * \param[in] numTasks The number of tasks
+         *
+         * \param[in] task The work, called once for each task index in
+         *  `[0, numTasks)`
+         */
+        void run(std::size_t numTasks, Task const& task);
+
+
+    private:
+
+
+        //! \brief The loop of the pool's threads
+        void work(std::size_t worker);
+
+
+        //! \brief Runs pending tasks of the current batch
+        void runTasks(std::size_t worker);
+
+
+        //! \brief The threads of the pool, workers `1` and up
+        std::vector<std::thread> m_threads;
+
+
+        //! \brief Guards the batch and the state of the threads
+        std::mutex m_mutex;
+
+
+        //! \brief Signals a new batch or the end of the pool
+        std::condition_variable m_wakeUp;
+
+
+        //! \brief Signals that the last thread finished a batch
+        std::condition_variable m_done;
+
+
+        //! \brief The task of the current batch
+        Task const* m_task;
+
+
+        //! \brief The number of tasks of the current batch
+        std::size_t m_numTasks;
+
+
+        //! \brief The index of the next task to be picked
+        std::atomic<std::size_t> m_nextTask;
+
+
+        //! \brief Counts the batches, so that threads detect a new one
+        std::size_t m_batch;
+
+
+        //! \brief The number of threads still working on the batch
+        std::size_t m_numBusy;
+
+
+        //! \brief Whether the threads shall terminate
+        bool m_stop;
+
+
+        //! \brief The exception of each task of the batch, if any
+        std::vector<std::exception_ptr> m_exceptions;
+    };
+} // namespace wzann
+
+#endif // WZANN_WORKERPOOL_H_
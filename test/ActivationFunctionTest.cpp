@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 
+#include "Vector.h"
 #include "ActivationFunction.h"
 #include "ActivationFunctionTest.h"
 
@@ -63,3 +64,42 @@ TEST(ActivationFunctionTest, testTanh)
                 * calculate(ActivationFunction::Tanh, 3.2),
             calculateDerivative(ActivationFunction::Tanh, 3.2));
 }
+
+
+TEST(ActivationFunctionTest, testArrayCalculation)
+{
+    Vector x;
+    for (double v = -12.0; v <= 12.0; v += 0.37) {
+        x.push_back(v);
+    }
+    x.push_back(0.0);
+    x.push_back(1e-9);
+    x.push_back(-800.0);
+
+    for (auto f: ActivationFunction::_values()) {
+        Vector fx(x.size()), dfx(x.size());
+
+        calculate(f, x.data(), fx.data(), x.size());
+        calculateDerivative(f, x.data(), dfx.data(), x.size());
+
+        for (Vector::size_type i = 0; i != x.size(); ++i) {
+            ASSERT_NEAR(calculate(f, x[i]), fx[i], 1e-14)
+                    << f._to_string() << "(" << x[i] << ")";
+            ASSERT_NEAR(calculateDerivative(f, x[i]), dfx[i], 1e-14)
+                    << f._to_string() << "'(" << x[i] << ")";
+        }
+    }
+
+    Vector inPlace = x;
+    calculate(
+            ActivationFunction::Logistic,
+            inPlace.data(),
+            inPlace.data(),
+            inPlace.size());
+    for (Vector::size_type i = 0; i != x.size(); ++i) {
+        ASSERT_NEAR(
+                calculate(ActivationFunction::Logistic, x[i]),
+                inPlace[i],
+                1e-15);
+    }
+}
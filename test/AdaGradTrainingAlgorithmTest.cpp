@@ -0,0 +1,103 @@
+#include <cmath>
+#include <iostream>
+
+#include <gtest/gtest.h>
+
+#include "TrainingSet.h"
+#include "ClassRegistry.h"
+#include "NeuralNetwork.h"
+#include "ActivationFunction.h"
+#include "SimpleWeightRandomizer.h"
+#include "PerceptronNetworkPattern.h"
+
+#include "AdaGradTrainingAlgorithm.h"
+#include "TestNetworks.h"
+#include "AdaGradTrainingAlgorithmTest.h"
+
+
+using namespace wzann;
+
+
+TEST(AdaGradTrainingAlgorithmTest, testIsRegistered)
+{
+    ASSERT_TRUE(ClassRegistry<TrainingAlgorithm>::instance()->isRegistered(
+            "wzann::AdaGradTrainingAlgorithm"));
+}
+
+
+TEST(AdaGradTrainingAlgorithmTest, testTrainXOR)
+{
+    NeuralNetwork network;
+    PerceptronNetworkPattern pattern;
+    pattern.addLayer({ 2, ActivationFunction::Identity });
+    pattern.addLayer({ 3, ActivationFunction::Logistic });
+    pattern.addLayer({ 1, ActivationFunction::Logistic });
+    network.configure(pattern);
+    SimpleWeightRandomizer().randomize(network);
+
+    // Build training data:
+
+    double targetVariance = 1e-2;
+    double targetTrainingError = targetVariance * targetVariance / 4. * 0.5;
+
+    TrainingSet trainingSet;
+    trainingSet.targetError(targetTrainingError).maxEpochs(100000)
+            << TrainingItem({ 0.0, 0.0 }, { 0.0 })
+            << TrainingItem({ 0.0, 1.0 }, { 1.0 })
+            << TrainingItem({ 1.0, 0.0 }, { 1.0 })
+            << TrainingItem({ 1.0, 1.0 }, { 0.0 });
+    AdaGradTrainingAlgorithm()
+            .learningRate(0.5)
+            .train(network, trainingSet);
+
+    std::cout << "Error: " << trainingSet.error()
+            << ", Epochs: " << trainingSet.epochs() << "\n";
+
+    Vector output;
+    output = network.calculate({ 1., 1. });
+    ASSERT_NEAR(0., output[0], targetVariance);
+    output = network.calculate({ 1, 0 });
+    ASSERT_NEAR(1., output[0], targetVariance);
+    output = network.calculate({ 0, 0 });
+    ASSERT_NEAR(0., output[0], targetVariance);
+    output = network.calculate({ 0, 1 });
+    ASSERT_NEAR(1., output[0], targetVariance);
+
+    ASSERT_LE(trainingSet.error(), targetTrainingError);
+    ASSERT_TRUE(trainingSet.epochs() < trainingSet.maxEpochs());
+}
+
+
+TEST(AdaGradTrainingAlgorithmTest, testStepShrinksWithSumOfSquares)
+{
+    // The error is (0.5 - w)^2 / 2, its gradient w - 0.5:
+
+    TrainingSet trainingSet;
+    trainingSet.targetError(0.0).maxEpochs(1)
+            << TrainingItem({ 1.0 }, { 0.5 });
+
+    AdaGradTrainingAlgorithm algorithm;
+    algorithm.learningRate(0.1).epsilon(0.25);
+
+    // The first step is lr * |g| / (|g| + eps):
+
+    NeuralNetwork network;
+    createSingleWeightNetwork(network, ActivationFunction::Identity, 0.0);
+    algorithm.train(network, trainingSet);
+
+    double const w1 = 0.1 * 0.5 / (0.5 + 0.25);
+    ASSERT_NEAR(w1, network.trainableWeights()[0], 1e-12);
+
+    // The second step divides by the root of the sum of both squared
+    // gradients, not by the second gradient alone:
+
+    NeuralNetwork twice;
+    createSingleWeightNetwork(twice, ActivationFunction::Identity, 0.0);
+    trainingSet.maxEpochs(2);
+    algorithm.train(twice, trainingSet);
+
+    double const g2 = w1 - 0.5;
+    double const step = 0.1 * -g2 / (std::sqrt(0.25 + g2 * g2) + 0.25);
+    ASSERT_NEAR(w1 + step, twice.trainableWeights()[0], 1e-12);
+    ASSERT_LT(step, 0.1 * -g2 / (-g2 + 0.25));
+}
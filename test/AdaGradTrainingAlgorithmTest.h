@@ -0,0 +1,6 @@
+#ifndef ADAGRADTRAININGALGORITHMTEST_H
+#define ADAGRADTRAININGALGORITHMTEST_H
+
+
+
+#endif // ADAGRADTRAININGALGORITHMTEST_H
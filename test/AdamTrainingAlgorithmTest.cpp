@@ -0,0 +1,102 @@
+#include <cmath>
+#include <iostream>
+
+#include <gtest/gtest.h>
+
+#include "TrainingSet.h"
+#include "ClassRegistry.h"
+#include "NeuralNetwork.h"
+#include "ActivationFunction.h"
+#include "SimpleWeightRandomizer.h"
+#include "PerceptronNetworkPattern.h"
+
+#include "AdamTrainingAlgorithm.h"
+#include "AdamTrainingAlgorithmTest.h"
+
+
+using namespace wzann;
+
+
+TEST(AdamTrainingAlgorithmTest, testIsRegistered)
+{
+    ASSERT_TRUE(ClassRegistry<TrainingAlgorithm>::instance()->isRegistered(
+            "wzann::AdamTrainingAlgorithm"));
+}
+
+
+TEST(AdamTrainingAlgorithmTest, testTrainXOR)
+{
+    NeuralNetwork network;
+    PerceptronNetworkPattern pattern;
+    pattern.addLayer({ 2, ActivationFunction::Identity });
+    pattern.addLayer({ 3, ActivationFunction::Logistic });
+    pattern.addLayer({ 1, ActivationFunction::Logistic });
+    network.configure(pattern);
+    SimpleWeightRandomizer().randomize(network);
+
+    // Build training data:
+
+    double targetVariance = 1e-2;
+    double targetTrainingError = targetVariance * targetVariance / 4. * 0.5;
+
+    TrainingSet trainingSet;
+    trainingSet.targetError(targetTrainingError).maxEpochs(100000)
+            << TrainingItem({ 0.0, 0.0 }, { 0.0 })
+            << TrainingItem({ 0.0, 1.0 }, { 1.0 })
+            << TrainingItem({ 1.0, 0.0 }, { 1.0 })
+            << TrainingItem({ 1.0, 1.0 }, { 0.0 });
+    AdamTrainingAlgorithm()
+            .learningRate(0.02)
+            .train(network, trainingSet);
+
+    std::cout << "Error: " << trainingSet.error()
+            << ", Epochs: " << trainingSet.epochs() << "\n";
+
+    Vector output;
+    output = network.calculate({ 1., 1. });
+    ASSERT_NEAR(0., output[0], targetVariance);
+    output = network.calculate({ 1, 0 });
+    ASSERT_NEAR(1., output[0], targetVariance);
+    output = network.calculate({ 0, 0 });
+    ASSERT_NEAR(0., output[0], targetVariance);
+    output = network.calculate({ 0, 1 });
+    ASSERT_NEAR(1., output[0], targetVariance);
+
+    ASSERT_LE(trainingSet.error(), targetTrainingError);
+    ASSERT_TRUE(trainingSet.epochs() < trainingSet.maxEpochs());
+}
+
+
+TEST(AdamTrainingAlgorithmTest, testFirstStepIsLearningRate)
+{
+    NeuralNetwork network;
+    PerceptronNetworkPattern pattern;
+    pattern.addLayer({ 2, ActivationFunction::Identity });
+    pattern.addLayer({ 3, ActivationFunction::Logistic });
+    pattern.addLayer({ 1, ActivationFunction::Logistic });
+    network.configure(pattern);
+    SimpleWeightRandomizer().randomize(network);
+
+    TrainingSet trainingSet;
+    trainingSet.targetError(0.0).maxEpochs(1)
+            << TrainingItem({ 0.0, 1.0 }, { 1.0 })
+            << TrainingItem({ 1.0, 1.0 }, { 0.0 });
+
+    // With bias correction, the first step of each weight is the learning
+    // rate, regardless of the gradient's magnitude:
+
+    auto const weights = network.weights();
+    AdamTrainingAlgorithm algorithm;
+    algorithm.learningRate(0.01).epsilon(0.0);
+    algorithm.train(network, trainingSet);
+
+    for (Vector::size_type i = 0; i != weights.size(); ++i) {
+        auto const step = std::fabs(network.weights()[i] - weights[i]);
+
+        if (0.0 != step) {
+            ASSERT_NEAR(0.01, step, 1e-12);
+        }
+    }
+
+    ASSERT_NE(weights, network.weights());
+}
@@ -0,0 +1,6 @@
+#ifndef ADAMTRAININGALGORITHMTEST_H
+#define ADAMTRAININGALGORITHMTEST_H
+
+
+
+#endif // ADAMTRAININGALGORITHMTEST_H
@@ -0,0 +1,106 @@
+#include <cmath>
+#include <iostream>
+
+#include <gtest/gtest.h>
+
+#include "TrainingSet.h"
+#include "ClassRegistry.h"
+#include "NeuralNetwork.h"
+#include "ActivationFunction.h"
+#include "SimpleWeightRandomizer.h"
+#include "PerceptronNetworkPattern.h"
+
+#include "AdamTrainingAlgorithm.h"
+#include "AdamWTrainingAlgorithm.h"
+#include "AdamWTrainingAlgorithmTest.h"
+
+
+using namespace wzann;
+
+
+TEST(AdamWTrainingAlgorithmTest, testIsRegistered)
+{
+    ASSERT_TRUE(ClassRegistry<TrainingAlgorithm>::instance()->isRegistered(
+            "wzann::AdamWTrainingAlgorithm"));
+}
+
+
+TEST(AdamWTrainingAlgorithmTest, testTrainXOR)
+{
+    NeuralNetwork network;
+    PerceptronNetworkPattern pattern;
+    pattern.addLayer({ 2, ActivationFunction::Identity });
+    pattern.addLayer({ 3, ActivationFunction::Logistic });
+    pattern.addLayer({ 1, ActivationFunction::Logistic });
+    network.configure(pattern);
+    SimpleWeightRandomizer().randomize(network);
+
+    // Build training data:
+
+    double targetVariance = 1e-2;
+    double targetTrainingError = targetVariance * targetVariance / 4. * 0.5;
+
+    TrainingSet trainingSet;
+    trainingSet.targetError(targetTrainingError).maxEpochs(100000)
+            << TrainingItem({ 0.0, 0.0 }, { 0.0 })
+            << TrainingItem({ 0.0, 1.0 }, { 1.0 })
+            << TrainingItem({ 1.0, 0.0 }, { 1.0 })
+            << TrainingItem({ 1.0, 1.0 }, { 0.0 });
+    AdamWTrainingAlgorithm()
+            .learningRate(0.1)
+            .train(network, trainingSet);
+
+    std::cout << "Error: " << trainingSet.error()
+            << ", Epochs: " << trainingSet.epochs() << "\n";
+
+    Vector output;
+    output = network.calculate({ 1., 1. });
+    ASSERT_NEAR(0., output[0], targetVariance);
+    output = network.calculate({ 1, 0 });
+    ASSERT_NEAR(1., output[0], targetVariance);
+    output = network.calculate({ 0, 0 });
+    ASSERT_NEAR(0., output[0], targetVariance);
+    output = network.calculate({ 0, 1 });
+    ASSERT_NEAR(1., output[0], targetVariance);
+
+    ASSERT_LE(trainingSet.error(), targetTrainingError);
+    ASSERT_TRUE(trainingSet.epochs() < trainingSet.maxEpochs());
+}
+
+
+TEST(AdamWTrainingAlgorithmTest, testWeightDecay)
+{
+    NeuralNetwork network;
+    PerceptronNetworkPattern pattern;
+    pattern.addLayer({ 2, ActivationFunction::Identity });
+    pattern.addLayer({ 3, ActivationFunction::Logistic });
+    pattern.addLayer({ 1, ActivationFunction::Logistic });
+    network.configure(pattern);
+    SimpleWeightRandomizer().randomize(network);
+
+    auto* fixed = *(network.connections().first);
+    fixed->fixedWeight(true);
+    auto const fixedWeight = fixed->weight();
+
+    TrainingSet trainingSet;
+    trainingSet.targetError(0.0).maxEpochs(10)
+            << TrainingItem({ 0.0, 1.0 }, { 1.0 })
+            << TrainingItem({ 1.0, 1.0 }, { 0.0 });
+
+    // Without decay, AdamW is Adam:
+
+    NeuralNetwork adam(network);
+    NeuralNetwork undecayed(network);
+    NeuralNetwork decayed(network);
+
+    AdamTrainingAlgorithm().train(adam, trainingSet);
+    AdamWTrainingAlgorithm().weightDecay(0.0).train(undecayed, trainingSet);
+    AdamWTrainingAlgorithm().weightDecay(1.0).train(decayed, trainingSet);
+
+    ASSERT_EQ(adam.weights(), undecayed.weights());
+    ASSERT_NE(adam.weights(), decayed.weights());
+
+    // Fixed weights do not decay:
+
+    ASSERT_EQ(fixedWeight, decayed.weights()[fixed->position()]);
+}
@@ -0,0 +1,6 @@
+#ifndef ADAMWTRAININGALGORITHMTEST_H
+#define ADAMWTRAININGALGORITHMTEST_H
+
+
+
+#endif // ADAMWTRAININGALGORITHMTEST_H
@@ -0,0 +1,102 @@
+#include <memory>
+#include <stdexcept>
+
+#include <gtest/gtest.h>
+
+#include "Vector.h"
+#include "NeuralNetwork.h"
+#include "ActivationFunction.h"
+#include "ElmanNetworkPattern.h"
+#include "SimpleWeightRandomizer.h"
+#include "PerceptronNetworkPattern.h"
+
+#include "AveragingEnsemble.h"
+#include "AveragingEnsembleTest.h"
+
+
+using namespace wzann;
+
+
+namespace {
+    void createNetwork(
+            NeuralNetwork& network,
+            std::size_t hiddenSize,
+            std::uint32_t seed)
+    {
+        PerceptronNetworkPattern pattern;
+        pattern.addLayer({ 2, ActivationFunction::Identity });
+        pattern.addLayer({ hiddenSize, ActivationFunction::Tanh });
+        pattern.addLayer({ 2, ActivationFunction::Logistic });
+        network.configure(pattern);
+        SimpleWeightRandomizer().minWeight(-1.0).maxWeight(1.0).seed(seed)
+                .randomize(network);
+    }
+}
+
+
+TEST(AveragingEnsembleTest, testAveragesMemberOutputs)
+{
+    NeuralNetwork n1;
+    NeuralNetwork n2;
+    NeuralNetwork n3;
+    createNetwork(n1, 3, 1);
+    createNetwork(n2, 4, 2);
+    createNetwork(n3, 3, 3);
+
+    std::unique_ptr<NeuralNetwork> ensemble(
+            averagingEnsemble({ &n1, &n2, &n3 }));
+
+    ASSERT_EQ(4u, ensemble->size());
+    ASSERT_EQ(10u, (*ensemble)[1].size());
+    ASSERT_EQ(2u, ensemble->outputLayer().size());
+
+    for (Vector const& input: { Vector({ 0.0, 0.0 }),
+            Vector({ 0.5, -1.0 }),
+            Vector({ 1.0, 1.0 }) }) {
+        auto const o1 = n1.calculate(input);
+        auto const o2 = n2.calculate(input);
+        auto const o3 = n3.calculate(input);
+        auto const output = ensemble->calculate(input);
+
+        ASSERT_EQ(2u, output.size());
+
+        for (Vector::size_type i = 0; i != output.size(); ++i) {
+            ASSERT_NEAR((o1[i] + o2[i] + o3[i]) / 3.0, output[i], 1e-12);
+        }
+    }
+}
+
+
+TEST(AveragingEnsembleTest, testRejectsIncompatibleMembers)
+{
+    ASSERT_THROW(averagingEnsemble({}), std::invalid_argument);
+
+    NeuralNetwork perceptron;
+    createNetwork(perceptron, 3, 1);
+
+    NeuralNetwork narrow;
+    PerceptronNetworkPattern narrowPattern;
+    narrowPattern.addLayer({ 1, ActivationFunction::Identity });
+    narrowPattern.addLayer({ 3, ActivationFunction::Tanh });
+    narrowPattern.addLayer({ 2, ActivationFunction::Logistic });
+    narrow.configure(narrowPattern);
+
+    ASSERT_THROW(
+            averagingEnsemble({ &perceptron, &narrow }),
+            std::invalid_argument);
+
+    NeuralNetwork elman;
+    ElmanNetworkPattern elmanPattern;
+    elmanPattern.addLayer({ 2, ActivationFunction::Identity });
+    elmanPattern.addLayer({ 3, ActivationFunction::Tanh });
+    elmanPattern.addLayer({ 2, ActivationFunction::Logistic });
+    elman.configure(elmanPattern);
+
+    ASSERT_THROW(averagingEnsemble({ &elman }), std::invalid_argument);
+
+    // Each network can be checked on its own before it is trained:
+
+    ASSERT_NO_THROW(checkEnsembleMember(perceptron));
+    ASSERT_NO_THROW(checkEnsembleMember(narrow));
+    ASSERT_THROW(checkEnsembleMember(elman), std::invalid_argument);
+}
@@ -0,0 +1,6 @@
+#ifndef AVERAGINGENSEMBLETEST_H
+#define AVERAGINGENSEMBLETEST_H
+
+
+
+#endif // AVERAGINGENSEMBLETEST_H
@@ -0,0 +1,190 @@
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+
+#include <gtest/gtest.h>
+
+#include "TrainingSet.h"
+#include "ClassRegistry.h"
+#include "NeuralNetwork.h"
+#include "InferenceContext.h"
+#include "ActivationFunction.h"
+#include "ElmanNetworkPattern.h"
+#include "SimpleWeightRandomizer.h"
+#include "PerceptronNetworkPattern.h"
+
+#include "BackpropagationThroughTimeTrainingAlgorithm.h"
+#include "BackpropagationThroughTimeTrainingAlgorithmTest.h"
+
+
+using namespace wzann;
+
+
+namespace {
+    void createNetwork(NeuralNetwork& network, size_t hiddenSize)
+    {
+        ElmanNetworkPattern pattern;
+        pattern.addLayer({ 1, ActivationFunction::Identity });
+        pattern.addLayer({ hiddenSize, ActivationFunction::Logistic });
+        pattern.addLayer({ 1, ActivationFunction::Logistic });
+        network.configure(pattern);
+        SimpleWeightRandomizer().randomize(network);
+    }
+
+
+    //! \brief A sequence whose expected output is the previous input
+    TrainingSet createDelaySequence()
+    {
+        TrainingSet trainingSet;
+        double last = 0.0;
+        unsigned bits = 0x9a5c3e71u;
+
+        for (int i = 0; i != 32; ++i) {
+            double const input = ((bits >> i) & 1u);
+            trainingSet << TrainingItem({ input }, { last });
+            last = input;
+        }
+
+        return trainingSet;
+    }
+
+
+    double meanError(NeuralNetwork const& network, TrainingSet const& ts)
+    {
+        InferenceContext context(network);
+        Vector output;
+        double error = 0.0;
+
+        for (auto const& item: ts.trainingItems) {
+            network.calculate(item.input(), output, context);
+            auto const d = item.expectedOutput()[0] - output[0];
+            error += d * d / 2.0;
+        }
+
+        return error / ts.trainingItems.size();
+    }
+}
+
+
+TEST(BackpropagationThroughTimeTrainingAlgorithmTest, testIsRegistered)
+{
+    ASSERT_TRUE(ClassRegistry<TrainingAlgorithm>::instance()->isRegistered(
+            "wzann::BackpropagationThroughTimeTrainingAlgorithm"));
+}
+
+
+TEST(BackpropagationThroughTimeTrainingAlgorithmTest,
+        testGradientMatchesFiniteDifferences)
+{
+    NeuralNetwork network;
+    createNetwork(network, 3);
+
+    TrainingSet trainingSet;
+    trainingSet.targetError(0.0).maxEpochs(1)
+            << TrainingItem({ 1.0 }, { 0.2 })
+            << TrainingItem({ 0.0 }, { 0.9 })
+            << TrainingItem({ 0.5 }, { 0.1 })
+            << TrainingItem({ 1.0 }, { 0.7 })
+            << TrainingItem({ 0.0 }, { 0.4 });
+
+    // Unrolled over the whole sequence with a learning rate of 1.0, one
+    // epoch subtracts the exact gradient of the mean error:
+
+    NeuralNetwork trained(network);
+    BackpropagationThroughTimeTrainingAlgorithm()
+            .learningRate(1.0)
+            .window(5)
+            .stride(5)
+            .train(trained, trainingSet);
+
+    auto const& fixed = network.fixedWeights();
+    auto weights = network.weights();
+    double const h = 1e-6;
+
+    for (Vector::size_type i = 0; i != weights.size(); ++i) {
+        if (fixed[i]) {
+            ASSERT_EQ(weights[i], trained.weights()[i]);
+            continue;
+        }
+
+        NeuralNetwork probe(network);
+        auto w = weights;
+
+        w[i] = weights[i] + h;
+        probe.swapWeights(w);
+        auto const upper = meanError(probe, trainingSet);
+
+        w = weights;
+        w[i] = weights[i] - h;
+        probe.swapWeights(w);
+        auto const lower = meanError(probe, trainingSet);
+
+        auto const numerical = (upper - lower) / (2.0 * h);
+        auto const analytical = weights[i] - trained.weights()[i];
+        ASSERT_NEAR(numerical, analytical, 1e-8) << "weight " << i;
+    }
+}
+
+
+TEST(BackpropagationThroughTimeTrainingAlgorithmTest, testTrainDelay)
+{
+    NeuralNetwork network;
+    createNetwork(network, 4);
+
+    auto trainingSet = createDelaySequence();
+    trainingSet.targetError(1e-3).maxEpochs(20000);
+
+    BackpropagationThroughTimeTrainingAlgorithm()
+            .learningRate(0.5)
+            .train(network, trainingSet);
+
+    std::cout << "Error: " << trainingSet.error()
+            << ", Epochs: " << trainingSet.epochs() << "\n";
+
+    ASSERT_LE(trainingSet.error(), trainingSet.targetError());
+    ASSERT_TRUE(trainingSet.epochs() < trainingSet.maxEpochs());
+    ASSERT_LE(meanError(network, trainingSet), 2e-3);
+}
+
+
+TEST(BackpropagationThroughTimeTrainingAlgorithmTest,
+        testRejectsFeedForwardNetworks)
+{
+    NeuralNetwork network;
+    PerceptronNetworkPattern pattern;
+    pattern.addLayer({ 2, ActivationFunction::Identity });
+    pattern.addLayer({ 1, ActivationFunction::Logistic });
+    network.configure(pattern);
+
+    TrainingSet trainingSet;
+    trainingSet << TrainingItem({ 0.0, 1.0 }, { 1.0 });
+
+    ASSERT_THROW(
+            BackpropagationThroughTimeTrainingAlgorithm().train(
+                network,
+                trainingSet),
+            std::invalid_argument);
+}
+
+
+TEST(BackpropagationThroughTimeTrainingAlgorithmTest,
+        testDuplicateBiasConnectionStaysUnchanged)
+{
+    NeuralNetwork network;
+    createNetwork(network, 2);
+
+    // Only the first connection from the bias neuron to a neuron counts:
+
+    auto& duplicate = network.connectNeurons(
+                network.biasNeuron(),
+                network[network.size() - 1][0])
+            .weight(0.3);
+
+    auto trainingSet = createDelaySequence();
+    trainingSet.targetError(0.0).maxEpochs(5);
+    BackpropagationThroughTimeTrainingAlgorithm()
+            .learningRate(0.5)
+            .train(network, trainingSet);
+
+    ASSERT_EQ(0.3, duplicate.weight());
+}
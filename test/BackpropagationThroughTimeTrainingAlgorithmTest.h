@@ -0,0 +1,6 @@
+#ifndef BACKPROPAGATIONTHROUGHTIMETRAININGALGORITHMTEST_H
+#define BACKPROPAGATIONTHROUGHTIMETRAININGALGORITHMTEST_H
+
+
+
+#endif // BACKPROPAGATIONTHROUGHTIMETRAININGALGORITHMTEST_H
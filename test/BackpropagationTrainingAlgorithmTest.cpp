@@ -57,3 +57,79 @@ TEST(BackpropagationTrainingAlgorithmTest, testTrainXOR)
     ASSERT_LE(trainingSet.error(), targetTrainingError);
     ASSERT_TRUE(trainingSet.epochs() < trainingSet.maxEpochs());
 }
+
+
+TEST(BackpropagationTrainingAlgorithmTest, testBatchSizeAveragesGradient)
+{
+    NeuralNetwork network;
+    PerceptronNetworkPattern pattern;
+    pattern.addLayer({ 2, ActivationFunction::Identity });
+    pattern.addLayer({ 3, ActivationFunction::Logistic });
+    pattern.addLayer({ 1, ActivationFunction::Logistic });
+    network.configure(pattern);
+    SimpleWeightRandomizer().randomize(network);
+
+    TrainingSet trainingSet;
+    trainingSet.targetError(0.0).maxEpochs(1)
+            << TrainingItem({ 0.0, 0.0 }, { 0.0 })
+            << TrainingItem({ 0.0, 1.0 }, { 1.0 })
+            << TrainingItem({ 1.0, 0.0 }, { 1.0 })
+            << TrainingItem({ 1.0, 1.0 }, { 0.0 });
+
+    // One epoch with the whole set as a batch must equal one epoch with
+    // a batch size that covers all items, and both must differ from
+    // online learning:
+
+    NeuralNetwork fullBatch(network);
+    NeuralNetwork largeBatch(network);
+    NeuralNetwork online(network);
+
+    BackpropagationTrainingAlgorithm().batchSize(0)
+            .train(fullBatch, trainingSet);
+    BackpropagationTrainingAlgorithm().batchSize(100)
+            .train(largeBatch, trainingSet);
+    BackpropagationTrainingAlgorithm().batchSize(1)
+            .train(online, trainingSet);
+
+    ASSERT_EQ(fullBatch.weights(), largeBatch.weights());
+    ASSERT_NE(fullBatch.weights(), online.weights());
+    ASSERT_NE(fullBatch.weights(), network.weights());
+}
+
+
+TEST(BackpropagationTrainingAlgorithmTest, testTrainXORWithMomentum)
+{
+    for (bool nesterov: { false, true }) {
+        NeuralNetwork network;
+        PerceptronNetworkPattern pattern;
+        pattern.addLayer({ 2, ActivationFunction::Identity });
+        pattern.addLayer({ 3, ActivationFunction::Logistic });
+        pattern.addLayer({ 1, ActivationFunction::Logistic });
+        network.configure(pattern);
+        SimpleWeightRandomizer().randomize(network);
+
+        double targetVariance = 1e-2;
+        double targetTrainingError =
+                targetVariance * targetVariance / 4. * 0.5;
+
+        TrainingSet trainingSet;
+        trainingSet.targetError(targetTrainingError).maxEpochs(100000)
+                << TrainingItem({ 0.0, 0.0 }, { 0.0 })
+                << TrainingItem({ 0.0, 1.0 }, { 1.0 })
+                << TrainingItem({ 1.0, 0.0 }, { 1.0 })
+                << TrainingItem({ 1.0, 1.0 }, { 0.0 });
+        BackpropagationTrainingAlgorithm()
+                .learningRate(2.0)
+                .batchSize(0)
+                .momentum(0.9)
+                .nesterov(nesterov)
+                .train(network, trainingSet);
+
+        std::cout << "Nesterov: " << nesterov
+                << ", Error: " << trainingSet.error()
+                << ", Epochs: " << trainingSet.epochs() << "\n";
+
+        ASSERT_LE(trainingSet.error(), targetTrainingError);
+        ASSERT_TRUE(trainingSet.epochs() < trainingSet.maxEpochs());
+    }
+}
@@ -0,0 +1,126 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+#include <iterator>
+
+#include <boost/range.hpp>
+
+#include "Neuron.h"
+#include "Connection.h"
+#include "ConnectionStore.h"
+
+#include "ConnectionStoreTest.h"
+
+
+using namespace wzann;
+using boost::make_iterator_range;
+
+
+TEST(ConnectionStoreTest, testAdjacency)
+{
+    std::vector<Neuron> sources(30), destinations(30);
+    ConnectionStore store;
+
+    ASSERT_EQ(0, std::distance(
+            store.from(sources[0]).first,
+            store.from(sources[0]).second));
+
+    for (auto& s: sources) {
+        for (auto& d: destinations) {
+            store.create(s, d);
+        }
+    }
+
+    ASSERT_EQ(900u, store.size());
+
+    // Connections of one destination neuron are spread over the whole
+    // creation order, but still end up contiguous:
+
+    for (size_t i = 0; i != 30; ++i) {
+        auto from = store.from(sources[i]);
+        auto to = store.to(destinations[i]);
+        ASSERT_EQ(30, std::distance(from.first, from.second));
+        ASSERT_EQ(30, std::distance(to.first, to.second));
+
+        for (size_t j = 0; j != 30; ++j) {
+            ASSERT_EQ(
+                    &(destinations[j]),
+                    &((*(from.first + j))->destination()));
+            ASSERT_EQ(&(sources[j]), &((*(to.first + j))->source()));
+        }
+    }
+}
+
+
+TEST(ConnectionStoreTest, testDestroyAndReuse)
+{
+    std::vector<Neuron> neurons(4);
+    ConnectionStore store;
+
+    auto* c1 = store.create(neurons[0], neurons[1]);
+    auto* c2 = store.create(neurons[0], neurons[2]);
+    auto* c3 = store.create(neurons[3], neurons[2]);
+
+    store.destroy(c2);
+    ASSERT_EQ(2u, store.size());
+    ASSERT_EQ(c1, *(store.all().first));
+    ASSERT_EQ(c3, *(store.all().first + 1));
+    ASSERT_EQ(1, std::distance(
+            store.from(neurons[0]).first,
+            store.from(neurons[0]).second));
+    ASSERT_EQ(c3, *(store.to(neurons[2]).first));
+
+    // The slot of the destroyed connection is reused:
+
+    auto* c4 = store.create(neurons[2], neurons[3]);
+    ASSERT_EQ(c2, c4);
+    ASSERT_EQ(0.0, c4->weight());
+    ASSERT_EQ(&(neurons[2]), &(c4->source()));
+    ASSERT_EQ(c4, *(store.all().first + 2));
+
+    std::vector<Connection*> to;
+    for (auto* c: make_iterator_range(store.to(neurons[3]))) {
+        to.push_back(c);
+    }
+    ASSERT_EQ(std::vector<Connection*>({ c4 }), to);
+}
+
+
+TEST(ConnectionStoreTest, testAssign)
+{
+    std::vector<Neuron> neurons(3), copies(3);
+    ConnectionStore store;
+
+    store.create(neurons[0], neurons[1])->weight(0.5);
+    store.create(neurons[2], neurons[1])->fixedWeight(true);
+    store.create(neurons[0], neurons[2])->weight(-1.0);
+
+    ConnectionStore copy;
+    copy.assign(store, [&neurons, &copies](Neuron const& n) -> Neuron& {
+        return copies[&n - neurons.data()];
+    });
+
+    ASSERT_EQ(3u, copy.size());
+
+    for (size_t i = 0; i != 3; ++i) {
+        auto const* original = *(store.all().first + i);
+        auto const* c = *(copy.all().first + i);
+
+        ASSERT_NE(original, c);
+        ASSERT_EQ(original->weight(), c->weight());
+        ASSERT_EQ(original->fixedWeight(), c->fixedWeight());
+        ASSERT_EQ(
+                &(original->source()) - neurons.data(),
+                &(c->source()) - copies.data());
+        ASSERT_EQ(
+                &(original->destination()) - neurons.data(),
+                &(c->destination()) - copies.data());
+    }
+
+    ASSERT_EQ(2, std::distance(
+            copy.to(copies[1]).first,
+            copy.to(copies[1]).second));
+    ASSERT_EQ(0, std::distance(
+            copy.from(neurons[0]).first,
+            copy.from(neurons[0]).second));
+}
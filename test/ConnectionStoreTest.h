@@ -0,0 +1,6 @@
+#ifndef CONNECTIONSTORETEST_H
+#define CONNECTIONSTORETEST_H
+
+
+
+#endif // CONNECTIONSTORETEST_H
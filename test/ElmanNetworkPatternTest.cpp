@@ -1,5 +1,9 @@
 #include <gtest/gtest.h>
 
+#include <memory>
+
+#include <boost/range.hpp>
+
 
 #include "NeuralNetwork.h"
 #include "Layer.h"
@@ -56,3 +60,35 @@ TEST_F(ElmanNetworkPatternTest, testConfigure)
         }
     }
 }
+
+
+TEST_F(ElmanNetworkPatternTest, testCalculateBatchIsSequential)
+{
+    NeuralNetwork network;
+    ElmanNetworkPattern pattern;
+
+    for (auto const& layerDefinition : m_layers) {
+        pattern.addLayer(layerDefinition);
+    }
+
+    network.configure(pattern);
+
+    double w = 0.1;
+    for (auto* c: boost::make_iterator_range(network.connections())) {
+        if (! c->fixedWeight()) {
+            c->weight(w);
+            w = -w * 1.1;
+        }
+    }
+
+    std::unique_ptr<NeuralNetwork> clone(network.clone());
+
+    Vector inputs = { 0.1, 0.5, 0.9, 0.2 };
+    Vector outputs;
+    network.calculateBatch(inputs, outputs);
+    ASSERT_EQ(inputs.size(), outputs.size());
+
+    for (size_t n = 0; n != inputs.size(); ++n) {
+        ASSERT_DOUBLE_EQ(clone->calculate({ inputs[n] })[0], outputs[n]);
+    }
+}
@@ -0,0 +1,200 @@
+#include <gtest/gtest.h>
+
+#include <boost/range.hpp>
+
+#include "Vector.h"
+#include "Connection.h"
+#include "TrainingSet.h"
+#include "TrainingItem.h"
+#include "NeuralNetwork.h"
+#include "InferenceContext.h"
+#include "ActivationFunction.h"
+
+#include "GradientEngine.h"
+#include "TestNetworks.h"
+#include "GradientEngineTest.h"
+
+
+using namespace wzann;
+
+
+namespace {
+    void createNetwork(NeuralNetwork& network)
+    {
+        createPerceptron(network, {
+                { 2, ActivationFunction::Identity },
+                { 3, ActivationFunction::Tanh },
+                { 2, ActivationFunction::Logistic } });
+
+        Vector weights(network.weights().size());
+        for (Vector::size_type i = 0; i != weights.size(); ++i) {
+            weights[i] = 0.1 * ((i * 7) % 11) - 0.5;
+        }
+        network.weights(weights);
+    }
+
+
+    TrainingSet createTrainingSet()
+    {
+        TrainingSet trainingSet;
+        trainingSet
+                << TrainingItem({ 0.0, 1.0 }, { 1.0, 0.0 })
+                << TrainingItem({ 0.5, -1.0 }, { 0.0, 1.0 })
+                << TrainingItem({ 1.0, 0.0 }, { 1.0, 1.0 })
+                << TrainingItem({ -0.5, 0.2 }, { 0.0, 0.0 })
+                << TrainingItem({ 1.0, 1.0 }, { 0.5, 0.5 })
+                << TrainingItem({ 0.3, 0.7 }, { 1.0, 0.0 });
+        return trainingSet;
+    }
+
+
+    double totalError(NeuralNetwork& network, TrainingSet const& ts)
+    {
+        double error = 0.0;
+
+        for (auto const& item: ts.trainingItems) {
+            auto output = network.calculate(item.input());
+            auto expected = item.expectedOutput();
+
+            for (Vector::size_type i = 0; i != output.size(); ++i) {
+                error += (expected[i] - output[i])
+                        * (expected[i] - output[i]) / 2.0;
+            }
+        }
+
+        return error;
+    }
+
+
+    void expectFiniteDifferences(
+            NeuralNetwork& network,
+            TrainingSet const& trainingSet,
+            Vector const& gradient)
+    {
+        double const h = 1e-6;
+        Vector weights = network.weights();
+
+        for (Vector::size_type i = 0; i != weights.size(); ++i) {
+            auto const w = weights[i];
+
+            weights[i] = w + h;
+            network.weights(weights);
+            auto const e1 = totalError(network, trainingSet);
+
+            weights[i] = w - h;
+            network.weights(weights);
+            auto const e2 = totalError(network, trainingSet);
+
+            weights[i] = w;
+            network.weights(weights);
+
+            EXPECT_NEAR((e1 - e2) / (2 * h), gradient[i], 1e-6);
+        }
+    }
+}
+
+
+TEST(GradientEngineTest, testGradientMatchesFiniteDifferences)
+{
+    NeuralNetwork network;
+    createNetwork(network);
+    auto const trainingSet = createTrainingSet();
+
+    GradientEngine engine(network);
+    auto const error = engine.accumulate(
+            trainingSet.trainingItems.begin(),
+            trainingSet.trainingItems.end());
+    Vector const gradient = engine.gradient();
+
+    ASSERT_EQ(6u, engine.numItems());
+    ASSERT_DOUBLE_EQ(error, engine.error());
+    ASSERT_DOUBLE_EQ(totalError(network, trainingSet), error);
+    ASSERT_EQ(network.weights().size(), gradient.size());
+
+    expectFiniteDifferences(network, trainingSet, gradient);
+}
+
+
+TEST(GradientEngineTest, testDuplicateBiasConnectionHasNoGradient)
+{
+    NeuralNetwork network;
+    createNetwork(network);
+    auto const trainingSet = createTrainingSet();
+
+    // Only the first connection from the bias neuron to a neuron counts:
+
+    auto const position = network.connectNeurons(
+                network.biasNeuron(),
+                network[1][0])
+            .weight(0.3)
+            .position();
+
+    GradientEngine engine(network);
+    engine.accumulate(
+            trainingSet.trainingItems.begin(),
+            trainingSet.trainingItems.end());
+    Vector const gradient = engine.gradient();
+
+    ASSERT_EQ(0.0, gradient[position]);
+    expectFiniteDifferences(network, trainingSet, gradient);
+}
+
+
+TEST(GradientEngineTest, testBlocksSumUpItems)
+{
+    NeuralNetwork network;
+    createNetwork(network);
+    auto const trainingSet = createTrainingSet();
+
+    GradientEngine engine(network);
+    Vector sum(network.weights().size(), 0.0);
+
+    for (auto const& item: trainingSet.trainingItems) {
+        engine.clear();
+        engine.accumulate(item);
+        auto const& gradient = engine.gradient();
+
+        for (Vector::size_type i = 0; i != sum.size(); ++i) {
+            sum[i] += gradient[i];
+        }
+    }
+
+    engine.clear();
+    engine.accumulate(
+            trainingSet.trainingItems.begin(),
+            trainingSet.trainingItems.end());
+    ASSERT_EQ(sum, engine.gradient());
+
+    // Fixed weights have no gradient:
+
+    auto* c = *(network.connections().first);
+    c->fixedWeight(true);
+    ASSERT_EQ(0.0, engine.gradient()[c->position()]);
+}
+
+
+TEST(GradientEngineTest, testContextLeavesNetworkUntouched)
+{
+    NeuralNetwork network;
+    createNetwork(network);
+    auto const trainingSet = createTrainingSet();
+
+    NeuralNetwork reference(network);
+    GradientEngine referenceEngine(reference);
+    referenceEngine.accumulate(
+            trainingSet.trainingItems.begin(),
+            trainingSet.trainingItems.end());
+
+    auto const lastResults = network[1].lastResults();
+    InferenceContext context(network);
+    GradientEngine engine(network, context);
+    auto const error = engine.accumulate(
+            trainingSet.trainingItems.begin(),
+            trainingSet.trainingItems.end());
+
+    ASSERT_EQ(referenceEngine.error(), error);
+    ASSERT_EQ(referenceEngine.numItems(), engine.numItems());
+    ASSERT_EQ(referenceEngine.gradient(), engine.gradient());
+    ASSERT_EQ(lastResults, network[1].lastResults());
+    ASSERT_EQ(reference[1].lastResults(), context.layerOutputs(1));
+}
@@ -0,0 +1,6 @@
+#ifndef GRADIENTENGINETEST_H
+#define GRADIENTENGINETEST_H
+
+
+
+#endif // GRADIENTENGINETEST_H
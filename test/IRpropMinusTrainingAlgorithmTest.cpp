@@ -0,0 +1,98 @@
+#include <cstddef>
+
+#include <gtest/gtest.h>
+
+#include "TrainingSet.h"
+#include "ClassRegistry.h"
+#include "NeuralNetwork.h"
+#include "ActivationFunction.h"
+#include "SimpleWeightRandomizer.h"
+#include "PerceptronNetworkPattern.h"
+
+#include "IRpropMinusTrainingAlgorithm.h"
+#include "TestNetworks.h"
+#include "IRpropMinusTrainingAlgorithmTest.h"
+
+
+using namespace wzann;
+
+
+TEST(IRpropMinusTrainingAlgorithmTest, testIsRegistered)
+{
+    ASSERT_TRUE(ClassRegistry<TrainingAlgorithm>::instance()->isRegistered(
+            "wzann::IRpropMinusTrainingAlgorithm"));
+}
+
+
+TEST(IRpropMinusTrainingAlgorithmTest, testTrainXOR)
+{
+    NeuralNetwork network;
+    PerceptronNetworkPattern pattern;
+    pattern.addLayer({ 2, ActivationFunction::Identity });
+    pattern.addLayer({ 3, ActivationFunction::Logistic });
+    pattern.addLayer({ 1, ActivationFunction::Logistic });
+    network.configure(pattern);
+    SimpleWeightRandomizer().randomize(network);
+
+    // Build training data:
+
+    double targetVariance = 1e-2;
+    double targetTrainingError = targetVariance * targetVariance / 9.;
+
+    TrainingSet trainingSet;
+    trainingSet.targetError(targetTrainingError).maxEpochs(100000)
+            << TrainingItem({ 0.0, 0.0 }, { 0.0 })
+            << TrainingItem({ 0.0, 1.0 }, { 1.0 })
+            << TrainingItem({ 1.0, 0.0 }, { 1.0 })
+            << TrainingItem({ 1.0, 1.0 }, { 0.0 });
+    IRpropMinusTrainingAlgorithm().train(network, trainingSet);
+
+    std::cout << "Error: " << trainingSet.error()
+            << ", Epochs: " << trainingSet.epochs() << "\n";
+
+    Vector output;
+    output = network.calculate({ 1., 1. });
+    ASSERT_NEAR(0, output[0], targetVariance);
+    output = network.calculate({ 1, 0 });
+    ASSERT_NEAR(1, output[0], targetVariance);
+    output = network.calculate({ 0, 0 });
+    ASSERT_NEAR(0, output[0], targetVariance);
+    output = network.calculate({ 0, 1 });
+    ASSERT_NEAR(1, output[0], targetVariance);
+
+    ASSERT_LE(trainingSet.error(), targetTrainingError);
+    ASSERT_TRUE(trainingSet.epochs() < trainingSet.maxEpochs());
+}
+
+
+TEST(IRpropMinusTrainingAlgorithmTest, testNeverBacktracks)
+{
+    // E(w) = w^2 / 2, so the gradient is w. With the initial step of
+    // 0.1, which then grows to 0.12, w = 0.15 moves to 0.05 and -0.07:
+    // The sign changes and the error rises, but the weight stays. Only
+    // the gradient is set to zero, so that the next step is the halved
+    // step of 0.06, in the direction of the new gradient, without a
+    // sign comparison. From w = 0.2, the same steps lead to 0.1 and
+    // -0.02, where the error falls, which makes no difference.
+
+    TrainingSet trainingSet;
+    trainingSet << TrainingItem({ 1.0 }, { 0.0 });
+
+    auto train = [&trainingSet](double weight, std::size_t epochs) {
+        NeuralNetwork network;
+        createSingleWeightNetwork(
+                network,
+                ActivationFunction::Identity,
+                weight);
+        trainingSet.targetError(0.0).maxEpochs(epochs);
+        IRpropMinusTrainingAlgorithm().train(network, trainingSet);
+        return network.trainableWeights()[0];
+    };
+
+    ASSERT_NEAR(-0.07, train(0.15, 3), 1e-12);
+    ASSERT_EQ(3u, trainingSet.epochs());
+    ASSERT_NEAR(-0.01, train(0.15, 4), 1e-12);
+
+    ASSERT_NEAR(-0.02, train(0.2, 3), 1e-12);
+    ASSERT_NEAR(0.04, train(0.2, 4), 1e-12);
+}
@@ -0,0 +1,6 @@
+#ifndef IRPROPMINUSTRAININGALGORITHMTEST_H
+#define IRPROPMINUSTRAININGALGORITHMTEST_H
+
+
+
+#endif // IRPROPMINUSTRAININGALGORITHMTEST_H
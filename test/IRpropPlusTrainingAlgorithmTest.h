@@ -0,0 +1,6 @@
+#ifndef IRPROPPLUSTRAININGALGORITHMTEST_H
+#define IRPROPPLUSTRAININGALGORITHMTEST_H
+
+
+
+#endif // IRPROPPLUSTRAININGALGORITHMTEST_H
@@ -0,0 +1,249 @@
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <boost/range.hpp>
+
+#include "Layer.h"
+#include "Neuron.h"
+#include "Connection.h"
+#include "NeuralNetwork.h"
+#include "InferenceContext.h"
+#include "ActivationFunction.h"
+#include "ElmanNetworkPattern.h"
+#include "PerceptronNetworkPattern.h"
+
+#include "InferenceContextTest.h"
+
+
+using namespace wzann;
+
+
+namespace {
+    //! \brief A pattern that accumulates its inputs in its neurons
+    class AccumulatorPattern: public NeuralNetworkPattern
+    {
+    public:
+
+
+        virtual NeuralNetworkPattern* clone() const override
+        {
+            return new AccumulatorPattern();
+        }
+
+
+    protected:
+
+
+        virtual void configureNetwork(NeuralNetwork& network) override
+        {
+            auto* layer = new Layer();
+            layer->addNeuron(new Neuron());
+            (*layer)[0].activationFunction(ActivationFunction::Identity);
+            network << layer;
+        }
+
+
+        virtual Vector calculate(
+                NeuralNetwork& network,
+                Vector const& input)
+                override
+        {
+            return network[0].activate({
+                    network[0][0].lastInput() + input[0] });
+        }
+    };
+
+
+    void initializeWeights(NeuralNetwork& network)
+    {
+        double w = 0.2;
+        for (auto* c: boost::make_iterator_range(network.connections())) {
+            if (! c->fixedWeight()) {
+                c->weight(w);
+                w = -w * 1.07;
+            }
+        }
+    }
+}
+
+
+TEST(InferenceContextTest, testPerceptronMatchesStatefulCalculation)
+{
+    NeuralNetwork network;
+    PerceptronNetworkPattern pattern;
+
+    pattern.addLayer({ 3, ActivationFunction::Logistic });
+    pattern.addLayer({ 5, ActivationFunction::Tanh });
+    pattern.addLayer({ 2, ActivationFunction::Logistic });
+    network.configure(pattern);
+    initializeWeights(network);
+
+    std::unique_ptr<NeuralNetwork> clone(network.clone());
+    std::unique_ptr<NeuralNetwork> pristine(network.clone());
+    Vector input = { 0.3, -0.7, 1.0 };
+
+    InferenceContext context;
+    NeuralNetwork const& constNetwork = network;
+    auto output = constNetwork.calculate(input, context);
+
+    ASSERT_EQ(clone->calculate(input), output);
+    ASSERT_EQ(*pristine, network);
+
+    // The context holds the same state the neurons would have:
+
+    ASSERT_EQ(network.size(), context.size());
+    for (NeuralNetwork::size_type l = 0; l != network.size(); ++l) {
+        for (Layer::size_type n = 0; n != network[l].size(); ++n) {
+            ASSERT_EQ(
+                    (*clone)[l][n].lastInput(),
+                    context.layerInputs(l)[n]);
+            ASSERT_EQ(
+                    (*clone)[l][n].lastResult(),
+                    context.layerOutputs(l)[n]);
+        }
+    }
+
+    ASSERT_EQ(0.0, network[1][0].lastResult());
+}
+
+
+TEST(InferenceContextTest, testElmanStateLivesInContext)
+{
+    NeuralNetwork network;
+    ElmanNetworkPattern pattern;
+
+    pattern.addLayer({ 2, ActivationFunction::Identity });
+    pattern.addLayer({ 4, ActivationFunction::Logistic });
+    pattern.addLayer({ 1, ActivationFunction::Logistic });
+    network.configure(pattern);
+    initializeWeights(network);
+
+    std::unique_ptr<NeuralNetwork> clone(network.clone());
+    InferenceContext c1(network), c2(network);
+
+    Vector sequence = { 0.1, 0.9, 0.5, 0.2, 0.8, 0.0, 0.4, 0.6 };
+    for (size_t i = 0; i != sequence.size(); i += 2) {
+        Vector input = { sequence[i], sequence[i+1] };
+        auto expected = clone->calculate(input);
+
+        ASSERT_EQ(expected, network.calculate(input, c1));
+        ASSERT_EQ(expected, network.calculate(input, c2));
+    }
+
+    // A fresh context starts over:
+
+    InferenceContext c3(network);
+    ASSERT_NE(
+            network.calculate({ 0.4, 0.6 }, c1),
+            network.calculate({ 0.4, 0.6 }, c3));
+}
+
+
+TEST(InferenceContextTest, testCalculateIntoBuffer)
+{
+    NeuralNetwork network;
+    ElmanNetworkPattern pattern;
+
+    pattern.addLayer({ 2, ActivationFunction::Identity });
+    pattern.addLayer({ 6, ActivationFunction::Tanh });
+    pattern.addLayer({ 3, ActivationFunction::Logistic });
+    network.configure(pattern);
+    initializeWeights(network);
+
+    std::unique_ptr<NeuralNetwork> clone(network.clone());
+    InferenceContext context(network);
+    ASSERT_LE(6u, context.workspace().size());
+
+    Vector output;
+    network.calculate({ 0.0, 0.0 }, output, context);
+    clone->calculate({ 0.0, 0.0 });
+    auto const* buffer = output.data();
+
+    // Once all buffers are in place, they are reused:
+
+    for (int i = 0; i != 8; ++i) {
+        Vector input = { 0.1 * i, 1.0 - 0.2 * i };
+        network.calculate(input, output, context);
+
+        ASSERT_EQ(clone->calculate(input), output);
+        ASSERT_EQ(buffer, output.data());
+    }
+}
+
+
+TEST(InferenceContextTest, testConcurrentCalculation)
+{
+    NeuralNetwork network;
+    PerceptronNetworkPattern pattern;
+
+    pattern.addLayer({ 4, ActivationFunction::Logistic });
+    pattern.addLayer({ 16, ActivationFunction::Tanh });
+    pattern.addLayer({ 3, ActivationFunction::Logistic });
+    network.configure(pattern);
+    initializeWeights(network);
+
+    std::vector<Vector> inputs;
+    for (int i = 0; i != 64; ++i) {
+        inputs.push_back({ 0.01 * i, -0.02 * i, 0.5, 1.0 - 0.01 * i });
+    }
+
+    std::vector<Vector> expected;
+    for (auto const& input: inputs) {
+        expected.push_back(network.calculate(input));
+    }
+
+    // Modify a weight, so that the plan must be refreshed by one of the
+    // threads, then restore it:
+
+    auto* c = *(network.connections().first);
+    auto w = c->weight();
+    c->weight(w + 1.0).weight(w);
+
+    NeuralNetwork const& constNetwork = network;
+    std::vector<std::vector<Vector>> results(4);
+    std::vector<std::thread> threads;
+
+    for (size_t t = 0; t != results.size(); ++t) {
+        threads.emplace_back([&constNetwork, &inputs, &results, t]() {
+            InferenceContext context;
+            for (int round = 0; round != 10; ++round) {
+                results[t].clear();
+                for (auto const& input: inputs) {
+                    results[t].push_back(
+                            constNetwork.calculate(input, context));
+                }
+            }
+        });
+    }
+
+    for (auto& thread: threads) {
+        thread.join();
+    }
+
+    for (auto const& result: results) {
+        ASSERT_EQ(expected, result);
+    }
+}
+
+
+TEST(InferenceContextTest, testFallbackForStatefulPatterns)
+{
+    NeuralNetwork network;
+    AccumulatorPattern pattern;
+    network.configure(pattern);
+
+    ASSERT_EQ(Vector({ 1.0 }), network.calculate({ 1.0 }));
+
+    InferenceContext context(network);
+    ASSERT_EQ(1.0, context.layerInputs(0)[0]);
+
+    ASSERT_EQ(Vector({ 3.0 }), network.calculate({ 2.0 }, context));
+    ASSERT_EQ(Vector({ 6.0 }), network.calculate({ 3.0 }, context));
+    ASSERT_EQ(6.0, context.layerInputs(0)[0]);
+    ASSERT_EQ(1.0, network[0][0].lastInput());
+
+    ASSERT_EQ(Vector({ 2.0 }), network.calculate({ 1.0 }));
+}
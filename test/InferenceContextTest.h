@@ -0,0 +1,6 @@
+#ifndef INFERENCECONTEXTTEST_H
+#define INFERENCECONTEXTTEST_H
+
+
+
+#endif // INFERENCECONTEXTTEST_H
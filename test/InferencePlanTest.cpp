@@ -0,0 +1,272 @@
+#include <gtest/gtest.h>
+
+#include "Layer.h"
+#include "Neuron.h"
+#include "Connection.h"
+#include "NeuralNetwork.h"
+#include "InferencePlan.h"
+#include "ActivationFunction.h"
+
+#include "InferencePlanTest.h"
+
+
+using namespace wzann;
+
+
+namespace {
+    NeuralNetwork* createNetwork()
+    {
+        auto* network = new NeuralNetwork();
+        auto* l1 = new Layer();
+        auto* l2 = new Layer();
+
+        for (int i = 0; i != 2; ++i) {
+            auto* n = new Neuron();
+            n->activationFunction(ActivationFunction::Identity);
+            *l1 << n;
+        }
+
+        for (int i = 0; i != 3; ++i) {
+            auto* n = new Neuron();
+            n->activationFunction(ActivationFunction::Identity);
+            *l2 << n;
+        }
+
+        *network << l1 << l2;
+
+        for (int i = 0; i != 2; ++i) {
+            for (int j = 0; j != 3; ++j) {
+                network->connectNeurons((*l1)[i], (*l2)[j])
+                    .weight(10.0 * i + j);
+            }
+        }
+
+        network->connectNeurons(network->biasNeuron(), (*l2)[1])
+            .weight(0.5);
+
+        return network;
+    }
+}
+
+
+TEST(InferencePlanTest, testCompile)
+{
+    std::unique_ptr<NeuralNetwork> network(createNetwork());
+    auto const& plan = network->compile();
+
+    ASSERT_TRUE(plan.isCompiled());
+    ASSERT_TRUE(plan.hasValidWeights());
+    ASSERT_EQ(2u, plan.size());
+    ASSERT_EQ(2u, plan.layerSize(0));
+    ASSERT_EQ(3u, plan.layerSize(1));
+    ASSERT_EQ(1u, plan.layerIndex((*network)[1]));
+
+    ASSERT_EQ(nullptr, plan.transition(1, 0));
+    ASSERT_EQ(nullptr, plan.transition(0, 0));
+
+    auto const* t = plan.transition(0, 1);
+    ASSERT_NE(nullptr, t);
+    ASSERT_EQ(3u, t->rows);
+    ASSERT_EQ(2u, t->columns);
+
+    for (size_t i = 0; i != 2; ++i) {
+        for (size_t j = 0; j != 3; ++j) {
+            ASSERT_DOUBLE_EQ(10.0 * i + j, t->weights[j * 2 + i]);
+        }
+    }
+
+    ASSERT_EQ(Vector({ 0.0, 0.0 }), plan.bias(0));
+    ASSERT_EQ(Vector({ 0.0, 0.5, 0.0 }), plan.bias(1));
+
+    Vector input = { 1.0, 2.0 };
+    Vector output(3, 0.0);
+    InferencePlan::transfer(*t, input.data(), output.data());
+    ASSERT_EQ(Vector({ 20.0, 23.0, 26.0 }), output);
+}
+
+
+TEST(InferencePlanTest, testIsRecurrent)
+{
+    std::unique_ptr<NeuralNetwork> network(createNetwork());
+    ASSERT_FALSE(network->compile().isRecurrent());
+
+    network->connectNeurons((*network)[1][0], (*network)[0][1]);
+    ASSERT_TRUE(network->compile().isRecurrent());
+}
+
+
+TEST(InferencePlanTest, testWeightChangeRefreshesPlan)
+{
+    std::unique_ptr<NeuralNetwork> network(createNetwork());
+    auto const& plan = network->compile();
+
+    network->connection((*network)[0][1], (*network)[1][2])->weight(-1.0);
+    ASSERT_TRUE(plan.isCompiled());
+    ASSERT_FALSE(plan.hasValidWeights());
+
+    network->compile();
+    ASSERT_TRUE(plan.hasValidWeights());
+    ASSERT_DOUBLE_EQ(-1.0, plan.transition(0, 1)->weights[2 * 2 + 1]);
+
+    Vector output = network->calculateLayerTransition(
+            (*network)[0],
+            (*network)[1],
+            { 1.0, 1.0 });
+    ASSERT_EQ(Vector({ 10.0, 12.0, 1.0 }), output);
+}
+
+
+TEST(InferencePlanTest, testWeightVector)
+{
+    std::unique_ptr<NeuralNetwork> network(createNetwork());
+    auto const& plan = network->compile();
+
+    ASSERT_EQ(
+            Vector({ 0.0, 1.0, 2.0, 10.0, 11.0, 12.0, 0.5 }),
+            network->weights());
+
+    network->connection((*network)[0][0], (*network)[1][0])
+        ->fixedWeight(true);
+    ASSERT_EQ(
+            std::vector<char>({ 1, 0, 0, 0, 0, 0, 0 }),
+            network->fixedWeights());
+    ASSERT_EQ(
+            Vector({ 1.0, 2.0, 10.0, 11.0, 12.0, 0.5 }),
+            network->trainableWeights());
+
+    Vector weights({ 0.0, -1.0, -2.0, -3.0, -4.0, -5.0, 7.0 });
+    network->swapWeights(weights);
+    ASSERT_EQ(0.5, weights.back());
+    ASSERT_FALSE(plan.hasValidWeights());
+    ASSERT_DOUBLE_EQ(
+            -4.0,
+            network->connection((*network)[0][1], (*network)[1][1])
+                ->weight());
+
+    network->compile();
+    ASSERT_DOUBLE_EQ(-5.0, plan.transition(0, 1)->weights[2 * 2 + 1]);
+    ASSERT_EQ(Vector({ 0.0, 7.0, 0.0 }), plan.bias(1));
+
+    network->trainableWeights({ 1.0, 2.0, 3.0, 4.0, 5.0, 6.0 });
+    ASSERT_EQ(
+            Vector({ 0.0, 1.0, 2.0, 3.0, 4.0, 5.0, 6.0 }),
+            network->weights());
+    ASSERT_FALSE(plan.hasValidWeights());
+
+    network->compile();
+    ASSERT_EQ(Vector({ 0.0, 6.0, 0.0 }), plan.bias(1));
+}
+
+
+TEST(InferencePlanTest, testTopologyChangeInvalidatesPlan)
+{
+    std::unique_ptr<NeuralNetwork> network(createNetwork());
+    auto const& plan = network->compile();
+
+    network->disconnectNeurons((*network)[0][0], (*network)[1][2]);
+    ASSERT_FALSE(plan.isCompiled());
+    ASSERT_FALSE(network->connectionExists(
+            (*network)[0][0],
+            (*network)[1][2]));
+
+    network->compile();
+    ASSERT_DOUBLE_EQ(0.0, plan.transition(0, 1)->weights[2 * 2 + 0]);
+
+    network->connectNeurons((*network)[1][0], (*network)[0][0])
+        .weight(2.0);
+    ASSERT_FALSE(plan.isCompiled());
+
+    network->compile();
+    ASSERT_NE(nullptr, plan.transition(1, 0));
+    ASSERT_DOUBLE_EQ(2.0, plan.transition(1, 0)->weights[0]);
+
+    (*network)[1] << new Neuron();
+    ASSERT_FALSE(plan.isCompiled());
+
+    network->compile();
+    ASSERT_EQ(4u, plan.layerSize(1));
+    ASSERT_EQ(4u, plan.transition(0, 1)->rows);
+}
+
+
+TEST(InferencePlanTest, testBiasChangeKeepsPlanValid)
+{
+    std::unique_ptr<NeuralNetwork> network(createNetwork());
+    auto const& plan = network->compile();
+    auto& biasNeuron = network->biasNeuron();
+
+    network->connection(biasNeuron, (*network)[1][1])->weight(-2.0);
+    ASSERT_TRUE(plan.hasValidWeights());
+    ASSERT_EQ(Vector({ 0.0, -2.0, 0.0 }), plan.bias(1));
+
+    network->connectNeurons(biasNeuron, (*network)[1][2]).weight(3.0);
+    ASSERT_TRUE(plan.hasValidWeights());
+    ASSERT_EQ(Vector({ 0.0, -2.0, 3.0 }), plan.bias(1));
+
+    // Only the first bias connection to a neuron counts; the second one
+    // takes over as soon as the first one is removed:
+
+    network->connectNeurons(biasNeuron, (*network)[1][2]).weight(4.0);
+    ASSERT_EQ(Vector({ 0.0, -2.0, 3.0 }), plan.bias(1));
+
+    network->disconnectNeurons(biasNeuron, (*network)[1][2]);
+    ASSERT_TRUE(plan.hasValidWeights());
+    ASSERT_EQ(Vector({ 0.0, -2.0, 4.0 }), plan.bias(1));
+
+    network->disconnectNeurons(biasNeuron, (*network)[1][2]);
+    network->disconnectNeurons(biasNeuron, (*network)[1][1]);
+    ASSERT_TRUE(plan.hasValidWeights());
+    ASSERT_EQ(Vector({ 0.0, 0.0, 0.0 }), plan.bias(1));
+
+    // Connections created after a removed one are still found:
+
+    network->connectNeurons(biasNeuron, (*network)[1][0]).weight(5.0);
+    network->connectNeurons((*network)[1][0], (*network)[0][0]);
+    network->compile();
+    network->disconnectNeurons(biasNeuron, (*network)[1][0]);
+    ASSERT_TRUE(plan.isCompiled());
+
+    network->connection((*network)[1][0], (*network)[0][0])->weight(3.0);
+    network->compile();
+    ASSERT_DOUBLE_EQ(3.0, plan.transition(1, 0)->weights[0]);
+    ASSERT_EQ(Vector({ 0.0, 0.0, 0.0 }), plan.bias(1));
+}
+
+
+TEST(InferencePlanTest, testCalculateLayerWithBias)
+{
+    std::unique_ptr<NeuralNetwork> network(createNetwork());
+    auto const lastResult = network->biasNeuron().lastResult();
+
+    Vector output = network->calculateLayer(
+            (*network)[1],
+            { 1.0, 2.0, 3.0 });
+    ASSERT_EQ(Vector({ 1.0, 2.5, 3.0 }), output);
+    ASSERT_EQ(lastResult, network->biasNeuron().lastResult());
+}
+
+
+TEST(InferencePlanTest, testTransferBatch)
+{
+    std::unique_ptr<NeuralNetwork> network(createNetwork());
+    auto const& plan = network->compile();
+    auto const* t = plan.transition(0, 1);
+
+    Vector inputs;
+    for (int i = 0; i != 7; ++i) {
+        inputs.push_back(i);
+        inputs.push_back(-0.5 * i);
+    }
+
+    Vector outputs(7 * 3, 0.0);
+    InferencePlan::transferBatch(*t, inputs.data(), 7, outputs.data());
+
+    for (size_t n = 0; n != 7; ++n) {
+        Vector output(3, 0.0);
+        InferencePlan::transfer(*t, inputs.data() + 2 * n, output.data());
+
+        for (size_t r = 0; r != 3; ++r) {
+            ASSERT_DOUBLE_EQ(output[r], outputs[3 * n + r]);
+        }
+    }
+}
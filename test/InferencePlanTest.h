@@ -0,0 +1,6 @@
+#ifndef INFERENCEPLANTEST_H
+#define INFERENCEPLANTEST_H
+
+
+
+#endif // INFERENCEPLANTEST_H
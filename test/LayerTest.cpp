@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 
 #include <list>
+#include <cstddef>
 
 #include "Neuron.h"
 #include "ActivationFunction.h"
@@ -71,3 +72,49 @@ TEST(LayerTest, testSerialization)
 
     delete layer2;
 }
+
+
+TEST(LayerTest, testNeuronStateInLayerArrays)
+{
+    auto* n1 = new Neuron(), *n2 = new Neuron();
+    n1->activationFunction(ActivationFunction::Identity);
+    n2->activationFunction(ActivationFunction::Logistic);
+    n2->activate(0.0);
+
+    Layer layer;
+    layer << n1 << n2;
+
+    ASSERT_EQ(0ul, layer.indexOf(*n1));
+    ASSERT_EQ(1ul, layer.indexOf(*n2));
+    ASSERT_DOUBLE_EQ(0.5, layer.lastResults()[1]);
+
+    n1->activate(2.0);
+    ASSERT_DOUBLE_EQ(2.0, layer.lastInputs()[0]);
+    ASSERT_DOUBLE_EQ(2.0, layer.lastResults()[0]);
+
+    layer.activate({ 3.0, 0.0 });
+    ASSERT_DOUBLE_EQ(3.0, n1->lastInput());
+    ASSERT_DOUBLE_EQ(3.0, n1->lastResult());
+    ASSERT_DOUBLE_EQ(0.5, n2->lastResult());
+
+    n2->activationFunction(ActivationFunction::Identity);
+    ASSERT_TRUE(layer.hasUniformActivationFunction());
+}
+
+
+TEST(LayerTest, testAttachedNeuronIsHandle)
+{
+    ASSERT_EQ(sizeof(Layer*) + sizeof(std::size_t), sizeof(Neuron));
+
+    auto* neuron = new Neuron();
+    neuron->activationFunction(ActivationFunction::Logistic);
+    neuron->activate(0.0);
+
+    Layer layer;
+    layer << neuron;
+
+    ASSERT_TRUE(neuron->activationFunction()
+            == ActivationFunction(ActivationFunction::Logistic));
+    ASSERT_DOUBLE_EQ(0.0, neuron->lastInput());
+    ASSERT_DOUBLE_EQ(0.5, neuron->lastResult());
+}
@@ -0,0 +1,91 @@
+#include <cstddef>
+#include <iostream>
+
+#include <gtest/gtest.h>
+
+#include "TrainingSet.h"
+#include "ClassRegistry.h"
+#include "NeuralNetwork.h"
+#include "ActivationFunction.h"
+
+#include "LbfgsTrainingAlgorithm.h"
+#include "TestNetworks.h"
+#include "LbfgsTrainingAlgorithmTest.h"
+
+
+using namespace wzann;
+
+
+TEST(LbfgsTrainingAlgorithmTest, testIsRegistered)
+{
+    ASSERT_TRUE(ClassRegistry<TrainingAlgorithm>::instance()->isRegistered(
+            "wzann::LbfgsTrainingAlgorithm"));
+}
+
+
+TEST(LbfgsTrainingAlgorithmTest, testSecondDirectionIsNewtonStep)
+{
+    // E(w) = ((w - 2)^2 + (2w - 3)^2) / 4 has its minimum at w = 1.6.
+    // The first epoch descends along the gradient, -4 at w = 0, with a
+    // step of 1/4 and reaches w = 1. The second epoch remembers one
+    // change, whose secant is the exact curvature of 2.5, so the
+    // two-loop recursion yields the Newton step to the minimum.
+
+    TrainingSet trainingSet;
+    trainingSet
+            << TrainingItem({ 1.0 }, { 2.0 })
+            << TrainingItem({ 2.0 }, { 3.0 });
+    trainingSet.targetError(0.0).maxEpochs(1);
+
+    NeuralNetwork initial;
+    createSingleWeightNetwork(initial, ActivationFunction::Identity, 0.0);
+    ASSERT_EQ(1u, initial.trainableWeights().size());
+
+    NeuralNetwork n1(initial);
+    LbfgsTrainingAlgorithm().train(n1, trainingSet);
+
+    ASSERT_EQ(1u, trainingSet.epochs());
+    ASSERT_DOUBLE_EQ(1.0, n1.trainableWeights()[0]);
+
+    NeuralNetwork n2(initial);
+    trainingSet.maxEpochs(2);
+    LbfgsTrainingAlgorithm().train(n2, trainingSet);
+
+    ASSERT_EQ(2u, trainingSet.epochs());
+    ASSERT_DOUBLE_EQ(1.6, n2.trainableWeights()[0]);
+    ASSERT_NEAR(0.05, trainingSet.error(), 1e-12);
+}
+
+
+TEST(LbfgsTrainingAlgorithmTest, testHistoryWrapsAround)
+{
+    NeuralNetwork initial;
+    createXORNetwork(initial);
+
+    auto train = [&initial](std::size_t historySize, std::size_t epochs) {
+        NeuralNetwork network(initial);
+        auto trainingSet = createXORTrainingSet();
+        trainingSet.targetError(0.0).maxEpochs(epochs);
+        LbfgsTrainingAlgorithm().historySize(historySize)
+                .train(network, trainingSet);
+        return network.weights();
+    };
+
+    // The n-th epoch uses the changes of the n epochs before it, as far
+    // as the history holds them:
+
+    ASSERT_EQ(train(2, 3), train(3, 3));
+    ASSERT_NE(train(2, 4), train(3, 4));
+
+    // Once the history is full, the oldest change is overwritten:
+
+    NeuralNetwork network(initial);
+    auto trainingSet = createXORTrainingSet();
+    trainingSet.targetError(1e-4).maxEpochs(1000);
+    LbfgsTrainingAlgorithm().historySize(2).train(network, trainingSet);
+
+    std::cout << "Error: " << trainingSet.error()
+            << ", Epochs: " << trainingSet.epochs() << "\n";
+
+    ASSERT_LE(trainingSet.error(), trainingSet.targetError());
+}
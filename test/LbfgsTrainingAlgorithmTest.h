@@ -0,0 +1,6 @@
+#ifndef LBFGSTRAININGALGORITHMTEST_H
+#define LBFGSTRAININGALGORITHMTEST_H
+
+
+
+#endif // LBFGSTRAININGALGORITHMTEST_H
@@ -0,0 +1,119 @@
+#include <cmath>
+#include <iostream>
+
+#include <gtest/gtest.h>
+
+#include "ClassRegistry.h"
+#include "NeuralNetwork.h"
+#include "GradientEngine.h"
+
+#include "LevenbergMarquardtTrainingAlgorithm.h"
+#include "TestNetworks.h"
+#include "LevenbergMarquardtTrainingAlgorithmTest.h"
+
+
+using namespace wzann;
+
+
+TEST(LevenbergMarquardtTrainingAlgorithmTest, testIsRegistered)
+{
+    ASSERT_TRUE(ClassRegistry<TrainingAlgorithm>::instance()->isRegistered(
+            "wzann::LevenbergMarquardtTrainingAlgorithm"));
+}
+
+
+TEST(LevenbergMarquardtTrainingAlgorithmTest, testTrainXOR)
+{
+    NeuralNetwork network;
+    createXORNetwork(network);
+
+    double targetVariance = 1e-2;
+    double targetTrainingError = targetVariance * targetVariance / 9.;
+
+    auto trainingSet = createXORTrainingSet();
+    trainingSet.targetError(targetTrainingError).maxEpochs(1000);
+    LevenbergMarquardtTrainingAlgorithm().train(network, trainingSet);
+
+    std::cout << "Error: " << trainingSet.error()
+            << ", Epochs: " << trainingSet.epochs() << "\n";
+
+    Vector output;
+    output = network.calculate({ 1., 1. });
+    ASSERT_NEAR(0, output[0], targetVariance);
+    output = network.calculate({ 1, 0 });
+    ASSERT_NEAR(1, output[0], targetVariance);
+    output = network.calculate({ 0, 0 });
+    ASSERT_NEAR(0, output[0], targetVariance);
+    output = network.calculate({ 0, 1 });
+    ASSERT_NEAR(1, output[0], targetVariance);
+
+    ASSERT_LE(trainingSet.error(), targetTrainingError);
+    ASSERT_LT(trainingSet.epochs(), 100u);
+}
+
+
+TEST(LevenbergMarquardtTrainingAlgorithmTest, testLargeDampingFollowsGradient)
+{
+    NeuralNetwork network;
+    createXORNetwork(network);
+
+    auto trainingSet = createXORTrainingSet();
+    trainingSet.targetError(0.0).maxEpochs(1);
+
+    NeuralNetwork reference(network);
+    GradientEngine engine(reference);
+    engine.accumulate(
+            trainingSet.trainingItems.begin(),
+            trainingSet.trainingItems.end());
+    auto const gradient = engine.gradient();
+
+    // With a large damping, J^T J is negligible, and the step is the
+    // gradient of the summed errors, divided by the damping:
+
+    double const damping = 1e8;
+    LevenbergMarquardtTrainingAlgorithm().damping(damping)
+            .train(network, trainingSet);
+
+    for (Vector::size_type i = 0; i != gradient.size(); ++i) {
+        auto const step = reference.weights()[i] - network.weights()[i];
+        ASSERT_NEAR(gradient[i], step * damping, 1e-6) << "weight " << i;
+    }
+}
+
+
+TEST(LevenbergMarquardtTrainingAlgorithmTest, testFixedWeightsStayFixed)
+{
+    NeuralNetwork network;
+    createXORNetwork(network);
+
+    auto* fixed = *(network.connections().first);
+    fixed->fixedWeight(true);
+    auto const fixedWeight = fixed->weight();
+
+    auto trainingSet = createXORTrainingSet();
+    trainingSet.targetError(0.0).maxEpochs(10);
+    LevenbergMarquardtTrainingAlgorithm().train(network, trainingSet);
+
+    ASSERT_EQ(fixedWeight, network.weights()[fixed->position()]);
+}
+
+
+TEST(LevenbergMarquardtTrainingAlgorithmTest,
+        testDuplicateBiasConnectionStaysUnchanged)
+{
+    NeuralNetwork network;
+    createXORNetwork(network);
+
+    // Only the first connection from the bias neuron to a neuron counts:
+
+    auto& duplicate = network.connectNeurons(
+                network.biasNeuron(),
+                network[2][0])
+            .weight(0.3);
+
+    auto trainingSet = createXORTrainingSet();
+    trainingSet.targetError(0.0).maxEpochs(10);
+    LevenbergMarquardtTrainingAlgorithm().train(network, trainingSet);
+
+    ASSERT_EQ(0.3, duplicate.weight());
+}
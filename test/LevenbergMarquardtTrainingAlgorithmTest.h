@@ -0,0 +1,6 @@
+#ifndef LEVENBERGMARQUARDTTRAININGALGORITHMTEST_H
+#define LEVENBERGMARQUARDTTRAININGALGORITHMTEST_H
+
+
+
+#endif // LEVENBERGMARQUARDTTRAININGALGORITHMTEST_H
@@ -0,0 +1,45 @@
+#include <vector>
+#include <stdexcept>
+
+#include <gtest/gtest.h>
+
+#include "ParallelFor.h"
+#include "ParallelForTest.h"
+
+
+using namespace wzann;
+
+
+TEST(ParallelForTest, testRunsEachTaskOnce)
+{
+    std::vector<int> runs(100, 0);
+
+    parallelFor(runs.size(), 4, [&runs](std::size_t i) {
+        ++runs[i];
+    });
+
+    ASSERT_EQ(std::vector<int>(100, 1), runs);
+    ASSERT_GE(effectiveNumThreads(0), 1u);
+    ASSERT_EQ(3u, effectiveNumThreads(3));
+}
+
+
+TEST(ParallelForTest, testRethrowsFirstException)
+{
+    std::vector<int> runs(10, 0);
+
+    try {
+        parallelFor(runs.size(), 3, [&runs](std::size_t i) {
+            ++runs[i];
+
+            if (i == 4 || i == 7) {
+                throw std::runtime_error(std::to_string(i));
+            }
+        });
+        FAIL();
+    } catch (std::runtime_error const& e) {
+        ASSERT_STREQ("4", e.what());
+    }
+
+    ASSERT_EQ(std::vector<int>(10, 1), runs);
+}
@@ -0,0 +1,6 @@
+#ifndef PARALLELFORTEST_H
+#define PARALLELFORTEST_H
+
+
+
+#endif // PARALLELFORTEST_H
@@ -1,8 +1,11 @@
 #include <gtest/gtest.h>
 
+#include <boost/range.hpp>
+
 #include "Layer.h"
 #include "NeuralNetwork.h"
 #include "ActivationFunction.h"
+#include "LayerSizeMismatchException.h"
 
 #include "PerceptronNetworkPattern.h"
 #include "PerceptronNetworkPatternTest.h"
@@ -60,3 +63,44 @@ TEST(PerceptronNetworkPatternTest, testCalculate)
     Vector output = network.calculate(input);
     ASSERT_TRUE(1.0f != output[0] + 1.0);
 }
+
+
+TEST(PerceptronNetworkPatternTest, testCalculateBatch)
+{
+    NeuralNetwork network;
+    PerceptronNetworkPattern pattern;
+
+    pattern.addLayer({ 2, ActivationFunction::Logistic });
+    pattern.addLayer({ 3, ActivationFunction::Tanh });
+    pattern.addLayer({ 2, ActivationFunction::Logistic });
+    network.configure(pattern);
+
+    double w = -1.0;
+    for (auto* c: boost::make_iterator_range(network.connections())) {
+        c->weight(w);
+        w += 0.3;
+    }
+
+    Vector inputs = {
+        0.0, 0.0,
+        0.0, 1.0,
+        1.0, 0.0,
+        1.0, 1.0,
+        0.5, -0.5,
+        -1.0, 2.0
+    };
+    Vector outputs;
+
+    ASSERT_EQ(6u, network.calculateBatch(inputs, outputs));
+    ASSERT_EQ(12u, outputs.size());
+
+    for (size_t n = 0; n != 6; ++n) {
+        auto output = network.calculate({ inputs[2*n], inputs[2*n+1] });
+        ASSERT_DOUBLE_EQ(output[0], outputs[2*n]);
+        ASSERT_DOUBLE_EQ(output[1], outputs[2*n+1]);
+    }
+
+    ASSERT_THROW(
+            network.calculateBatch({ 1.0, 2.0, 3.0 }, outputs),
+            LayerSizeMismatchException);
+}
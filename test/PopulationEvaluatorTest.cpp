@@ -0,0 +1,196 @@
+#include <cmath>
+#include <stdexcept>
+
+#include <gtest/gtest.h>
+
+#include "Vector.h"
+#include "Connection.h"
+#include "TrainingSet.h"
+#include "TrainingItem.h"
+#include "NeuralNetwork.h"
+#include "ActivationFunction.h"
+#include "ElmanNetworkPattern.h"
+
+#include "PopulationEvaluator.h"
+#include "TestNetworks.h"
+#include "PopulationEvaluatorTest.h"
+
+
+using namespace wzann;
+
+
+namespace {
+    void createNetwork(NeuralNetwork& network)
+    {
+        createPerceptron(network, {
+                { 3, ActivationFunction::Identity },
+                { 5, ActivationFunction::Tanh },
+                { 2, ActivationFunction::Logistic } });
+    }
+
+
+    Vector createPopulation(std::size_t size, std::size_t numParameters)
+    {
+        Vector population(size * numParameters);
+
+        for (Vector::size_type i = 0; i != population.size(); ++i) {
+            population[i] = 0.1 * ((i * 7) % 13) - 0.6;
+        }
+
+        return population;
+    }
+}
+
+
+TEST(PopulationEvaluatorTest, testOutputsMatchNetwork)
+{
+    NeuralNetwork network;
+    createNetwork(network);
+    auto* fixed = *(network.connections().first);
+    fixed->weight(0.25).fixedWeight(true);
+
+    PopulationEvaluator evaluator(network);
+    ASSERT_EQ(network.trainableWeights().size(), evaluator.numParameters());
+
+    std::size_t const P = 5;
+    auto const population = createPopulation(P, evaluator.numParameters());
+    evaluator.load(population, P);
+    ASSERT_EQ(P, evaluator.populationSize());
+
+    Vector const inputs = { 0.1, 0.2, 0.3, -1.0, 0.5, 2.0 };
+    Vector outputs;
+    evaluator.calculate(inputs, 2, outputs);
+    ASSERT_EQ(P * 2 * 2, outputs.size());
+
+    for (std::size_t p = 0; p != P; ++p) {
+        network.trainableWeights(Vector(
+                population.begin() + p * evaluator.numParameters(),
+                population.begin() + (p + 1) * evaluator.numParameters()));
+        ASSERT_EQ(0.25, fixed->weight());
+
+        for (std::size_t n = 0; n != 2; ++n) {
+            auto const expected = network.calculate(Vector(
+                    inputs.begin() + n * 3,
+                    inputs.begin() + (n + 1) * 3));
+
+            for (std::size_t o = 0; o != 2; ++o) {
+                ASSERT_NEAR(
+                        expected[o],
+                        outputs[(p * 2 + n) * 2 + o],
+                        1e-12);
+            }
+        }
+    }
+}
+
+
+TEST(PopulationEvaluatorTest, testDuplicateConnectionsMatchNetwork)
+{
+    NeuralNetwork network;
+    createNetwork(network);
+
+    // A second connection between two neurons adds to the first; a
+    // second one from the bias neuron is ignored:
+
+    network.connectNeurons(network[0][1], network[1][2]).weight(0.5);
+    network.connectNeurons(network[1][3], network[2][0])
+            .weight(-0.75)
+            .fixedWeight(true);
+    network.connectNeurons(network.biasNeuron(), network[1][0]);
+    network.connectNeurons(network.biasNeuron(), network[2][1])
+            .weight(2.0)
+            .fixedWeight(true);
+
+    PopulationEvaluator evaluator(network);
+    ASSERT_EQ(network.trainableWeights().size(), evaluator.numParameters());
+
+    std::size_t const P = 3;
+    auto const population = createPopulation(P, evaluator.numParameters());
+    evaluator.load(population, P);
+
+    Vector const input = { 0.3, -0.4, 0.9 };
+    Vector outputs;
+    evaluator.calculate(input, 1, outputs);
+
+    for (std::size_t p = 0; p != P; ++p) {
+        network.trainableWeights(Vector(
+                population.begin() + p * evaluator.numParameters(),
+                population.begin() + (p + 1) * evaluator.numParameters()));
+        auto const expected = network.calculate(input);
+
+        for (std::size_t o = 0; o != 2; ++o) {
+            ASSERT_NEAR(expected[o], outputs[p * 2 + o], 1e-12);
+        }
+    }
+}
+
+
+TEST(PopulationEvaluatorTest, testMeanErrors)
+{
+    NeuralNetwork network;
+    createNetwork(network);
+
+    TrainingSet trainingSet;
+    trainingSet
+            << TrainingItem({ 0.0, 1.0, 0.5 }, { 1.0, 0.0 })
+            << TrainingItem({ 0.5, -1.0, 0.0 }, { 0.0, 1.0 })
+            << TrainingItem({ 1.0, 0.0, 1.0 }, { 1.0, 1.0 });
+
+    PopulationEvaluator evaluator(network);
+    std::size_t const P = 3;
+    auto const population = createPopulation(P, evaluator.numParameters());
+    evaluator.load(population, P);
+
+    Vector errors;
+    evaluator.meanErrors(trainingSet, errors);
+    ASSERT_EQ(P, errors.size());
+
+    for (std::size_t p = 0; p != P; ++p) {
+        network.trainableWeights(Vector(
+                population.begin() + p * evaluator.numParameters(),
+                population.begin() + (p + 1) * evaluator.numParameters()));
+        double error = 0.0;
+
+        for (auto const& item: trainingSet.trainingItems) {
+            auto const actual = network.calculate(item.input());
+            auto const expected = item.expectedOutput();
+            double itemError = 0.0;
+
+            for (std::size_t o = 0; o != actual.size(); ++o) {
+                itemError += std::pow(expected[o] - actual[o], 2);
+            }
+
+            error += itemError / 2.0;
+        }
+
+        ASSERT_NEAR(error / 3.0, errors[p], 1e-12);
+    }
+}
+
+
+TEST(PopulationEvaluatorTest, testRejectsRecurrentNetworks)
+{
+    NeuralNetwork network;
+    ElmanNetworkPattern pattern;
+    pattern.addLayer({ 2, ActivationFunction::Logistic });
+    pattern.addLayer({ 3, ActivationFunction::Logistic });
+    pattern.addLayer({ 1, ActivationFunction::Logistic });
+    network.configure(pattern);
+
+    ASSERT_FALSE(PopulationEvaluator::supports(network));
+    ASSERT_THROW(PopulationEvaluator evaluator(network), std::invalid_argument);
+
+    NeuralNetwork feedForward;
+    createNetwork(feedForward);
+    ASSERT_TRUE(PopulationEvaluator::supports(feedForward));
+}
+
+
+TEST(PopulationEvaluatorTest, testRejectsSkipConnections)
+{
+    NeuralNetwork network;
+    createSkipConnectionNetwork(network);
+
+    ASSERT_FALSE(PopulationEvaluator::supports(network));
+    ASSERT_THROW(PopulationEvaluator evaluator(network), std::invalid_argument);
+}
@@ -0,0 +1,6 @@
+#ifndef POPULATIONEVALUATORTEST_H
+#define POPULATIONEVALUATORTEST_H
+
+
+
+#endif // POPULATIONEVALUATORTEST_H
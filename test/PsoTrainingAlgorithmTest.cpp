@@ -1,122 +1,160 @@
-#include <QtTest>
-#include <QObject>
-
-#include <QFile>
-#include <QTextStream>
-
 #include <iostream>
 
 #include <gtest/gtest.h>
 
-#include "Layer.h"
-#include "Neuron.h"
-#include "Connection.h"
+#include "ClassRegistry.h"
 #include "NeuralNetwork.h"
-#include "SimpleWeightRandomizer.h"
-
+#include "InferenceContext.h"
+#include "ActivationFunction.h"
 #include "ElmanNetworkPattern.h"
-#include "PerceptronNetworkPattern.h"
-#include "LinearActivationFunction.h"
-#include "SigmoidActivationFunction.h"
-
-#include "TrainingSet.h"
+#include "PopulationEvaluator.h"
+#include "SimpleWeightRandomizer.h"
 
 #include "PsoTrainingAlgorithm.h"
+#include "TestNetworks.h"
 #include "PsoTrainingAlgorithmTest.h"
 
 
-using wzann::Layer;
-using wzann::Neuron;
-using wzann::Connection;
-using wzann::Vector;
-using wzann::NeuralNetwork;
-using wzann::ElmanNetworkPattern;
-using wzann::SimpleWeightRandomizer;
-using wzann::PerceptronNetworkPattern;
-using wzann::LinearActivationFunction;
-using wzann::SigmoidActivationFunction;
+using namespace wzann;
+
+
+TEST(PsoTrainingAlgorithmTest, testIsRegistered)
+{
+    ASSERT_TRUE(ClassRegistry<TrainingAlgorithm>::instance()->isRegistered(
+            "wzann::PsoTrainingAlgorithm"));
+}
+
+
+TEST(PsoTrainingAlgorithmTest, testTrainXOR)
+{
+    NeuralNetwork network;
+    createXORNetwork(network);
+
+    auto trainingSet = createXORTrainingSet();
+    trainingSet.targetError(1e-2).maxEpochs(1000);
+    PsoTrainingAlgorithm().train(network, trainingSet);
+
+    std::cout << "Error: " << trainingSet.error()
+            << ", Epochs: " << trainingSet.epochs() << "\n";
+
+    ASSERT_LE(trainingSet.error(), trainingSet.targetError());
+
+    Vector output;
+    output = network.calculate({ 1., 1. });
+    ASSERT_GT(0.5, output[0]);
+    output = network.calculate({ 1., 0. });
+    ASSERT_LT(0.5, output[0]);
+    output = network.calculate({ 0., 0. });
+    ASSERT_GT(0.5, output[0]);
+    output = network.calculate({ 0., 1. });
+    ASSERT_LT(0.5, output[0]);
+}
+
+
+TEST(PsoTrainingAlgorithmTest, testResultIndependentOfThreads)
+{
+    NeuralNetwork n1;
+    createXORNetwork(n1);
+    NeuralNetwork n2(n1);
+
+    auto ts1 = createXORTrainingSet();
+    ts1.targetError(0.0).maxEpochs(10);
+    auto ts2 = ts1;
 
-using wzann::TrainingSet;
-using wzann::TrainingItem;
+    PsoTrainingAlgorithm().swarmSize(50).numThreads(1).train(n1, ts1);
+    PsoTrainingAlgorithm().swarmSize(50).numThreads(3).train(n2, ts2);
 
-using wzann::Individual;
-using wzann::PsoTrainingAlgorithm;
+    ASSERT_EQ(ts1.error(), ts2.error());
+    ASSERT_EQ(n1.weights(), n2.weights());
+}
 
 
-NeuralNetwork* PsoTrainingAlgorithmTest::createNeuralNetwork()
+TEST(PsoTrainingAlgorithmTest, testTrainRecurrentNetwork)
 {
-    NeuralNetwork *net = new NeuralNetwork();
-
-    static ElmanNetworkPattern pattern({
-            2,
-            3,
-            1
-        },
-        {
-            new SigmoidActivationFunction(),
-            new SigmoidActivationFunction(),
-            new SigmoidActivationFunction()
-        });
-    net->configure(pattern);
-
-    return net;
+    NeuralNetwork network;
+    ElmanNetworkPattern pattern;
+    pattern.addLayer({ 2, ActivationFunction::Identity });
+    pattern.addLayer({ 3, ActivationFunction::Logistic });
+    pattern.addLayer({ 1, ActivationFunction::Logistic });
+    network.configure(pattern);
+    SimpleWeightRandomizer().randomize(network);
+
+    auto trainingSet = createXORTrainingSet();
+    trainingSet.targetError(0.0).maxEpochs(1);
+    PsoTrainingAlgorithm().train(network, trainingSet);
+    auto const initialError = trainingSet.error();
+
+    trainingSet.maxEpochs(50);
+    PsoTrainingAlgorithm().train(network, trainingSet);
+
+    ASSERT_EQ(50u, trainingSet.epochs());
+    ASSERT_GT(initialError, trainingSet.error());
 }
 
 
-TEST_F(PsoTrainingAlgorithmTest, testTrainXOR)
+TEST(PsoTrainingAlgorithmTest, testRecurrentNetworkErrorIsSequential)
 {
     NeuralNetwork network;
-    PerceptronNetworkPattern pattern(
-            {
-                2,
-                3,
-                1
-            }, {
-                new LinearActivationFunction(),
-                new SigmoidActivationFunction(),
-                new SigmoidActivationFunction()
-            });
+    ElmanNetworkPattern pattern;
+    pattern.addLayer({ 2, ActivationFunction::Identity });
+    pattern.addLayer({ 3, ActivationFunction::Logistic });
+    pattern.addLayer({ 1, ActivationFunction::Logistic });
     network.configure(pattern);
     SimpleWeightRandomizer().randomize(network);
+    ASSERT_FALSE(PopulationEvaluator::supports(network));
+
+    auto trainingSet = createXORTrainingSet();
+    trainingSet.targetError(0.0).maxEpochs(5);
+    PsoTrainingAlgorithm().swarmSize(20).numThreads(2)
+            .train(network, trainingSet);
+
+    // Recurrent networks are evaluated on copies of the network, with
+    // the context carried over from one item to the next:
+
+    ASSERT_EQ(
+            TrainingAlgorithm::meanError(
+                network,
+                trainingSet,
+                InferenceContext(network)),
+            trainingSet.error());
+}
+
+
+TEST(PsoTrainingAlgorithmTest, testSkipConnectionFallsBackToNetworks)
+{
+    NeuralNetwork network;
+    createSkipConnectionNetwork(network);
+    ASSERT_FALSE(PopulationEvaluator::supports(network));
+
+    auto trainingSet = createXORTrainingSet();
+    trainingSet.targetError(0.0).maxEpochs(5);
+    PsoTrainingAlgorithm().swarmSize(20).numThreads(2)
+            .train(network, trainingSet);
+
+    // The error is the one the network itself calculates:
+
+    ASSERT_EQ(
+            TrainingAlgorithm::meanError(
+                network,
+                trainingSet,
+                InferenceContext(network)),
+            trainingSet.error());
+}
+
+
+TEST(PsoTrainingAlgorithmTest, testFixedWeightsStayFixed)
+{
+    NeuralNetwork network;
+    createXORNetwork(network);
+
+    auto* fixed = *(network.connections().first);
+    fixed->fixedWeight(true);
+    auto const fixedWeight = fixed->weight();
+
+    auto trainingSet = createXORTrainingSet();
+    trainingSet.targetError(0.0).maxEpochs(3);
+    PsoTrainingAlgorithm().train(network, trainingSet);
 
-    // Build training data:
-
-    QList<TrainingItem> trainingItems;
-    trainingItems
-            << TrainingItem({ 0.0, 0.0 }, { 0.0 })
-            << TrainingItem({ 0.0, 1.0 }, { 1.0 })
-            << TrainingItem({ 1.0, 0.0 }, { 1.0 })
-            << TrainingItem({ 1.0, 1.0 }, { 0.0 });
-
-    TrainingSet trainingSet(
-            trainingItems,
-            1e-2,
-            5000);
-
-    PsoTrainingAlgorithm trainingAlgorithm;
-    QDateTime dt1 = QDateTime::currentDateTime();
-    trainingAlgorithm.train(network, trainingSet);
-    QDateTime dt2 = QDateTime::currentDateTime();
-
-    qDebug() << "Trained XOR(x, y) in" << dt1.msecsTo(dt2) << "msec";
-
-    auto output = network.calculate({ 1, 1 });
-    qDebug() << "(1, 1) =>" << output;
-    ASSERT_EQ(0, qRound(output[0]));
-    output = network.calculate({ 1, 0 });
-    qDebug() << "(1, 0) =>" << output;
-    ASSERT_EQ(1, qRound(output[0]));
-    output = network.calculate({ 0, 0 });
-    qDebug() << "(0, 0) =>" << output;
-    ASSERT_EQ(0, qRound(output[0]));
-    output = network.calculate({ 0, 1 });
-    qDebug() << "(0, 1) =>" << output;
-    ASSERT_EQ(1, qRound(output[0]));
-
-    QFile annDumpFile("testTrainXOR.out");
-    annDumpFile.open(
-            QIODevice::WriteOnly|QIODevice::Truncate|QIODevice::Text);
-    annDumpFile.write(network.toJSON().toJson());
-    annDumpFile.flush();
-    annDumpFile.close();
+    ASSERT_EQ(fixedWeight, network.weights()[fixed->position()]);
+    ASSERT_EQ(3u, trainingSet.epochs());
 }
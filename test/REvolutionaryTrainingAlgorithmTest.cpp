@@ -1,3 +1,4 @@
+#include <memory>
 #include <vector>
 #include <iostream>
 
@@ -9,6 +10,7 @@
 #include "Neuron.h"
 #include "Connection.h"
 #include "NeuralNetwork.h"
+#include "InferenceContext.h"
 #include "ActivationFunction.h"
 #include "SimpleWeightRandomizer.h"
 
@@ -18,6 +20,7 @@
 #include "TrainingSet.h"
 
 #include "REvolutionaryTrainingAlgorithm.h"
+#include "TestNetworks.h"
 #include "REvolutionaryTrainingAlgorithmTest.h"
 
 
@@ -27,6 +30,7 @@ using wzann::Vector;
 using wzann::Connection;
 using wzann::TrainingSet;
 using wzann::TrainingItem;
+using wzann::TrainingAlgorithm;
 using wzann::NeuralNetwork;
 using wzann::ActivationFunction;
 using wzann::ElmanNetworkPattern;
@@ -288,6 +292,183 @@ TEST_F(REvolutionaryTrainingAlgorithmTest, testTrainSmallAnn)
 }
 
 
+TEST_F(REvolutionaryTrainingAlgorithmTest, testEvaluationIgnoresThreads)
+{
+    std::unique_ptr<NeuralNetwork> ann(createNeuralNetwork());
+    wzann::SimpleWeightRandomizer().randomize(*ann);
+
+    TrainingSet ts;
+    ts.targetError(0.0);
+
+    for (size_t i = 0;
+            i != 3 * REvolutionaryTrainingAlgorithm::EVALUATION_CHUNK_SIZE;
+            ++i) {
+        double x = 0.001 * i;
+        ts << TrainingItem({ x, 1.0 - x }, { x * x });
+    }
+
+    Individual individual;
+    REvolutionaryTrainingAlgorithm::getWeights(*ann, individual.parameters);
+    individual.restrictions.assign(1, 0.0);
+
+    Individual other = individual;
+    REvolutionaryTrainingAlgorithm::individualSucceeds(individual, *ann, ts);
+    REvolutionaryTrainingAlgorithm::individualSucceeds(other, *ann, ts, 3);
+
+    ASSERT_GT(individual.restrictions[0], 0.0);
+    ASSERT_EQ(individual.restrictions[0], other.restrictions[0]);
+
+    // The network's neurons are left untouched, so that the evaluation
+    // is repeatable:
+
+    REvolutionaryTrainingAlgorithm::individualSucceeds(other, *ann, ts, 2);
+    ASSERT_EQ(individual.restrictions[0], other.restrictions[0]);
+}
+
+
+TEST_F(REvolutionaryTrainingAlgorithmTest, testRacingStopsAtLowerBound)
+{
+    NeuralNetwork ann;
+    createPerceptron(ann, {
+            { 2, ActivationFunction::Identity },
+            { 3, ActivationFunction::Logistic },
+            { 1, ActivationFunction::Logistic } });
+    wzann::SimpleWeightRandomizer().randomize(ann);
+
+    auto const chunkSize =
+            REvolutionaryTrainingAlgorithm::EVALUATION_CHUNK_SIZE;
+    TrainingSet ts;
+    TrainingSet firstChunk;
+    ts.targetError(0.0);
+
+    for (size_t i = 0; i != 3 * chunkSize; ++i) {
+        double x = 0.001 * i;
+        ts << TrainingItem({ x, 1.0 - x }, { x * x });
+
+        if (i < chunkSize) {
+            firstChunk << TrainingItem({ x, 1.0 - x }, { x * x });
+        }
+    }
+
+    Individual individual;
+    REvolutionaryTrainingAlgorithm::getWeights(ann, individual.parameters);
+    individual.restrictions.assign(1, 0.0);
+    Individual raced = individual;
+
+    REvolutionaryTrainingAlgorithm::individualSucceeds(individual, ann, ts);
+    auto const error = individual.restrictions[0];
+
+    // The first chunk's share of the error is a lower bound. Once it
+    // exceeds the threshold, the other chunks are not calculated:
+
+    auto const bound = TrainingAlgorithm::meanError(
+                ann,
+                firstChunk,
+                wzann::InferenceContext(ann))
+            / 3.0;
+    ASSERT_LT(bound, error);
+
+    for (size_t numThreads: { 1, 3 }) {
+        REvolutionaryTrainingAlgorithm::individualSucceeds(
+                raced,
+                ann,
+                ts,
+                numThreads,
+                bound / 2.0);
+        ASSERT_NEAR(bound, raced.restrictions[0], 1e-12);
+    }
+
+    // Individuals below the threshold are evaluated completely:
+
+    REvolutionaryTrainingAlgorithm::individualSucceeds(
+            raced,
+            ann,
+            ts,
+            3,
+            error);
+    ASSERT_EQ(error, raced.restrictions[0]);
+}
+
+
+TEST_F(REvolutionaryTrainingAlgorithmTest, testRacingIgnoresThreads)
+{
+    TrainingSet ts;
+    ts.targetError(1e-4).maxEpochs(300);
+
+    for (size_t i = 0;
+            i != 4 * REvolutionaryTrainingAlgorithm::EVALUATION_CHUNK_SIZE;
+            ++i) {
+        double x = 0.001 * i;
+        ts << TrainingItem({ x, 1.0 - x }, { x * x });
+    }
+
+    NeuralNetwork ann1;
+    createPerceptron(ann1, {
+            { 2, ActivationFunction::Identity },
+            { 3, ActivationFunction::Logistic },
+            { 1, ActivationFunction::Logistic } });
+    wzann::SimpleWeightRandomizer().randomize(ann1);
+    NeuralNetwork ann2(ann1);
+
+    REvolutionaryTrainingAlgorithm trainingAlgorithm;
+    ASSERT_FALSE(trainingAlgorithm.racing());
+    trainingAlgorithm.racing(true).numThreads(1);
+    trainingAlgorithm.train(ann1, ts);
+    auto const error = ts.error();
+    auto const epochs = ts.epochs();
+
+    trainingAlgorithm.numThreads(3);
+    trainingAlgorithm.train(ann2, ts);
+
+    ASSERT_EQ(error, ts.error());
+    ASSERT_EQ(epochs, ts.epochs());
+    ASSERT_EQ(ann1.weights(), ann2.weights());
+}
+
+
+TEST_F(REvolutionaryTrainingAlgorithmTest, testEvaluationKeepsRecurrentState)
+{
+    std::unique_ptr<NeuralNetwork> ann(createNeuralNetwork());
+    wzann::SimpleWeightRandomizer().randomize(*ann);
+    ASSERT_TRUE(ann->compile().isRecurrent());
+
+    TrainingSet ts;
+    ts.targetError(0.0);
+
+    for (size_t i = 0;
+            i != 3 * REvolutionaryTrainingAlgorithm::EVALUATION_CHUNK_SIZE;
+            ++i) {
+        double x = 0.001 * i;
+        ts << TrainingItem({ x, 1.0 - x }, { x * x });
+    }
+
+    // The items form one sequence, calculated with one context:
+
+    wzann::InferenceContext context(*ann);
+    Vector actual;
+    double error = 0.0;
+
+    for (auto const& item: ts.trainingItems) {
+        ann->calculate(item.input(), actual, context);
+        double const d = item.expectedOutput()[0] - actual[0];
+        error += d * d / 2.0;
+    }
+
+    error /= static_cast<double>(ts.trainingItems.size());
+
+    Individual individual;
+    REvolutionaryTrainingAlgorithm::getWeights(*ann, individual.parameters);
+    individual.restrictions.assign(1, 0.0);
+    REvolutionaryTrainingAlgorithm::individualSucceeds(
+            individual,
+            *ann,
+            ts,
+            3);
+
+    ASSERT_DOUBLE_EQ(error, individual.restrictions[0]);
+}
+
+
 TEST_F(REvolutionaryTrainingAlgorithmTest, testTrainXOR)
 {
     NeuralNetwork network;
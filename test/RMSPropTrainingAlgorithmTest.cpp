@@ -0,0 +1,94 @@
+#include <cmath>
+#include <iostream>
+
+#include <gtest/gtest.h>
+
+#include "TrainingSet.h"
+#include "ClassRegistry.h"
+#include "NeuralNetwork.h"
+#include "ActivationFunction.h"
+#include "SimpleWeightRandomizer.h"
+#include "PerceptronNetworkPattern.h"
+
+#include "RMSPropTrainingAlgorithm.h"
+#include "TestNetworks.h"
+#include "RMSPropTrainingAlgorithmTest.h"
+
+
+using namespace wzann;
+
+
+TEST(RMSPropTrainingAlgorithmTest, testIsRegistered)
+{
+    ASSERT_TRUE(ClassRegistry<TrainingAlgorithm>::instance()->isRegistered(
+            "wzann::RMSPropTrainingAlgorithm"));
+}
+
+
+TEST(RMSPropTrainingAlgorithmTest, testTrainXOR)
+{
+    NeuralNetwork network;
+    PerceptronNetworkPattern pattern;
+    pattern.addLayer({ 2, ActivationFunction::Identity });
+    pattern.addLayer({ 3, ActivationFunction::Logistic });
+    pattern.addLayer({ 1, ActivationFunction::Logistic });
+    network.configure(pattern);
+    SimpleWeightRandomizer().randomize(network);
+
+    // Build training data:
+
+    double targetVariance = 1e-2;
+    double targetTrainingError = targetVariance * targetVariance / 4. * 0.5;
+
+    TrainingSet trainingSet;
+    trainingSet.targetError(targetTrainingError).maxEpochs(100000)
+            << TrainingItem({ 0.0, 0.0 }, { 0.0 })
+            << TrainingItem({ 0.0, 1.0 }, { 1.0 })
+            << TrainingItem({ 1.0, 0.0 }, { 1.0 })
+            << TrainingItem({ 1.0, 1.0 }, { 0.0 });
+    RMSPropTrainingAlgorithm()
+            .learningRate(0.01)
+            .train(network, trainingSet);
+
+    std::cout << "Error: " << trainingSet.error()
+            << ", Epochs: " << trainingSet.epochs() << "\n";
+
+    Vector output;
+    output = network.calculate({ 1., 1. });
+    ASSERT_NEAR(0., output[0], targetVariance);
+    output = network.calculate({ 1, 0 });
+    ASSERT_NEAR(1., output[0], targetVariance);
+    output = network.calculate({ 0, 0 });
+    ASSERT_NEAR(0., output[0], targetVariance);
+    output = network.calculate({ 0, 1 });
+    ASSERT_NEAR(1., output[0], targetVariance);
+
+    ASSERT_LE(trainingSet.error(), targetTrainingError);
+    ASSERT_TRUE(trainingSet.epochs() < trainingSet.maxEpochs());
+}
+
+
+TEST(RMSPropTrainingAlgorithmTest, testFirstStepScalesWithDecay)
+{
+    NeuralNetwork network;
+    createSingleWeightNetwork(network, ActivationFunction::Identity, 0.0);
+
+    // The error is (0.5 - w)^2 / 2, its gradient w - 0.5:
+
+    TrainingSet trainingSet;
+    trainingSet.targetError(0.0).maxEpochs(1)
+            << TrainingItem({ 1.0 }, { 0.5 });
+
+    // The mean of the squares starts at zero, so the first step is
+    // lr * |g| / (sqrt(1 - rho) * |g| + eps):
+
+    RMSPropTrainingAlgorithm algorithm;
+    algorithm.decay(0.9);
+    algorithm.learningRate(0.01).epsilon(0.25);
+    algorithm.train(network, trainingSet);
+
+    ASSERT_NEAR(
+            0.01 * 0.5 / (std::sqrt(1.0 - 0.9) * 0.5 + 0.25),
+            network.trainableWeights()[0],
+            1e-12);
+}
@@ -0,0 +1,6 @@
+#ifndef RMSPROPTRAININGALGORITHMTEST_H
+#define RMSPROPTRAININGALGORITHMTEST_H
+
+
+
+#endif // RMSPROPTRAININGALGORITHMTEST_H
@@ -53,3 +53,44 @@ TEST(RpropTrainingAlgorithmTest, testTrainXOR)
     ASSERT_LE(trainingSet.error(), targetTrainingError);
     ASSERT_TRUE(trainingSet.epochs() < trainingSet.maxEpochs());
 }
+
+
+TEST(RpropTrainingAlgorithmTest, testThreadsAreDeterministic)
+{
+    NeuralNetwork network;
+    PerceptronNetworkPattern pattern;
+    pattern.addLayer({ 2, ActivationFunction::Identity });
+    pattern.addLayer({ 5, ActivationFunction::Tanh });
+    pattern.addLayer({ 1, ActivationFunction::Logistic });
+    network.configure(pattern);
+    SimpleWeightRandomizer().randomize(network);
+
+    TrainingSet trainingSet;
+    trainingSet.targetError(0.0).maxEpochs(20);
+
+    for (int i = 0; i != 50; ++i) {
+        double x = 0.04 * i - 1.0;
+        trainingSet << TrainingItem({ x, x * x }, { x > 0.0 ? 1.0 : 0.0 });
+    }
+
+    NeuralNetwork serial(network);
+    RpropTrainingAlgorithm().numThreads(1).train(serial, trainingSet);
+    auto const serialError = trainingSet.error();
+
+    // Threads only change the order in which the shards' gradients are
+    // added, and the result must not depend on their scheduling:
+
+    NeuralNetwork parallel1(network);
+    NeuralNetwork parallel2(network);
+    RpropTrainingAlgorithm().numThreads(4).train(parallel1, trainingSet);
+    auto const parallelError = trainingSet.error();
+    RpropTrainingAlgorithm().numThreads(4).train(parallel2, trainingSet);
+
+    ASSERT_EQ(parallel1.weights(), parallel2.weights());
+    ASSERT_EQ(parallelError, trainingSet.error());
+    ASSERT_NEAR(serialError, parallelError, 1e-9);
+
+    for (Vector::size_type i = 0; i != serial.weights().size(); ++i) {
+        ASSERT_NEAR(serial.weights()[i], parallel1.weights()[i], 1e-9);
+    }
+}
@@ -0,0 +1,58 @@
+#include <cmath>
+
+#include <gtest/gtest.h>
+
+#include "TrainingSet.h"
+#include "ClassRegistry.h"
+#include "NeuralNetwork.h"
+#include "ActivationFunction.h"
+
+#include "ScaledConjugateGradientTrainingAlgorithm.h"
+#include "TestNetworks.h"
+#include "ScaledConjugateGradientTrainingAlgorithmTest.h"
+
+
+using namespace wzann;
+
+
+TEST(ScaledConjugateGradientTrainingAlgorithmTest, testIsRegistered)
+{
+    ASSERT_TRUE(ClassRegistry<TrainingAlgorithm>::instance()->isRegistered(
+            "wzann::ScaledConjugateGradientTrainingAlgorithm"));
+}
+
+
+TEST(ScaledConjugateGradientTrainingAlgorithmTest, testAdaptsLambda)
+{
+    // E(w) = (logistic(w) - 0.7)^2 / 2 has its minimum at
+    // w = ln(0.7 / 0.3). With a sigma of 100, the curvature is estimated
+    // from the gradient at w = 100, where the error is flat, and the
+    // first step overshoots to w = 100, which raises the error from
+    // 0.02 to 0.045. The step must be rejected and lambda raised until
+    // the step is short enough; lambda must then be lowered again, or
+    // the steps remain damped and converge only linearly.
+
+    TrainingSet trainingSet;
+    trainingSet << TrainingItem({ 1.0 }, { 0.7 });
+    trainingSet.targetError(0.0).maxEpochs(1);
+
+    NeuralNetwork initial;
+    createSingleWeightNetwork(initial, ActivationFunction::Logistic, 0.0);
+    ASSERT_EQ(1u, initial.trainableWeights().size());
+
+    NeuralNetwork n1(initial);
+    ScaledConjugateGradientTrainingAlgorithm().sigma(100.0)
+            .train(n1, trainingSet);
+
+    ASSERT_EQ(1u, trainingSet.epochs());
+    ASSERT_EQ(initial.weights(), n1.weights());
+    ASSERT_DOUBLE_EQ(0.02, trainingSet.error());
+
+    NeuralNetwork n2(initial);
+    trainingSet.maxEpochs(14);
+    ScaledConjugateGradientTrainingAlgorithm().sigma(100.0)
+            .train(n2, trainingSet);
+
+    ASSERT_NEAR(std::log(0.7 / 0.3), n2.trainableWeights()[0], 1e-9);
+    ASSERT_GT(1e-18, trainingSet.error());
+}
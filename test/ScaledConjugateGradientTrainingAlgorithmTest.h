@@ -0,0 +1,6 @@
+#ifndef SCALEDCONJUGATEGRADIENTTRAININGALGORITHMTEST_H
+#define SCALEDCONJUGATEGRADIENTTRAININGALGORITHMTEST_H
+
+
+
+#endif // SCALEDCONJUGATEGRADIENTTRAININGALGORITHMTEST_H
@@ -44,3 +44,26 @@ TEST(SimpleWeightRandomizerTest, testWeightRandomization)
         }
     }
 }
+
+
+TEST(SimpleWeightRandomizerTest, testSeed)
+{
+    NeuralNetwork neuralNetwork;
+    PerceptronNetworkPattern pattern;
+
+    pattern.addLayer({ 5, ActivationFunction::Identity });
+    pattern.addLayer({ 20, ActivationFunction::Identity });
+    neuralNetwork.configure(pattern);
+
+    NeuralNetwork seeded(neuralNetwork);
+    NeuralNetwork reseeded(neuralNetwork);
+
+    SimpleWeightRandomizer().randomize(neuralNetwork);
+    SimpleWeightRandomizer().seed(42).randomize(seeded);
+    SimpleWeightRandomizer().seed(42).randomize(reseeded);
+
+    ASSERT_EQ(SimpleWeightRandomizer::defaultSeed,
+            SimpleWeightRandomizer().seed());
+    ASSERT_EQ(seeded.weights(), reseeded.weights());
+    ASSERT_NE(neuralNetwork.weights(), seeded.weights());
+}
@@ -1,98 +1,107 @@
-#include <QObject>
-#include <QtTest>
-#include <QList>
-#include <QFile>
-#include <QTextStream>
+#include <iostream>
 
-#include "NeuralNetwork.h"
-
-#include "LinearActivationFunction.h"
-#include "SigmoidActivationFunction.h"
+#include <gtest/gtest.h>
 
-#include "PerceptronNetworkPattern.h"
-#include <NguyenWidrowWeightRandomizer.h>
+#include "ClassRegistry.h"
+#include "NeuralNetwork.h"
+#include "ActivationFunction.h"
 
-#include "TrainingSet.h"
 #include "SimulatedAnnealingTrainingAlgorithm.h"
-
-#include <gtest/gtest.h>
+#include "TestNetworks.h"
 #include "SimulatedAnnealingTrainingAlgorithmTest.h"
 
 
 using namespace wzann;
 
 
-SimulatedAnnealingTrainingAlgorithmTest::SimulatedAnnealingTrainingAlgorithmTest(
-        QObject *parent):
-            QObject(parent)
+TEST(SimulatedAnnealingTrainingAlgorithmTest, testIsRegistered)
 {
+    ASSERT_TRUE(ClassRegistry<TrainingAlgorithm>::instance()->isRegistered(
+            "wzann::SimulatedAnnealingTrainingAlgorithm"));
 }
 
 
 TEST(SimulatedAnnealingTrainingAlgorithmTest, testTrainXOR)
 {
     NeuralNetwork network;
-    PerceptronNetworkPattern pattern(
-            {
-                2,
-                3,
-                1
-            }, {
-                new LinearActivationFunction(),
-                new SigmoidActivationFunction(),
-                new SigmoidActivationFunction()
-            });
+    createXORNetwork(network, ActivationFunction::Logistic);
 
-    network.configure(pattern);
-    NguyenWidrowWeightRandomizer().randomize(network);
+    auto trainingSet = createXORTrainingSet();
+    trainingSet.targetError(1e-2).maxEpochs(1000);
+    SimulatedAnnealingTrainingAlgorithm().train(network, trainingSet);
 
-    // Build training data:
+    std::cout << "Error: " << trainingSet.error()
+            << ", Epochs: " << trainingSet.epochs() << "\n";
 
-    QList<TrainingItem> trainingItems;
-    trainingItems
-            << TrainingItem({ 0.0, 0.0 }, { 0.0 })
-            << TrainingItem({ 0.0, 1.0 }, { 1.0 })
-            << TrainingItem({ 1.0, 0.0 }, { 1.0 })
-            << TrainingItem({ 1.0, 1.0 }, { 0.0 });
+    ASSERT_LE(trainingSet.error(), trainingSet.targetError());
 
-    TrainingSet trainingSet(
-            trainingItems,
-            1e-3,
-            10000);
+    Vector output;
+    output = network.calculate({ 1., 1. });
+    ASSERT_GT(0.5, output[0]);
+    output = network.calculate({ 1., 0. });
+    ASSERT_LT(0.5, output[0]);
+    output = network.calculate({ 0., 0. });
+    ASSERT_GT(0.5, output[0]);
+    output = network.calculate({ 0., 1. });
+    ASSERT_LT(0.5, output[0]);
+}
 
-    QFile testResultFile(QString(QTest::currentTestFunction()).append(".out"));
-    testResultFile.open(QIODevice::Text
-            | QIODevice::WriteOnly | QIODevice::Truncate);
-    QTextStream testResultStream(&testResultFile);
 
-    testResultStream << network;
+TEST(SimulatedAnnealingTrainingAlgorithmTest, testParallelTemperingBinaryStep)
+{
+    NeuralNetwork network;
+    createXORNetwork(network, ActivationFunction::BinaryStep);
 
-    QDateTime dt1 = QDateTime::currentDateTime();
+    auto trainingSet = createXORTrainingSet();
+    trainingSet.targetError(1e-9).maxEpochs(1000);
+    SimulatedAnnealingTrainingAlgorithm().replicas(4).numThreads(2)
+            .train(network, trainingSet);
 
-    SimulatedAnnealingTrainingAlgorithm(10, 2, 100)
-        .train(network, trainingSet);
+    std::cout << "Error: " << trainingSet.error()
+            << ", Epochs: " << trainingSet.epochs() << "\n";
 
-    QDateTime dt2 = QDateTime::currentDateTime();
-    qDebug() << "Trained XOR(x, y) in" << dt1.msecsTo(dt2) << "msec";
+    ASSERT_EQ(0.0, trainingSet.error());
+    ASSERT_EQ(0.0, network.calculate({ 1., 1. })[0]);
+    ASSERT_EQ(1.0, network.calculate({ 1., 0. })[0]);
+    ASSERT_EQ(0.0, network.calculate({ 0., 0. })[0]);
+    ASSERT_EQ(1.0, network.calculate({ 0., 1. })[0]);
+}
 
-    testResultStream << network;
 
-    Vector output;
-    output = network.calculate({ 1, 1 });
-    qDebug() << "(1, 1) =>" << output;
-    ASSERT_EQ(0, qRound(output[0]));
-    output = network.calculate({ 1, 0 });
-    qDebug() << "(1, 0) =>" << output;
-    ASSERT_EQ(1, qRound(output[0]));
-    output = network.calculate({ 0, 0 });
-    qDebug() << "(0, 0) =>" << output;
-    ASSERT_EQ(0, qRound(output[0]));
-    output = network.calculate({ 0, 1 });
-    qDebug() << "(0, 1) =>" << output;
-    ASSERT_EQ(1, qRound(output[0]));
-
-
-    testResultStream.flush();
-    testResultFile.flush();
-    testResultFile.close();
+TEST(SimulatedAnnealingTrainingAlgorithmTest, testResultIndependentOfThreads)
+{
+    NeuralNetwork n1;
+    createXORNetwork(n1, ActivationFunction::Logistic);
+    NeuralNetwork n2(n1);
+
+    auto ts1 = createXORTrainingSet();
+    ts1.targetError(0.0).maxEpochs(5);
+    auto ts2 = ts1;
+
+    SimulatedAnnealingTrainingAlgorithm().replicas(3).numThreads(1)
+            .train(n1, ts1);
+    SimulatedAnnealingTrainingAlgorithm().replicas(3).numThreads(3)
+            .train(n2, ts2);
+
+    ASSERT_EQ(ts1.error(), ts2.error());
+    ASSERT_EQ(n1.weights(), n2.weights());
+}
+
+
+TEST(SimulatedAnnealingTrainingAlgorithmTest, testFixedWeightsStayFixed)
+{
+    NeuralNetwork network;
+    createXORNetwork(network, ActivationFunction::Logistic);
+
+    auto* fixed = *(network.connections().first);
+    fixed->fixedWeight(true);
+    auto const fixedWeight = fixed->weight();
+
+    auto trainingSet = createXORTrainingSet();
+    trainingSet.targetError(0.0).maxEpochs(3);
+    SimulatedAnnealingTrainingAlgorithm().replicas(2)
+            .train(network, trainingSet);
+
+    ASSERT_EQ(fixedWeight, network.weights()[fixed->position()]);
+    ASSERT_EQ(3u, trainingSet.epochs());
 }
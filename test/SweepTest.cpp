@@ -0,0 +1,204 @@
+#include <cmath>
+#include <limits>
+#include <atomic>
+#include <stdexcept>
+
+#include <gtest/gtest.h>
+
+#include "NeuralNetwork.h"
+#include "BackpropagationTrainingAlgorithm.h"
+
+#include "Sweep.h"
+#include "TestNetworks.h"
+#include "SweepTest.h"
+
+
+using namespace wzann;
+
+
+TEST(SweepTest, testGridConfigurations)
+{
+    Sweep sweep;
+    sweep
+            .values("b", { 10.0, 20.0, 30.0 })
+            .values("a", { 1.0, 2.0 });
+
+    auto const configurations = sweep.configurations();
+
+    ASSERT_EQ(6u, configurations.size());
+    ASSERT_EQ(1.0, configurations[0].at("a"));
+    ASSERT_EQ(10.0, configurations[0].at("b"));
+    ASSERT_EQ(20.0, configurations[1].at("b"));
+    ASSERT_EQ(2.0, configurations[5].at("a"));
+    ASSERT_EQ(30.0, configurations[5].at("b"));
+
+    sweep.uniform("c", 0.0, 1.0);
+    ASSERT_THROW(sweep.configurations(), std::invalid_argument);
+}
+
+
+TEST(SweepTest, testRandomConfigurations)
+{
+    Sweep sweep;
+    sweep
+            .values("list", { 1.0, 2.0 })
+            .uniform("uniform", -1.0, 1.0)
+            .logUniform("log", 1e-4, 1e-1)
+            .uniformInteger("integer", 3, 5)
+            .numSamples(50)
+            .seed(7);
+
+    auto const configurations = sweep.configurations();
+    ASSERT_EQ(50u, configurations.size());
+    ASSERT_EQ(configurations, sweep.configurations());
+
+    for (auto const& c: configurations) {
+        ASSERT_TRUE(1.0 == c.at("list") || 2.0 == c.at("list"));
+        ASSERT_LE(-1.0, c.at("uniform"));
+        ASSERT_GT(1.0, c.at("uniform"));
+        ASSERT_LE(1e-4, c.at("log"));
+        ASSERT_GE(1e-1, c.at("log"));
+        ASSERT_EQ(std::round(c.at("integer")), c.at("integer"));
+        ASSERT_LE(3.0, c.at("integer"));
+        ASSERT_GE(5.0, c.at("integer"));
+    }
+
+    ASSERT_NE(configurations, sweep.seed(8).configurations());
+}
+
+
+TEST(SweepTest, testSuccessiveHalving)
+{
+    NeuralNetwork network;
+    createXORNetwork(network);
+
+    auto trainingSet = createXORTrainingSet();
+    trainingSet.targetError(0.0).maxEpochs(270);
+
+    std::atomic<int> numTrainings(0);
+    auto factory = [&numTrainings](Sweep::Configuration const& c) {
+        ++numTrainings;
+        auto* algorithm = new BackpropagationTrainingAlgorithm();
+        algorithm->learningRate(c.at("learning-rate"));
+        return algorithm;
+    };
+
+    Sweep sweep;
+    sweep
+            .values("learning-rate", {
+                0.0, 0.01, 0.1, 0.2, 0.5, 1.0, 2.0, 5.0, 10.0 })
+            .minEpochs(10)
+            .halvingRate(3)
+            .numThreads(2);
+
+    auto const trials = sweep.run(
+            network,
+            trainingSet,
+            &trainingSet,
+            factory);
+
+    // 9 trials train for 10 epochs, 3 for 30, and 1 for all 270:
+
+    ASSERT_EQ(9u, trials.size());
+    ASSERT_EQ(13, numTrainings);
+
+    int numPruned[2] = { 0, 0 };
+    Sweep::Trial const* best = nullptr;
+
+    for (auto const& trial: trials) {
+        ASSERT_FALSE(std::isnan(trial.verificationError));
+        ASSERT_EQ(trial.verificationError, trial.score());
+
+        if (trial.pruned) {
+            numPruned[10 == trial.budget ? 0 : 1]++;
+        } else {
+            ASSERT_EQ(nullptr, best);
+            best = &trial;
+        }
+    }
+
+    ASSERT_EQ(6, numPruned[0]);
+    ASSERT_EQ(2, numPruned[1]);
+    ASSERT_NE(nullptr, best);
+    ASSERT_EQ(270u, best->budget);
+    ASSERT_EQ(270u, best->epochs);
+    ASSERT_NE(0.0, best->configuration.at("learning-rate"));
+}
+
+
+TEST(SweepTest, testWithoutHalvingTrainsAllTrialsFully)
+{
+    NeuralNetwork network;
+    createXORNetwork(network);
+    auto const weights = network.weights();
+
+    auto trainingSet = createXORTrainingSet();
+    trainingSet.targetError(0.0).maxEpochs(20);
+
+    Sweep sweep;
+    sweep.uniform("learning-rate", 0.1, 1.0).numSamples(4);
+
+    auto const trials = sweep.run(
+            network,
+            trainingSet,
+            nullptr,
+            [](Sweep::Configuration const& c) {
+                auto* algorithm = new BackpropagationTrainingAlgorithm();
+                algorithm->learningRate(c.at("learning-rate"));
+                return algorithm;
+            });
+
+    ASSERT_EQ(4u, trials.size());
+
+    for (auto const& trial: trials) {
+        ASSERT_FALSE(trial.pruned);
+        ASSERT_EQ(20u, trial.budget);
+        ASSERT_TRUE(std::isnan(trial.verificationError));
+        ASSERT_EQ(trial.trainingError, trial.score());
+    }
+
+    ASSERT_EQ(weights, network.weights());
+}
+
+
+TEST(SweepTest, testDivergingTrialsRankLast)
+{
+    NeuralNetwork network;
+    createXORNetwork(network);
+
+    auto trainingSet = createXORTrainingSet();
+    trainingSet.targetError(0.0).maxEpochs(90);
+
+    auto const diverging = std::numeric_limits<double>::infinity();
+    Sweep sweep;
+    sweep
+            .values("learning-rate", {
+                diverging, diverging, 0.5, diverging, diverging,
+                diverging, diverging, diverging, diverging })
+            .minEpochs(10)
+            .halvingRate(3);
+
+    auto const trials = sweep.run(
+            network,
+            trainingSet,
+            &trainingSet,
+            [](Sweep::Configuration const& c) {
+                auto* algorithm = new BackpropagationTrainingAlgorithm();
+                algorithm->learningRate(c.at("learning-rate"));
+                return algorithm;
+            });
+
+    for (auto const& trial: trials) {
+        if (0.5 == trial.configuration.at("learning-rate")) {
+            ASSERT_FALSE(trial.pruned);
+            ASSERT_EQ(90u, trial.budget);
+            ASSERT_TRUE(std::isfinite(trial.score()));
+        } else {
+            ASSERT_TRUE(trial.pruned);
+            ASSERT_EQ(10u, trial.budget);
+            ASSERT_EQ(
+                    std::numeric_limits<double>::infinity(),
+                    trial.score());
+        }
+    }
+}
@@ -0,0 +1,6 @@
+#ifndef SWEEPTEST_H
+#define SWEEPTEST_H
+
+
+
+#endif // SWEEPTEST_H
@@ -0,0 +1,111 @@
+#ifndef TESTNETWORKS_H
+#define TESTNETWORKS_H
+
+
+#include <boost/range.hpp>
+
+#include "Connection.h"
+#include "TrainingSet.h"
+#include "NeuralNetwork.h"
+#include "ActivationFunction.h"
+#include "NeuralNetworkPattern.h"
+#include "SimpleWeightRandomizer.h"
+#include "PerceptronNetworkPattern.h"
+
+
+/*!
+ * \brief Configures a network as a perceptron with the given layers
+ *
+ * The weights are those the pattern creates; tests that need others set
+ * them afterwards.
+ */
+inline void createPerceptron(
+        wzann::NeuralNetwork& network,
+        wzann::NeuralNetworkPattern::SimpleLayerDefinitions const& layers)
+{
+    wzann::PerceptronNetworkPattern pattern;
+
+    for (auto const& layer: layers) {
+        pattern.addLayer(layer);
+    }
+
+    network.configure(pattern);
+}
+
+
+/*!
+ * \brief Configures a network with two inputs, three hidden neurons and
+ *  one output, for createXORTrainingSet(), with random weights
+ */
+inline void createXORNetwork(
+        wzann::NeuralNetwork& network,
+        wzann::ActivationFunction activationFunction =
+            wzann::ActivationFunction::Logistic)
+{
+    createPerceptron(network, {
+            { 2, wzann::ActivationFunction::Identity },
+            { 3, activationFunction },
+            { 1, activationFunction } });
+    wzann::SimpleWeightRandomizer().randomize(network);
+}
+
+
+/*!
+ * \brief Configures an XOR network as createXORNetwork() does, with an
+ *  additional connection from the first input to the output neuron
+ *
+ * The connection skips the hidden layer, which the network's pattern
+ * does not calculate.
+ */
+inline void createSkipConnectionNetwork(wzann::NeuralNetwork& network)
+{
+    createXORNetwork(network);
+    network.connectNeurons(
+            *(network.layerAt(0)->neuronAt(0)),
+            *(network.layerAt(2)->neuronAt(0))).weight(0.5);
+}
+
+
+/*!
+ * \brief Configures a network with one input and one output neuron,
+ *  whose only trainable weight connects the two
+ *
+ * The bias weight is fixed at `0.0`, so that the network calculates
+ * \f$f(w x)\f$. This makes the error a function of a single weight that
+ * tests can work out by hand.
+ */
+inline void createSingleWeightNetwork(
+        wzann::NeuralNetwork& network,
+        wzann::ActivationFunction activationFunction,
+        double weight)
+{
+    createPerceptron(network, {
+            { 1, wzann::ActivationFunction::Identity },
+            { 1, activationFunction } });
+
+    for (auto* connection:
+            boost::make_iterator_range(network.connections())) {
+        if (&connection->source() == &network.biasNeuron()) {
+            connection->weight(0.0);
+            connection->fixedWeight(true);
+        } else {
+            connection->weight(weight);
+        }
+    }
+}
+
+
+//! \brief Creates a training set for the XOR function
+inline wzann::TrainingSet createXORTrainingSet()
+{
+    wzann::TrainingSet trainingSet;
+    trainingSet
+            << wzann::TrainingItem({ 0.0, 0.0 }, { 0.0 })
+            << wzann::TrainingItem({ 0.0, 1.0 }, { 1.0 })
+            << wzann::TrainingItem({ 1.0, 0.0 }, { 1.0 })
+            << wzann::TrainingItem({ 1.0, 1.0 }, { 0.0 });
+    return trainingSet;
+}
+
+
+#endif // TESTNETWORKS_H
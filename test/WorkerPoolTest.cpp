@@ -0,0 +1,66 @@
+#include <vector>
+#include <stdexcept>
+
+#include <gtest/gtest.h>
+
+#include "WorkerPool.h"
+#include "WorkerPoolTest.h"
+
+
+using namespace wzann;
+
+
+TEST(WorkerPoolTest, testRunsEachTaskOncePerBatch)
+{
+    WorkerPool pool(4);
+    ASSERT_EQ(4u, pool.numWorkers());
+
+    std::vector<int> runs(100, 0);
+    std::vector<std::size_t> workers(runs.size(), 0);
+
+    // The threads are kept from one batch to the next:
+
+    for (int batch = 1; batch != 4; ++batch) {
+        pool.run(runs.size(), [&](std::size_t worker, std::size_t i) {
+            ++runs[i];
+            workers[i] = worker;
+        });
+
+        ASSERT_EQ(std::vector<int>(100, batch), runs);
+
+        for (auto const worker: workers) {
+            ASSERT_LT(worker, pool.numWorkers());
+        }
+    }
+
+    pool.run(0, [](std::size_t, std::size_t) { FAIL(); });
+}
+
+
+TEST(WorkerPoolTest, testRethrowsFirstException)
+{
+    WorkerPool pool(3);
+    std::vector<int> runs(10, 0);
+
+    try {
+        pool.run(runs.size(), [&runs](std::size_t, std::size_t i) {
+            ++runs[i];
+
+            if (i == 4 || i == 7) {
+                throw std::runtime_error(std::to_string(i));
+            }
+        });
+        FAIL();
+    } catch (std::runtime_error const& e) {
+        ASSERT_STREQ("4", e.what());
+    }
+
+    ASSERT_EQ(std::vector<int>(10, 1), runs);
+
+    // The pool stays usable:
+
+    pool.run(runs.size(), [&runs](std::size_t, std::size_t i) {
+        ++runs[i];
+    });
+    ASSERT_EQ(std::vector<int>(10, 2), runs);
+}
@@ -0,0 +1,6 @@
+#ifndef WORKERPOOLTEST_H
+#define WORKERPOOLTEST_H
+
+
+
+#endif // WORKERPOOLTEST_H
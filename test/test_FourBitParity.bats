@@ -30,4 +30,34 @@ vrfy_in="${SRCDIR}/mock/FourBitParity-Verify.json"
     [[ "$parity" =~ ^\(0\.9 ]]
 }
 
+
+@test "Verification set with the wrong number of inputs is rejected" {
+    "$mkann" \
+        -p wzann::PerceptronNetworkPattern \
+        -l 4:ReLU \
+        -l 12:Logistic \
+        -l 1:Logistic \
+        > FourBitParityAnn.in.json
+    cat > ShortVerify.json <<EOF
+{
+    "targetError": 0.001,
+    "maxEpochs": 20000,
+    "trainingItems": [{
+            "input": [1, 0, 0],
+            "expectedOutput": [1]
+        }
+    ]
+}
+EOF
+
+    run "$train" \
+        -i FourBitParityAnn.in.json \
+        -o FourBitParityAnn.out.json \
+        -I "$train_in" \
+        -V ShortVerify.json \
+        -t wzann::RpropTrainingAlgorithm
+    [ "$status" -eq 1 ]
+    [[ "$output" =~ "Verification set item 0 has 3 inputs" ]]
+}
+
 # vim:ft=sh